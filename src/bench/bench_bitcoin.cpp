@@ -6,7 +6,11 @@
 
 #include <clientversion.h>
 #include <common/args.h>
+#include <crypto/chacha20.h>
+#include <crypto/poly1305.h>
+#include <crypto/ripemd160.h>
 #include <crypto/sha256.h>
+#include <crypto/siphash.h>
 #include <util/fs.h>
 #include <util/strencodings.h>
 
@@ -64,6 +68,10 @@ int main(int argc, char** argv)
     ArgsManager argsman;
     SetupBenchArgs(argsman);
     SHA256AutoDetect();
+    ChaCha20AutoDetect();
+    Poly1305AutoDetect();
+    SipHashAutoDetect();
+    RIPEMD160AutoDetect();
     std::string error;
     if (!argsman.ParseParameters(argc, argv, error)) {
         tfm::format(std::cerr, "Error parsing command line arguments: %s\n", error);
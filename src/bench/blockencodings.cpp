@@ -0,0 +1,81 @@
+// Copyright (c) 2024 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <blockencodings.h>
+#include <consensus/amount.h>
+#include <crypto/siphash.h>
+#include <kernel/cs_main.h>
+#include <kernel/mempool_entry.h>
+#include <primitives/block.h>
+#include <random.h>
+#include <test/util/setup_common.h>
+#include <tinyformat.h>
+#include <txmempool.h>
+#include <util/chaintype.h>
+
+#include <vector>
+
+/** Number of transactions in the mempool */
+static constexpr int MEMPOOL_TXS{300'000};
+/** Number of mempool transactions included in the compact block */
+static constexpr int BLOCK_TXS{3'000};
+
+static void AddTx(const CTransactionRef& tx, CTxMemPool& pool) EXCLUSIVE_LOCKS_REQUIRED(cs_main, pool.cs)
+{
+    LockPoints lp;
+    pool.addUnchecked(CTxMemPoolEntry(tx, /*fee=*/1000, /*time=*/0, /*entry_height=*/1, /*entry_sequence=*/0, /*spends_coinbase=*/false, /*sigops_cost=*/4, lp));
+}
+
+static void BlockEncodingInitData(benchmark::Bench& bench)
+{
+    const auto testing_setup = MakeNoLogFileContext<const ChainTestingSetup>(ChainType::MAIN);
+    CTxMemPool& pool = *Assert(testing_setup->m_node.mempool);
+    FastRandomContext det_rand{/*fDeterministic=*/true};
+
+    CBlock block;
+    block.nBits = 0x207fffff; // a null header is rejected
+    CMutableTransaction coinbase;
+    coinbase.vin.resize(1);
+    coinbase.vout.resize(1);
+    block.vtx.push_back(MakeTransactionRef(coinbase));
+    {
+        LOCK2(cs_main, pool.cs);
+        for (int i = 0; i < MEMPOOL_TXS; ++i) {
+            CMutableTransaction tx;
+            tx.vin.resize(1);
+            tx.vin[0].prevout = COutPoint{Txid::FromUint256(det_rand.rand256()), 0};
+            tx.vin[0].scriptWitness.stack.push_back({1});
+            tx.vout.resize(1);
+            tx.vout[0].scriptPubKey = CScript() << OP_1 << OP_EQUAL;
+            tx.vout[0].nValue = COIN;
+            const CTransactionRef tx_r{MakeTransactionRef(tx)};
+            AddTx(tx_r, pool);
+            if (i % (MEMPOOL_TXS / BLOCK_TXS) == 0) block.vtx.push_back(tx_r);
+        }
+    }
+    const CBlockHeaderAndShortTxIDs cmpctblock{block, det_rand.rand64()};
+
+    bench.unit("block").run([&] {
+        PartiallyDownloadedBlock partial_block{&pool};
+        const ReadStatus status{partial_block.InitData(cmpctblock, /*extra_txn=*/{})};
+        assert(status == READ_STATUS_OK);
+    });
+}
+
+static void BlockEncodingInitDataStandard(benchmark::Bench& bench)
+{
+    bench.name(strprintf("%s using the '%s' SipHash implementation", __func__, SipHashAutoDetect(siphash_implementation::STANDARD)));
+    BlockEncodingInitData(bench);
+    SipHashAutoDetect();
+}
+
+static void BlockEncodingInitDataVectorized(benchmark::Bench& bench)
+{
+    bench.name(strprintf("%s using the '%s' SipHash implementation", __func__, SipHashAutoDetect()));
+    BlockEncodingInitData(bench);
+}
+
+BENCHMARK(BlockEncodingInitDataStandard, benchmark::PriorityLevel::HIGH);
+BENCHMARK(BlockEncodingInitDataVectorized, benchmark::PriorityLevel::HIGH);
@@ -6,6 +6,7 @@
 #include <bench/bench.h>
 #include <crypto/chacha20.h>
 #include <crypto/chacha20poly1305.h>
+#include <tinyformat.h>
 
 /* Number of bytes to process per iteration */
 static const uint64_t BUFFER_SIZE_TINY  = 64;
@@ -66,9 +67,40 @@ static void FSCHACHA20POLY1305_1MB(benchmark::Bench& bench)
     FSCHACHA20POLY1305(bench, BUFFER_SIZE_LARGE);
 }
 
+static void CHACHA20_1MB_IMPL(benchmark::Bench& bench, const char* name, chacha20_implementation::UseImplementation use_implementation)
+{
+    bench.name(strprintf("%s using the '%s' ChaCha20 implementation", name, ChaCha20AutoDetect(use_implementation)));
+    CHACHA20(bench, BUFFER_SIZE_LARGE);
+    ChaCha20AutoDetect();
+}
+
+static void CHACHA20_1MB_STANDARD(benchmark::Bench& bench)
+{
+    CHACHA20_1MB_IMPL(bench, __func__, chacha20_implementation::STANDARD);
+}
+
+static void CHACHA20_1MB_SSE41(benchmark::Bench& bench)
+{
+    CHACHA20_1MB_IMPL(bench, __func__, chacha20_implementation::USE_SSE41);
+}
+
+static void CHACHA20_1MB_AVX2(benchmark::Bench& bench)
+{
+    CHACHA20_1MB_IMPL(bench, __func__, chacha20_implementation::USE_SSE41_AND_AVX2);
+}
+
+static void CHACHA20_1MB_AVX512(benchmark::Bench& bench)
+{
+    CHACHA20_1MB_IMPL(bench, __func__, chacha20_implementation::USE_ALL);
+}
+
 BENCHMARK(CHACHA20_64BYTES, benchmark::PriorityLevel::HIGH);
 BENCHMARK(CHACHA20_256BYTES, benchmark::PriorityLevel::HIGH);
 BENCHMARK(CHACHA20_1MB, benchmark::PriorityLevel::HIGH);
 BENCHMARK(FSCHACHA20POLY1305_64BYTES, benchmark::PriorityLevel::HIGH);
 BENCHMARK(FSCHACHA20POLY1305_256BYTES, benchmark::PriorityLevel::HIGH);
 BENCHMARK(FSCHACHA20POLY1305_1MB, benchmark::PriorityLevel::HIGH);
+BENCHMARK(CHACHA20_1MB_STANDARD, benchmark::PriorityLevel::HIGH);
+BENCHMARK(CHACHA20_1MB_SSE41, benchmark::PriorityLevel::HIGH);
+BENCHMARK(CHACHA20_1MB_AVX2, benchmark::PriorityLevel::HIGH);
+BENCHMARK(CHACHA20_1MB_AVX512, benchmark::PriorityLevel::HIGH);
@@ -5,18 +5,28 @@
 #include <bench/bench.h>
 #include <bench/data.h>
 
+#include <chain.h>
 #include <chainparams.h>
+#include <checkqueue.h>
+#include <coins.h>
 #include <common/args.h>
+#include <common/system.h>
 #include <consensus/validation.h>
+#include <script/interpreter.h>
 #include <streams.h>
+#include <tinyformat.h>
 #include <util/chaintype.h>
 #include <validation.h>
 
+#include <algorithm>
+#include <vector>
+
 // These are the two major time-sinks which happen after we have fully received
 // a block off the wire, but before we can relay the block on to peers using
 // compact block relay.
 
-static void DeserializeBlockTest(benchmark::Bench& bench)
+template <typename Params>
+static void DeserializeBlock(benchmark::Bench& bench, const Params& params)
 {
     DataStream stream(benchmark::data::block413567);
     std::byte a{0};
@@ -24,12 +34,22 @@ static void DeserializeBlockTest(benchmark::Bench& bench)
 
     bench.unit("block").run([&] {
         CBlock block;
-        stream >> TX_WITH_WITNESS(block);
+        stream >> params(block);
         bool rewound = stream.Rewind(benchmark::data::block413567.size());
         assert(rewound);
     });
 }
 
+static void DeserializeBlockTest(benchmark::Bench& bench)
+{
+    DeserializeBlock(bench, TX_WITH_WITNESS);
+}
+
+static void DeserializeBlockArenaTest(benchmark::Bench& bench)
+{
+    DeserializeBlock(bench, TX_WITH_WITNESS_ARENA);
+}
+
 static void DeserializeAndCheckBlockTest(benchmark::Bench& bench)
 {
     DataStream stream(benchmark::data::block413567);
@@ -51,5 +71,54 @@ static void DeserializeAndCheckBlockTest(benchmark::Bench& bench)
     });
 }
 
+// The contextual transaction checks of ConnectBlock (inputs, sequence locks and
+// sigop cost), run against a made-up coin for every input.
+static void ConnectBlockTxChecks(benchmark::Bench& bench, int worker_threads)
+{
+    DataStream stream(benchmark::data::block413567);
+    CBlock block;
+    stream >> TX_WITH_WITNESS(block);
+
+    std::vector<std::vector<Coin>> spent_coins(block.vtx.size());
+    for (size_t i = 0; i < block.vtx.size(); i++) {
+        const CTransaction& tx{*block.vtx[i]};
+        if (tx.IsCoinBase()) continue;
+        // Let the first input pay for all outputs.
+        for (size_t j = 0; j < tx.vin.size(); j++) {
+            spent_coins[i].emplace_back(CTxOut{j == 0 ? tx.GetValueOut() : 0, CScript() << OP_TRUE}, 1, false);
+        }
+    }
+    CBlockIndex prev_index;
+    CBlockIndex block_index{block};
+    block_index.pprev = &prev_index;
+    block_index.nHeight = 413567;
+    // The block predates CSV and segwit.
+    const unsigned int flags{SCRIPT_VERIFY_P2SH | SCRIPT_VERIFY_DERSIG | SCRIPT_VERIFY_CHECKLOCKTIMEVERIFY};
+
+    CCheckQueue<CTxInputsCheck> queue{/*batch_size=*/16, worker_threads};
+    std::vector<CTxInputsCheck::Result> results(block.vtx.size());
+    bench.unit("block").run([&] {
+        std::vector<CTxInputsCheck> checks;
+        checks.reserve(block.vtx.size());
+        for (size_t i = 0; i < block.vtx.size(); i++) {
+            checks.emplace_back(*block.vtx[i], spent_coins[i], block_index, /*lock_time_flags=*/0, flags, results[i]);
+        }
+        if (worker_threads == 0) {
+            for (auto& check : checks) check();
+        } else {
+            CCheckQueueControl<CTxInputsCheck> control(&queue);
+            control.Add(std::move(checks));
+            control.Wait();
+        }
+        assert(std::all_of(results.begin(), results.end(), [](const auto& result) { return result.inputs_ok && result.sequence_locks_ok; }));
+    });
+}
+
+static void ConnectBlockTxChecksSerial(benchmark::Bench& bench) { ConnectBlockTxChecks(bench, 0); }
+static void ConnectBlockTxChecksParallel(benchmark::Bench& bench) { ConnectBlockTxChecks(bench, std::max(GetNumCores() - 1, 1)); }
+
 BENCHMARK(DeserializeBlockTest, benchmark::PriorityLevel::HIGH);
+BENCHMARK(DeserializeBlockArenaTest, benchmark::PriorityLevel::HIGH);
 BENCHMARK(DeserializeAndCheckBlockTest, benchmark::PriorityLevel::HIGH);
+BENCHMARK(ConnectBlockTxChecksSerial, benchmark::PriorityLevel::HIGH);
+BENCHMARK(ConnectBlockTxChecksParallel, benchmark::PriorityLevel::HIGH);
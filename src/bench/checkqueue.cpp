@@ -7,8 +7,13 @@
 #include <common/system.h>
 #include <key.h>
 #include <prevector.h>
+#include <primitives/transaction.h>
 #include <pubkey.h>
 #include <random.h>
+#include <script/interpreter.h>
+#include <script/sigcache.h>
+#include <tinyformat.h>
+#include <validation.h>
 
 #include <vector>
 
@@ -19,7 +24,9 @@ static const unsigned int QUEUE_BATCH_SIZE = 128;
 
 // This Benchmark tests the CheckQueue with a slightly realistic workload,
 // where checks all contain a prevector that is indirect 50% of the time
-// and there is a little bit of work done between calls to Add.
+// and there is a little bit of work done between calls to Add. It is run
+// with 1 to 64 threads (including the master), up to the number of cores, to
+// show how the queue scales.
 static void CCheckQueueSpeedPrevectorJob(benchmark::Bench& bench)
 {
     // We shouldn't ever be running with the checkqueue on a single core machine.
@@ -38,11 +45,6 @@ static void CCheckQueueSpeedPrevectorJob(benchmark::Bench& bench)
         }
     };
 
-    // The main thread should be counted to prevent thread oversubscription, and
-    // to decrease the variance of benchmark results.
-    int worker_threads_num{GetNumCores() - 1};
-    CCheckQueue<PrevectorJob> queue{QUEUE_BATCH_SIZE, worker_threads_num};
-
     // create all the data once, then submit copies in the benchmark.
     FastRandomContext insecure_rand(true);
     std::vector<std::vector<PrevectorJob>> vBatches(BATCHES);
@@ -52,15 +54,82 @@ static void CCheckQueueSpeedPrevectorJob(benchmark::Bench& bench)
             vChecks.emplace_back(insecure_rand);
     }
 
-    bench.minEpochIterations(10).batch(BATCH_SIZE * BATCHES).unit("job").run([&] {
-        // Make insecure_rand here so that each iteration is identical.
-        CCheckQueueControl<PrevectorJob> control(&queue);
-        for (auto vChecks : vBatches) {
-            control.Add(std::move(vChecks));
+    for (const int threads : {1, 2, 4, 8, 16, 32, 64}) {
+        // Running more threads than cores would only measure oversubscription.
+        if (threads > GetNumCores()) break;
+        // The master thread is counted as one of the threads.
+        CCheckQueue<PrevectorJob> queue{QUEUE_BATCH_SIZE, threads - 1};
+        bench.name(strprintf("CCheckQueueSpeedPrevectorJob, %d threads", threads));
+        bench.minEpochIterations(10).batch(BATCH_SIZE * BATCHES).unit("job").run([&] {
+            // Make insecure_rand here so that each iteration is identical.
+            CCheckQueueControl<PrevectorJob> control(&queue);
+            for (auto vChecks : vBatches) {
+                control.Add(std::move(vChecks));
+            }
+            // control waits for completion by RAII, but
+            // it is done explicitly here for clarity
+            control.Wait();
+        });
+    }
+}
+BENCHMARK(CCheckQueueSpeedPrevectorJob, benchmark::PriorityLevel::HIGH);
+
+// This Benchmark tests the CheckQueue with the script checks of a block full
+// of taproot key path spends, so that the time is dominated by Schnorr
+// signature verification.
+static void CCheckQueueTaprootKeyPath(benchmark::Bench& bench)
+{
+    static constexpr size_t INPUTS{2000};
+    static constexpr unsigned int FLAGS{SCRIPT_VERIFY_P2SH | SCRIPT_VERIFY_WITNESS | SCRIPT_VERIFY_TAPROOT};
+
+    ECC_Context ecc_context{};
+
+    FastRandomContext insecure_rand(true);
+    CKey key;
+    key.MakeNewKey(true);
+    const auto output_key{XOnlyPubKey{key.GetPubKey()}.CreateTapTweak(/*merkle_root=*/nullptr)};
+    const CScript script_pubkey{CScript() << OP_1 << ToByteVector(output_key->first)};
+
+    CMutableTransaction mtx;
+    std::vector<CTxOut> spent_outputs;
+    for (size_t i = 0; i < INPUTS; ++i) {
+        mtx.vin.emplace_back(COutPoint{Txid::FromUint256(insecure_rand.rand256()), 0});
+        spent_outputs.emplace_back(1000, script_pubkey);
+    }
+    mtx.vout.emplace_back(INPUTS * 900, script_pubkey);
+
+    // Sign all inputs with SIGHASH_DEFAULT, with the key tweaked for a key path
+    // spend without scripts.
+    const uint256 merkle_root;
+    PrecomputedTransactionData sign_txdata;
+    sign_txdata.Init(mtx, std::vector<CTxOut>{spent_outputs}, /*force=*/true);
+    for (size_t i = 0; i < INPUTS; ++i) {
+        ScriptExecutionData execdata;
+        execdata.m_annex_init = true;
+        execdata.m_annex_present = false;
+        uint256 sighash;
+        assert(SignatureHashSchnorr(sighash, execdata, mtx, i, SIGHASH_DEFAULT, SigVersion::TAPROOT, sign_txdata, MissingDataBehavior::FAIL));
+        std::vector<unsigned char> sig(64);
+        assert(key.SignSchnorr(sighash, sig, &merkle_root, insecure_rand.rand256()));
+        mtx.vin[i].scriptWitness.stack.push_back(std::move(sig));
+    }
+    const CTransaction tx{mtx};
+    PrecomputedTransactionData txdata;
+    txdata.Init(tx, std::move(spent_outputs));
+
+    // Signatures are not stored, so every iteration misses the cache.
+    SignatureCache signature_cache{DEFAULT_SIGNATURE_CACHE_BYTES};
+    CCheckQueue<CScriptCheck> queue{QUEUE_BATCH_SIZE, std::max(GetNumCores() - 1, 0)};
+
+    bench.batch(INPUTS).unit("input").run([&] {
+        CCheckQueueControl<CScriptCheck> control(&queue);
+        std::vector<CScriptCheck> checks;
+        checks.reserve(INPUTS);
+        for (size_t i = 0; i < INPUTS; ++i) {
+            checks.emplace_back(txdata.m_spent_outputs[i], tx, signature_cache, i, FLAGS, /*cacheIn=*/false, &txdata);
         }
-        // control waits for completion by RAII, but
-        // it is done explicitly here for clarity
-        control.Wait();
+        control.Add(std::move(checks));
+        assert(control.Wait());
     });
 }
-BENCHMARK(CCheckQueueSpeedPrevectorJob, benchmark::PriorityLevel::HIGH);
+BENCHMARK(CCheckQueueTaprootKeyPath, benchmark::PriorityLevel::HIGH);
@@ -3,6 +3,7 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <bench/bench.h>
+#include <common/system.h>
 #include <interfaces/chain.h>
 #include <node/context.h>
 #include <policy/policy.h>
@@ -20,6 +21,7 @@ using wallet::COutput;
 using wallet::CWallet;
 using wallet::CWalletTx;
 using wallet::CoinEligibilityFilter;
+using wallet::CoinGrinder;
 using wallet::CoinSelectionParams;
 using wallet::CreateMockableWalletDatabase;
 using wallet::OutputGroup;
@@ -124,5 +126,48 @@ static void BnBExhaustion(benchmark::Bench& bench)
     });
 }
 
+// A pool of UTXOs with pseudorandom values of up to 1 BTC, whose inputs cost more at the current than at the long term feerate
+static std::vector<OutputGroup> MakeLargePool(int num_utxos)
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    std::vector<OutputGroup> utxo_pool;
+    utxo_pool.reserve(num_utxos);
+    for (int i = 0; i < num_utxos; ++i) {
+        CMutableTransaction tx;
+        tx.nLockTime = i; // so all transactions get different hashes
+        tx.vout.resize(1);
+        tx.vout[0].nValue = 10'000 + rng.randrange(COIN);
+        const int input_bytes{rng.randbool() ? 68 : 91};
+        COutput output(COutPoint(tx.GetHash(), 0), tx.vout[0], /*depth=*/ 6, input_bytes, /*spendable=*/ true, /*solvable=*/ true, /*safe=*/ true, /*time=*/ 0, /*from_me=*/ true, /*fees=*/ input_bytes * 20);
+        utxo_pool.emplace_back();
+        utxo_pool.back().Insert(std::make_shared<COutput>(output), /*ancestors=*/ 0, /*descendants=*/ 0);
+        utxo_pool.back().long_term_fee = input_bytes * 10;
+    }
+    return utxo_pool;
+}
+
+// Searches of a large UTXO pool, which typically run into the limit on tries. Each run finds a
+// solution, so the selections per second are the solutions found per second.
+static void LargePoolSelection(benchmark::Bench& bench, bool coin_grinder, size_t num_threads)
+{
+    std::vector<OutputGroup> utxo_pool{MakeLargePool(50'000)};
+    const CAmount target{COIN + COIN / 3};
+
+    bench.unit("solution").run([&] {
+        const auto result{coin_grinder ? CoinGrinder(utxo_pool, target, CHANGE_LOWER, MAX_STANDARD_TX_WEIGHT, num_threads) :
+                                         SelectCoinsBnB(utxo_pool, target, /*cost_of_change=*/ 5'000, MAX_STANDARD_TX_WEIGHT, num_threads)};
+        assert(result);
+    });
+}
+
+static void BnBLargePool(benchmark::Bench& bench) { LargePoolSelection(bench, /*coin_grinder=*/false, /*num_threads=*/1); }
+static void BnBLargePoolParallel(benchmark::Bench& bench) { LargePoolSelection(bench, /*coin_grinder=*/false, std::max(GetNumCores(), 1)); }
+static void CoinGrinderLargePool(benchmark::Bench& bench) { LargePoolSelection(bench, /*coin_grinder=*/true, /*num_threads=*/1); }
+static void CoinGrinderLargePoolParallel(benchmark::Bench& bench) { LargePoolSelection(bench, /*coin_grinder=*/true, std::max(GetNumCores(), 1)); }
+
 BENCHMARK(CoinSelection, benchmark::PriorityLevel::HIGH);
 BENCHMARK(BnBExhaustion, benchmark::PriorityLevel::HIGH);
+BENCHMARK(BnBLargePool, benchmark::PriorityLevel::LOW);
+BENCHMARK(BnBLargePoolParallel, benchmark::PriorityLevel::LOW);
+BENCHMARK(CoinGrinderLargePool, benchmark::PriorityLevel::LOW);
+BENCHMARK(CoinGrinderLargePoolParallel, benchmark::PriorityLevel::LOW);
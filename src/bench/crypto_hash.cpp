@@ -178,6 +178,79 @@ static void SHA256D64_1024_SHANI(benchmark::Bench& bench)
     SHA256AutoDetect();
 }
 
+/** Double-SHA256 of 1024 messages with transaction-like sizes (150 to 600 bytes). */
+static void SHA256DMulti_1024(benchmark::Bench& bench, const char* name, sha256_implementation::UseImplementation use_implementation)
+{
+    bench.name(strprintf("%s using the '%s' SHA256 implementation", name, SHA256AutoDetect(use_implementation)));
+    FastRandomContext rng{/*fDeterministic=*/true};
+    std::vector<std::vector<uint8_t>> msgs(1024);
+    std::vector<Span<const uint8_t>> in;
+    size_t total{0};
+    for (auto& msg : msgs) {
+        msg = rng.randbytes(150 + rng.randrange(451));
+        total += msg.size();
+        in.emplace_back(msg);
+    }
+    std::vector<uint8_t> out(32 * in.size());
+    bench.batch(total).unit("byte").run([&] {
+        SHA256DMulti(out.data(), in.data(), in.size());
+    });
+    SHA256AutoDetect();
+}
+
+static void SHA256DMulti_1024_STANDARD(benchmark::Bench& bench)
+{
+    SHA256DMulti_1024(bench, __func__, sha256_implementation::STANDARD);
+}
+
+static void SHA256DMulti_1024_SSE4(benchmark::Bench& bench)
+{
+    SHA256DMulti_1024(bench, __func__, sha256_implementation::USE_SSE4);
+}
+
+static void SHA256DMulti_1024_AVX2(benchmark::Bench& bench)
+{
+    SHA256DMulti_1024(bench, __func__, sha256_implementation::USE_SSE4_AND_AVX2);
+}
+
+static void SHA256DMulti_1024_SHANI(benchmark::Bench& bench)
+{
+    SHA256DMulti_1024(bench, __func__, sha256_implementation::USE_SSE4_AND_SHANI);
+}
+
+/** Hash160 of 1024 compressed public keys. */
+static void Hash160Multi_1024(benchmark::Bench& bench, const char* name, ripemd160_implementation::UseImplementation use_implementation)
+{
+    bench.name(strprintf("%s using the '%s' RIPEMD160 implementation", name, RIPEMD160AutoDetect(use_implementation)));
+    FastRandomContext rng{/*fDeterministic=*/true};
+    std::vector<std::vector<uint8_t>> pubkeys(1024);
+    std::vector<Span<const uint8_t>> in;
+    for (auto& pubkey : pubkeys) {
+        pubkey = rng.randbytes(33);
+        in.emplace_back(pubkey);
+    }
+    bench.batch(in.size()).unit("key").run([&] {
+        const auto hashes{Hash160Multi(in)};
+        ankerl::nanobench::doNotOptimizeAway(hashes);
+    });
+    RIPEMD160AutoDetect();
+}
+
+static void Hash160Multi_1024_STANDARD(benchmark::Bench& bench)
+{
+    Hash160Multi_1024(bench, __func__, ripemd160_implementation::STANDARD);
+}
+
+static void Hash160Multi_1024_SSE41(benchmark::Bench& bench)
+{
+    Hash160Multi_1024(bench, __func__, ripemd160_implementation::USE_SSE41);
+}
+
+static void Hash160Multi_1024_AVX2(benchmark::Bench& bench)
+{
+    Hash160Multi_1024(bench, __func__, ripemd160_implementation::USE_ALL);
+}
+
 static void SHA512(benchmark::Bench& bench)
 {
     uint8_t hash[CSHA512::OUTPUT_SIZE];
@@ -258,6 +331,13 @@ BENCHMARK(SHA256D64_1024_STANDARD, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SHA256D64_1024_SSE4, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SHA256D64_1024_AVX2, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SHA256D64_1024_SHANI, benchmark::PriorityLevel::HIGH);
+BENCHMARK(SHA256DMulti_1024_STANDARD, benchmark::PriorityLevel::HIGH);
+BENCHMARK(SHA256DMulti_1024_SSE4, benchmark::PriorityLevel::HIGH);
+BENCHMARK(SHA256DMulti_1024_AVX2, benchmark::PriorityLevel::HIGH);
+BENCHMARK(SHA256DMulti_1024_SHANI, benchmark::PriorityLevel::HIGH);
+BENCHMARK(Hash160Multi_1024_STANDARD, benchmark::PriorityLevel::HIGH);
+BENCHMARK(Hash160Multi_1024_SSE41, benchmark::PriorityLevel::HIGH);
+BENCHMARK(Hash160Multi_1024_AVX2, benchmark::PriorityLevel::HIGH);
 
 BENCHMARK(MuHash, benchmark::PriorityLevel::HIGH);
 BENCHMARK(MuHashMul, benchmark::PriorityLevel::HIGH);
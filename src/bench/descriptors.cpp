@@ -29,4 +29,44 @@ static void ExpandDescriptor(benchmark::Bench& bench)
     });
 }
 
+/** Derive 1000 keys of a ranged descriptor from a cached xpub, like DescriptorScriptPubKeyMan::TopUp does. */
+static void ExpandRangedDescriptorFromCache(benchmark::Bench& bench, bool expand_range)
+{
+    ECC_Context ecc_context{};
+
+    const auto desc_str = "wpkh([ffffffff/13']xpub69H7F5d8KSRgmmdJg2KhpAK8SR3DjMwAdkxj3ZuxV27CprR9LgpeyGmXUbC6wb7ERfvrnKZjXoUmmDznezpbZb7ap6r1D3tgFxHmwMkQTPH/1/2/*)";
+    constexpr int RANGE_END{1000};
+    FlatSigningProvider provider;
+    std::string error;
+    auto desc = Parse(desc_str, provider, error);
+    DescriptorCache cache;
+    {
+        std::vector<CScript> scripts;
+        FlatSigningProvider out;
+        const bool success = desc->Expand(0, provider, scripts, out, &cache);
+        assert(success);
+    }
+
+    bench.batch(RANGE_END).unit("key").run([&] {
+        if (expand_range) {
+            std::vector<std::vector<CScript>> scripts;
+            std::vector<FlatSigningProvider> out;
+            bool success = desc->ExpandRangeFromCache(0, RANGE_END, cache, scripts, out);
+            assert(success);
+        } else {
+            for (int i = 0; i < RANGE_END; ++i) {
+                std::vector<CScript> scripts;
+                FlatSigningProvider out;
+                bool success = desc->ExpandFromCache(i, cache, scripts, out);
+                assert(success);
+            }
+        }
+    });
+}
+
+static void ExpandDescriptorFromCache(benchmark::Bench& bench) { ExpandRangedDescriptorFromCache(bench, /*expand_range=*/false); }
+static void ExpandDescriptorRangeFromCache(benchmark::Bench& bench) { ExpandRangedDescriptorFromCache(bench, /*expand_range=*/true); }
+
 BENCHMARK(ExpandDescriptor, benchmark::PriorityLevel::HIGH);
+BENCHMARK(ExpandDescriptorFromCache, benchmark::PriorityLevel::HIGH);
+BENCHMARK(ExpandDescriptorRangeFromCache, benchmark::PriorityLevel::HIGH);
@@ -0,0 +1,83 @@
+// Copyright (c) 2024-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+
+#include <addresstype.h>
+#include <index/txindex.h>
+#include <node/chainstate.h>
+#include <node/context.h>
+#include <test/util/setup_common.h>
+#include <util/strencodings.h>
+
+static constexpr int CHAIN_SIZE{600};
+
+static std::unique_ptr<TestChain100Setup> CreateTxIndexChain()
+{
+    auto test_setup = MakeNoLogFileContext<TestChain100Setup>();
+    CPubKey pubkey{ParseHex("02ed26169896db86ced4cbb7b3ecef9859b5952825adbeab998fb5b307e54949c9")};
+    CScript script = GetScriptForDestination(WitnessV0KeyHash(pubkey));
+    std::vector<CMutableTransaction> noTxns;
+    for (int i = 0; i < CHAIN_SIZE - 100; i++) {
+        test_setup->CreateAndProcessBlock(noTxns, script);
+        SetMockTime(GetTime() + 1);
+    }
+    assert(WITH_LOCK(::cs_main, return test_setup->m_node.chainman->ActiveHeight() == CHAIN_SIZE));
+    return test_setup;
+}
+
+// Sync a transaction index from scratch, only using coinbase transactions.
+static void TxIndexSync(benchmark::Bench& bench, TxIndexFormat format)
+{
+    const auto test_setup = CreateTxIndexChain();
+
+    bench.minEpochIterations(5).run([&] {
+        TxIndex txindex(interfaces::MakeChain(test_setup->m_node), /*n_cache_size=*/0, /*f_memory=*/false, /*f_wipe=*/true, format);
+        assert(txindex.Init());
+        assert(!txindex.BlockUntilSyncedToCurrentChain());
+        txindex.Sync();
+
+        IndexSummary summary = txindex.GetSummary();
+        assert(summary.synced);
+        assert(summary.best_block_hash == WITH_LOCK(::cs_main, return test_setup->m_node.chainman->ActiveTip()->GetBlockHash()));
+    });
+}
+
+// Look up all indexed transactions of a synced transaction index.
+static void TxIndexFindTx(benchmark::Bench& bench, TxIndexFormat format)
+{
+    const auto test_setup = CreateTxIndexChain();
+    TxIndex txindex(interfaces::MakeChain(test_setup->m_node), /*n_cache_size=*/0, /*f_memory=*/false, /*f_wipe=*/true, format);
+    assert(txindex.Init());
+    txindex.Sync();
+
+    std::vector<uint256> txids;
+    {
+        LOCK(::cs_main);
+        const CChain& chain{test_setup->m_node.chainman->ActiveChain()};
+        for (int height = 1; height <= chain.Height(); ++height) {
+            CBlock block;
+            assert(test_setup->m_node.chainman->m_blockman.ReadBlockFromDisk(block, *chain[height]));
+            txids.push_back(block.vtx[0]->GetHash());
+        }
+    }
+
+    bench.minEpochIterations(5).batch(txids.size()).unit("tx").run([&] {
+        uint256 block_hash;
+        CTransactionRef tx;
+        for (const uint256& txid : txids) {
+            assert(txindex.FindTx(txid, block_hash, tx));
+        }
+    });
+}
+
+static void TxIndexSyncFull(benchmark::Bench& bench) { TxIndexSync(bench, TxIndexFormat::FULL); }
+static void TxIndexSyncCompact(benchmark::Bench& bench) { TxIndexSync(bench, TxIndexFormat::COMPACT); }
+static void TxIndexFindTxFull(benchmark::Bench& bench) { TxIndexFindTx(bench, TxIndexFormat::FULL); }
+static void TxIndexFindTxCompact(benchmark::Bench& bench) { TxIndexFindTx(bench, TxIndexFormat::COMPACT); }
+
+BENCHMARK(TxIndexSyncFull, benchmark::PriorityLevel::HIGH);
+BENCHMARK(TxIndexSyncCompact, benchmark::PriorityLevel::HIGH);
+BENCHMARK(TxIndexFindTxFull, benchmark::PriorityLevel::HIGH);
+BENCHMARK(TxIndexFindTxCompact, benchmark::PriorityLevel::HIGH);
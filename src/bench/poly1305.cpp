@@ -7,6 +7,7 @@
 #include <crypto/poly1305.h>
 
 #include <span.h>
+#include <tinyformat.h>
 
 /* Number of bytes to process per iteration */
 static constexpr uint64_t BUFFER_SIZE_TINY  = 64;
@@ -38,6 +39,25 @@ static void POLY1305_1MB(benchmark::Bench& bench)
     POLY1305(bench, BUFFER_SIZE_LARGE);
 }
 
+static void POLY1305_1MB_IMPL(benchmark::Bench& bench, const char* name, poly1305_implementation::UseImplementation use_implementation)
+{
+    bench.name(strprintf("%s using the '%s' Poly1305 implementation", name, Poly1305AutoDetect(use_implementation)));
+    POLY1305(bench, BUFFER_SIZE_LARGE);
+    Poly1305AutoDetect();
+}
+
+static void POLY1305_1MB_STANDARD(benchmark::Bench& bench)
+{
+    POLY1305_1MB_IMPL(bench, __func__, poly1305_implementation::STANDARD);
+}
+
+static void POLY1305_1MB_AVX2(benchmark::Bench& bench)
+{
+    POLY1305_1MB_IMPL(bench, __func__, poly1305_implementation::USE_AVX2);
+}
+
 BENCHMARK(POLY1305_64BYTES, benchmark::PriorityLevel::HIGH);
 BENCHMARK(POLY1305_256BYTES, benchmark::PriorityLevel::HIGH);
 BENCHMARK(POLY1305_1MB, benchmark::PriorityLevel::HIGH);
+BENCHMARK(POLY1305_1MB_STANDARD, benchmark::PriorityLevel::HIGH);
+BENCHMARK(POLY1305_1MB_AVX2, benchmark::PriorityLevel::HIGH);
@@ -7,6 +7,7 @@
 #include <coins.h>
 #include <key.h>
 #include <primitives/transaction.h>
+#include <psbt.h>
 #include <pubkey.h>
 #include <script/interpreter.h>
 #include <script/script.h>
@@ -14,6 +15,8 @@
 #include <uint256.h>
 #include <util/translation.h>
 
+#include <vector>
+
 enum class InputType {
     P2WPKH, // segwitv0, witness-pubkey-hash (ECDSA signature)
     P2TR,   // segwitv1, taproot key-path spend (Schnorr signature)
@@ -68,3 +71,49 @@ static void SignTransactionSchnorr(benchmark::Bench& bench) { SignTransactionSin
 
 BENCHMARK(SignTransactionECDSA, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SignTransactionSchnorr, benchmark::PriorityLevel::HIGH);
+
+//! Sign and finalize all inputs of a PSBT spending many outputs, each to its own key.
+static void SignPSBTManyInputs(benchmark::Bench& bench, InputType input_type, int num_inputs)
+{
+    ECC_Context ecc_context{};
+
+    FlatSigningProvider keystore;
+    CMutableTransaction unsigned_tx;
+    std::vector<CTxOut> prev_outs;
+    for (int i = 0; i < num_inputs; i++) {
+        CKey privkey = GenerateRandomKey();
+        CPubKey pubkey = privkey.GetPubKey();
+        CKeyID key_id = pubkey.GetID();
+        keystore.keys.emplace(key_id, privkey);
+        keystore.pubkeys.emplace(key_id, pubkey);
+
+        CScript prev_spk;
+        switch (input_type) {
+        case InputType::P2WPKH: prev_spk = GetScriptForDestination(WitnessV0KeyHash(pubkey)); break;
+        case InputType::P2TR:   prev_spk = GetScriptForDestination(WitnessV1Taproot(XOnlyPubKey{pubkey})); break;
+        default: assert(false);
+        }
+        prev_outs.emplace_back(10000, prev_spk);
+        unsigned_tx.vin.emplace_back(COutPoint{Txid::FromUint256(uint256::ONE), static_cast<uint32_t>(i)});
+    }
+    unsigned_tx.vout.emplace_back(num_inputs * 9000, prev_outs[0].scriptPubKey);
+
+    PartiallySignedTransaction unsigned_psbt{unsigned_tx};
+    for (int i = 0; i < num_inputs; i++) {
+        unsigned_psbt.inputs[i].witness_utxo = prev_outs[i];
+    }
+    const std::vector<const SigningProvider*> providers(num_inputs, &keystore);
+
+    bench.unit("input").batch(num_inputs).run([&] {
+        PartiallySignedTransaction psbt{unsigned_psbt};
+        const PrecomputedTransactionData txdata{PrecomputePSBTData(psbt)};
+        const bool complete{SignPSBTInputs(providers, psbt, txdata, SIGHASH_ALL, /*finalize=*/true)};
+        assert(complete);
+    });
+}
+
+static void SignPSBTECDSA1000Inputs(benchmark::Bench& bench)   { SignPSBTManyInputs(bench, InputType::P2WPKH, 1000); }
+static void SignPSBTSchnorr1000Inputs(benchmark::Bench& bench) { SignPSBTManyInputs(bench, InputType::P2TR, 1000); }
+
+BENCHMARK(SignPSBTECDSA1000Inputs, benchmark::PriorityLevel::LOW);
+BENCHMARK(SignPSBTSchnorr1000Inputs, benchmark::PriorityLevel::LOW);
@@ -4,6 +4,7 @@
 
 #include <bench/bench.h>
 #include <key.h>
+#include <pubkey.h>
 #include <script/script.h>
 #include <script/interpreter.h>
 #include <streams.h>
@@ -11,9 +12,11 @@
 
 #include <array>
 
+using VerifyFn = bool (*)(const CScript&, const CScript&, const CScriptWitness*, unsigned int, const BaseSignatureChecker&, ScriptError*);
+
 // Microbenchmark for verification of a basic P2WPKH script. Can be easily
 // modified to measure performance of other types of scripts.
-static void VerifyScriptBench(benchmark::Bench& bench)
+static void VerifyP2WPKH(benchmark::Bench& bench, VerifyFn verify)
 {
     ECC_Context ecc_context{};
 
@@ -47,7 +50,7 @@ static void VerifyScriptBench(benchmark::Bench& bench)
     // Benchmark.
     bench.run([&] {
         ScriptError err;
-        bool success = VerifyScript(
+        bool success = verify(
             txSpend.vin[0].scriptSig,
             txCredit.vout[0].scriptPubKey,
             &txSpend.vin[0].scriptWitness,
@@ -59,6 +62,56 @@ static void VerifyScriptBench(benchmark::Bench& bench)
     });
 }
 
+static void VerifyScriptBench(benchmark::Bench& bench) { VerifyP2WPKH(bench, VerifyScript); }
+static void VerifyScriptBenchInterpreted(benchmark::Bench& bench) { VerifyP2WPKH(bench, VerifyScriptInterpreted); }
+
+// Taproot key path spend, which doesn't involve any script execution.
+static void VerifyP2TRKeyPath(benchmark::Bench& bench, VerifyFn verify)
+{
+    ECC_Context ecc_context{};
+
+    const uint32_t flags{SCRIPT_VERIFY_WITNESS | SCRIPT_VERIFY_P2SH | SCRIPT_VERIFY_TAPROOT};
+
+    CKey key;
+    static const std::array<unsigned char, 32> vchKey = {
+        {
+            0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1
+        }
+    };
+    key.Set(vchKey.begin(), vchKey.end(), true);
+    const auto output_key{XOnlyPubKey{key.GetPubKey()}.CreateTapTweak(/*merkle_root=*/nullptr)};
+    const CScript scriptPubKey{CScript() << OP_1 << ToByteVector(output_key->first)};
+    const CMutableTransaction& txCredit = BuildCreditingTransaction(scriptPubKey, 1);
+    CMutableTransaction txSpend = BuildSpendingTransaction(CScript(), CScriptWitness(), CTransaction(txCredit));
+
+    PrecomputedTransactionData txdata;
+    txdata.Init(txSpend, {txCredit.vout[0]});
+    ScriptExecutionData execdata;
+    execdata.m_annex_init = true;
+    execdata.m_annex_present = false;
+    uint256 sighash;
+    assert(SignatureHashSchnorr(sighash, execdata, txSpend, 0, SIGHASH_DEFAULT, SigVersion::TAPROOT, txdata, MissingDataBehavior::ASSERT_FAIL));
+    std::vector<unsigned char> sig(64);
+    assert(key.SignSchnorr(sighash, sig, /*merkle_root=*/nullptr, uint256::ONE));
+    txSpend.vin[0].scriptWitness.stack.push_back(std::move(sig));
+
+    bench.run([&] {
+        ScriptError err;
+        bool success = verify(
+            txSpend.vin[0].scriptSig,
+            txCredit.vout[0].scriptPubKey,
+            &txSpend.vin[0].scriptWitness,
+            flags,
+            MutableTransactionSignatureChecker(&txSpend, 0, txCredit.vout[0].nValue, txdata, MissingDataBehavior::ASSERT_FAIL),
+            &err);
+        assert(err == SCRIPT_ERR_OK);
+        assert(success);
+    });
+}
+
+static void VerifyScriptP2TRKeyPath(benchmark::Bench& bench) { VerifyP2TRKeyPath(bench, VerifyScript); }
+static void VerifyScriptP2TRKeyPathInterpreted(benchmark::Bench& bench) { VerifyP2TRKeyPath(bench, VerifyScriptInterpreted); }
+
 static void VerifyNestedIfScript(benchmark::Bench& bench)
 {
     std::vector<std::vector<unsigned char>> stack;
@@ -81,4 +134,7 @@ static void VerifyNestedIfScript(benchmark::Bench& bench)
 }
 
 BENCHMARK(VerifyScriptBench, benchmark::PriorityLevel::HIGH);
+BENCHMARK(VerifyScriptBenchInterpreted, benchmark::PriorityLevel::HIGH);
+BENCHMARK(VerifyScriptP2TRKeyPath, benchmark::PriorityLevel::HIGH);
+BENCHMARK(VerifyScriptP2TRKeyPathInterpreted, benchmark::PriorityLevel::HIGH);
 BENCHMARK(VerifyNestedIfScript, benchmark::PriorityLevel::HIGH);
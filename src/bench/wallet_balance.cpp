@@ -4,6 +4,7 @@
 
 #include <bench/bench.h>
 #include <interfaces/chain.h>
+#include <key_io.h>
 #include <node/chainstate.h>
 #include <node/context.h>
 #include <test/util/mining.h>
@@ -16,7 +17,28 @@
 #include <optional>
 
 namespace wallet {
-static void WalletBalance(benchmark::Bench& bench, const bool set_dirty, const bool add_mine)
+//! Add num_payments payments to script_mine, each spent again to an external
+//! script, so that the wallet history is much larger than its UTXO set.
+static void AddSpentHistory(CWallet& wallet, const CScript& script_mine, const int num_payments)
+{
+    LOCK(wallet.cs_wallet);
+    const TxStateConfirmed state{wallet.GetLastBlockHash(), wallet.GetLastBlockHeight(), /*index=*/0};
+    for (int i = 0; i < num_payments; ++i) {
+        CMutableTransaction receive;
+        receive.vin.emplace_back(COutPoint{Txid::FromUint256(uint256::ONE), static_cast<uint32_t>(i)});
+        receive.vout.emplace_back(COIN, script_mine);
+        const CTransactionRef receive_tx{MakeTransactionRef(std::move(receive))};
+
+        CMutableTransaction spend;
+        spend.vin.emplace_back(COutPoint{receive_tx->GetHash(), 0});
+        spend.vout.emplace_back(COIN, CScript{} << OP_TRUE);
+
+        wallet.AddToWallet(receive_tx, state);
+        wallet.AddToWallet(MakeTransactionRef(std::move(spend)), state);
+    }
+}
+
+static void WalletBalance(benchmark::Bench& bench, const bool set_dirty, const bool add_mine, const int num_history = 0, const bool new_tip = false)
 {
     const auto test_setup = MakeNoLogFileContext<const TestingSetup>();
 
@@ -42,10 +64,20 @@ static void WalletBalance(benchmark::Bench& bench, const bool set_dirty, const b
     // Calls SyncWithValidationInterfaceQueue
     wallet.chain().waitForNotificationsIfTipChanged(uint256::ZERO);
 
+    if (num_history > 0) AddSpentHistory(wallet, GetScriptForDestination(DecodeDestination(*address_mine)), num_history);
+
     auto bal = GetBalance(wallet); // Cache
 
+    const auto [tip_height, tip_hash] = WITH_LOCK(wallet.cs_wallet, return std::make_pair(wallet.GetLastBlockHeight(), wallet.GetLastBlockHash()));
+    bool at_tip{true};
+
     bench.run([&] {
         if (set_dirty) wallet.MarkDirty();
+        if (new_tip) {
+            // Alternate between two tips at the same height, invalidating the cached balances
+            at_tip = !at_tip;
+            WITH_LOCK(wallet.cs_wallet, wallet.SetLastBlockProcessed(tip_height, at_tip ? tip_hash : uint256::ONE));
+        }
         bal = GetBalance(wallet);
         if (add_mine) assert(bal.m_mine_trusted > 0);
     });
@@ -55,9 +87,13 @@ static void WalletBalanceDirty(benchmark::Bench& bench) { WalletBalance(bench, /
 static void WalletBalanceClean(benchmark::Bench& bench) { WalletBalance(bench, /*set_dirty=*/false, /*add_mine=*/true); }
 static void WalletBalanceMine(benchmark::Bench& bench) { WalletBalance(bench, /*set_dirty=*/false, /*add_mine=*/true); }
 static void WalletBalanceWatch(benchmark::Bench& bench) { WalletBalance(bench, /*set_dirty=*/false, /*add_mine=*/false); }
+static void WalletBalanceLargeHistoryDirty(benchmark::Bench& bench) { WalletBalance(bench, /*set_dirty=*/true, /*add_mine=*/true, /*num_history=*/10000); }
+static void WalletBalanceLargeHistoryNewTip(benchmark::Bench& bench) { WalletBalance(bench, /*set_dirty=*/false, /*add_mine=*/true, /*num_history=*/10000, /*new_tip=*/true); }
 
 BENCHMARK(WalletBalanceDirty, benchmark::PriorityLevel::HIGH);
 BENCHMARK(WalletBalanceClean, benchmark::PriorityLevel::HIGH);
 BENCHMARK(WalletBalanceMine, benchmark::PriorityLevel::HIGH);
 BENCHMARK(WalletBalanceWatch, benchmark::PriorityLevel::HIGH);
+BENCHMARK(WalletBalanceLargeHistoryDirty, benchmark::PriorityLevel::LOW);
+BENCHMARK(WalletBalanceLargeHistoryNewTip, benchmark::PriorityLevel::LOW);
 } // namespace wallet
@@ -32,10 +32,11 @@ TipBlock getTip(const CChainParams& params, const node::NodeContext& context)
            TipBlock{params.GenesisBlock().GetHash(), params.GenesisBlock().GetBlockTime(), 0};
 }
 
-void generateFakeBlock(const CChainParams& params,
-                       const node::NodeContext& context,
-                       CWallet& wallet,
-                       const CScript& coinbase_out_script)
+CTransactionRef generateFakeBlock(const CChainParams& params,
+                                  const node::NodeContext& context,
+                                  CWallet& wallet,
+                                  const CScript& coinbase_out_script,
+                                  const std::vector<CTransactionRef>& txs = {})
 {
     TipBlock tip{getTip(params, context)};
 
@@ -51,6 +52,7 @@ void generateFakeBlock(const CChainParams& params,
     coinbase_tx.vout[1].scriptPubKey = coinbase_out_script; // extra output
     coinbase_tx.vout[1].nValue = 1 * COIN;
     block.vtx = {MakeTransactionRef(std::move(coinbase_tx))};
+    block.vtx.insert(block.vtx.end(), txs.begin(), txs.end());
 
     block.nVersion = VERSIONBITS_LAST_OLD_BLOCK_VERSION;
     block.hashPrevBlock = tip.prev_block_hash;
@@ -70,6 +72,35 @@ void generateFakeBlock(const CChainParams& params,
     // notify wallet
     const auto& pindex = WITH_LOCK(::cs_main, return context.chainman->ActiveChain().Tip());
     wallet.blockConnected(ChainstateRole::NORMAL, kernel::MakeBlockInfo(pindex, &block));
+    return block.vtx[0];
+}
+
+/**
+ * Spend both outputs of the first num_spent coinbases to an external script, so
+ * that the wallet history is much larger than its UTXO set. Returns the number of
+ * blocks generated to confirm the spends.
+ */
+unsigned int spendCoinbases(const CChainParams& params,
+                            const node::NodeContext& context,
+                            CWallet& wallet,
+                            const std::vector<CTransactionRef>& coinbases,
+                            unsigned int num_spent)
+{
+    const CScript external_script{CScript() << OP_TRUE};
+    unsigned int num_blocks{0};
+    for (unsigned int i = 0; i < num_spent; i += 100) {
+        std::vector<CTransactionRef> spends;
+        for (unsigned int j = i; j < std::min(i + 100, num_spent); ++j) {
+            CMutableTransaction spend;
+            spend.vin.emplace_back(COutPoint{coinbases[j]->GetHash(), 0});
+            spend.vin.emplace_back(COutPoint{coinbases[j]->GetHash(), 1});
+            spend.vout.emplace_back(50 * COIN, external_script);
+            spends.push_back(MakeTransactionRef(std::move(spend)));
+        }
+        generateFakeBlock(params, context, wallet, external_script, spends);
+        ++num_blocks;
+    }
+    return num_blocks;
 }
 
 struct PreSelectInputs {
@@ -78,7 +109,7 @@ struct PreSelectInputs {
     // future: this could have external inputs as well.
 };
 
-static void WalletCreateTx(benchmark::Bench& bench, const OutputType output_type, bool allow_other_inputs, std::optional<PreSelectInputs> preset_inputs)
+static void WalletCreateTx(benchmark::Bench& bench, const OutputType output_type, bool allow_other_inputs, std::optional<PreSelectInputs> preset_inputs, unsigned int num_spent = 0)
 {
     const auto test_setup = MakeNoLogFileContext<const TestingSetup>();
 
@@ -98,13 +129,15 @@ static void WalletCreateTx(benchmark::Bench& bench, const OutputType output_type
     const auto& params = Params();
     const CScript coinbase_out{GetScriptForDestination(dest)};
     unsigned int chain_size = 5000; // 5k blocks means 10k UTXO for the wallet (minus 200 due COINBASE_MATURITY)
+    std::vector<CTransactionRef> coinbases;
     for (unsigned int i = 0; i < chain_size; ++i) {
-        generateFakeBlock(params, test_setup->m_node, wallet, coinbase_out);
+        coinbases.push_back(generateFakeBlock(params, test_setup->m_node, wallet, coinbase_out));
     }
+    const unsigned int num_blocks{chain_size + spendCoinbases(params, test_setup->m_node, wallet, coinbases, num_spent)};
 
     // Check available balance
     auto bal = WITH_LOCK(wallet.cs_wallet, return wallet::AvailableCoins(wallet).GetTotalAmount()); // Cache
-    assert(bal == 50 * COIN * (chain_size - COINBASE_MATURITY));
+    assert(bal == 50 * COIN * (std::min(chain_size, num_blocks - COINBASE_MATURITY) - num_spent));
 
     wallet::CCoinControl coin_control;
     coin_control.m_allow_other_inputs = allow_other_inputs;
@@ -134,7 +167,7 @@ static void WalletCreateTx(benchmark::Bench& bench, const OutputType output_type
     });
 }
 
-static void AvailableCoins(benchmark::Bench& bench, const std::vector<OutputType>& output_type)
+static void AvailableCoins(benchmark::Bench& bench, const std::vector<OutputType>& output_type, unsigned int num_spent = 0)
 {
     const auto test_setup = MakeNoLogFileContext<const TestingSetup>();
     // Set clock to genesis block, so the descriptors/keys creation time don't interfere with the blocks scanning process.
@@ -155,21 +188,24 @@ static void AvailableCoins(benchmark::Bench& bench, const std::vector<OutputType
 
     // Generate chain; each coinbase will have two outputs to fill-up the wallet
     const auto& params = Params();
-    unsigned int chain_size = 1000;
+    unsigned int chain_size = num_spent > 0 ? 10000 : 1000;
+    std::vector<CTransactionRef> coinbases;
     for (unsigned int i = 0; i < chain_size / dest_wallet.size(); ++i) {
         for (const auto& dest : dest_wallet) {
-            generateFakeBlock(params, test_setup->m_node, wallet, dest);
+            coinbases.push_back(generateFakeBlock(params, test_setup->m_node, wallet, dest));
         }
     }
+    const unsigned int num_blocks{chain_size + spendCoinbases(params, test_setup->m_node, wallet, coinbases, num_spent)};
+    const unsigned int num_available{std::min(chain_size, num_blocks - COINBASE_MATURITY) - num_spent};
 
     // Check available balance
     auto bal = WITH_LOCK(wallet.cs_wallet, return wallet::AvailableCoins(wallet).GetTotalAmount()); // Cache
-    assert(bal == 50 * COIN * (chain_size - COINBASE_MATURITY));
+    assert(bal == 50 * COIN * num_available);
 
     bench.epochIterations(2).run([&] {
         LOCK(wallet.cs_wallet);
         const auto& res = wallet::AvailableCoins(wallet);
-        assert(res.All().size() == (chain_size - COINBASE_MATURITY) * 2);
+        assert(res.All().size() == num_available * 2);
     });
 }
 
@@ -179,8 +215,14 @@ static void WalletCreateTxUseOnlyPresetInputs(benchmark::Bench& bench) { WalletC
 static void WalletCreateTxUsePresetInputsAndCoinSelection(benchmark::Bench& bench) { WalletCreateTx(bench, OutputType::BECH32, /*allow_other_inputs=*/true,
                                                                                                     {{/*num_of_internal_inputs=*/4}}); }
 
+static void WalletCreateTxLargeHistory(benchmark::Bench& bench) { WalletCreateTx(bench, OutputType::BECH32, /*allow_other_inputs=*/true,
+                                                                                 {{/*num_of_internal_inputs=*/4}}, /*num_spent=*/4000); }
+
 static void WalletAvailableCoins(benchmark::Bench& bench) { AvailableCoins(bench, {OutputType::BECH32M}); }
+static void WalletAvailableCoinsLargeHistory(benchmark::Bench& bench) { AvailableCoins(bench, {OutputType::BECH32M}, /*num_spent=*/9000); }
 
 BENCHMARK(WalletCreateTxUseOnlyPresetInputs, benchmark::PriorityLevel::LOW)
 BENCHMARK(WalletCreateTxUsePresetInputsAndCoinSelection, benchmark::PriorityLevel::LOW)
+BENCHMARK(WalletCreateTxLargeHistory, benchmark::PriorityLevel::LOW)
 BENCHMARK(WalletAvailableCoins, benchmark::PriorityLevel::LOW);
+BENCHMARK(WalletAvailableCoinsLargeHistory, benchmark::PriorityLevel::LOW);
@@ -0,0 +1,74 @@
+// Copyright (c) 2024 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <config/bitcoin-config.h> // IWYU pragma: keep
+#include <bench/bench.h>
+#include <test/util/setup_common.h>
+#include <util/translation.h>
+#include <wallet/db.h>
+#ifdef USE_SQLITE
+#include <wallet/sqlite.h>
+#endif
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace wallet {
+#ifdef USE_SQLITE
+//! Write records each through its own batch, or all of them in a single batch transaction, as a rescan does.
+static void WalletDatabaseWrite(benchmark::Bench& bench, const DatabaseOptions& options, bool one_txn)
+{
+    const auto test_setup = MakeNoLogFileContext<const BasicTestingSetup>();
+    DatabaseStatus status;
+    bilingual_str error;
+    const std::unique_ptr<SQLiteDatabase> database{MakeSQLiteDatabase(test_setup->m_path_root / "wallet", options, status, error)};
+    assert(database);
+
+    constexpr int NUM_RECORDS{1000};
+    const std::vector<unsigned char> value(200, 0xab);
+    uint32_t key{0};
+    bench.unit("record").batch(NUM_RECORDS).run([&] {
+        std::unique_ptr<DatabaseBatch> batch;
+        if (one_txn) {
+            batch = database->MakeBatch();
+            const bool begun{batch->TxnBegin()};
+            assert(begun);
+        }
+        for (int i = 0; i < NUM_RECORDS; ++i) {
+            const bool written{(one_txn ? *batch : *database->MakeBatch()).Write(std::make_pair(std::string{"record"}, key++), value)};
+            assert(written);
+        }
+        if (one_txn) {
+            const bool committed{batch->TxnCommit()};
+            assert(committed);
+        }
+    });
+}
+
+static void WalletDatabaseWriteDefault(benchmark::Bench& bench)
+{
+    WalletDatabaseWrite(bench, DatabaseOptions{}, /*one_txn=*/false);
+}
+
+static void WalletDatabaseWriteTxn(benchmark::Bench& bench)
+{
+    WalletDatabaseWrite(bench, DatabaseOptions{}, /*one_txn=*/true);
+}
+
+static void WalletDatabaseWriteWal(benchmark::Bench& bench)
+{
+    DatabaseOptions options;
+    options.use_wal_journal = true;
+    options.sync_level = "normal";
+    WalletDatabaseWrite(bench, options, /*one_txn=*/false);
+}
+
+BENCHMARK(WalletDatabaseWriteDefault, benchmark::PriorityLevel::LOW);
+BENCHMARK(WalletDatabaseWriteTxn, benchmark::PriorityLevel::LOW);
+BENCHMARK(WalletDatabaseWriteWal, benchmark::PriorityLevel::LOW);
+#endif
+} // namespace wallet
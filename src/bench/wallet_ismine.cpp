@@ -7,7 +7,10 @@
 #include <interfaces/chain.h>
 #include <key.h>
 #include <key_io.h>
+#include <kernel/chain.h>
 #include <node/context.h>
+#include <primitives/block.h>
+#include <random.h>
 #include <test/util/setup_common.h>
 #include <util/translation.h>
 #include <validationinterface.h>
@@ -17,14 +20,8 @@
 #include <wallet/walletutil.h>
 
 namespace wallet {
-static void WalletIsMine(benchmark::Bench& bench, bool legacy_wallet, int num_combo = 0)
+static std::shared_ptr<CWallet> CreateIsMineWallet(WalletContext& context, bool legacy_wallet, int num_combo)
 {
-    const auto test_setup = MakeNoLogFileContext<TestingSetup>();
-
-    WalletContext context;
-    context.args = &test_setup->m_args;
-    context.chain = test_setup->m_node.chain.get();
-
     // Setup the wallet
     // Loading the wallet will also create it
     uint64_t create_flags = 0;
@@ -49,6 +46,17 @@ static void WalletIsMine(benchmark::Bench& bench, bool legacy_wallet, int num_co
             assert(spkm);
         }
     }
+    return wallet;
+}
+
+static void WalletIsMine(benchmark::Bench& bench, bool legacy_wallet, int num_combo = 0)
+{
+    const auto test_setup = MakeNoLogFileContext<TestingSetup>();
+
+    WalletContext context;
+    context.args = &test_setup->m_args;
+    context.chain = test_setup->m_node.chain.get();
+    auto wallet = CreateIsMineWallet(context, legacy_wallet, num_combo);
 
     const CScript script = GetScriptForDestination(DecodeDestination(ADDRESS_BCRT1_UNSPENDABLE));
 
@@ -61,6 +69,41 @@ static void WalletIsMine(benchmark::Bench& bench, bool legacy_wallet, int num_co
     TestUnloadWallet(std::move(wallet));
 }
 
+//! Scan a full block of transactions unrelated to the wallet, as on block connection.
+static void WalletIsMineBlock(benchmark::Bench& bench, int num_combo = 0)
+{
+    const auto test_setup = MakeNoLogFileContext<TestingSetup>();
+
+    WalletContext context;
+    context.args = &test_setup->m_args;
+    context.chain = test_setup->m_node.chain.get();
+    auto wallet = CreateIsMineWallet(context, /*legacy_wallet=*/false, num_combo);
+
+    // About a full block of 2-input, 2-output P2WPKH transactions
+    FastRandomContext rng{/*fDeterministic=*/true};
+    CBlock block;
+    for (int i = 0; i < 2500; ++i) {
+        CMutableTransaction tx;
+        for (int j = 0; j < 2; ++j) {
+            tx.vin.emplace_back(Txid::FromUint256(rng.rand256()), j);
+            tx.vout.emplace_back(COIN, CScript() << OP_0 << rng.randbytes(20));
+        }
+        block.vtx.push_back(MakeTransactionRef(std::move(tx)));
+    }
+    const uint256 block_hash{block.GetHash()};
+    interfaces::BlockInfo info{block_hash};
+    info.data = &block;
+    info.height = 1;
+    info.chain_time_max = std::numeric_limits<unsigned int>::max();
+
+    bench.unit("tx").batch(block.vtx.size()).run([&] {
+        wallet->blockConnected(ChainstateRole::NORMAL, info);
+    });
+    assert(WITH_LOCK(wallet->cs_wallet, return wallet->mapWallet.empty()));
+
+    TestUnloadWallet(std::move(wallet));
+}
+
 #ifdef USE_BDB
 static void WalletIsMineLegacy(benchmark::Bench& bench) { WalletIsMine(bench, /*legacy_wallet=*/true); }
 BENCHMARK(WalletIsMineLegacy, benchmark::PriorityLevel::LOW);
@@ -69,7 +112,11 @@ BENCHMARK(WalletIsMineLegacy, benchmark::PriorityLevel::LOW);
 #ifdef USE_SQLITE
 static void WalletIsMineDescriptors(benchmark::Bench& bench) { WalletIsMine(bench, /*legacy_wallet=*/false); }
 static void WalletIsMineMigratedDescriptors(benchmark::Bench& bench) { WalletIsMine(bench, /*legacy_wallet=*/false, /*num_combo=*/2000); }
+static void WalletIsMineBlockDescriptors(benchmark::Bench& bench) { WalletIsMineBlock(bench); }
+static void WalletIsMineBlockMigratedDescriptors(benchmark::Bench& bench) { WalletIsMineBlock(bench, /*num_combo=*/2000); }
 BENCHMARK(WalletIsMineDescriptors, benchmark::PriorityLevel::LOW);
 BENCHMARK(WalletIsMineMigratedDescriptors, benchmark::PriorityLevel::LOW);
+BENCHMARK(WalletIsMineBlockDescriptors, benchmark::PriorityLevel::LOW);
+BENCHMARK(WalletIsMineBlockMigratedDescriptors, benchmark::PriorityLevel::LOW);
 #endif
 } // namespace wallet
@@ -0,0 +1,89 @@
+// Copyright (c) 2024 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <config/bitcoin-config.h> // IWYU pragma: keep
+#include <bench/bench.h>
+#include <interfaces/chain.h>
+#include <node/context.h>
+#include <rpc/request.h>
+#include <rpc/util.h>
+#include <test/util/setup_common.h>
+#include <univalue.h>
+#include <wallet/context.h>
+#include <wallet/test/util.h>
+#include <wallet/wallet.h>
+#include <wallet/walletutil.h>
+
+#include <memory>
+#include <string>
+
+namespace wallet {
+RPCHelpMan listtransactions();
+
+static void WalletListTransactions(benchmark::Bench& bench, bool with_label)
+{
+    const auto test_setup = MakeNoLogFileContext<const TestingSetup>();
+    const auto wallet{std::make_shared<CWallet>(test_setup->m_node.chain.get(), "", CreateMockableWalletDatabase())};
+    WalletContext context;
+    context.chain = test_setup->m_node.chain.get();
+    AddWallet(context, wallet);
+
+    // Receive NUM_TXS payments, one in every LABEL_INTERVAL of them to an address with a label
+    constexpr int NUM_TXS{10000};
+    constexpr int LABEL_INTERVAL{100};
+    constexpr int PAGE_SIZE{100};
+    {
+        LOCK(wallet->cs_wallet);
+        wallet->SetWalletFlag(WALLET_FLAG_DESCRIPTORS);
+        wallet->SetupDescriptorScriptPubKeyMans();
+        const int tip_height{*Assert(context.chain->getHeight())};
+        const uint256 tip_hash{context.chain->getBlockHash(tip_height)};
+        wallet->SetLastBlockProcessed(tip_height, tip_hash);
+
+        const CScript script{GetScriptForDestination(*Assert(wallet->GetNewDestination(OutputType::BECH32, "")))};
+        const CScript script_label{GetScriptForDestination(*Assert(wallet->GetNewDestination(OutputType::BECH32, "label")))};
+        const TxStateConfirmed state{tip_hash, tip_height, /*index=*/0};
+        for (int i = 0; i < NUM_TXS; ++i) {
+            CMutableTransaction mtx;
+            mtx.vin.emplace_back(COutPoint{Txid::FromUint256(uint256::ONE), static_cast<uint32_t>(i)});
+            mtx.vout.emplace_back(COIN, i % LABEL_INTERVAL == 0 ? script_label : script);
+            Assert(wallet->AddToWallet(MakeTransactionRef(std::move(mtx)), state));
+        }
+    }
+
+    JSONRPCRequest request;
+    request.context = &context;
+    if (with_label) {
+        // All transactions with the label fit in a single page
+        bench.run([&] {
+            request.params = UniValue{UniValue::VARR};
+            request.params.push_back("label");
+            request.params.push_back(PAGE_SIZE);
+            const UniValue result{listtransactions().HandleRequest(request)};
+            assert(result.size() == NUM_TXS / LABEL_INTERVAL);
+        });
+    } else {
+        // Page through the whole history, as a client fetching all of it would
+        bench.unit("page").batch(NUM_TXS / PAGE_SIZE).run([&] {
+            for (int skip = 0; skip < NUM_TXS; skip += PAGE_SIZE) {
+                request.params = UniValue{UniValue::VARR};
+                request.params.push_back("*");
+                request.params.push_back(PAGE_SIZE);
+                request.params.push_back(skip);
+                const UniValue result{listtransactions().HandleRequest(request)};
+                assert(result.size() == PAGE_SIZE);
+            }
+        });
+    }
+    RemoveWallet(context, wallet, /*load_on_start=*/std::nullopt);
+}
+
+static void WalletListTransactionsPaging(benchmark::Bench& bench) { WalletListTransactions(bench, /*with_label=*/false); }
+static void WalletListTransactionsLabel(benchmark::Bench& bench) { WalletListTransactions(bench, /*with_label=*/true); }
+
+#ifdef USE_SQLITE
+BENCHMARK(WalletListTransactionsPaging, benchmark::PriorityLevel::LOW);
+BENCHMARK(WalletListTransactionsLabel, benchmark::PriorityLevel::LOW);
+#endif
+} // namespace wallet
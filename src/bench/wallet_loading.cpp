@@ -5,11 +5,13 @@
 #include <config/bitcoin-config.h> // IWYU pragma: keep
 
 #include <bench/bench.h>
+#include <core_memusage.h>
 #include <interfaces/chain.h>
 #include <node/context.h>
 #include <test/util/mining.h>
 #include <test/util/setup_common.h>
 #include <wallet/test/util.h>
+#include <util/string.h>
 #include <util/translation.h>
 #include <validationinterface.h>
 #include <wallet/context.h>
@@ -19,22 +21,44 @@
 #include <optional>
 
 namespace wallet{
-static void AddTx(CWallet& wallet)
+static void AddTx(CWallet& wallet, const CScript& script, uint32_t n, const TxState& state = TxStateInactive{}, bool with_witness = false)
 {
     CMutableTransaction mtx;
-    mtx.vout.emplace_back(COIN, GetScriptForDestination(*Assert(wallet.GetNewDestination(OutputType::BECH32, ""))));
-    mtx.vin.emplace_back();
+    mtx.vout.emplace_back(COIN, script);
+    mtx.vin.emplace_back(COutPoint{Txid::FromUint256(uint256::ONE), n});
+    if (with_witness) {
+        // Signature and public key, as in a P2WPKH spend
+        mtx.vin.back().scriptWitness.stack = {std::vector<unsigned char>(72, 1), std::vector<unsigned char>(33, 2)};
+    }
+
+    wallet.AddToWallet(MakeTransactionRef(mtx), state);
+}
 
-    wallet.AddToWallet(MakeTransactionRef(mtx), TxStateInactive{});
+static size_t WalletTxsMemoryUsage(const CWallet& wallet)
+{
+    LOCK(wallet.cs_wallet);
+    size_t usage{0};
+    for (const auto& [_, wtx] : wallet.mapWallet) {
+        usage += RecursiveDynamicUsage(wtx.tx);
+    }
+    return usage;
 }
 
-static void WalletLoading(benchmark::Bench& bench, bool legacy_wallet)
+/**
+ * Load a wallet with num_txs transactions. If compact_depth is set, they are
+ * confirmed in the genesis block and spend witness inputs, the wallet is
+ * loaded with -walletcompacthistory=<compact_depth>, and the memory used by
+ * the loaded transactions is added to the benchmark name.
+ */
+static void WalletLoading(benchmark::Bench& bench, bool legacy_wallet, int num_txs = 1000, std::optional<unsigned int> compact_depth = std::nullopt)
 {
     const auto test_setup = MakeNoLogFileContext<TestingSetup>();
 
     WalletContext context;
     context.args = &test_setup->m_args;
     context.chain = test_setup->m_node.chain.get();
+    if (compact_depth) test_setup->m_args.ForceSetArg("-walletcompacthistory", util::ToString(*compact_depth));
+    const TxState state{compact_depth ? TxState{TxStateConfirmed{context.chain->getBlockHash(0), /*height=*/0, /*index=*/0}} : TxState{TxStateInactive{}}};
 
     // Setup the wallet
     // Loading the wallet will also create it
@@ -45,9 +69,12 @@ static void WalletLoading(benchmark::Bench& bench, bool legacy_wallet)
     auto database = CreateMockableWalletDatabase();
     auto wallet = TestLoadWallet(std::move(database), context, create_flags);
 
-    // Generate a bunch of transactions and addresses to put into the wallet
-    for (int i = 0; i < 1000; ++i) {
-        AddTx(*wallet);
+    // Generate a bunch of transactions and addresses to put into the wallet,
+    // reusing the last address beyond the first thousand transactions
+    CScript script;
+    for (int i = 0; i < num_txs; ++i) {
+        if (i < 1000) script = GetScriptForDestination(*Assert(wallet->GetNewDestination(OutputType::BECH32, "")));
+        AddTx(*wallet, script, i, state, /*with_witness=*/compact_depth.has_value());
     }
 
     database = DuplicateMockDatabase(wallet->GetDatabase());
@@ -55,6 +82,13 @@ static void WalletLoading(benchmark::Bench& bench, bool legacy_wallet)
     // reload the wallet for the actual benchmark
     TestUnloadWallet(std::move(wallet));
 
+    if (compact_depth) {
+        wallet = TestLoadWallet(std::move(database), context, create_flags);
+        bench.name(strprintf("%s (%u KiB transactions in memory)", bench.name(), WalletTxsMemoryUsage(*wallet) >> 10));
+        database = DuplicateMockDatabase(wallet->GetDatabase());
+        TestUnloadWallet(std::move(wallet));
+    }
+
     bench.epochs(5).run([&] {
         wallet = TestLoadWallet(std::move(database), context, create_flags);
 
@@ -71,6 +105,12 @@ BENCHMARK(WalletLoadingLegacy, benchmark::PriorityLevel::HIGH);
 
 #ifdef USE_SQLITE
 static void WalletLoadingDescriptors(benchmark::Bench& bench) { WalletLoading(bench, /*legacy_wallet=*/false); }
+static void WalletLoadingDescriptorsLargeHistory(benchmark::Bench& bench) { WalletLoading(bench, /*legacy_wallet=*/false, /*num_txs=*/1'000'000); }
+static void WalletLoadingDescriptorsWitnessHistory(benchmark::Bench& bench) { WalletLoading(bench, /*legacy_wallet=*/false, /*num_txs=*/100'000, /*compact_depth=*/0); }
+static void WalletLoadingDescriptorsCompactHistory(benchmark::Bench& bench) { WalletLoading(bench, /*legacy_wallet=*/false, /*num_txs=*/100'000, /*compact_depth=*/1); }
 BENCHMARK(WalletLoadingDescriptors, benchmark::PriorityLevel::HIGH);
+BENCHMARK(WalletLoadingDescriptorsLargeHistory, benchmark::PriorityLevel::LOW);
+BENCHMARK(WalletLoadingDescriptorsWitnessHistory, benchmark::PriorityLevel::LOW);
+BENCHMARK(WalletLoadingDescriptorsCompactHistory, benchmark::PriorityLevel::LOW);
 #endif
 } // namespace wallet
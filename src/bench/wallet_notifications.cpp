@@ -0,0 +1,70 @@
+// Copyright (c) 2024 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <config/bitcoin-config.h> // IWYU pragma: keep
+#include <bench/bench.h>
+#include <chain.h>
+#include <kernel/chain.h>
+#include <primitives/block.h>
+#include <random.h>
+#include <test/util/setup_common.h>
+#include <util/time.h>
+#include <validation.h>
+#include <validationinterface.h>
+#include <wallet/context.h>
+#include <wallet/test/util.h>
+#include <wallet/wallet.h>
+#include <wallet/walletutil.h>
+
+#include <memory>
+#include <vector>
+
+namespace wallet {
+//! Deliver a block of transactions unrelated to the wallets to many loaded wallets.
+static void WalletBlockConnected(benchmark::Bench& bench, int num_wallets)
+{
+    const auto test_setup = MakeNoLogFileContext<TestingSetup>(ChainType::REGTEST, {.extra_args = {"-keypool=100"}});
+    const CBlockIndex* tip{WITH_LOCK(::cs_main, return test_setup->m_node.chainman->ActiveChain().Tip())};
+
+    WalletContext context;
+    context.args = &test_setup->m_args;
+    context.chain = test_setup->m_node.chain.get();
+
+    // Create the wallets at the time of the tip, so that blocks aren't skipped as older than them
+    SetMockTime(tip->GetBlockTime());
+    std::vector<std::shared_ptr<CWallet>> wallets;
+    for (int i = 0; i < num_wallets; ++i) {
+        wallets.push_back(TestLoadWallet(CreateMockableWalletDatabase(), context, WALLET_FLAG_DESCRIPTORS));
+    }
+
+    // About a full block of 2-input, 2-output P2WPKH transactions
+    FastRandomContext rng{/*fDeterministic=*/true};
+    auto block{std::make_shared<CBlock>()};
+    for (int i = 0; i < 2500; ++i) {
+        CMutableTransaction tx;
+        for (int j = 0; j < 2; ++j) {
+            tx.vin.emplace_back(Txid::FromUint256(rng.rand256()), j);
+            tx.vout.emplace_back(COIN, CScript() << OP_0 << rng.randbytes(20));
+        }
+        block->vtx.push_back(MakeTransactionRef(std::move(tx)));
+    }
+
+    ValidationSignals& signals{*test_setup->m_node.validation_signals};
+    bench.unit("block").run([&] {
+        signals.BlockConnected(ChainstateRole::NORMAL, block, tip);
+        signals.SyncWithValidationInterfaceQueue();
+    });
+
+    for (auto& wallet : wallets) {
+        TestUnloadWallet(std::move(wallet));
+    }
+    SetMockTime(0);
+}
+
+static void WalletBlockConnected100Wallets(benchmark::Bench& bench) { WalletBlockConnected(bench, /*num_wallets=*/100); }
+
+#ifdef USE_SQLITE
+BENCHMARK(WalletBlockConnected100Wallets, benchmark::PriorityLevel::LOW);
+#endif
+} // namespace wallet
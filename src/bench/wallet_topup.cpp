@@ -0,0 +1,44 @@
+// Copyright (c) 2024 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <config/bitcoin-config.h> // IWYU pragma: keep
+#include <bench/bench.h>
+#include <node/context.h>
+#include <script/descriptor.h>
+#include <test/util/setup_common.h>
+#include <wallet/scriptpubkeyman.h>
+#include <wallet/test/util.h>
+#include <wallet/wallet.h>
+#include <wallet/walletutil.h>
+
+namespace wallet {
+static void WalletDescriptorTopUp(benchmark::Bench& bench, const std::string& desc_str, int num_keys)
+{
+    const auto test_setup = MakeNoLogFileContext<const TestingSetup>();
+    CWallet wallet{test_setup->m_node.chain.get(), "", CreateMockableWalletDatabase()};
+    wallet.SetWalletFlag(WALLET_FLAG_DESCRIPTORS);
+
+    FlatSigningProvider keys;
+    std::string error;
+    const std::shared_ptr<Descriptor> desc{Parse(desc_str, keys, error, /*require_checksum=*/false)};
+    assert(desc);
+
+    bench.unit("key").batch(num_keys).run([&] {
+        // Start from an empty descriptor cache each time, so all keys are derived
+        WalletDescriptor w_desc(desc, /*creation_time=*/0, /*range_start=*/0, /*range_end=*/0, /*next_index=*/0);
+        DescriptorScriptPubKeyMan spkm(wallet, w_desc, /*keypool_size=*/num_keys);
+        const bool topped_up{spkm.TopUp()};
+        assert(topped_up);
+    });
+}
+
+static void WalletDescriptorTopUpXpub(benchmark::Bench& bench)
+{
+    WalletDescriptorTopUp(bench, "wpkh([ffffffff/13']xpub69H7F5d8KSRgmmdJg2KhpAK8SR3DjMwAdkxj3ZuxV27CprR9LgpeyGmXUbC6wb7ERfvrnKZjXoUmmDznezpbZb7ap6r1D3tgFxHmwMkQTPH/1/2/*)", /*num_keys=*/10000);
+}
+
+#ifdef USE_SQLITE
+BENCHMARK(WalletDescriptorTopUpXpub, benchmark::PriorityLevel::LOW);
+#endif
+} // namespace wallet
@@ -15,6 +15,7 @@
 #include <txmempool.h>
 #include <validation.h>
 
+#include <array>
 #include <unordered_map>
 
 CBlockHeaderAndShortTxIDs::CBlockHeaderAndShortTxIDs(const CBlock& block, const uint64_t nonce) :
@@ -42,11 +43,14 @@ void CBlockHeaderAndShortTxIDs::FillShortTxIDSelector() const {
 
 uint64_t CBlockHeaderAndShortTxIDs::GetShortID(const Wtxid& wtxid) const {
     static_assert(SHORTTXIDS_LENGTH == 6, "shorttxids calculation assumes 6-byte shorttxids");
-    return SipHashUint256(shorttxidk0, shorttxidk1, wtxid) & 0xffffffffffffL;
+    return SipHashUint256(shorttxidk0, shorttxidk1, wtxid) & SHORTTXIDS_MASK;
 }
 
 
 
+/** Number of mempool transactions whose short IDs are computed at once in InitData */
+static constexpr size_t SHORTTXIDS_BATCH_SIZE{256};
+
 ReadStatus PartiallyDownloadedBlock::InitData(const CBlockHeaderAndShortTxIDs& cmpctblock, const std::vector<CTransactionRef>& extra_txn) {
     if (cmpctblock.header.IsNull() || (cmpctblock.shorttxids.empty() && cmpctblock.prefilledtxn.empty()))
         return READ_STATUS_INVALID;
@@ -107,29 +111,38 @@ ReadStatus PartiallyDownloadedBlock::InitData(const CBlockHeaderAndShortTxIDs& c
     std::vector<bool> have_txn(txn_available.size());
     {
     LOCK(pool->cs);
-    for (const auto& tx : pool->txns_randomized) {
-        uint64_t shortid = cmpctblock.GetShortID(tx->GetWitnessHash());
-        std::unordered_map<uint64_t, uint16_t>::iterator idit = shorttxids.find(shortid);
-        if (idit != shorttxids.end()) {
-            if (!have_txn[idit->second]) {
-                txn_available[idit->second] = tx;
-                have_txn[idit->second]  = true;
-                mempool_count++;
-            } else {
-                // If we find two mempool txn that match the short id, just request it.
-                // This should be rare enough that the extra bandwidth doesn't matter,
-                // but eating a round-trip due to FillBlock failure would be annoying
-                if (txn_available[idit->second]) {
-                    txn_available[idit->second].reset();
-                    mempool_count--;
+    // Compute the short IDs of mempool transactions in batches, so that several can be
+    // hashed at once while still allowing the early exit below.
+    std::array<uint64_t, SHORTTXIDS_BATCH_SIZE> batch_shortids;
+    const std::vector<CTransactionRef>& txns{pool->txns_randomized};
+    for (size_t begin = 0; begin < txns.size() && mempool_count < shorttxids.size(); begin += SHORTTXIDS_BATCH_SIZE) {
+        const Span<uint64_t> shortids{Span{batch_shortids}.first(std::min(SHORTTXIDS_BATCH_SIZE, txns.size() - begin))};
+        pool->GetWtxidSipHashes(cmpctblock.shorttxidk0, cmpctblock.shorttxidk1, begin, shortids);
+        for (size_t i = 0; i < shortids.size(); i++) {
+            const CTransactionRef& tx{txns[begin + i]};
+            uint64_t shortid = shortids[i] & CBlockHeaderAndShortTxIDs::SHORTTXIDS_MASK;
+            std::unordered_map<uint64_t, uint16_t>::iterator idit = shorttxids.find(shortid);
+            if (idit != shorttxids.end()) {
+                if (!have_txn[idit->second]) {
+                    txn_available[idit->second] = tx;
+                    have_txn[idit->second]  = true;
+                    mempool_count++;
+                } else {
+                    // If we find two mempool txn that match the short id, just request it.
+                    // This should be rare enough that the extra bandwidth doesn't matter,
+                    // but eating a round-trip due to FillBlock failure would be annoying
+                    if (txn_available[idit->second]) {
+                        txn_available[idit->second].reset();
+                        mempool_count--;
+                    }
                 }
             }
+            // Though ideally we'd continue scanning for the two-txn-match-shortid case,
+            // the performance win of an early exit here is too good to pass up and worth
+            // the extra risk.
+            if (mempool_count == shorttxids.size())
+                break;
         }
-        // Though ideally we'd continue scanning for the two-txn-match-shortid case,
-        // the performance win of an early exit here is too good to pass up and worth
-        // the extra risk.
-        if (mempool_count == shorttxids.size())
-            break;
     }
     }
 
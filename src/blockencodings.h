@@ -103,6 +103,7 @@ protected:
 
 public:
     static constexpr int SHORTTXIDS_LENGTH = 6;
+    static constexpr uint64_t SHORTTXIDS_MASK = 0xffffffffffffL;
 
     CBlockHeader header;
 
@@ -9,8 +9,11 @@
 #include <tinyformat.h>
 #include <util/threadnames.h>
 
-#include <algorithm>
-#include <iterator>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <thread>
 #include <vector>
 
 /**
@@ -22,12 +25,151 @@
   * onto the queue, where they are processed by N-1 worker threads. When
   * the master is done adding work, it temporarily joins the worker pool
   * as an N'th worker, until all jobs are done.
+  *
+  * Work is distributed by work stealing: the master pushes every added batch
+  * as one range onto its own deque. A thread that takes a range larger than
+  * the maximum chunk size processes the first chunk and pushes the rest onto
+  * its own deque, where it either picks it up again or another thread steals
+  * it. Idle threads spin for a while before they park on a condition
+  * variable, and are only woken if there is new work.
   */
 template <typename T>
 class CCheckQueue
 {
 private:
-    //! Mutex to protect the inner state
+    //! A range of checks that are owned by the queue and haven't been processed yet.
+    struct Range {
+        T* begin{nullptr};
+        T* end{nullptr};
+    };
+
+    /**
+     * Storage for the checks of one Add() call. The checks are destroyed by
+     * the thread that processes them, so that their cleanup is parallelized
+     * too; only the memory is released by the master.
+     */
+    class Storage
+    {
+    private:
+        T* const m_data;
+        const size_t m_size;
+
+    public:
+        template <typename U>
+        explicit Storage(std::vector<U>&& checks) : m_data{std::allocator<T>{}.allocate(checks.size())}, m_size{checks.size()}
+        {
+            std::uninitialized_move(checks.begin(), checks.end(), m_data);
+        }
+        ~Storage() { std::allocator<T>{}.deallocate(m_data, m_size); }
+        Storage(const Storage&) = delete;
+        Storage& operator=(const Storage&) = delete;
+
+        Range GetRange() const { return {m_data, m_data + m_size}; }
+        size_t size() const { return m_size; }
+    };
+
+    /**
+     * Chase-Lev work-stealing deque of ranges (see "Correct and Efficient
+     * Work-Stealing for Weak Memory Models", Lê et al., 2013). Push and Pop
+     * may only be called by the thread owning the deque, Steal by any thread.
+     */
+    class Deque
+    {
+    private:
+        struct Slot {
+            std::atomic<T*> begin{nullptr};
+            std::atomic<T*> end{nullptr};
+        };
+
+        struct Buffer {
+            const int64_t capacity;
+            const std::unique_ptr<Slot[]> slots;
+
+            explicit Buffer(int64_t capacity_in) : capacity{capacity_in}, slots{std::make_unique<Slot[]>(capacity_in)} {}
+
+            // Slots are accessed with relaxed atomics, as a thief may read a
+            // slot while the owner overwrites it. Its CAS on m_top then fails
+            // and the torn value is discarded.
+            Range Get(int64_t i) const
+            {
+                const Slot& slot{slots[i & (capacity - 1)]};
+                return {slot.begin.load(std::memory_order_relaxed), slot.end.load(std::memory_order_relaxed)};
+            }
+            void Put(int64_t i, const Range& range)
+            {
+                Slot& slot{slots[i & (capacity - 1)]};
+                slot.begin.store(range.begin, std::memory_order_relaxed);
+                slot.end.store(range.end, std::memory_order_relaxed);
+            }
+        };
+
+        std::atomic<int64_t> m_top{0};
+        std::atomic<int64_t> m_bottom{0};
+        std::atomic<Buffer*> m_buffer;
+        //! All buffers ever used by this deque. Thieves may still read from a
+        //! buffer after it was replaced by a larger one, so they are only
+        //! freed together with the deque. Only accessed by the owner.
+        std::vector<std::unique_ptr<Buffer>> m_buffers;
+
+    public:
+        Deque()
+        {
+            m_buffers.push_back(std::make_unique<Buffer>(64));
+            m_buffer.store(m_buffers.back().get(), std::memory_order_relaxed);
+        }
+
+        void Push(const Range& range)
+        {
+            const int64_t b{m_bottom.load(std::memory_order_relaxed)};
+            const int64_t t{m_top.load(std::memory_order_acquire)};
+            Buffer* buffer{m_buffer.load(std::memory_order_relaxed)};
+            if (b - t >= buffer->capacity) {
+                auto larger{std::make_unique<Buffer>(buffer->capacity * 2)};
+                for (int64_t i = t; i < b; ++i) larger->Put(i, buffer->Get(i));
+                buffer = larger.get();
+                m_buffers.push_back(std::move(larger));
+                m_buffer.store(buffer, std::memory_order_release);
+            }
+            buffer->Put(b, range);
+            // Publishes the range (and the checks it points to) to thieves.
+            m_bottom.store(b + 1, std::memory_order_release);
+        }
+
+        bool Pop(Range& range)
+        {
+            const int64_t b{m_bottom.load(std::memory_order_relaxed) - 1};
+            Buffer* buffer{m_buffer.load(std::memory_order_relaxed)};
+            m_bottom.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t t{m_top.load(std::memory_order_relaxed)};
+            if (t > b) {
+                // Empty
+                m_bottom.store(b + 1, std::memory_order_relaxed);
+                return false;
+            }
+            range = buffer->Get(b);
+            if (t < b) return true;
+            // Last element, which thieves may be competing for.
+            const bool won{m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)};
+            m_bottom.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+
+        bool Steal(Range& range)
+        {
+            int64_t t{m_top.load(std::memory_order_acquire)};
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const int64_t b{m_bottom.load(std::memory_order_acquire)};
+            if (t >= b) return false;
+            range = m_buffer.load(std::memory_order_acquire)->Get(t);
+            return m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        }
+    };
+
+    //! Number of times an idle thread looks for work before it parks
+    static constexpr int SPIN_ROUNDS{64};
+
+    //! Mutex to protect the parking state
     Mutex m_mutex;
 
     //! Worker threads block on this when out of work
@@ -36,90 +178,129 @@ private:
     //! Master thread blocks on this when out of work
     std::condition_variable m_master_cv;
 
-    //! The queue of elements to be processed.
-    //! As the order of booleans doesn't matter, it is used as a LIFO (stack)
-    std::vector<T> queue GUARDED_BY(m_mutex);
+    //! Incremented whenever parked threads are woken up for new work.
+    uint64_t m_epoch GUARDED_BY(m_mutex){0};
+
+    //! Number of parked worker threads.
+    std::atomic<int> m_parked_workers{0};
+
+    //! Whether the master is parked.
+    std::atomic<bool> m_master_parked{false};
 
-    //! The number of workers (including the master) that are idle.
-    int nIdle GUARDED_BY(m_mutex){0};
+    //! One deque per worker thread, followed by the master's deque.
+    std::vector<std::unique_ptr<Deque>> m_deques;
 
-    //! The total number of workers (including the master).
-    int nTotal GUARDED_BY(m_mutex){0};
+    //! Storage of the checks added since the last Wait(). Only accessed by
+    //! the master; other threads only access checks through ranges.
+    std::vector<std::unique_ptr<Storage>> m_checks;
 
     //! The temporary evaluation result.
-    bool fAllOk GUARDED_BY(m_mutex){true};
+    std::atomic<bool> m_all_ok{true};
 
     /**
      * Number of verifications that haven't completed yet.
-     * This includes elements that are no longer queued, but still in the
-     * worker's own batches.
+     * This includes elements that are no longer queued, but still in a
+     * thread's current chunk.
      */
-    unsigned int nTodo GUARDED_BY(m_mutex){0};
+    std::atomic<size_t> m_todo{0};
 
-    //! The maximum number of elements to be processed in one batch
+    //! The maximum number of elements to be processed in one chunk
     const unsigned int nBatchSize;
 
     std::vector<std::thread> m_worker_threads;
-    bool m_request_stop GUARDED_BY(m_mutex){false};
+    std::atomic<bool> m_request_stop{false};
 
-    /** Internal function that does bulk of the verification work. */
-    bool Loop(bool fMaster) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    //! Wake up a parked thread, if any, after work was pushed.
+    void Wake() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
     {
-        std::condition_variable& cond = fMaster ? m_master_cv : m_worker_cv;
-        std::vector<T> vChecks;
-        vChecks.reserve(nBatchSize);
-        unsigned int nNow = 0;
-        bool fOk = true;
-        do {
-            {
+        // Pairs with the fence in Park(): either the parking thread finds the
+        // pushed work, or this thread sees that it parks.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const bool workers{m_parked_workers.load(std::memory_order_relaxed) > 0};
+        if (!workers && !m_master_parked.load(std::memory_order_relaxed)) return;
+        LOCK(m_mutex);
+        ++m_epoch;
+        if (workers) {
+            m_worker_cv.notify_one();
+        } else {
+            m_master_cv.notify_one();
+        }
+    }
+
+    //! Take a range from the own deque, or steal one from another thread.
+    bool FindWork(size_t self, Range& range)
+    {
+        if (m_deques[self]->Pop(range)) return true;
+        for (size_t i = 1; i < m_deques.size(); ++i) {
+            if (m_deques[(self + i) % m_deques.size()]->Steal(range)) return true;
+        }
+        return false;
+    }
+
+    //! Look for work, spinning for a while before giving up.
+    bool SpinForWork(size_t self, Range& range)
+    {
+        for (int i = 0; i < SPIN_ROUNDS; ++i) {
+            if (FindWork(self, range)) return true;
+            if (m_request_stop.load(std::memory_order_relaxed)) return false;
+            std::this_thread::yield();
+        }
+        return false;
+    }
+
+    /** Process the first chunk of a range, leaving the remainder on the own deque. */
+    void Process(size_t self, Range range) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        if (static_cast<size_t>(range.end - range.begin) > nBatchSize) {
+            m_deques[self]->Push({range.begin + nBatchSize, range.end});
+            Wake();
+            range.end = range.begin + nBatchSize;
+        }
+        // Check whether we need to do work at all
+        bool fOk{m_all_ok.load(std::memory_order_relaxed)};
+        for (T* check = range.begin; check != range.end; ++check) {
+            if (fOk) fOk = (*check)();
+            std::destroy_at(check);
+        }
+        if (!fOk) m_all_ok.store(false, std::memory_order_relaxed);
+        const size_t n = static_cast<size_t>(range.end - range.begin);
+        if (m_todo.fetch_sub(n, std::memory_order_acq_rel) == n) {
+            // We processed the last element; inform the master it can exit and return the result
+            LOCK(m_mutex);
+            m_master_cv.notify_one();
+        }
+    }
+
+    /** Destroy the checks of all queued ranges without running them. */
+    void Discard(size_t self)
+    {
+        Range range;
+        while (FindWork(self, range)) {
+            std::destroy(range.begin, range.end);
+            m_todo.fetch_sub(static_cast<size_t>(range.end - range.begin), std::memory_order_acq_rel);
+        }
+    }
+
+    /** Worker thread loop. */
+    void Loop(size_t self) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        while (!m_request_stop.load(std::memory_order_relaxed)) {
+            Range range;
+            if (!SpinForWork(self, range)) {
                 WAIT_LOCK(m_mutex, lock);
-                // first do the clean-up of the previous loop run (allowing us to do it in the same critsect)
-                if (nNow) {
-                    fAllOk &= fOk;
-                    nTodo -= nNow;
-                    if (nTodo == 0 && !fMaster)
-                        // We processed the last element; inform the master it can exit and return the result
-                        m_master_cv.notify_one();
-                } else {
-                    // first iteration
-                    nTotal++;
-                }
-                // logically, the do loop starts here
-                while (queue.empty() && !m_request_stop) {
-                    if (fMaster && nTodo == 0) {
-                        nTotal--;
-                        bool fRet = fAllOk;
-                        // reset the status for new work later
-                        fAllOk = true;
-                        // return the current status
-                        return fRet;
-                    }
-                    nIdle++;
-                    cond.wait(lock); // wait
-                    nIdle--;
+                const uint64_t epoch{m_epoch};
+                m_parked_workers.fetch_add(1, std::memory_order_relaxed);
+                // Pairs with the fence in Wake().
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                bool found{FindWork(self, range)};
+                while (!found && m_epoch == epoch && !m_request_stop) {
+                    m_worker_cv.wait(lock);
                 }
-                if (m_request_stop) {
-                    return false;
-                }
-
-                // Decide how many work units to process now.
-                // * Do not try to do everything at once, but aim for increasingly smaller batches so
-                //   all workers finish approximately simultaneously.
-                // * Try to account for idle jobs which will instantly start helping.
-                // * Don't do batches smaller than 1 (duh), or larger than nBatchSize.
-                nNow = std::max(1U, std::min(nBatchSize, (unsigned int)queue.size() / (nTotal + nIdle + 1)));
-                auto start_it = queue.end() - nNow;
-                vChecks.assign(std::make_move_iterator(start_it), std::make_move_iterator(queue.end()));
-                queue.erase(start_it, queue.end());
-                // Check whether we need to do work at all
-                fOk = fAllOk;
+                m_parked_workers.fetch_sub(1, std::memory_order_relaxed);
+                if (!found) continue;
             }
-            // execute work
-            for (T& check : vChecks)
-                if (fOk)
-                    fOk = check();
-            vChecks.clear();
-        } while (true);
+            Process(self, range);
+        }
     }
 
 public:
@@ -130,11 +311,14 @@ public:
     explicit CCheckQueue(unsigned int batch_size, int worker_threads_num)
         : nBatchSize(batch_size)
     {
+        for (int n = 0; n <= worker_threads_num; ++n) {
+            m_deques.push_back(std::make_unique<Deque>());
+        }
         m_worker_threads.reserve(worker_threads_num);
         for (int n = 0; n < worker_threads_num; ++n) {
             m_worker_threads.emplace_back([this, n]() {
                 util::ThreadRename(strprintf("scriptch.%i", n));
-                Loop(false /* worker thread */);
+                Loop(n);
             });
         }
     }
@@ -149,27 +333,50 @@ public:
     //! Wait until execution finishes, and return whether all evaluations were successful.
     bool Wait() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
     {
-        return Loop(true /* master thread */);
+        const size_t self{m_worker_threads.size()};
+        while (m_todo.load(std::memory_order_acquire) > 0 && !m_request_stop.load(std::memory_order_relaxed)) {
+            Range range;
+            if (SpinForWork(self, range)) {
+                Process(self, range);
+                continue;
+            }
+            WAIT_LOCK(m_mutex, lock);
+            const uint64_t epoch{m_epoch};
+            m_master_parked.store(true, std::memory_order_relaxed);
+            // Pairs with the fence in Wake().
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            while (m_todo.load(std::memory_order_acquire) > 0 && m_epoch == epoch && !m_request_stop) {
+                m_master_cv.wait(lock);
+            }
+            m_master_parked.store(false, std::memory_order_relaxed);
+        }
+        bool stopped{false};
+        while (m_todo.load(std::memory_order_acquire) > 0) {
+            // Stopping with work left: discard the queued checks, and wait
+            // for the chunks other threads are still processing.
+            stopped = true;
+            Discard(self);
+            std::this_thread::yield();
+        }
+        // All checks were destroyed by now, so that a new verification can't
+        // start before they are cleaned up. Release their memory.
+        m_checks.clear();
+        // return the current status, and reset it for new work later
+        return m_all_ok.exchange(true) && !stopped;
     }
 
-    //! Add a batch of checks to the queue
-    void Add(std::vector<T>&& vChecks) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    //! Add a batch of checks to the queue, of T or of a type T can be constructed from
+    template <typename U>
+    void Add(std::vector<U>&& vChecks) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
     {
         if (vChecks.empty()) {
             return;
         }
 
-        {
-            LOCK(m_mutex);
-            queue.insert(queue.end(), std::make_move_iterator(vChecks.begin()), std::make_move_iterator(vChecks.end()));
-            nTodo += vChecks.size();
-        }
-
-        if (vChecks.size() == 1) {
-            m_worker_cv.notify_one();
-        } else {
-            m_worker_cv.notify_all();
-        }
+        const Storage& checks{*m_checks.emplace_back(std::make_unique<Storage>(std::move(vChecks)))};
+        m_todo.fetch_add(checks.size(), std::memory_order_relaxed);
+        m_deques[m_worker_threads.size()]->Push(checks.GetRange());
+        Wake();
     }
 
     ~CCheckQueue()
@@ -179,6 +386,9 @@ public:
         for (std::thread& t : m_worker_threads) {
             t.join();
         }
+        // Destroy the checks that were added but never waited for.
+        Discard(m_worker_threads.size());
+        m_checks.clear();
     }
 
     bool HasThreads() const { return !m_worker_threads.empty(); }
@@ -216,7 +426,8 @@ public:
         return fRet;
     }
 
-    void Add(std::vector<T>&& vChecks)
+    template <typename U>
+    void Add(std::vector<U>&& vChecks)
     {
         if (pqueue != nullptr) {
             pqueue->Add(std::move(vChecks));
@@ -4,6 +4,7 @@
 
 #include <common/bloom.h>
 
+#include <crypto/siphash.h>
 #include <hash.h>
 #include <primitives/transaction.h>
 #include <random.h>
@@ -11,6 +12,7 @@
 #include <script/solver.h>
 #include <span.h>
 #include <streams.h>
+#include <uint256.h>
 #include <util/fastrange.h>
 
 #include <algorithm>
@@ -244,3 +246,62 @@ void CRollingBloomFilter::reset()
     nGeneration = 1;
     std::fill(data.begin(), data.end(), 0);
 }
+
+/* Number of bits set per element, and of bits addressing a position in a 512-bit block. */
+static constexpr int BLOCKED_BLOOM_HASH_FUNCS{7};
+static constexpr int BLOCKED_BLOOM_BLOCK_BITS{9};
+static constexpr size_t BLOCKED_BLOOM_BITS_PER_ELEMENT{16};
+
+BlockedBloomFilter::BlockedBloomFilter(size_t capacity)
+    : m_capacity{capacity}
+{
+    FastRandomContext rng;
+    m_k0 = rng.rand64();
+    m_k1 = rng.rand64();
+    m_blocks.resize(std::max<size_t>(1, (capacity * BLOCKED_BLOOM_BITS_PER_ELEMENT + 511) / 512));
+}
+
+void BlockedBloomFilter::InsertHash(uint64_t hash)
+{
+    Block& block = m_blocks[FastRange64(hash, m_blocks.size())];
+    /* FastRange64 uses the upper bits of hash, so remix all of them for the bit positions. */
+    uint64_t bits = hash * 0x9e3779b97f4a7c15ULL;
+    for (int n = 0; n < BLOCKED_BLOOM_HASH_FUNCS; ++n) {
+        const uint64_t pos = bits >> (64 - BLOCKED_BLOOM_BLOCK_BITS);
+        block.words[pos >> 6] |= uint64_t{1} << (pos & 63);
+        bits <<= BLOCKED_BLOOM_BLOCK_BITS;
+    }
+    ++m_size;
+}
+
+bool BlockedBloomFilter::ContainsHash(uint64_t hash) const
+{
+    const Block& block = m_blocks[FastRange64(hash, m_blocks.size())];
+    uint64_t bits = hash * 0x9e3779b97f4a7c15ULL;
+    for (int n = 0; n < BLOCKED_BLOOM_HASH_FUNCS; ++n) {
+        const uint64_t pos = bits >> (64 - BLOCKED_BLOOM_BLOCK_BITS);
+        if (!((block.words[pos >> 6] >> (pos & 63)) & 1)) return false;
+        bits <<= BLOCKED_BLOOM_BLOCK_BITS;
+    }
+    return true;
+}
+
+void BlockedBloomFilter::insert(Span<const unsigned char> key)
+{
+    InsertHash(CSipHasher(m_k0, m_k1).Write(key).Finalize());
+}
+
+void BlockedBloomFilter::insert(const uint256& key)
+{
+    InsertHash(SipHashUint256(m_k0, m_k1, key));
+}
+
+bool BlockedBloomFilter::contains(Span<const unsigned char> key) const
+{
+    return ContainsHash(CSipHasher(m_k0, m_k1).Write(key).Finalize());
+}
+
+bool BlockedBloomFilter::contains(const uint256& key) const
+{
+    return ContainsHash(SipHashUint256(m_k0, m_k1, key));
+}
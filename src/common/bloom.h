@@ -8,10 +8,13 @@
 #include <serialize.h>
 #include <span.h>
 
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
 class COutPoint;
 class CTransaction;
+class uint256;
 
 //! 20,000 items with fp rate < 0.1% or 10,000 items and <0.0001%
 static constexpr unsigned int MAX_BLOOM_FILTER_SIZE = 36000; // bytes
@@ -124,4 +127,43 @@ private:
     int nHashFuncs;
 };
 
+/**
+ * BlockedBloomFilter is a fast, insert-only membership prefilter for local use
+ * (it is not serialized or relayed). All bits of an element are set within one
+ * 64-byte block, so contains() reads a single cache line and hashes only once.
+ *
+ * It is sized for its capacity at 16 bits per element, which keeps the false
+ * positive rate well below 1% as long as size() <= capacity(). The filter does
+ * not grow; callers construct a larger one and re-insert once it is full.
+ * The hash is salted with a random key, so false positives can't be targeted.
+ */
+class BlockedBloomFilter
+{
+public:
+    explicit BlockedBloomFilter(size_t capacity = 0);
+
+    void insert(Span<const unsigned char> key);
+    void insert(const uint256& key);
+
+    bool contains(Span<const unsigned char> key) const;
+    bool contains(const uint256& key) const;
+
+    //! Number of insert() calls since construction
+    size_t size() const { return m_size; }
+    size_t capacity() const { return m_capacity; }
+
+private:
+    struct alignas(64) Block {
+        uint64_t words[8]{};
+    };
+
+    void InsertHash(uint64_t hash);
+    bool ContainsHash(uint64_t hash) const;
+
+    uint64_t m_k0, m_k1;
+    std::vector<Block> m_blocks;
+    size_t m_capacity;
+    size_t m_size{0};
+};
+
 #endif // BITCOIN_COMMON_BLOOM_H
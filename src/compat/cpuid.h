@@ -22,5 +22,14 @@ void static inline GetCPUID(uint32_t leaf, uint32_t subleaf, uint32_t& a, uint32
 #endif
 }
 
+/** Read the XCR0 register, which tells which register states the OS saves on
+ *  context switches. Only call this if CPUID reports OSXSAVE support. */
+uint64_t static inline GetXCR0()
+{
+    uint32_t a, d;
+    __asm__("xgetbv" : "=a"(a), "=d"(d) : "c"(0));
+    return (uint64_t{d} << 32) | a;
+}
+
 #endif // defined(__x86_64__) || defined(__amd64__) || defined(__i386__)
 #endif // BITCOIN_COMPAT_CPUID_H
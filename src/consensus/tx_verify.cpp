@@ -14,6 +14,8 @@
 #include <util/check.h>
 #include <util/moneystr.h>
 
+#include <algorithm>
+
 bool IsFinalTx(const CTransaction &tx, int nBlockHeight, int64_t nBlockTime)
 {
     if (tx.nLockTime == 0)
@@ -123,7 +125,30 @@ unsigned int GetLegacySigOpCount(const CTransaction& tx)
     return nSigOps;
 }
 
-unsigned int GetP2SHSigOpCount(const CTransaction& tx, const CCoinsViewCache& inputs)
+//! The coin spent by input i of a transaction, looked up in a view or given in a
+//! span with one coin per input.
+static const Coin& SpentCoin(const CTransaction& tx, const CCoinsViewCache& inputs, size_t i)
+{
+    return inputs.AccessCoin(tx.vin[i].prevout);
+}
+
+static const Coin& SpentCoin(const CTransaction& tx, Span<const Coin> coins, size_t i)
+{
+    return coins[i];
+}
+
+static bool HaveSpentCoins(const CTransaction& tx, const CCoinsViewCache& inputs)
+{
+    return inputs.HaveInputs(tx);
+}
+
+static bool HaveSpentCoins(const CTransaction& tx, Span<const Coin> coins)
+{
+    return coins.size() == tx.vin.size() && std::none_of(coins.begin(), coins.end(), [](const Coin& coin) { return coin.IsSpent(); });
+}
+
+template <typename Inputs>
+static unsigned int P2SHSigOpCount(const CTransaction& tx, const Inputs& inputs)
 {
     if (tx.IsCoinBase())
         return 0;
@@ -131,7 +156,7 @@ unsigned int GetP2SHSigOpCount(const CTransaction& tx, const CCoinsViewCache& in
     unsigned int nSigOps = 0;
     for (unsigned int i = 0; i < tx.vin.size(); i++)
     {
-        const Coin& coin = inputs.AccessCoin(tx.vin[i].prevout);
+        const Coin& coin = SpentCoin(tx, inputs, i);
         assert(!coin.IsSpent());
         const CTxOut &prevout = coin.out;
         if (prevout.scriptPubKey.IsPayToScriptHash())
@@ -140,7 +165,18 @@ unsigned int GetP2SHSigOpCount(const CTransaction& tx, const CCoinsViewCache& in
     return nSigOps;
 }
 
-int64_t GetTransactionSigOpCost(const CTransaction& tx, const CCoinsViewCache& inputs, uint32_t flags)
+unsigned int GetP2SHSigOpCount(const CTransaction& tx, const CCoinsViewCache& inputs)
+{
+    return P2SHSigOpCount(tx, inputs);
+}
+
+unsigned int GetP2SHSigOpCount(const CTransaction& tx, Span<const Coin> coins)
+{
+    return P2SHSigOpCount(tx, coins);
+}
+
+template <typename Inputs>
+static int64_t TransactionSigOpCost(const CTransaction& tx, const Inputs& inputs, uint32_t flags)
 {
     int64_t nSigOps = GetLegacySigOpCount(tx) * WITNESS_SCALE_FACTOR;
 
@@ -148,12 +184,12 @@ int64_t GetTransactionSigOpCost(const CTransaction& tx, const CCoinsViewCache& i
         return nSigOps;
 
     if (flags & SCRIPT_VERIFY_P2SH) {
-        nSigOps += GetP2SHSigOpCount(tx, inputs) * WITNESS_SCALE_FACTOR;
+        nSigOps += P2SHSigOpCount(tx, inputs) * WITNESS_SCALE_FACTOR;
     }
 
     for (unsigned int i = 0; i < tx.vin.size(); i++)
     {
-        const Coin& coin = inputs.AccessCoin(tx.vin[i].prevout);
+        const Coin& coin = SpentCoin(tx, inputs, i);
         assert(!coin.IsSpent());
         const CTxOut &prevout = coin.out;
         nSigOps += CountWitnessSigOps(tx.vin[i].scriptSig, prevout.scriptPubKey, &tx.vin[i].scriptWitness, flags);
@@ -161,18 +197,28 @@ int64_t GetTransactionSigOpCost(const CTransaction& tx, const CCoinsViewCache& i
     return nSigOps;
 }
 
-bool Consensus::CheckTxInputs(const CTransaction& tx, TxValidationState& state, const CCoinsViewCache& inputs, int nSpendHeight, CAmount& txfee)
+int64_t GetTransactionSigOpCost(const CTransaction& tx, const CCoinsViewCache& inputs, uint32_t flags)
+{
+    return TransactionSigOpCost(tx, inputs, flags);
+}
+
+int64_t GetTransactionSigOpCost(const CTransaction& tx, Span<const Coin> coins, uint32_t flags)
+{
+    return TransactionSigOpCost(tx, coins, flags);
+}
+
+template <typename Inputs>
+static bool CheckTxInputsImpl(const CTransaction& tx, TxValidationState& state, const Inputs& inputs, int nSpendHeight, CAmount& txfee)
 {
     // are the actual inputs available?
-    if (!inputs.HaveInputs(tx)) {
+    if (!HaveSpentCoins(tx, inputs)) {
         return state.Invalid(TxValidationResult::TX_MISSING_INPUTS, "bad-txns-inputs-missingorspent",
                          strprintf("%s: inputs missing/spent", __func__));
     }
 
     CAmount nValueIn = 0;
     for (unsigned int i = 0; i < tx.vin.size(); ++i) {
-        const COutPoint &prevout = tx.vin[i].prevout;
-        const Coin& coin = inputs.AccessCoin(prevout);
+        const Coin& coin = SpentCoin(tx, inputs, i);
         assert(!coin.IsSpent());
 
         // If prev is coinbase, check that it's matured
@@ -203,3 +249,13 @@ bool Consensus::CheckTxInputs(const CTransaction& tx, TxValidationState& state,
     txfee = txfee_aux;
     return true;
 }
+
+bool Consensus::CheckTxInputs(const CTransaction& tx, TxValidationState& state, const CCoinsViewCache& inputs, int nSpendHeight, CAmount& txfee)
+{
+    return CheckTxInputsImpl(tx, state, inputs, nSpendHeight, txfee);
+}
+
+bool Consensus::CheckTxInputs(const CTransaction& tx, TxValidationState& state, Span<const Coin> coins, int nSpendHeight, CAmount& txfee)
+{
+    return CheckTxInputsImpl(tx, state, coins, nSpendHeight, txfee);
+}
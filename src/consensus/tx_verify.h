@@ -6,12 +6,14 @@
 #define BITCOIN_CONSENSUS_TX_VERIFY_H
 
 #include <consensus/amount.h>
+#include <span.h>
 
 #include <stdint.h>
 #include <vector>
 
 class CBlockIndex;
 class CCoinsViewCache;
+class Coin;
 class CTransaction;
 class TxValidationState;
 
@@ -25,6 +27,8 @@ namespace Consensus {
  * Preconditions: tx.IsCoinBase() is false.
  */
 [[nodiscard]] bool CheckTxInputs(const CTransaction& tx, TxValidationState& state, const CCoinsViewCache& inputs, int nSpendHeight, CAmount& txfee);
+/** As above, with the coins spent by the transaction, one per input. */
+[[nodiscard]] bool CheckTxInputs(const CTransaction& tx, TxValidationState& state, Span<const Coin> coins, int nSpendHeight, CAmount& txfee);
 } // namespace Consensus
 
 /** Auxiliary functions for transaction validation (ideally should not be exposed) */
@@ -44,6 +48,7 @@ unsigned int GetLegacySigOpCount(const CTransaction& tx);
  * @see CTransaction::FetchInputs
  */
 unsigned int GetP2SHSigOpCount(const CTransaction& tx, const CCoinsViewCache& mapInputs);
+unsigned int GetP2SHSigOpCount(const CTransaction& tx, Span<const Coin> coins);
 
 /**
  * Compute total signature operation cost of a transaction.
@@ -53,6 +58,8 @@ unsigned int GetP2SHSigOpCount(const CTransaction& tx, const CCoinsViewCache& ma
  * @return Total signature operation cost of tx
  */
 int64_t GetTransactionSigOpCost(const CTransaction& tx, const CCoinsViewCache& inputs, uint32_t flags);
+/** As above, with the coins spent by the transaction, one per input. */
+int64_t GetTransactionSigOpCost(const CTransaction& tx, Span<const Coin> coins, uint32_t flags);
 
 /**
  * Check if transaction is final and can be included in a block with the
@@ -5,6 +5,9 @@
 // Based on the public domain implementation 'merged' by D. J. Bernstein
 // See https://cr.yp.to/chacha.html.
 
+#include <config/bitcoin-config.h> // IWYU pragma: keep
+
+#include <compat/cpuid.h>
 #include <crypto/common.h>
 #include <crypto/chacha20.h>
 #include <support/cleanse.h>
@@ -22,6 +25,105 @@
 
 #define REPEAT10(a) do { {a}; {a}; {a}; {a}; {a}; {a}; {a}; {a}; {a}; {a}; } while(0)
 
+#if defined(ENABLE_SSE41)
+namespace chacha20_sse41 {
+void Crypt_4way(const uint32_t* input, const unsigned char* in, unsigned char* out);
+}
+#endif
+#if defined(ENABLE_AVX2)
+namespace chacha20_avx2 {
+void Crypt_8way(const uint32_t* input, const unsigned char* in, unsigned char* out);
+}
+#endif
+#if defined(ENABLE_AVX512)
+namespace chacha20_avx512 {
+void Crypt_16way(const uint32_t* input, const unsigned char* in, unsigned char* out);
+}
+#endif
+
+namespace {
+
+/** A function computing N consecutive blocks, starting at the block counter in
+ *  input[8..9]. It xors them into in, or outputs the keystream if in is nullptr. */
+typedef void (*CryptMultiFn)(const uint32_t* input, const unsigned char* in, unsigned char* out);
+
+CryptMultiFn Crypt_4way = nullptr;
+CryptMultiFn Crypt_8way = nullptr;
+CryptMultiFn Crypt_16way = nullptr;
+
+/** Process as many leading blocks as possible with the multi-block
+ *  implementations, advancing the input pointers and block counter.
+ *  Returns the number of blocks left for the single-block code. */
+size_t CryptMulti(uint32_t* input, const unsigned char*& m, unsigned char*& c, size_t blocks)
+{
+    const auto run = [&](CryptMultiFn fn, size_t n) {
+        while (fn && blocks >= n) {
+            fn(input, m, c);
+            const uint64_t counter{(uint64_t{input[9]} << 32 | input[8]) + n};
+            input[8] = counter;
+            input[9] = counter >> 32;
+            if (m) m += n * ChaCha20Aligned::BLOCKLEN;
+            c += n * ChaCha20Aligned::BLOCKLEN;
+            blocks -= n;
+        }
+    };
+    run(Crypt_16way, 16);
+    run(Crypt_8way, 8);
+    run(Crypt_4way, 4);
+    return blocks;
+}
+
+} // namespace
+
+std::string ChaCha20AutoDetect(chacha20_implementation::UseImplementation use_implementation)
+{
+    std::string ret = "standard";
+    Crypt_4way = nullptr;
+    Crypt_8way = nullptr;
+    Crypt_16way = nullptr;
+
+#if defined(HAVE_GETCPUID)
+    [[maybe_unused]] bool have_sse41 = false;
+    [[maybe_unused]] bool have_avx2 = false;
+    [[maybe_unused]] bool have_avx512 = false;
+    uint64_t xcr0 = 0;
+
+    uint32_t eax, ebx, ecx, edx;
+    GetCPUID(1, 0, eax, ebx, ecx, edx);
+    // The SSE4.1 implementation also uses the SSSE3 byte shuffle.
+    have_sse41 = ((ecx >> 19) & 1) && ((ecx >> 9) & 1) && (use_implementation & chacha20_implementation::USE_SSE41);
+    const bool have_xsave_avx = ((ecx >> 27) & 1) && ((ecx >> 28) & 1);
+    if (have_xsave_avx) xcr0 = GetXCR0();
+    if (have_sse41) {
+        GetCPUID(7, 0, eax, ebx, ecx, edx);
+        // AVX2 requires the OS to save the ymm registers, AVX-512F also the opmask and zmm registers.
+        have_avx2 = ((ebx >> 5) & 1) && (xcr0 & 0x6) == 0x6 && (use_implementation & chacha20_implementation::USE_AVX2);
+        have_avx512 = ((ebx >> 16) & 1) && (xcr0 & 0xe6) == 0xe6 && (use_implementation & chacha20_implementation::USE_AVX512);
+    }
+
+#if defined(ENABLE_SSE41)
+    if (have_sse41) {
+        Crypt_4way = chacha20_sse41::Crypt_4way;
+        ret = "sse41(4way)";
+    }
+#endif
+#if defined(ENABLE_AVX2)
+    if (have_avx2) {
+        Crypt_8way = chacha20_avx2::Crypt_8way;
+        ret += ",avx2(8way)";
+    }
+#endif
+#if defined(ENABLE_AVX512)
+    if (have_avx512) {
+        Crypt_16way = chacha20_avx512::Crypt_16way;
+        ret += ",avx512(16way)";
+    }
+#endif
+#endif // defined(HAVE_GETCPUID)
+
+    return ret;
+}
+
 void ChaCha20Aligned::SetKey(Span<const std::byte> key) noexcept
 {
     assert(key.size() == KEYLEN);
@@ -63,6 +165,9 @@ inline void ChaCha20Aligned::Keystream(Span<std::byte> output) noexcept
     size_t blocks = output.size() / BLOCKLEN;
     assert(blocks * BLOCKLEN == output.size());
 
+    const unsigned char* m = nullptr;
+    blocks = CryptMulti(input, m, c, blocks);
+
     uint32_t x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15;
     uint32_t j4, j5, j6, j7, j8, j9, j10, j11, j12, j13, j14, j15;
 
@@ -166,6 +271,8 @@ inline void ChaCha20Aligned::Crypt(Span<const std::byte> in_bytes, Span<std::byt
     size_t blocks = out_bytes.size() / BLOCKLEN;
     assert(blocks * BLOCKLEN == out_bytes.size());
 
+    blocks = CryptMulti(input, m, c, blocks);
+
     uint32_t x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15;
     uint32_t j4, j5, j6, j7, j8, j9, j10, j11, j12, j13, j14, j15;
 
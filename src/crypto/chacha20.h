@@ -11,6 +11,7 @@
 #include <cstddef>
 #include <cstdlib>
 #include <stdint.h>
+#include <string>
 #include <utility>
 
 // classes for ChaCha20 256-bit stream cipher developed by Daniel J. Bernstein
@@ -21,6 +22,23 @@
 // the first 32-bit part of the nonce is automatically incremented, making it
 // conceptually compatible with variants that use a 64/64 split instead.
 
+namespace chacha20_implementation {
+enum UseImplementation : uint8_t {
+    STANDARD = 0,
+    USE_SSE41 = 1 << 0,
+    USE_AVX2 = 1 << 1,
+    USE_AVX512 = 1 << 2,
+    USE_SSE41_AND_AVX2 = USE_SSE41 | USE_AVX2,
+    USE_ALL = USE_SSE41 | USE_AVX2 | USE_AVX512,
+};
+}
+
+/** Autodetect the best available multi-block ChaCha20 implementations.
+ *  Returns the name of the implementation. All implementations produce the
+ *  same output; the wider ones are used for requests of at least 4, 8 or 16 blocks.
+ */
+std::string ChaCha20AutoDetect(chacha20_implementation::UseImplementation use_implementation = chacha20_implementation::USE_ALL);
+
 /** ChaCha20 cipher that only operates on multiples of 64 bytes. */
 class ChaCha20Aligned
 {
@@ -0,0 +1,106 @@
+// Copyright (c) 2024 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// ChaCha20 computing 8 consecutive blocks at once, one block per 32-bit lane.
+
+#ifdef ENABLE_AVX2
+
+#include <stdint.h>
+#include <immintrin.h>
+
+namespace chacha20_avx2 {
+namespace {
+
+__m256i inline K(uint32_t x) { return _mm256_set1_epi32(x); }
+__m256i inline Add(__m256i x, __m256i y) { return _mm256_add_epi32(x, y); }
+__m256i inline Xor(__m256i x, __m256i y) { return _mm256_xor_si256(x, y); }
+
+template <int N>
+__m256i inline Rotl(__m256i x) { return _mm256_or_si256(_mm256_slli_epi32(x, N), _mm256_srli_epi32(x, 32 - N)); }
+template <>
+__m256i inline Rotl<16>(__m256i x)
+{
+    return _mm256_shuffle_epi8(x, _mm256_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13,
+                                                   2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13));
+}
+template <>
+__m256i inline Rotl<8>(__m256i x)
+{
+    return _mm256_shuffle_epi8(x, _mm256_setr_epi8(3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14,
+                                                   3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14));
+}
+
+void inline QuarterRound(__m256i& a, __m256i& b, __m256i& c, __m256i& d)
+{
+    a = Add(a, b); d = Rotl<16>(Xor(d, a));
+    c = Add(c, d); b = Rotl<12>(Xor(b, c));
+    a = Add(a, b); d = Rotl<8>(Xor(d, a));
+    c = Add(c, d); b = Rotl<7>(Xor(b, c));
+}
+
+/** Transpose the 4x4 matrices of 32-bit words in each 128-bit half of a, b, c, d. */
+void inline Transpose(__m256i& a, __m256i& b, __m256i& c, __m256i& d)
+{
+    __m256i t0 = _mm256_unpacklo_epi32(a, b), t1 = _mm256_unpacklo_epi32(c, d);
+    __m256i t2 = _mm256_unpackhi_epi32(a, b), t3 = _mm256_unpackhi_epi32(c, d);
+    a = _mm256_unpacklo_epi64(t0, t1);
+    b = _mm256_unpackhi_epi64(t0, t1);
+    c = _mm256_unpacklo_epi64(t2, t3);
+    d = _mm256_unpackhi_epi64(t2, t3);
+}
+
+void inline Write(__m256i v, const unsigned char* in, unsigned char* out, int offset)
+{
+    if (in) v = Xor(v, _mm256_loadu_si256((const __m256i*)(in + offset)));
+    _mm256_storeu_si256((__m256i*)(out + offset), v);
+}
+
+} // namespace
+
+void Crypt_8way(const uint32_t* input, const unsigned char* in, unsigned char* out)
+{
+    const uint64_t counter{uint64_t{input[9]} << 32 | input[8]};
+    uint32_t counter_lo[8], counter_hi[8];
+    for (int b = 0; b < 8; ++b) {
+        counter_lo[b] = uint32_t(counter + b);
+        counter_hi[b] = uint32_t((counter + b) >> 32);
+    }
+    __m256i j[16] = {
+        K(0x61707865), K(0x3320646e), K(0x79622d32), K(0x6b206574),
+        K(input[0]), K(input[1]), K(input[2]), K(input[3]),
+        K(input[4]), K(input[5]), K(input[6]), K(input[7]),
+        _mm256_loadu_si256((const __m256i*)counter_lo), _mm256_loadu_si256((const __m256i*)counter_hi),
+        K(input[10]), K(input[11]),
+    };
+    __m256i x[16];
+    for (int i = 0; i < 16; ++i) x[i] = j[i];
+
+    for (int round = 0; round < 10; ++round) {
+        QuarterRound(x[0], x[4], x[8], x[12]);
+        QuarterRound(x[1], x[5], x[9], x[13]);
+        QuarterRound(x[2], x[6], x[10], x[14]);
+        QuarterRound(x[3], x[7], x[11], x[15]);
+        QuarterRound(x[0], x[5], x[10], x[15]);
+        QuarterRound(x[1], x[6], x[11], x[12]);
+        QuarterRound(x[2], x[7], x[8], x[13]);
+        QuarterRound(x[3], x[4], x[9], x[14]);
+    }
+    for (int i = 0; i < 16; ++i) x[i] = Add(x[i], j[i]);
+
+    // After transposing each group of 4 words, the lower half of x[4 * g + b]
+    // holds words 4 * g to 4 * g + 3 of block b, the upper half those of block b + 4.
+    for (int g = 0; g < 4; ++g) {
+        Transpose(x[4 * g], x[4 * g + 1], x[4 * g + 2], x[4 * g + 3]);
+    }
+    for (int b = 0; b < 4; ++b) {
+        Write(_mm256_permute2x128_si256(x[b], x[4 + b], 0x20), in, out, 64 * b);
+        Write(_mm256_permute2x128_si256(x[8 + b], x[12 + b], 0x20), in, out, 64 * b + 32);
+        Write(_mm256_permute2x128_si256(x[b], x[4 + b], 0x31), in, out, 64 * (b + 4));
+        Write(_mm256_permute2x128_si256(x[8 + b], x[12 + b], 0x31), in, out, 64 * (b + 4) + 32);
+    }
+}
+
+} // namespace chacha20_avx2
+
+#endif
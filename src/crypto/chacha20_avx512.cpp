@@ -0,0 +1,70 @@
+// Copyright (c) 2024 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// ChaCha20 computing 16 consecutive blocks at once, one block per 32-bit lane.
+
+#ifdef ENABLE_AVX512
+
+#include <stdint.h>
+#include <immintrin.h>
+
+namespace chacha20_avx512 {
+namespace {
+
+__m512i inline K(uint32_t x) { return _mm512_set1_epi32(x); }
+__m512i inline Add(__m512i x, __m512i y) { return _mm512_add_epi32(x, y); }
+__m512i inline Xor(__m512i x, __m512i y) { return _mm512_xor_si512(x, y); }
+
+void inline QuarterRound(__m512i& a, __m512i& b, __m512i& c, __m512i& d)
+{
+    a = Add(a, b); d = _mm512_rol_epi32(Xor(d, a), 16);
+    c = Add(c, d); b = _mm512_rol_epi32(Xor(b, c), 12);
+    a = Add(a, b); d = _mm512_rol_epi32(Xor(d, a), 8);
+    c = Add(c, d); b = _mm512_rol_epi32(Xor(b, c), 7);
+}
+
+} // namespace
+
+void Crypt_16way(const uint32_t* input, const unsigned char* in, unsigned char* out)
+{
+    const uint64_t counter{uint64_t{input[9]} << 32 | input[8]};
+    alignas(64) uint32_t words[16 * 16];
+    for (int b = 0; b < 16; ++b) {
+        words[b] = uint32_t(counter + b);
+        words[16 + b] = uint32_t((counter + b) >> 32);
+    }
+    __m512i j[16] = {
+        K(0x61707865), K(0x3320646e), K(0x79622d32), K(0x6b206574),
+        K(input[0]), K(input[1]), K(input[2]), K(input[3]),
+        K(input[4]), K(input[5]), K(input[6]), K(input[7]),
+        _mm512_load_si512(words), _mm512_load_si512(words + 16),
+        K(input[10]), K(input[11]),
+    };
+    __m512i x[16];
+    for (int i = 0; i < 16; ++i) x[i] = j[i];
+
+    for (int round = 0; round < 10; ++round) {
+        QuarterRound(x[0], x[4], x[8], x[12]);
+        QuarterRound(x[1], x[5], x[9], x[13]);
+        QuarterRound(x[2], x[6], x[10], x[14]);
+        QuarterRound(x[3], x[7], x[11], x[15]);
+        QuarterRound(x[0], x[5], x[10], x[15]);
+        QuarterRound(x[1], x[6], x[11], x[12]);
+        QuarterRound(x[2], x[7], x[8], x[13]);
+        QuarterRound(x[3], x[4], x[9], x[14]);
+    }
+
+    // Word i of block b ends up at words[16 * i + b]; gather each block's words.
+    for (int i = 0; i < 16; ++i) _mm512_store_si512(words + 16 * i, Add(x[i], j[i]));
+    const __m512i index = _mm512_setr_epi32(0, 16, 32, 48, 64, 80, 96, 112, 128, 144, 160, 176, 192, 208, 224, 240);
+    for (int b = 0; b < 16; ++b) {
+        __m512i v = _mm512_i32gather_epi32(_mm512_add_epi32(index, K(b)), words, 4);
+        if (in) v = Xor(v, _mm512_loadu_si512(in + 64 * b));
+        _mm512_storeu_si512(out + 64 * b, v);
+    }
+}
+
+} // namespace chacha20_avx512
+
+#endif
@@ -0,0 +1,88 @@
+// Copyright (c) 2024 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// ChaCha20 computing 4 consecutive blocks at once, one block per 32-bit lane.
+
+#ifdef ENABLE_SSE41
+
+#include <stdint.h>
+#include <immintrin.h>
+
+namespace chacha20_sse41 {
+namespace {
+
+__m128i inline K(uint32_t x) { return _mm_set1_epi32(x); }
+__m128i inline Add(__m128i x, __m128i y) { return _mm_add_epi32(x, y); }
+__m128i inline Xor(__m128i x, __m128i y) { return _mm_xor_si128(x, y); }
+
+template <int N>
+__m128i inline Rotl(__m128i x) { return _mm_or_si128(_mm_slli_epi32(x, N), _mm_srli_epi32(x, 32 - N)); }
+template <>
+__m128i inline Rotl<16>(__m128i x) { return _mm_shuffle_epi8(x, _mm_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13)); }
+template <>
+__m128i inline Rotl<8>(__m128i x) { return _mm_shuffle_epi8(x, _mm_setr_epi8(3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14)); }
+
+void inline QuarterRound(__m128i& a, __m128i& b, __m128i& c, __m128i& d)
+{
+    a = Add(a, b); d = Rotl<16>(Xor(d, a));
+    c = Add(c, d); b = Rotl<12>(Xor(b, c));
+    a = Add(a, b); d = Rotl<8>(Xor(d, a));
+    c = Add(c, d); b = Rotl<7>(Xor(b, c));
+}
+
+/** Transpose the 4x4 matrix of 32-bit words in a, b, c, d. */
+void inline Transpose(__m128i& a, __m128i& b, __m128i& c, __m128i& d)
+{
+    __m128i t0 = _mm_unpacklo_epi32(a, b), t1 = _mm_unpacklo_epi32(c, d);
+    __m128i t2 = _mm_unpackhi_epi32(a, b), t3 = _mm_unpackhi_epi32(c, d);
+    a = _mm_unpacklo_epi64(t0, t1);
+    b = _mm_unpackhi_epi64(t0, t1);
+    c = _mm_unpacklo_epi64(t2, t3);
+    d = _mm_unpackhi_epi64(t2, t3);
+}
+
+} // namespace
+
+void Crypt_4way(const uint32_t* input, const unsigned char* in, unsigned char* out)
+{
+    const uint64_t counter{uint64_t{input[9]} << 32 | input[8]};
+    __m128i j[16] = {
+        K(0x61707865), K(0x3320646e), K(0x79622d32), K(0x6b206574),
+        K(input[0]), K(input[1]), K(input[2]), K(input[3]),
+        K(input[4]), K(input[5]), K(input[6]), K(input[7]),
+        _mm_setr_epi32(uint32_t(counter), uint32_t(counter + 1), uint32_t(counter + 2), uint32_t(counter + 3)),
+        _mm_setr_epi32(uint32_t(counter >> 32), uint32_t((counter + 1) >> 32), uint32_t((counter + 2) >> 32), uint32_t((counter + 3) >> 32)),
+        K(input[10]), K(input[11]),
+    };
+    __m128i x[16];
+    for (int i = 0; i < 16; ++i) x[i] = j[i];
+
+    for (int round = 0; round < 10; ++round) {
+        QuarterRound(x[0], x[4], x[8], x[12]);
+        QuarterRound(x[1], x[5], x[9], x[13]);
+        QuarterRound(x[2], x[6], x[10], x[14]);
+        QuarterRound(x[3], x[7], x[11], x[15]);
+        QuarterRound(x[0], x[5], x[10], x[15]);
+        QuarterRound(x[1], x[6], x[11], x[12]);
+        QuarterRound(x[2], x[7], x[8], x[13]);
+        QuarterRound(x[3], x[4], x[9], x[14]);
+    }
+    for (int i = 0; i < 16; ++i) x[i] = Add(x[i], j[i]);
+
+    // After transposing each group of 4 words, x[4 * g + b] holds words 4 * g
+    // to 4 * g + 3 of block b.
+    for (int g = 0; g < 4; ++g) {
+        Transpose(x[4 * g], x[4 * g + 1], x[4 * g + 2], x[4 * g + 3]);
+        for (int b = 0; b < 4; ++b) {
+            __m128i v = x[4 * g + b];
+            const int offset{64 * b + 16 * g};
+            if (in) v = Xor(v, _mm_loadu_si128((const __m128i*)(in + offset)));
+            _mm_storeu_si128((__m128i*)(out + offset), v);
+        }
+    }
+}
+
+} // namespace chacha20_sse41
+
+#endif
@@ -2,11 +2,54 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <config/bitcoin-config.h> // IWYU pragma: keep
+
+#include <compat/cpuid.h>
 #include <crypto/common.h>
 #include <crypto/poly1305.h>
 
 #include <string.h>
 
+#if defined(ENABLE_AVX2)
+namespace poly1305_avx2 {
+void Blocks_4way(uint32_t h[5], const uint32_t r[5], const unsigned char* m, size_t blocks);
+}
+#endif
+
+namespace {
+
+/** Process a multiple of 4 (non-final) blocks, updating the accumulator h. */
+typedef void (*BlocksMultiFn)(uint32_t h[5], const uint32_t r[5], const unsigned char* m, size_t blocks);
+
+BlocksMultiFn Blocks_4way = nullptr;
+
+/** Minimum number of blocks for which the multi-block implementation is used,
+ *  as it needs to compute powers of r first. */
+constexpr size_t MIN_MULTI_BLOCKS{16};
+
+} // namespace
+
+std::string Poly1305AutoDetect(poly1305_implementation::UseImplementation use_implementation)
+{
+    std::string ret = "standard";
+    Blocks_4way = nullptr;
+
+#if defined(HAVE_GETCPUID) && defined(ENABLE_AVX2)
+    uint32_t eax, ebx, ecx, edx;
+    GetCPUID(1, 0, eax, ebx, ecx, edx);
+    const bool have_xsave_avx = ((ecx >> 27) & 1) && ((ecx >> 28) & 1);
+    if (have_xsave_avx && (GetXCR0() & 0x6) == 0x6) {
+        GetCPUID(7, 0, eax, ebx, ecx, edx);
+        if (((ebx >> 5) & 1) && (use_implementation & poly1305_implementation::USE_AVX2)) {
+            Blocks_4way = poly1305_avx2::Blocks_4way;
+            ret = "avx2(4way)";
+        }
+    }
+#endif
+
+    return ret;
+}
+
 namespace poly1305_donna {
 
 // Based on the public domain implementation by Andrew Moon
@@ -203,6 +246,14 @@ void poly1305_update(poly1305_context *st, const unsigned char *m, size_t bytes)
         st->leftover = 0;
     }
 
+    /* process multiples of 4 full blocks with the multi-block implementation */
+    if (Blocks_4way && bytes >= MIN_MULTI_BLOCKS * POLY1305_BLOCK_SIZE) {
+        size_t want = (bytes & ~(4 * POLY1305_BLOCK_SIZE - 1));
+        Blocks_4way(st->h, st->r, m, want / POLY1305_BLOCK_SIZE);
+        m += want;
+        bytes -= want;
+    }
+
     /* process full blocks */
     if (bytes >= POLY1305_BLOCK_SIZE) {
         size_t want = (bytes & ~(POLY1305_BLOCK_SIZE - 1));
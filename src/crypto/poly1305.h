@@ -10,6 +10,7 @@
 #include <cassert>
 #include <cstdlib>
 #include <stdint.h>
+#include <string>
 
 #define POLY1305_BLOCK_SIZE 16
 
@@ -33,6 +34,19 @@ void poly1305_finish(poly1305_context *st, unsigned char mac[16]) noexcept;
 
 }  // namespace poly1305_donna
 
+namespace poly1305_implementation {
+enum UseImplementation : uint8_t {
+    STANDARD = 0,
+    USE_AVX2 = 1 << 0,
+    USE_ALL = USE_AVX2,
+};
+}
+
+/** Autodetect the best available Poly1305 implementation.
+ *  Returns the name of the implementation. All implementations produce the same tags.
+ */
+std::string Poly1305AutoDetect(poly1305_implementation::UseImplementation use_implementation = poly1305_implementation::USE_ALL);
+
 /** C++ wrapper with std::byte Span interface around poly1305_donna code. */
 class Poly1305
 {
@@ -0,0 +1,124 @@
+// Copyright (c) 2024 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// Poly1305 processing 4 blocks at once, using 26-bit limbs in 64-bit lanes.
+//
+// Lane j accumulates blocks j, j + 4, j + 8, ... multiplied by r^4 per step.
+// At the end, lane j is multiplied by r^(4 - j) and the lanes are summed, which
+// yields the same value modulo 2^130 - 5 as processing the blocks one by one.
+
+#ifdef ENABLE_AVX2
+
+#include <stddef.h>
+#include <stdint.h>
+#include <immintrin.h>
+
+namespace poly1305_avx2 {
+namespace {
+
+/** out = a * b mod 2^130 - 5, partially reduced, as in the scalar implementation. */
+void MulMod(uint32_t out[5], const uint32_t a[5], const uint32_t b[5])
+{
+    const uint32_t s1 = b[1] * 5, s2 = b[2] * 5, s3 = b[3] * 5, s4 = b[4] * 5;
+    uint64_t d0 = (uint64_t)a[0] * b[0] + (uint64_t)a[1] * s4 + (uint64_t)a[2] * s3 + (uint64_t)a[3] * s2 + (uint64_t)a[4] * s1;
+    uint64_t d1 = (uint64_t)a[0] * b[1] + (uint64_t)a[1] * b[0] + (uint64_t)a[2] * s4 + (uint64_t)a[3] * s3 + (uint64_t)a[4] * s2;
+    uint64_t d2 = (uint64_t)a[0] * b[2] + (uint64_t)a[1] * b[1] + (uint64_t)a[2] * b[0] + (uint64_t)a[3] * s4 + (uint64_t)a[4] * s3;
+    uint64_t d3 = (uint64_t)a[0] * b[3] + (uint64_t)a[1] * b[2] + (uint64_t)a[2] * b[1] + (uint64_t)a[3] * b[0] + (uint64_t)a[4] * s4;
+    uint64_t d4 = (uint64_t)a[0] * b[4] + (uint64_t)a[1] * b[3] + (uint64_t)a[2] * b[2] + (uint64_t)a[3] * b[1] + (uint64_t)a[4] * b[0];
+    uint32_t c;
+    c = (uint32_t)(d0 >> 26); out[0] = (uint32_t)d0 & 0x3ffffff;
+    d1 += c; c = (uint32_t)(d1 >> 26); out[1] = (uint32_t)d1 & 0x3ffffff;
+    d2 += c; c = (uint32_t)(d2 >> 26); out[2] = (uint32_t)d2 & 0x3ffffff;
+    d3 += c; c = (uint32_t)(d3 >> 26); out[3] = (uint32_t)d3 & 0x3ffffff;
+    d4 += c; c = (uint32_t)(d4 >> 26); out[4] = (uint32_t)d4 & 0x3ffffff;
+    out[0] += c * 5; c = out[0] >> 26; out[0] &= 0x3ffffff;
+    out[1] += c;
+}
+
+__m256i inline Mul(__m256i x, __m256i y) { return _mm256_mul_epu32(x, y); }
+__m256i inline Add(__m256i x, __m256i y) { return _mm256_add_epi64(x, y); }
+
+/** h = h * r mod 2^130 - 5 (partially reduced) in each lane, with s = 5 * r. */
+void inline MulModVec(__m256i h[5], const __m256i r[5], const __m256i s[5])
+{
+    const __m256i mask = _mm256_set1_epi64x(0x3ffffff);
+    __m256i d0 = Add(Add(Add(Add(Mul(h[0], r[0]), Mul(h[1], s[4])), Mul(h[2], s[3])), Mul(h[3], s[2])), Mul(h[4], s[1]));
+    __m256i d1 = Add(Add(Add(Add(Mul(h[0], r[1]), Mul(h[1], r[0])), Mul(h[2], s[4])), Mul(h[3], s[3])), Mul(h[4], s[2]));
+    __m256i d2 = Add(Add(Add(Add(Mul(h[0], r[2]), Mul(h[1], r[1])), Mul(h[2], r[0])), Mul(h[3], s[4])), Mul(h[4], s[3]));
+    __m256i d3 = Add(Add(Add(Add(Mul(h[0], r[3]), Mul(h[1], r[2])), Mul(h[2], r[1])), Mul(h[3], r[0])), Mul(h[4], s[4]));
+    __m256i d4 = Add(Add(Add(Add(Mul(h[0], r[4]), Mul(h[1], r[3])), Mul(h[2], r[2])), Mul(h[3], r[1])), Mul(h[4], r[0]));
+    __m256i c;
+    c = _mm256_srli_epi64(d0, 26); h[0] = _mm256_and_si256(d0, mask);
+    d1 = Add(d1, c); c = _mm256_srli_epi64(d1, 26); h[1] = _mm256_and_si256(d1, mask);
+    d2 = Add(d2, c); c = _mm256_srli_epi64(d2, 26); h[2] = _mm256_and_si256(d2, mask);
+    d3 = Add(d3, c); c = _mm256_srli_epi64(d3, 26); h[3] = _mm256_and_si256(d3, mask);
+    d4 = Add(d4, c); c = _mm256_srli_epi64(d4, 26); h[4] = _mm256_and_si256(d4, mask);
+    h[0] = Add(h[0], Add(c, _mm256_slli_epi64(c, 2)));
+    c = _mm256_srli_epi64(h[0], 26); h[0] = _mm256_and_si256(h[0], mask);
+    h[1] = Add(h[1], c);
+}
+
+/** Add 4 consecutive 16-byte blocks at m, one per lane, to h. */
+void inline AddBlocks(__m256i h[5], const unsigned char* m)
+{
+    const __m256i mask = _mm256_set1_epi64x(0x3ffffff);
+    const __m256i a = _mm256_loadu_si256((const __m256i*)m);
+    const __m256i b = _mm256_loadu_si256((const __m256i*)(m + 32));
+    // Gather the low and high 64 bits of the 4 blocks, in block order.
+    const __m256i lo = _mm256_permute4x64_epi64(_mm256_unpacklo_epi64(a, b), 0xd8);
+    const __m256i hi = _mm256_permute4x64_epi64(_mm256_unpackhi_epi64(a, b), 0xd8);
+    h[0] = Add(h[0], _mm256_and_si256(lo, mask));
+    h[1] = Add(h[1], _mm256_and_si256(_mm256_srli_epi64(lo, 26), mask));
+    h[2] = Add(h[2], _mm256_and_si256(_mm256_or_si256(_mm256_srli_epi64(lo, 52), _mm256_slli_epi64(hi, 12)), mask));
+    h[3] = Add(h[3], _mm256_and_si256(_mm256_srli_epi64(hi, 14), mask));
+    h[4] = Add(h[4], _mm256_or_si256(_mm256_srli_epi64(hi, 40), _mm256_set1_epi64x(1 << 24)));
+}
+
+} // namespace
+
+void Blocks_4way(uint32_t h[5], const uint32_t r[5], const unsigned char* m, size_t blocks)
+{
+    // Powers r^1..r^4, and lane j's final multiplier r^(4 - j).
+    uint32_t pow[4][5];
+    for (int i = 0; i < 5; ++i) pow[0][i] = r[i];
+    MulMod(pow[1], pow[0], pow[0]);
+    MulMod(pow[2], pow[1], pow[0]);
+    MulMod(pow[3], pow[2], pow[0]);
+
+    __m256i r4[5], s4[5], rf[5], sf[5], acc[5];
+    for (int i = 0; i < 5; ++i) {
+        r4[i] = _mm256_set1_epi64x(pow[3][i]);
+        s4[i] = _mm256_set1_epi64x(pow[3][i] * 5);
+        rf[i] = _mm256_setr_epi64x(pow[3][i], pow[2][i], pow[1][i], pow[0][i]);
+        sf[i] = _mm256_setr_epi64x(pow[3][i] * 5, pow[2][i] * 5, pow[1][i] * 5, pow[0][i] * 5);
+        acc[i] = _mm256_setr_epi64x(h[i], 0, 0, 0);
+    }
+
+    AddBlocks(acc, m);
+    for (blocks -= 4, m += 64; blocks >= 4; blocks -= 4, m += 64) {
+        MulModVec(acc, r4, s4);
+        AddBlocks(acc, m);
+    }
+    MulModVec(acc, rf, sf);
+
+    // Sum the lanes and carry into the partially reduced form the scalar code uses.
+    alignas(32) uint64_t lanes[5][4];
+    uint64_t d[5];
+    for (int i = 0; i < 5; ++i) {
+        _mm256_store_si256((__m256i*)lanes[i], acc[i]);
+        d[i] = lanes[i][0] + lanes[i][1] + lanes[i][2] + lanes[i][3];
+    }
+    uint64_t c;
+    c = d[0] >> 26; h[0] = d[0] & 0x3ffffff;
+    d[1] += c; c = d[1] >> 26; h[1] = d[1] & 0x3ffffff;
+    d[2] += c; c = d[2] >> 26; h[2] = d[2] & 0x3ffffff;
+    d[3] += c; c = d[3] >> 26; h[3] = d[3] & 0x3ffffff;
+    d[4] += c; c = d[4] >> 26; h[4] = d[4] & 0x3ffffff;
+    d[0] = h[0] + c * 5; c = d[0] >> 26; h[0] = d[0] & 0x3ffffff;
+    h[1] += c;
+}
+
+} // namespace poly1305_avx2
+
+#endif
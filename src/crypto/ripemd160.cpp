@@ -2,12 +2,28 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <config/bitcoin-config.h> // IWYU pragma: keep
+
 #include <crypto/ripemd160.h>
 
+#include <compat/cpuid.h>
 #include <crypto/common.h>
 
+#include <assert.h>
 #include <string.h>
 
+#if defined(ENABLE_SSE41)
+namespace ripemd160_sse41 {
+void TransformMulti_4way(uint32_t* s, const unsigned char* const* chunks);
+}
+#endif
+
+#if defined(ENABLE_AVX2)
+namespace ripemd160_avx2 {
+void TransformMulti_8way(uint32_t* s, const unsigned char* const* chunks);
+}
+#endif
+
 // Internal implementation code.
 namespace
 {
@@ -235,8 +251,129 @@ void Transform(uint32_t* s, const unsigned char* chunk)
 
 } // namespace ripemd160
 
+/** Compress the current block of each of several lanes into its state (see RIPEMD160MultiLanes). */
+typedef void (*TransformMultiType)(uint32_t*, const unsigned char* const*);
+
+TransformMultiType TransformMulti_4way = nullptr;
+TransformMultiType TransformMulti_8way = nullptr;
+
+/** Hash messages of arbitrary length using a transform that processes one
+ *  block of each of LANES messages at a time, the same way SHA256Multi does. */
+template <size_t LANES>
+void RIPEMD160MultiLanes(TransformMultiType transform, unsigned char* out, const Span<const unsigned char>* in, size_t count)
+{
+    static const unsigned char idle_chunk[64] = {0};
+    // Word i of the state of lane l is s[i * LANES + l].
+    uint32_t s[5 * LANES];
+    // The final (one or two) blocks of the message of each lane, including padding.
+    unsigned char tail[LANES][128];
+    size_t msg[LANES], block[LANES], full_blocks[LANES], total_blocks[LANES];
+    const unsigned char* chunks[LANES];
+    size_t next{0}, active{0};
+
+    auto start = [&](size_t lane) {
+        msg[lane] = next;
+        if (next == count) return;
+        const Span<const unsigned char> data{in[next++]};
+        ++active;
+        const size_t rem{data.size() % 64};
+        full_blocks[lane] = data.size() / 64;
+        total_blocks[lane] = full_blocks[lane] + (rem + 9 > 64 ? 2 : 1);
+        block[lane] = 0;
+        const size_t tail_size{(total_blocks[lane] - full_blocks[lane]) * 64};
+        if (rem) memcpy(tail[lane], data.data() + full_blocks[lane] * 64, rem);
+        tail[lane][rem] = 0x80;
+        memset(tail[lane] + rem + 1, 0, tail_size - rem - 9);
+        WriteLE64(tail[lane] + tail_size - 8, uint64_t{data.size()} << 3);
+        uint32_t init[5];
+        ripemd160::Initialize(init);
+        for (size_t i = 0; i < 5; ++i) s[i * LANES + lane] = init[i];
+    };
+
+    for (size_t lane = 0; lane < LANES; ++lane) start(lane);
+    while (active) {
+        for (size_t lane = 0; lane < LANES; ++lane) {
+            if (msg[lane] == count) {
+                chunks[lane] = idle_chunk;
+            } else if (block[lane] < full_blocks[lane]) {
+                chunks[lane] = in[msg[lane]].data() + block[lane] * 64;
+            } else {
+                chunks[lane] = tail[lane] + (block[lane] - full_blocks[lane]) * 64;
+            }
+        }
+        transform(s, chunks);
+        for (size_t lane = 0; lane < LANES; ++lane) {
+            if (msg[lane] == count || ++block[lane] < total_blocks[lane]) continue;
+            for (size_t i = 0; i < 5; ++i) WriteLE32(out + msg[lane] * 20 + i * 4, s[i * LANES + lane]);
+            --active;
+            start(lane);
+        }
+    }
+}
+
+/** Check the multi-buffer transforms against the standard one. */
+bool SelfTest(TransformMultiType transform, size_t lanes)
+{
+    uint32_t expected[8][5];
+    uint32_t state[40];
+    unsigned char data[8][64];
+    const unsigned char* chunks[8];
+    for (size_t l = 0; l < lanes; ++l) {
+        for (size_t i = 0; i < 64; ++i) data[l][i] = uint8_t(l * 64 + i);
+        ripemd160::Initialize(expected[l]);
+        // Start each lane at a different state.
+        for (size_t i = 0; i < 5; ++i) expected[l][i] += uint32_t(l);
+        for (size_t i = 0; i < 5; ++i) state[i * lanes + l] = expected[l][i];
+        chunks[l] = data[l];
+        ripemd160::Transform(expected[l], data[l]);
+    }
+    transform(state, chunks);
+    for (size_t l = 0; l < lanes; ++l) {
+        for (size_t i = 0; i < 5; ++i) {
+            if (state[i * lanes + l] != expected[l][i]) return false;
+        }
+    }
+    return true;
+}
+
 } // namespace
 
+std::string RIPEMD160AutoDetect(ripemd160_implementation::UseImplementation use_implementation)
+{
+    std::string ret = "standard";
+    TransformMulti_4way = nullptr;
+    TransformMulti_8way = nullptr;
+
+#if defined(HAVE_GETCPUID)
+    uint32_t eax, ebx, ecx, edx;
+    GetCPUID(1, 0, eax, ebx, ecx, edx);
+    [[maybe_unused]] const bool have_sse41 = ((ecx >> 19) & 1) && (use_implementation & ripemd160_implementation::USE_SSE41);
+    const bool have_xsave_avx = ((ecx >> 27) & 1) && ((ecx >> 28) & 1);
+    [[maybe_unused]] bool have_avx2 = false;
+    if (have_xsave_avx && (GetXCR0() & 0x6) == 0x6) {
+        GetCPUID(7, 0, eax, ebx, ecx, edx);
+        have_avx2 = ((ebx >> 5) & 1) && (use_implementation & ripemd160_implementation::USE_AVX2);
+    }
+
+#if defined(ENABLE_SSE41)
+    if (have_sse41) {
+        TransformMulti_4way = ripemd160_sse41::TransformMulti_4way;
+        ret = "sse41(4way)";
+    }
+#endif
+#if defined(ENABLE_AVX2)
+    if (have_avx2) {
+        TransformMulti_8way = ripemd160_avx2::TransformMulti_8way;
+        ret += ",avx2(8way)";
+    }
+#endif
+#endif // defined(HAVE_GETCPUID)
+
+    assert(!TransformMulti_4way || SelfTest(TransformMulti_4way, 4));
+    assert(!TransformMulti_8way || SelfTest(TransformMulti_8way, 8));
+    return ret;
+}
+
 ////// RIPEMD160
 
 CRIPEMD160::CRIPEMD160()
@@ -290,3 +427,16 @@ CRIPEMD160& CRIPEMD160::Reset()
     ripemd160::Initialize(s);
     return *this;
 }
+
+void RIPEMD160Multi(unsigned char* out, const Span<const unsigned char>* in, size_t count)
+{
+    if (count > 1 && TransformMulti_8way) {
+        RIPEMD160MultiLanes<8>(TransformMulti_8way, out, in, count);
+    } else if (count > 1 && TransformMulti_4way) {
+        RIPEMD160MultiLanes<4>(TransformMulti_4way, out, in, count);
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            CRIPEMD160().Write(in[i].data(), in[i].size()).Finalize(out + i * 20);
+        }
+    }
+}
@@ -5,8 +5,11 @@
 #ifndef BITCOIN_CRYPTO_RIPEMD160_H
 #define BITCOIN_CRYPTO_RIPEMD160_H
 
+#include <span.h>
+
 #include <cstdlib>
 #include <stdint.h>
+#include <string>
 
 /** A hasher class for RIPEMD-160. */
 class CRIPEMD160
@@ -25,4 +28,26 @@ public:
     CRIPEMD160& Reset();
 };
 
+namespace ripemd160_implementation {
+enum UseImplementation : uint8_t {
+    STANDARD = 0,
+    USE_SSE41 = 1 << 0,
+    USE_AVX2 = 1 << 1,
+    USE_ALL = USE_SSE41 | USE_AVX2,
+};
+}
+
+/** Autodetect the best available multi-buffer RIPEMD-160 implementation.
+ *  Returns the name of the implementation.
+ */
+std::string RIPEMD160AutoDetect(ripemd160_implementation::UseImplementation use_implementation = ripemd160_implementation::USE_ALL);
+
+/** Compute the RIPEMD-160's of multiple messages of arbitrary length, hashing
+ *  several of them in parallel where a multi-buffer implementation is available.
+ *  output:  pointer to a count*20 byte output buffer
+ *  input:   pointer to count messages
+ *  count:   the number of hashes to compute.
+ */
+void RIPEMD160Multi(unsigned char* output, const Span<const unsigned char>* input, size_t count);
+
 #endif // BITCOIN_CRYPTO_RIPEMD160_H
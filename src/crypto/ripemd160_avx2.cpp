@@ -0,0 +1,131 @@
+// Copyright (c) 2024 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifdef ENABLE_AVX2
+
+#include <stdint.h>
+#include <immintrin.h>
+
+#include <crypto/common.h>
+
+namespace ripemd160_avx2 {
+namespace {
+
+__m256i inline K(uint32_t x) { return _mm256_set1_epi32(x); }
+
+__m256i inline Add(__m256i x, __m256i y) { return _mm256_add_epi32(x, y); }
+__m256i inline Add(__m256i x, __m256i y, __m256i z) { return Add(Add(x, y), z); }
+__m256i inline Xor(__m256i x, __m256i y) { return _mm256_xor_si256(x, y); }
+__m256i inline Or(__m256i x, __m256i y) { return _mm256_or_si256(x, y); }
+__m256i inline And(__m256i x, __m256i y) { return _mm256_and_si256(x, y); }
+/** ~x & y */
+__m256i inline AndNot(__m256i x, __m256i y) { return _mm256_andnot_si256(x, y); }
+__m256i inline Not(__m256i x) { return Xor(x, K(0xfffffffful)); }
+__m256i inline Rol(__m256i x, int n) { return Or(_mm256_slli_epi32(x, n), _mm256_srli_epi32(x, 32 - n)); }
+
+__m256i inline f1(__m256i x, __m256i y, __m256i z) { return Xor(Xor(x, y), z); }
+__m256i inline f2(__m256i x, __m256i y, __m256i z) { return Or(And(x, y), AndNot(x, z)); }
+__m256i inline f3(__m256i x, __m256i y, __m256i z) { return Xor(Or(x, Not(y)), z); }
+__m256i inline f4(__m256i x, __m256i y, __m256i z) { return Or(And(x, z), AndNot(z, y)); }
+__m256i inline f5(__m256i x, __m256i y, __m256i z) { return Xor(x, Or(y, Not(z))); }
+
+/** Read word offset/4 of the current block of each lane. */
+__m256i inline ReadLanes8(const unsigned char* const* chunks, int offset) {
+    return _mm256_set_epi32(
+        ReadLE32(chunks[7] + offset),
+        ReadLE32(chunks[6] + offset),
+        ReadLE32(chunks[5] + offset),
+        ReadLE32(chunks[4] + offset),
+        ReadLE32(chunks[3] + offset),
+        ReadLE32(chunks[2] + offset),
+        ReadLE32(chunks[1] + offset),
+        ReadLE32(chunks[0] + offset)
+    );
+}
+
+/** Message word and rotation of each step of the left and right lines. */
+const int WORD_LEFT[80] = {
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+    7, 4, 13, 1, 10, 6, 15, 3, 12, 0, 9, 5, 2, 14, 11, 8,
+    3, 10, 14, 4, 9, 15, 8, 1, 2, 7, 0, 6, 13, 11, 5, 12,
+    1, 9, 11, 10, 0, 8, 12, 4, 13, 3, 7, 15, 14, 5, 6, 2,
+    4, 0, 5, 9, 7, 12, 2, 10, 14, 1, 3, 8, 11, 6, 15, 13,
+};
+const int WORD_RIGHT[80] = {
+    5, 14, 7, 0, 9, 2, 11, 4, 13, 6, 15, 8, 1, 10, 3, 12,
+    6, 11, 3, 7, 0, 13, 5, 10, 14, 15, 8, 12, 4, 9, 1, 2,
+    15, 5, 1, 3, 7, 14, 6, 9, 11, 8, 12, 2, 10, 0, 4, 13,
+    8, 6, 4, 1, 3, 11, 15, 0, 5, 12, 2, 13, 9, 7, 10, 14,
+    12, 15, 10, 4, 1, 5, 8, 7, 6, 2, 13, 14, 0, 3, 9, 11,
+};
+const int ROT_LEFT[80] = {
+    11, 14, 15, 12, 5, 8, 7, 9, 11, 13, 14, 15, 6, 7, 9, 8,
+    7, 6, 8, 13, 11, 9, 7, 15, 7, 12, 15, 9, 11, 7, 13, 12,
+    11, 13, 6, 7, 14, 9, 13, 15, 14, 8, 13, 6, 5, 12, 7, 5,
+    11, 12, 14, 15, 14, 15, 9, 8, 9, 14, 5, 6, 8, 6, 5, 12,
+    9, 15, 5, 11, 6, 8, 13, 12, 5, 12, 13, 14, 11, 8, 5, 6,
+};
+const int ROT_RIGHT[80] = {
+    8, 9, 9, 11, 13, 15, 15, 5, 7, 7, 8, 11, 14, 14, 12, 6,
+    9, 13, 15, 7, 12, 8, 9, 11, 7, 7, 12, 7, 6, 15, 13, 11,
+    9, 7, 15, 11, 8, 6, 6, 14, 12, 13, 5, 14, 13, 13, 7, 5,
+    15, 5, 8, 11, 14, 14, 6, 14, 6, 9, 12, 9, 12, 5, 15, 8,
+    8, 5, 12, 9, 12, 5, 14, 6, 8, 13, 6, 5, 15, 13, 11, 11,
+};
+
+/** One step of a line: the five state words move one position to the right. */
+void inline Step(__m256i& a, __m256i& b, __m256i& c, __m256i& d, __m256i& e, __m256i f, __m256i x, __m256i k, int r)
+{
+    const __m256i t = Add(Rol(Add(Add(a, f, x), k), r), e);
+    a = e;
+    e = d;
+    d = Rol(c, 10);
+    c = b;
+    b = t;
+}
+
+}
+
+/** Compress the current block of each of 8 lanes into its state. Word i of lane l's state is s[i * 8 + l]. */
+void TransformMulti_8way(uint32_t* s, const unsigned char* const* chunks)
+{
+    const __m256i s0 = _mm256_loadu_si256((__m256i*)(s + 0)), s1 = _mm256_loadu_si256((__m256i*)(s + 8)), s2 = _mm256_loadu_si256((__m256i*)(s + 16));
+    const __m256i s3 = _mm256_loadu_si256((__m256i*)(s + 24)), s4 = _mm256_loadu_si256((__m256i*)(s + 32));
+    __m256i a1 = s0, b1 = s1, c1 = s2, d1 = s3, e1 = s4;
+    __m256i a2 = s0, b2 = s1, c2 = s2, d2 = s3, e2 = s4;
+
+    __m256i w[16];
+    for (int i = 0; i < 16; ++i) w[i] = ReadLanes8(chunks, 4 * i);
+
+    for (int i = 0; i < 16; ++i) {
+        Step(a1, b1, c1, d1, e1, f1(b1, c1, d1), w[WORD_LEFT[i]], K(0), ROT_LEFT[i]);
+        Step(a2, b2, c2, d2, e2, f5(b2, c2, d2), w[WORD_RIGHT[i]], K(0x50A28BE6ul), ROT_RIGHT[i]);
+    }
+    for (int i = 16; i < 32; ++i) {
+        Step(a1, b1, c1, d1, e1, f2(b1, c1, d1), w[WORD_LEFT[i]], K(0x5A827999ul), ROT_LEFT[i]);
+        Step(a2, b2, c2, d2, e2, f4(b2, c2, d2), w[WORD_RIGHT[i]], K(0x5C4DD124ul), ROT_RIGHT[i]);
+    }
+    for (int i = 32; i < 48; ++i) {
+        Step(a1, b1, c1, d1, e1, f3(b1, c1, d1), w[WORD_LEFT[i]], K(0x6ED9EBA1ul), ROT_LEFT[i]);
+        Step(a2, b2, c2, d2, e2, f3(b2, c2, d2), w[WORD_RIGHT[i]], K(0x6D703EF3ul), ROT_RIGHT[i]);
+    }
+    for (int i = 48; i < 64; ++i) {
+        Step(a1, b1, c1, d1, e1, f4(b1, c1, d1), w[WORD_LEFT[i]], K(0x8F1BBCDCul), ROT_LEFT[i]);
+        Step(a2, b2, c2, d2, e2, f2(b2, c2, d2), w[WORD_RIGHT[i]], K(0x7A6D76E9ul), ROT_RIGHT[i]);
+    }
+    for (int i = 64; i < 80; ++i) {
+        Step(a1, b1, c1, d1, e1, f5(b1, c1, d1), w[WORD_LEFT[i]], K(0xA953FD4Eul), ROT_LEFT[i]);
+        Step(a2, b2, c2, d2, e2, f1(b2, c2, d2), w[WORD_RIGHT[i]], K(0), ROT_RIGHT[i]);
+    }
+
+    _mm256_storeu_si256((__m256i*)(s + 0), Add(s1, c1, d2));
+    _mm256_storeu_si256((__m256i*)(s + 8), Add(s2, d1, e2));
+    _mm256_storeu_si256((__m256i*)(s + 16), Add(s3, e1, a2));
+    _mm256_storeu_si256((__m256i*)(s + 24), Add(s4, a1, b2));
+    _mm256_storeu_si256((__m256i*)(s + 32), Add(s0, b1, c2));
+}
+
+}
+
+#endif
@@ -10,6 +10,8 @@
 #include <assert.h>
 #include <string.h>
 
+#include <vector>
+
 #if !defined(DISABLE_OPTIMIZED_SHA256)
 #include <compat/cpuid.h>
 
@@ -33,11 +35,13 @@ void Transform(uint32_t* s, const unsigned char* chunk, size_t blocks);
 namespace sha256d64_sse41
 {
 void Transform_4way(unsigned char* out, const unsigned char* in);
+void TransformMulti_4way(uint32_t* s, const unsigned char* const* chunks);
 }
 
 namespace sha256d64_avx2
 {
 void Transform_8way(unsigned char* out, const unsigned char* in);
+void TransformMulti_8way(uint32_t* s, const unsigned char* const* chunks);
 }
 
 namespace sha256d64_x86_shani
@@ -438,6 +442,7 @@ void TransformD64(unsigned char* out, const unsigned char* in)
 
 typedef void (*TransformType)(uint32_t*, const unsigned char*, size_t);
 typedef void (*TransformD64Type)(unsigned char*, const unsigned char*);
+typedef void (*TransformMultiType)(uint32_t*, const unsigned char* const*);
 
 template<TransformType tr>
 void TransformD64Wrapper(unsigned char* out, const unsigned char* in)
@@ -483,6 +488,64 @@ TransformD64Type TransformD64 = sha256::TransformD64;
 TransformD64Type TransformD64_2way = nullptr;
 TransformD64Type TransformD64_4way = nullptr;
 TransformD64Type TransformD64_8way = nullptr;
+TransformMultiType TransformMulti_4way = nullptr;
+TransformMultiType TransformMulti_8way = nullptr;
+
+/** Hash messages of arbitrary length using a transform that processes one
+ *  block of each of LANES messages at a time. Whenever a lane finishes its
+ *  message it picks up the next one, so lanes stay busy until the last few
+ *  messages, regardless of how message lengths are distributed. */
+template <size_t LANES>
+void SHA256MultiLanes(TransformMultiType transform, unsigned char* out, const Span<const unsigned char>* in, size_t count)
+{
+    static const unsigned char idle_chunk[64] = {0};
+    // Word i of the state of lane l is s[i * LANES + l].
+    uint32_t s[8 * LANES];
+    // The final (one or two) blocks of the message of each lane, including padding.
+    unsigned char tail[LANES][128];
+    size_t msg[LANES], block[LANES], full_blocks[LANES], total_blocks[LANES];
+    const unsigned char* chunks[LANES];
+    size_t next{0}, active{0};
+
+    auto start = [&](size_t lane) {
+        msg[lane] = next;
+        if (next == count) return;
+        const Span<const unsigned char> data{in[next++]};
+        ++active;
+        const size_t rem{data.size() % 64};
+        full_blocks[lane] = data.size() / 64;
+        total_blocks[lane] = full_blocks[lane] + (rem + 9 > 64 ? 2 : 1);
+        block[lane] = 0;
+        const size_t tail_size{(total_blocks[lane] - full_blocks[lane]) * 64};
+        if (rem) memcpy(tail[lane], data.data() + full_blocks[lane] * 64, rem);
+        tail[lane][rem] = 0x80;
+        memset(tail[lane] + rem + 1, 0, tail_size - rem - 9);
+        WriteBE64(tail[lane] + tail_size - 8, uint64_t{data.size()} << 3);
+        uint32_t init[8];
+        sha256::Initialize(init);
+        for (size_t i = 0; i < 8; ++i) s[i * LANES + lane] = init[i];
+    };
+
+    for (size_t lane = 0; lane < LANES; ++lane) start(lane);
+    while (active) {
+        for (size_t lane = 0; lane < LANES; ++lane) {
+            if (msg[lane] == count) {
+                chunks[lane] = idle_chunk;
+            } else if (block[lane] < full_blocks[lane]) {
+                chunks[lane] = in[msg[lane]].data() + block[lane] * 64;
+            } else {
+                chunks[lane] = tail[lane] + (block[lane] - full_blocks[lane]) * 64;
+            }
+        }
+        transform(s, chunks);
+        for (size_t lane = 0; lane < LANES; ++lane) {
+            if (msg[lane] == count || ++block[lane] < total_blocks[lane]) continue;
+            for (size_t i = 0; i < 8; ++i) WriteBE32(out + msg[lane] * 32 + i * 4, s[i * LANES + lane]);
+            --active;
+            start(lane);
+        }
+    }
+}
 
 bool SelfTest() {
     // Input state (equal to the initial SHA256 state)
@@ -566,6 +629,24 @@ bool SelfTest() {
         if (!std::equal(out, out + 256, result_d64)) return false;
     }
 
+    // Test TransformMulti_4way and TransformMulti_8way, if available, by
+    // starting lane i at the state after i blocks and feeding it block i.
+    for (const auto& [transform, lanes] : {std::pair{TransformMulti_4way, 4}, std::pair{TransformMulti_8way, 8}}) {
+        if (!transform) continue;
+        uint32_t state[64];
+        const unsigned char* chunks[8];
+        for (int l = 0; l < lanes; ++l) {
+            for (int i = 0; i < 8; ++i) state[i * lanes + l] = result[l][i];
+            chunks[l] = data + 1 + l * 64;
+        }
+        transform(state, chunks);
+        for (int l = 0; l < lanes; ++l) {
+            for (int i = 0; i < 8; ++i) {
+                if (state[i * lanes + l] != result[l + 1][i]) return false;
+            }
+        }
+    }
+
     return true;
 }
 
@@ -591,6 +672,8 @@ std::string SHA256AutoDetect(sha256_implementation::UseImplementation use_implem
     TransformD64_2way = nullptr;
     TransformD64_4way = nullptr;
     TransformD64_8way = nullptr;
+    TransformMulti_4way = nullptr;
+    TransformMulti_8way = nullptr;
 
 #if !defined(DISABLE_OPTIMIZED_SHA256)
 #if defined(HAVE_GETCPUID)
@@ -640,6 +723,7 @@ std::string SHA256AutoDetect(sha256_implementation::UseImplementation use_implem
 #endif
 #if defined(ENABLE_SSE41)
         TransformD64_4way = sha256d64_sse41::Transform_4way;
+        TransformMulti_4way = sha256d64_sse41::TransformMulti_4way;
         ret += ",sse41(4way)";
 #endif
     }
@@ -647,6 +731,7 @@ std::string SHA256AutoDetect(sha256_implementation::UseImplementation use_implem
 #if defined(ENABLE_AVX2)
     if (have_avx2 && have_avx && enabled_avx) {
         TransformD64_8way = sha256d64_avx2::Transform_8way;
+        TransformMulti_8way = sha256d64_avx2::TransformMulti_8way;
         ret += ",avx2(8way)";
     }
 #endif
@@ -780,3 +865,26 @@ void SHA256D64(unsigned char* out, const unsigned char* in, size_t blocks)
         --blocks;
     }
 }
+
+void SHA256Multi(unsigned char* out, const Span<const unsigned char>* in, size_t count)
+{
+    if (count > 1 && TransformMulti_8way) {
+        SHA256MultiLanes<8>(TransformMulti_8way, out, in, count);
+    } else if (count > 1 && TransformMulti_4way) {
+        SHA256MultiLanes<4>(TransformMulti_4way, out, in, count);
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            CSHA256().Write(in[i].data(), in[i].size()).Finalize(out + i * 32);
+        }
+    }
+}
+
+void SHA256DMulti(unsigned char* out, const Span<const unsigned char>* in, size_t count)
+{
+    std::vector<unsigned char> first(count * 32);
+    SHA256Multi(first.data(), in, count);
+    std::vector<Span<const unsigned char>> second;
+    second.reserve(count);
+    for (size_t i = 0; i < count; ++i) second.emplace_back(first.data() + i * 32, 32);
+    SHA256Multi(out, second.data(), count);
+}
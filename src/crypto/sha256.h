@@ -5,6 +5,8 @@
 #ifndef BITCOIN_CRYPTO_SHA256_H
 #define BITCOIN_CRYPTO_SHA256_H
 
+#include <span.h>
+
 #include <cstdlib>
 #include <stdint.h>
 #include <string>
@@ -36,6 +38,18 @@ enum UseImplementation : uint8_t {
     USE_SSE4_AND_SHANI = USE_SSE4 | USE_SHANI,
     USE_ALL = USE_SSE4 | USE_AVX2 | USE_SHANI,
 };
+
+/** The SHA-256 round constants, for the implementations that look them up by round. */
+inline constexpr uint32_t ROUND_CONSTANTS[64] = {
+    0x428a2f98ul, 0x71374491ul, 0xb5c0fbcful, 0xe9b5dba5ul, 0x3956c25bul, 0x59f111f1ul, 0x923f82a4ul, 0xab1c5ed5ul,
+    0xd807aa98ul, 0x12835b01ul, 0x243185beul, 0x550c7dc3ul, 0x72be5d74ul, 0x80deb1feul, 0x9bdc06a7ul, 0xc19bf174ul,
+    0xe49b69c1ul, 0xefbe4786ul, 0x0fc19dc6ul, 0x240ca1ccul, 0x2de92c6ful, 0x4a7484aaul, 0x5cb0a9dcul, 0x76f988daul,
+    0x983e5152ul, 0xa831c66dul, 0xb00327c8ul, 0xbf597fc7ul, 0xc6e00bf3ul, 0xd5a79147ul, 0x06ca6351ul, 0x14292967ul,
+    0x27b70a85ul, 0x2e1b2138ul, 0x4d2c6dfcul, 0x53380d13ul, 0x650a7354ul, 0x766a0abbul, 0x81c2c92eul, 0x92722c85ul,
+    0xa2bfe8a1ul, 0xa81a664bul, 0xc24b8b70ul, 0xc76c51a3ul, 0xd192e819ul, 0xd6990624ul, 0xf40e3585ul, 0x106aa070ul,
+    0x19a4c116ul, 0x1e376c08ul, 0x2748774cul, 0x34b0bcb5ul, 0x391c0cb3ul, 0x4ed8aa4aul, 0x5b9cca4ful, 0x682e6ff3ul,
+    0x748f82eeul, 0x78a5636ful, 0x84c87814ul, 0x8cc70208ul, 0x90befffaul, 0xa4506cebul, 0xbef9a3f7ul, 0xc67178f2ul,
+};
 }
 
 /** Autodetect the best available SHA256 implementation.
@@ -50,4 +64,15 @@ std::string SHA256AutoDetect(sha256_implementation::UseImplementation use_implem
  */
 void SHA256D64(unsigned char* output, const unsigned char* input, size_t blocks);
 
+/** Compute the SHA256's of multiple messages of arbitrary length, hashing
+ *  several of them in parallel where a multi-buffer implementation is available.
+ *  output:  pointer to a count*32 byte output buffer
+ *  input:   pointer to count messages
+ *  count:   the number of hashes to compute.
+ */
+void SHA256Multi(unsigned char* output, const Span<const unsigned char>* input, size_t count);
+
+/** Compute the double-SHA256's of multiple messages of arbitrary length (see SHA256Multi). */
+void SHA256DMulti(unsigned char* output, const Span<const unsigned char>* input, size_t count);
+
 #endif // BITCOIN_CRYPTO_SHA256_H
@@ -9,6 +9,7 @@
 
 #include <attributes.h>
 #include <crypto/common.h>
+#include <crypto/sha256.h>
 
 namespace sha256d64_sse41 {
 namespace {
@@ -63,6 +64,16 @@ void inline Write4(unsigned char* out, int offset, __m128i v) {
     WriteLE32(out + 96 + offset, _mm_extract_epi32(v, 0));
 }
 
+/** Read word offset/4 of the current block of each lane. */
+__m128i inline ReadLanes4(const unsigned char* const* chunks, int offset) {
+    return _mm_set_epi32(
+        ReadBE32(chunks[3] + offset),
+        ReadBE32(chunks[2] + offset),
+        ReadBE32(chunks[1] + offset),
+        ReadBE32(chunks[0] + offset)
+    );
+}
+
 }
 
 void Transform_4way(unsigned char* out, const unsigned char* in)
@@ -316,6 +327,42 @@ void Transform_4way(unsigned char* out, const unsigned char* in)
     Write4(out, 28, Add(h, K(0x5be0cd19ul)));
 }
 
+
+/** Compress the current block of each of 4 lanes into its state. Word i of lane l's state is s[i * 4 + l]. */
+void TransformMulti_4way(uint32_t* s, const unsigned char* const* chunks)
+{
+    const __m128i s0 = _mm_loadu_si128((__m128i*)(s + 0)), s1 = _mm_loadu_si128((__m128i*)(s + 4)), s2 = _mm_loadu_si128((__m128i*)(s + 8)), s3 = _mm_loadu_si128((__m128i*)(s + 12));
+    const __m128i s4 = _mm_loadu_si128((__m128i*)(s + 16)), s5 = _mm_loadu_si128((__m128i*)(s + 20)), s6 = _mm_loadu_si128((__m128i*)(s + 24)), s7 = _mm_loadu_si128((__m128i*)(s + 28));
+    __m128i a = s0, b = s1, c = s2, d = s3, e = s4, f = s5, g = s6, h = s7;
+
+    __m128i w[16];
+    for (int i = 0; i < 16; ++i) w[i] = ReadLanes4(chunks, 4 * i);
+    for (int i = 0; i < 64; i += 8) {
+        if (i >= 16) {
+            for (int j = i; j < i + 8; ++j) {
+                Inc(w[j & 15], sigma1(w[(j + 14) & 15]), w[(j + 9) & 15], sigma0(w[(j + 1) & 15]));
+            }
+        }
+        Round(a, b, c, d, e, f, g, h, Add(K(sha256_implementation::ROUND_CONSTANTS[i + 0]), w[(i + 0) & 15]));
+        Round(h, a, b, c, d, e, f, g, Add(K(sha256_implementation::ROUND_CONSTANTS[i + 1]), w[(i + 1) & 15]));
+        Round(g, h, a, b, c, d, e, f, Add(K(sha256_implementation::ROUND_CONSTANTS[i + 2]), w[(i + 2) & 15]));
+        Round(f, g, h, a, b, c, d, e, Add(K(sha256_implementation::ROUND_CONSTANTS[i + 3]), w[(i + 3) & 15]));
+        Round(e, f, g, h, a, b, c, d, Add(K(sha256_implementation::ROUND_CONSTANTS[i + 4]), w[(i + 4) & 15]));
+        Round(d, e, f, g, h, a, b, c, Add(K(sha256_implementation::ROUND_CONSTANTS[i + 5]), w[(i + 5) & 15]));
+        Round(c, d, e, f, g, h, a, b, Add(K(sha256_implementation::ROUND_CONSTANTS[i + 6]), w[(i + 6) & 15]));
+        Round(b, c, d, e, f, g, h, a, Add(K(sha256_implementation::ROUND_CONSTANTS[i + 7]), w[(i + 7) & 15]));
+    }
+
+    _mm_storeu_si128((__m128i*)(s + 0), Add(a, s0));
+    _mm_storeu_si128((__m128i*)(s + 4), Add(b, s1));
+    _mm_storeu_si128((__m128i*)(s + 8), Add(c, s2));
+    _mm_storeu_si128((__m128i*)(s + 12), Add(d, s3));
+    _mm_storeu_si128((__m128i*)(s + 16), Add(e, s4));
+    _mm_storeu_si128((__m128i*)(s + 20), Add(f, s5));
+    _mm_storeu_si128((__m128i*)(s + 24), Add(g, s6));
+    _mm_storeu_si128((__m128i*)(s + 28), Add(h, s7));
+}
+
 }
 
 #endif
@@ -2,10 +2,25 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <config/bitcoin-config.h> // IWYU pragma: keep
+
 #include <crypto/siphash.h>
 
+#include <compat/cpuid.h>
+
 #include <bit>
 
+#if defined(ENABLE_AVX2)
+namespace siphash_avx2 {
+void Uint256_4way(uint64_t k0, uint64_t k1, const unsigned char* const* in, uint64_t* out);
+}
+#endif
+
+namespace {
+/** Hash 4 32-byte values at once, or nullptr if no vectorized implementation is available. */
+void (*Uint256_4way)(uint64_t k0, uint64_t k1, const unsigned char* const* in, uint64_t* out) = nullptr;
+} // namespace
+
 #define SIPROUND do { \
     v0 += v1; v1 = std::rotl(v1, 13); v1 ^= v0; \
     v0 = std::rotl(v0, 32); \
@@ -172,3 +187,40 @@ uint64_t SipHashUint256Extra(uint64_t k0, uint64_t k1, const uint256& val, uint3
     SIPROUND;
     return v0 ^ v1 ^ v2 ^ v3;
 }
+
+void SipHashUint256Multi(uint64_t k0, uint64_t k1, Span<const uint256* const> vals, Span<uint64_t> out)
+{
+    assert(vals.size() == out.size());
+    if (Uint256_4way) {
+        while (vals.size() >= 4) {
+            const unsigned char* in[4] = {vals[0]->data(), vals[1]->data(), vals[2]->data(), vals[3]->data()};
+            Uint256_4way(k0, k1, in, out.data());
+            vals = vals.subspan(4);
+            out = out.subspan(4);
+        }
+    }
+    for (size_t i = 0; i < vals.size(); ++i) {
+        out[i] = SipHashUint256(k0, k1, *vals[i]);
+    }
+}
+
+std::string SipHashAutoDetect(siphash_implementation::UseImplementation use_implementation)
+{
+    std::string ret = "standard";
+    Uint256_4way = nullptr;
+
+#if defined(HAVE_GETCPUID) && defined(ENABLE_AVX2)
+    uint32_t eax, ebx, ecx, edx;
+    GetCPUID(1, 0, eax, ebx, ecx, edx);
+    const bool have_xsave_avx = ((ecx >> 27) & 1) && ((ecx >> 28) & 1);
+    if (have_xsave_avx && (GetXCR0() & 0x6) == 0x6) {
+        GetCPUID(7, 0, eax, ebx, ecx, edx);
+        if (((ebx >> 5) & 1) && (use_implementation & siphash_implementation::USE_AVX2)) {
+            Uint256_4way = siphash_avx2::Uint256_4way;
+            ret = "avx2(4way)";
+        }
+    }
+#endif
+
+    return ret;
+}
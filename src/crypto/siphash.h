@@ -10,6 +10,8 @@
 #include <span.h>
 #include <uint256.h>
 
+#include <string>
+
 /** SipHash-2-4 */
 class CSipHasher
 {
@@ -45,4 +47,23 @@ public:
 uint64_t SipHashUint256(uint64_t k0, uint64_t k1, const uint256& val);
 uint64_t SipHashUint256Extra(uint64_t k0, uint64_t k1, const uint256& val, uint32_t extra);
 
+/** Compute SipHashUint256(k0, k1, *vals[i]) into out[i] for all i, hashing
+ *  several values at once where a vectorized implementation is available.
+ *  vals and out must have the same size.
+ */
+void SipHashUint256Multi(uint64_t k0, uint64_t k1, Span<const uint256* const> vals, Span<uint64_t> out);
+
+namespace siphash_implementation {
+enum UseImplementation : uint8_t {
+    STANDARD = 0,
+    USE_AVX2 = 1 << 0,
+    USE_ALL = USE_AVX2,
+};
+}
+
+/** Autodetect the best available SipHashUint256Multi implementation.
+ *  Returns the name of the implementation.
+ */
+std::string SipHashAutoDetect(siphash_implementation::UseImplementation use_implementation = siphash_implementation::USE_ALL);
+
 #endif // BITCOIN_CRYPTO_SIPHASH_H
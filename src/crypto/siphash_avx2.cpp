@@ -0,0 +1,82 @@
+// Copyright (c) 2024 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// SipHash-2-4 of 4 independent 32-byte inputs at once, one per 64-bit lane.
+
+#ifdef ENABLE_AVX2
+
+#include <stdint.h>
+#include <immintrin.h>
+
+namespace siphash_avx2 {
+namespace {
+
+__m256i inline K(uint64_t x) { return _mm256_set1_epi64x(x); }
+__m256i inline Add(__m256i x, __m256i y) { return _mm256_add_epi64(x, y); }
+__m256i inline Xor(__m256i x, __m256i y) { return _mm256_xor_si256(x, y); }
+
+template <int N>
+__m256i inline Rotl(__m256i x) { return _mm256_or_si256(_mm256_slli_epi64(x, N), _mm256_srli_epi64(x, 64 - N)); }
+template <>
+__m256i inline Rotl<16>(__m256i x)
+{
+    return _mm256_shuffle_epi8(x, _mm256_setr_epi8(6, 7, 0, 1, 2, 3, 4, 5, 14, 15, 8, 9, 10, 11, 12, 13,
+                                                   6, 7, 0, 1, 2, 3, 4, 5, 14, 15, 8, 9, 10, 11, 12, 13));
+}
+template <>
+__m256i inline Rotl<32>(__m256i x) { return _mm256_shuffle_epi32(x, 0xb1); }
+
+void inline SipRound(__m256i& v0, __m256i& v1, __m256i& v2, __m256i& v3)
+{
+    v0 = Add(v0, v1); v1 = Rotl<13>(v1); v1 = Xor(v1, v0);
+    v0 = Rotl<32>(v0);
+    v2 = Add(v2, v3); v3 = Rotl<16>(v3); v3 = Xor(v3, v2);
+    v0 = Add(v0, v3); v3 = Rotl<21>(v3); v3 = Xor(v3, v0);
+    v2 = Add(v2, v1); v1 = Rotl<17>(v1); v1 = Xor(v1, v2);
+    v2 = Rotl<32>(v2);
+}
+
+void inline Compress(__m256i& v0, __m256i& v1, __m256i& v2, __m256i& v3, __m256i d)
+{
+    v3 = Xor(v3, d);
+    SipRound(v0, v1, v2, v3);
+    SipRound(v0, v1, v2, v3);
+    v0 = Xor(v0, d);
+}
+
+} // namespace
+
+void Uint256_4way(uint64_t k0, uint64_t k1, const unsigned char* const* in, uint64_t* out)
+{
+    // Transpose the 4 inputs so that d[j] holds their j-th 64-bit words.
+    const __m256i r0 = _mm256_loadu_si256((const __m256i*)in[0]);
+    const __m256i r1 = _mm256_loadu_si256((const __m256i*)in[1]);
+    const __m256i r2 = _mm256_loadu_si256((const __m256i*)in[2]);
+    const __m256i r3 = _mm256_loadu_si256((const __m256i*)in[3]);
+    const __m256i t0 = _mm256_unpacklo_epi64(r0, r1), t1 = _mm256_unpacklo_epi64(r2, r3);
+    const __m256i t2 = _mm256_unpackhi_epi64(r0, r1), t3 = _mm256_unpackhi_epi64(r2, r3);
+    const __m256i d[4] = {
+        _mm256_permute2x128_si256(t0, t1, 0x20),
+        _mm256_permute2x128_si256(t2, t3, 0x20),
+        _mm256_permute2x128_si256(t0, t1, 0x31),
+        _mm256_permute2x128_si256(t2, t3, 0x31),
+    };
+
+    __m256i v0 = K(0x736f6d6570736575ULL ^ k0);
+    __m256i v1 = K(0x646f72616e646f6dULL ^ k1);
+    __m256i v2 = K(0x6c7967656e657261ULL ^ k0);
+    __m256i v3 = K(0x7465646279746573ULL ^ k1);
+    for (int j = 0; j < 4; ++j) Compress(v0, v1, v2, v3, d[j]);
+    Compress(v0, v1, v2, v3, K(uint64_t{4} << 59));
+    v2 = Xor(v2, K(0xFF));
+    SipRound(v0, v1, v2, v3);
+    SipRound(v0, v1, v2, v3);
+    SipRound(v0, v1, v2, v3);
+    SipRound(v0, v1, v2, v3);
+    _mm256_storeu_si256((__m256i*)out, Xor(Xor(v0, v1), Xor(v2, v3)));
+}
+
+} // namespace siphash_avx2
+
+#endif
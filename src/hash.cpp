@@ -82,6 +82,25 @@ uint256 SHA256Uint256(const uint256& input)
     return result;
 }
 
+std::vector<uint160> Hash160Multi(Span<const Span<const unsigned char>> inputs)
+{
+    std::vector<unsigned char> sha256(inputs.size() * CSHA256::OUTPUT_SIZE);
+    SHA256Multi(sha256.data(), inputs.data(), inputs.size());
+    std::vector<Span<const unsigned char>> digests;
+    digests.reserve(inputs.size());
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        digests.push_back(Span{sha256}.subspan(i * CSHA256::OUTPUT_SIZE, CSHA256::OUTPUT_SIZE));
+    }
+    std::vector<unsigned char> ripemd160(inputs.size() * CRIPEMD160::OUTPUT_SIZE);
+    RIPEMD160Multi(ripemd160.data(), digests.data(), digests.size());
+    std::vector<uint160> result;
+    result.reserve(inputs.size());
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        result.emplace_back(Span{ripemd160}.subspan(i * CRIPEMD160::OUTPUT_SIZE, CRIPEMD160::OUTPUT_SIZE));
+    }
+    return result;
+}
+
 HashWriter TaggedHash(const std::string& tag)
 {
     HashWriter writer{};
@@ -96,6 +96,11 @@ inline uint160 Hash160(const T1& in1)
     return result;
 }
 
+/** Compute the 160-bit hashes of multiple byte arrays. This is faster than
+ *  hashing them one by one where multi-buffer SHA-256 or RIPEMD-160
+ *  implementations are available (see SHA256Multi and RIPEMD160Multi). */
+std::vector<uint160> Hash160Multi(Span<const Span<const unsigned char>> inputs);
+
 /** A writer stream (for serialization) that computes a 256-bit hash. */
 class HashWriter
 {
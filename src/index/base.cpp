@@ -88,7 +88,7 @@ bool BaseIndex::Init()
         return &m_chain->context()->chainman->GetChainstateForIndexing());
     // Register to validation interface before setting the 'm_synced' flag, so that
     // callbacks are not missed once m_synced is true.
-    m_chain->context()->validation_signals->RegisterValidationInterface(this);
+    m_chain->context()->validation_signals->RegisterValidationInterface(this, GetName());
 
     CBlockLocator locator;
     if (!GetDB().ReadBestBlock(locator)) {
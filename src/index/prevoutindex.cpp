@@ -0,0 +1,162 @@
+// Copyright (c) 2024 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/prevoutindex.h>
+
+#include <chain.h>
+#include <common/args.h>
+#include <logging.h>
+#include <node/blockstorage.h>
+#include <validation.h>
+
+constexpr uint8_t DB_PREVOUTS{'p'};
+
+std::unique_ptr<PrevoutIndex> g_prevout_index;
+
+
+/** Access to the prevout index database (indexes/prevoutindex/) */
+class PrevoutIndex::DB : public BaseIndex::DB
+{
+public:
+    explicit DB(size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    /// Read the spent outputs of the transaction with the given hash. Returns
+    /// false if the transaction hash is not indexed.
+    bool ReadPrevouts(const uint256& txid, TxPrevouts& prevouts) const;
+
+    /// Write the spent outputs of all transactions of a block to the DB.
+    [[nodiscard]] bool WritePrevouts(const std::vector<std::pair<uint256, TxPrevouts>>& v_prevouts);
+
+    /// Erase the entries of all transactions of a disconnected block.
+    [[nodiscard]] bool ErasePrevouts(const CBlock& block);
+};
+
+PrevoutIndex::DB::DB(size_t n_cache_size, bool f_memory, bool f_wipe) :
+    BaseIndex::DB(gArgs.GetDataDirNet() / "indexes" / "prevoutindex", n_cache_size, f_memory, f_wipe)
+{}
+
+bool PrevoutIndex::DB::ReadPrevouts(const uint256& txid, TxPrevouts& prevouts) const
+{
+    return Read(std::make_pair(DB_PREVOUTS, txid), prevouts);
+}
+
+bool PrevoutIndex::DB::WritePrevouts(const std::vector<std::pair<uint256, TxPrevouts>>& v_prevouts)
+{
+    CDBBatch batch(*this);
+    for (const auto& [txid, prevouts] : v_prevouts) {
+        batch.Write(std::make_pair(DB_PREVOUTS, txid), prevouts);
+    }
+    return WriteBatch(batch);
+}
+
+bool PrevoutIndex::DB::ErasePrevouts(const CBlock& block)
+{
+    CDBBatch batch(*this);
+    for (const auto& tx : block.vtx) {
+        if (tx->IsCoinBase()) continue;
+        batch.Erase(std::make_pair(DB_PREVOUTS, tx->GetHash()));
+    }
+    return WriteBatch(batch);
+}
+
+PrevoutIndex::PrevoutIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory, bool f_wipe)
+    : BaseIndex(std::move(chain), "prevoutindex"), m_db(std::make_unique<PrevoutIndex::DB>(n_cache_size, f_memory, f_wipe))
+{}
+
+PrevoutIndex::~PrevoutIndex() = default;
+
+bool PrevoutIndex::CustomAppend(const interfaces::BlockInfo& block)
+{
+    // The genesis block does not spend any outputs and has no undo data.
+    if (block.height == 0) return true;
+
+    assert(block.data);
+    if (block.data->vtx.size() <= 1) return true;
+
+    CBlockUndo block_undo;
+    const CBlockIndex* pindex = WITH_LOCK(cs_main, return m_chainstate->m_blockman.LookupBlockIndex(block.hash));
+    if (!m_chainstate->m_blockman.UndoReadFromDisk(block_undo, *pindex)) {
+        return false;
+    }
+    if (block_undo.vtxundo.size() + 1 != block.data->vtx.size()) {
+        LogError("%s: undo data of block %s does not match its transactions\n", __func__, block.hash.ToString());
+        return false;
+    }
+
+    std::vector<std::pair<uint256, TxPrevouts>> v_prevouts;
+    v_prevouts.reserve(block_undo.vtxundo.size());
+    for (size_t i = 1; i < block.data->vtx.size(); ++i) {
+        const auto& tx{block.data->vtx[i]};
+        TxPrevouts prevouts;
+        prevouts.height = block.height;
+        prevouts.undo = std::move(block_undo.vtxundo[i - 1]);
+        for (const Coin& coin : prevouts.undo.vprevout) {
+            prevouts.fee += coin.out.nValue;
+        }
+        prevouts.fee -= tx->GetValueOut();
+        v_prevouts.emplace_back(tx->GetHash(), std::move(prevouts));
+    }
+    return m_db->WritePrevouts(v_prevouts);
+}
+
+bool PrevoutIndex::CustomRewind(const interfaces::BlockKey& current_tip, const interfaces::BlockKey& new_tip)
+{
+    // Unlike the txindex, entries of disconnected blocks are erased, because
+    // the height of the spending block (and of the spent outputs) may differ
+    // when the same transaction is confirmed again on the new chain.
+    LOCK(cs_main);
+    const CBlockIndex* iter_tip{m_chainstate->m_blockman.LookupBlockIndex(current_tip.hash)};
+    const CBlockIndex* new_tip_index{m_chainstate->m_blockman.LookupBlockIndex(new_tip.hash)};
+
+    do {
+        CBlock block;
+        if (!m_chainstate->m_blockman.ReadBlockFromDisk(block, *iter_tip)) {
+            LogError("%s: Failed to read block %s from disk\n",
+                     __func__, iter_tip->GetBlockHash().ToString());
+            return false;
+        }
+        if (!m_db->ErasePrevouts(block)) {
+            return false;
+        }
+        iter_tip = iter_tip->GetAncestor(iter_tip->nHeight - 1);
+    } while (new_tip_index != iter_tip);
+
+    return true;
+}
+
+BaseIndex::DB& PrevoutIndex::GetDB() const { return *m_db; }
+
+bool PrevoutIndex::IsOnActiveChain() const
+{
+    const IndexSummary summary{GetSummary()};
+    LOCK(cs_main);
+    const CBlockIndex* best_block{m_chainstate->m_blockman.LookupBlockIndex(summary.best_block_hash)};
+    return best_block && m_chainstate->m_chain.Contains(best_block);
+}
+
+bool PrevoutIndex::FindTxPrevouts(const uint256& txid, TxPrevouts& prevouts) const
+{
+    // Entries of disconnected blocks are erased on rewind, so every entry
+    // belongs to the chain the index is synced to.
+    return m_db->ReadPrevouts(txid, prevouts) && IsOnActiveChain();
+}
+
+bool PrevoutIndex::FindBlockPrevouts(const CBlockIndex& block_index, const CBlock& block, CBlockUndo& block_undo) const
+{
+    if (WITH_LOCK(cs_main, return !m_chainstate->m_chain.Contains(&block_index))) return false;
+    if (!IsOnActiveChain()) return false;
+
+    block_undo.vtxundo.clear();
+    block_undo.vtxundo.reserve(block.vtx.size() > 0 ? block.vtx.size() - 1 : 0);
+    for (size_t i = 1; i < block.vtx.size(); ++i) {
+        TxPrevouts prevouts;
+        if (!m_db->ReadPrevouts(block.vtx[i]->GetHash(), prevouts) ||
+            prevouts.height != block_index.nHeight ||
+            prevouts.undo.vprevout.size() != block.vtx[i]->vin.size()) {
+            return false;
+        }
+        block_undo.vtxundo.push_back(std::move(prevouts.undo));
+    }
+    return true;
+}
@@ -0,0 +1,85 @@
+// Copyright (c) 2024 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_INDEX_PREVOUTINDEX_H
+#define BITCOIN_INDEX_PREVOUTINDEX_H
+
+#include <consensus/amount.h>
+#include <index/base.h>
+#include <serialize.h>
+#include <undo.h>
+
+class CBlock;
+class CBlockIndex;
+
+static constexpr bool DEFAULT_PREVOUTINDEX{false};
+
+/** Outputs spent by a confirmed transaction, as stored in the prevout index. */
+struct TxPrevouts {
+    //! Height of the block the spending transaction is confirmed in
+    int height{0};
+    //! Transaction fee, i.e. the sum of spent outputs minus the sum of created outputs
+    CAmount fee{0};
+    //! Spent outputs (value, scriptPubKey, creation height), in input order
+    CTxUndo undo;
+
+    SERIALIZE_METHODS(TxPrevouts, obj)
+    {
+        READWRITE(VARINT_MODE(obj.height, VarIntMode::NONNEGATIVE_SIGNED));
+        READWRITE(VARINT_MODE(obj.fee, VarIntMode::NONNEGATIVE_SIGNED));
+        READWRITE(obj.undo);
+    }
+};
+
+/**
+ * PrevoutIndex maps each confirmed non-coinbase transaction to the outputs
+ * spent by its inputs. It allows resolving prevouts (and therefore fees) of
+ * confirmed transactions with a single database lookup, without reading block
+ * undo data from disk.
+ */
+class PrevoutIndex final : public BaseIndex
+{
+protected:
+    class DB;
+
+private:
+    const std::unique_ptr<DB> m_db;
+
+    bool AllowPrune() const override { return true; }
+
+    /// Whether the chain the index is synced to is (a prefix of) the active chain.
+    bool IsOnActiveChain() const;
+
+protected:
+    bool CustomAppend(const interfaces::BlockInfo& block) override;
+
+    bool CustomRewind(const interfaces::BlockKey& current_tip, const interfaces::BlockKey& new_tip) override;
+
+    BaseIndex::DB& GetDB() const override;
+
+public:
+    /// Constructs the index, which becomes available to be queried.
+    explicit PrevoutIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    // Destructor is declared because this class contains a unique_ptr to an incomplete type.
+    virtual ~PrevoutIndex() override;
+
+    /// Look up the outputs spent by a transaction confirmed in the active chain.
+    ///
+    /// @param[in]   txid      The hash of the spending transaction.
+    /// @param[out]  prevouts  The spent outputs, the fee and the confirmation height.
+    /// @return  true if the transaction is found, false otherwise
+    bool FindTxPrevouts(const uint256& txid, TxPrevouts& prevouts) const;
+
+    /// Look up the outputs spent by all transactions of a block in the active
+    /// chain, in the same format as the block's undo data.
+    ///
+    /// @return  true if all transactions of the block are indexed, false otherwise
+    bool FindBlockPrevouts(const CBlockIndex& block_index, const CBlock& block, CBlockUndo& block_undo) const;
+};
+
+/// The global prevout index. May be null.
+extern std::unique_ptr<PrevoutIndex> g_prevout_index;
+
+#endif // BITCOIN_INDEX_PREVOUTINDEX_H
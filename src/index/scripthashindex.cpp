@@ -0,0 +1,319 @@
+// Copyright (c) 2024 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/scripthashindex.h>
+
+#include <chain.h>
+#include <common/args.h>
+#include <crypto/sha256.h>
+#include <logging.h>
+#include <node/blockstorage.h>
+#include <script/script.h>
+#include <serialize.h>
+#include <txdb.h>
+#include <undo.h>
+#include <validation.h>
+
+#include <algorithm>
+#include <map>
+#include <tuple>
+
+static constexpr uint8_t DB_SCRIPT_EVENT{'e'};
+static constexpr uint8_t DB_TX{'t'};
+
+std::unique_ptr<ScriptHashIndex> g_scripthash_index;
+
+namespace {
+
+/** Key of a funding or spending event. All fixed-size integers are stored big
+ * endian, so that the events of a script are iterated in block order. */
+struct DBEventKey {
+    uint256 script_hash;
+    uint32_t height{0};
+    uint32_t tx_pos{0};
+    uint8_t type{0};
+    uint32_t index{0};
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        ser_writedata8(s, DB_SCRIPT_EVENT);
+        s << script_hash;
+        ser_writedata32be(s, height);
+        ser_writedata32be(s, tx_pos);
+        ser_writedata8(s, type);
+        ser_writedata32be(s, index);
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        const uint8_t prefix{ser_readdata8(s)};
+        if (prefix != DB_SCRIPT_EVENT) {
+            throw std::ios_base::failure("Invalid format for scripthashindex DB event key");
+        }
+        s >> script_hash;
+        height = ser_readdata32be(s);
+        tx_pos = ser_readdata32be(s);
+        type = ser_readdata8(s);
+        index = ser_readdata32be(s);
+    }
+};
+
+/** Key of the txid of the transaction at a given position in a block. */
+struct DBTxKey {
+    uint32_t height{0};
+    uint32_t tx_pos{0};
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        ser_writedata8(s, DB_TX);
+        ser_writedata32be(s, height);
+        ser_writedata32be(s, tx_pos);
+    }
+};
+
+/** Value of a funding event: the created amount. */
+struct DBFundingValue {
+    CAmount value{0};
+
+    SERIALIZE_METHODS(DBFundingValue, obj) { READWRITE(VARINT_MODE(obj.value, VarIntMode::NONNEGATIVE_SIGNED)); }
+};
+
+/** Value of a spending event: the spent amount and outpoint. */
+struct DBSpendingValue {
+    CAmount value{0};
+    COutPoint prevout;
+
+    SERIALIZE_METHODS(DBSpendingValue, obj)
+    {
+        READWRITE(VARINT_MODE(obj.value, VarIntMode::NONNEGATIVE_SIGNED), obj.prevout);
+    }
+};
+
+} // namespace
+
+/** Access to the script hash index database (indexes/scripthashindex/) */
+class ScriptHashIndex::DB : public BaseIndex::DB
+{
+public:
+    explicit DB(size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    /// Queue the entries of a connected block in a batch.
+    void WriteBlock(CDBBatch& batch, const CBlock& block, const CBlockUndo& block_undo, int height);
+
+    /// Queue the removal of the entries of a disconnected block in a batch.
+    void EraseBlock(CDBBatch& batch, const CBlock& block, const CBlockUndo& block_undo, int height);
+};
+
+ScriptHashIndex::DB::DB(size_t n_cache_size, bool f_memory, bool f_wipe) :
+    BaseIndex::DB(gArgs.GetDataDirNet() / "indexes" / "scripthashindex", n_cache_size, f_memory, f_wipe)
+{}
+
+/** Call fn(key, value, spent_outpoint) for all events of a block. */
+template <typename Fn>
+static void ForEachEvent(const CBlock& block, const CBlockUndo& block_undo, int height, Fn fn)
+{
+    for (uint32_t tx_pos = 0; tx_pos < block.vtx.size(); ++tx_pos) {
+        const CTransaction& tx{*block.vtx[tx_pos]};
+        for (uint32_t n = 0; n < tx.vout.size(); ++n) {
+            const CTxOut& out{tx.vout[n]};
+            if (out.scriptPubKey.IsUnspendable()) continue;
+            fn(DBEventKey{ScriptHashIndex::GetScriptHash(out.scriptPubKey), uint32_t(height), tx_pos, uint8_t(ScriptEvent::Type::FUNDING), n},
+               out.nValue, nullptr);
+        }
+        // The coinbase transaction doesn't have undo data
+        if (tx_pos == 0) continue;
+        const CTxUndo& tx_undo{block_undo.vtxundo.at(tx_pos - 1)};
+        for (uint32_t n = 0; n < tx.vin.size(); ++n) {
+            const CTxOut& prev_out{tx_undo.vprevout.at(n).out};
+            fn(DBEventKey{ScriptHashIndex::GetScriptHash(prev_out.scriptPubKey), uint32_t(height), tx_pos, uint8_t(ScriptEvent::Type::SPENDING), n},
+               prev_out.nValue, &tx.vin[n].prevout);
+        }
+    }
+}
+
+void ScriptHashIndex::DB::WriteBlock(CDBBatch& batch, const CBlock& block, const CBlockUndo& block_undo, int height)
+{
+    for (uint32_t tx_pos = 0; tx_pos < block.vtx.size(); ++tx_pos) {
+        batch.Write(DBTxKey{uint32_t(height), tx_pos}, block.vtx[tx_pos]->GetHash());
+    }
+    ForEachEvent(block, block_undo, height, [&](const DBEventKey& key, CAmount value, const COutPoint* prevout) {
+        if (prevout) {
+            batch.Write(key, DBSpendingValue{value, *prevout});
+        } else {
+            batch.Write(key, DBFundingValue{value});
+        }
+    });
+}
+
+void ScriptHashIndex::DB::EraseBlock(CDBBatch& batch, const CBlock& block, const CBlockUndo& block_undo, int height)
+{
+    for (uint32_t tx_pos = 0; tx_pos < block.vtx.size(); ++tx_pos) {
+        batch.Erase(DBTxKey{uint32_t(height), tx_pos});
+    }
+    ForEachEvent(block, block_undo, height, [&](const DBEventKey& key, CAmount, const COutPoint*) {
+        batch.Erase(key);
+    });
+}
+
+ScriptHashIndex::ScriptHashIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory, bool f_wipe)
+    : BaseIndex(std::move(chain), "scripthashindex"),
+      m_db(std::make_unique<ScriptHashIndex::DB>(n_cache_size, f_memory, f_wipe)),
+      m_batch(std::make_unique<CDBBatch>(*m_db)),
+      m_max_batch_size(gArgs.GetIntArg("-dbbatchsize", nDefaultDbBatchSize))
+{}
+
+ScriptHashIndex::~ScriptHashIndex() = default;
+
+uint256 ScriptHashIndex::GetScriptHash(const CScript& script)
+{
+    uint256 hash;
+    CSHA256().Write(script.data(), script.size()).Finalize(hash.begin());
+    return hash;
+}
+
+bool ScriptHashIndex::FlushBatch()
+{
+    if (m_batch->SizeEstimate() == 0) return true;
+    if (!m_db->WriteBatch(*m_batch)) return false;
+    m_batch->Clear();
+    return true;
+}
+
+bool ScriptHashIndex::CustomAppend(const interfaces::BlockInfo& block)
+{
+    // Exclude genesis block transaction because outputs are not spendable.
+    if (block.height == 0) return true;
+
+    assert(block.data);
+    CBlockUndo block_undo;
+    if (block.data->vtx.size() > 1) {
+        const CBlockIndex* pindex = WITH_LOCK(cs_main, return m_chainstate->m_blockman.LookupBlockIndex(block.hash));
+        if (!m_chainstate->m_blockman.UndoReadFromDisk(block_undo, *pindex)) {
+            return false;
+        }
+    }
+    m_db->WriteBlock(*m_batch, *block.data, block_undo, block.height);
+
+    // Once in sync, make every block visible to lookups immediately. During
+    // initial sync, keep accumulating until the batch is large enough; the
+    // remainder is flushed by the next Commit().
+    if (GetSummary().synced || m_batch->SizeEstimate() > m_max_batch_size) {
+        return FlushBatch();
+    }
+    return true;
+}
+
+bool ScriptHashIndex::CustomCommit(CDBBatch& batch)
+{
+    // Pending entries must be on disk before the best block locator is
+    // advanced past them.
+    return FlushBatch();
+}
+
+bool ScriptHashIndex::CustomRewind(const interfaces::BlockKey& current_tip, const interfaces::BlockKey& new_tip)
+{
+    if (!FlushBatch()) return false;
+
+    CDBBatch batch(*m_db);
+    {
+        LOCK(cs_main);
+        const CBlockIndex* iter_tip{m_chainstate->m_blockman.LookupBlockIndex(current_tip.hash)};
+        const CBlockIndex* new_tip_index{m_chainstate->m_blockman.LookupBlockIndex(new_tip.hash)};
+
+        do {
+            CBlock block;
+            CBlockUndo block_undo;
+            if (!m_chainstate->m_blockman.ReadBlockFromDisk(block, *iter_tip) ||
+                (block.vtx.size() > 1 && !m_chainstate->m_blockman.UndoReadFromDisk(block_undo, *iter_tip))) {
+                LogError("%s: Failed to read block %s from disk\n",
+                         __func__, iter_tip->GetBlockHash().ToString());
+                return false;
+            }
+            m_db->EraseBlock(batch, block, block_undo, iter_tip->nHeight);
+            iter_tip = iter_tip->GetAncestor(iter_tip->nHeight - 1);
+        } while (new_tip_index != iter_tip);
+    }
+    return m_db->WriteBatch(batch);
+}
+
+BaseIndex::DB& ScriptHashIndex::GetDB() const { return *m_db; }
+
+template <typename Fn>
+bool ScriptHashIndex::ReadEvents(const uint256& script_hash, const ScriptEventPos& start, Fn fn, std::optional<ScriptEventPos>* next) const
+{
+    std::unique_ptr<CDBIterator> db_it(m_db->NewIterator());
+    DBEventKey key{script_hash, uint32_t(std::max(start.height, 0)), start.tx_pos, uint8_t(start.type), start.index};
+    for (db_it->Seek(key); db_it->Valid(); db_it->Next()) {
+        if (!db_it->GetKey(key) || key.script_hash != script_hash) break;
+
+        ScriptEvent event;
+        event.type = ScriptEvent::Type{key.type};
+        event.height = key.height;
+        event.tx_pos = key.tx_pos;
+        event.index = key.index;
+        bool ok;
+        if (event.type == ScriptEvent::Type::SPENDING) {
+            DBSpendingValue value;
+            ok = db_it->GetValue(value);
+            event.value = value.value;
+            event.prevout = value.prevout;
+        } else {
+            DBFundingValue value;
+            ok = db_it->GetValue(value);
+            event.value = value.value;
+        }
+        if (!ok || !m_db->Read(DBTxKey{key.height, key.tx_pos}, event.txid)) {
+            LogError("%s: Unable to read event of script %s at height %d\n", __func__, script_hash.ToString(), key.height);
+            return false;
+        }
+        if (!fn(std::move(event))) {
+            db_it->Next();
+            if (next && db_it->Valid() && db_it->GetKey(key) && key.script_hash == script_hash) {
+                *next = ScriptEventPos{int(key.height), key.tx_pos, ScriptEvent::Type{key.type}, key.index};
+            }
+            break;
+        }
+    }
+    return true;
+}
+
+bool ScriptHashIndex::LookupEvents(const uint256& script_hash, const ScriptEventPos& start, size_t max_events, std::vector<ScriptEvent>& events,
+                                   std::optional<ScriptEventPos>& next) const
+{
+    next.reset();
+    if (max_events == 0) return true;
+    return ReadEvents(script_hash, start, [&](ScriptEvent&& event) {
+        events.push_back(std::move(event));
+        return events.size() < max_events;
+    }, &next);
+}
+
+bool ScriptHashIndex::LookupUnspent(const uint256& script_hash, std::vector<ScriptEvent>& unspent) const
+{
+    // Outputs are always funded before they are spent, so a spending event
+    // can only refer to an earlier funding event.
+    std::map<COutPoint, ScriptEvent> unspent_by_outpoint;
+    const bool ok{ReadEvents(script_hash, ScriptEventPos{}, [&](ScriptEvent&& event) {
+        if (event.type == ScriptEvent::Type::SPENDING) {
+            unspent_by_outpoint.erase(event.prevout);
+        } else {
+            const COutPoint outpoint{event.txid, event.index};
+            unspent_by_outpoint.emplace(outpoint, std::move(event));
+        }
+        return true;
+    }, /*next=*/nullptr)};
+    if (!ok) return false;
+
+    const size_t offset{unspent.size()};
+    for (auto& [_, event] : unspent_by_outpoint) {
+        unspent.push_back(std::move(event));
+    }
+    std::sort(unspent.begin() + offset, unspent.end(), [](const ScriptEvent& a, const ScriptEvent& b) {
+        return std::tie(a.height, a.tx_pos, a.index) < std::tie(b.height, b.tx_pos, b.index);
+    });
+    return true;
+}
@@ -0,0 +1,127 @@
+// Copyright (c) 2024 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_INDEX_SCRIPTHASHINDEX_H
+#define BITCOIN_INDEX_SCRIPTHASHINDEX_H
+
+#include <consensus/amount.h>
+#include <index/base.h>
+#include <primitives/transaction.h>
+#include <uint256.h>
+
+#include <optional>
+#include <vector>
+
+class CDBBatch;
+class CScript;
+
+static constexpr bool DEFAULT_SCRIPTHASHINDEX{false};
+
+/** A funding or spending event of a script, as recorded by the script hash index. */
+struct ScriptEvent {
+    enum class Type : uint8_t {
+        FUNDING = 0, //!< an output paying to the script was created
+        SPENDING = 1, //!< an output paying to the script was spent
+    };
+
+    Type type{Type::FUNDING};
+    //! Height of the block containing the transaction
+    int height{0};
+    //! Position of the transaction in its block
+    uint32_t tx_pos{0};
+    //! Hash of the transaction
+    Txid txid;
+    //! Output index (funding) or input index (spending) within the transaction
+    uint32_t index{0};
+    //! Value of the created or spent output
+    CAmount value{0};
+    //! The spent outpoint (spending events only)
+    COutPoint prevout;
+};
+
+/** Position of an event in the history of a script, at which a lookup starts. */
+struct ScriptEventPos {
+    int height{0};
+    uint32_t tx_pos{0};
+    ScriptEvent::Type type{ScriptEvent::Type::FUNDING};
+    uint32_t index{0};
+};
+
+/**
+ * ScriptHashIndex records, for every script, the transactions that created or
+ * spent outputs paying to it. Scripts are identified by the SHA256 of the
+ * scriptPubKey (like the Electrum protocol), and events are stored in block
+ * order so that the history of a script can be read with a single range scan.
+ *
+ * Event keys only reference transactions by (height, position in block); the
+ * txid is stored once per transaction. During initial sync, writes of
+ * consecutive blocks are accumulated in one batch that is flushed when it
+ * grows beyond -dbbatchsize, bounding memory while avoiding many small
+ * LevelDB writes.
+ */
+class ScriptHashIndex final : public BaseIndex
+{
+protected:
+    class DB;
+
+private:
+    const std::unique_ptr<DB> m_db;
+
+    //! Pending writes not yet flushed to the database. Only accessed from the
+    //! thread currently appending blocks (the sync thread during initial sync,
+    //! the validation interface thread afterwards).
+    std::unique_ptr<CDBBatch> m_batch;
+    const size_t m_max_batch_size;
+
+    bool AllowPrune() const override { return true; }
+
+    [[nodiscard]] bool FlushBatch();
+
+    /** Call fn(event) for the events of a script from start on, in block
+     * order, until fn returns false. If it does, set next to the position of
+     * the following event, if any. */
+    template <typename Fn>
+    bool ReadEvents(const uint256& script_hash, const ScriptEventPos& start, Fn fn, std::optional<ScriptEventPos>* next) const;
+
+protected:
+    bool CustomAppend(const interfaces::BlockInfo& block) override;
+
+    bool CustomCommit(CDBBatch& batch) override;
+
+    bool CustomRewind(const interfaces::BlockKey& current_tip, const interfaces::BlockKey& new_tip) override;
+
+    BaseIndex::DB& GetDB() const override;
+
+public:
+    /// Constructs the index, which becomes available to be queried.
+    explicit ScriptHashIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    // Destructor is declared because this class contains a unique_ptr to an incomplete type.
+    virtual ~ScriptHashIndex() override;
+
+    /// Compute the hash identifying a script in the index.
+    static uint256 GetScriptHash(const CScript& script);
+
+    /// Look up the funding and spending events of a script, in block order.
+    ///
+    /// @param[in]   script_hash   The hash of the script, see GetScriptHash().
+    /// @param[in]   start         Only return events at or after this position.
+    /// @param[in]   max_events    Stop after this many events.
+    /// @param[out]  events        The events found.
+    /// @param[out]  next          The position to continue from if there are
+    ///                            more events, std::nullopt otherwise.
+    /// @return  false if the index could not be read, true otherwise
+    bool LookupEvents(const uint256& script_hash, const ScriptEventPos& start, size_t max_events, std::vector<ScriptEvent>& events,
+                      std::optional<ScriptEventPos>& next) const;
+
+    /// Look up the unspent outputs paying to a script, i.e. the funding events
+    /// that have no matching spending event, in block order. The history is
+    /// read in one pass, keeping only the outputs not yet spent.
+    bool LookupUnspent(const uint256& script_hash, std::vector<ScriptEvent>& unspent) const;
+};
+
+/// The global script hash index. May be null.
+extern std::unique_ptr<ScriptHashIndex> g_scripthash_index;
+
+#endif // BITCOIN_INDEX_SCRIPTHASHINDEX_H
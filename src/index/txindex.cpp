@@ -4,6 +4,7 @@
 
 #include <index/txindex.h>
 
+#include <chain.h>
 #include <clientversion.h>
 #include <common/args.h>
 #include <index/disktxpos.h>
@@ -12,9 +13,61 @@
 #include <validation.h>
 
 constexpr uint8_t DB_TXINDEX{'t'};
+constexpr uint8_t DB_TXINDEX_COMPACT{'c'};
+constexpr uint8_t DB_TXINDEX_FORMAT{'F'};
 
 std::unique_ptr<TxIndex> g_txindex;
 
+std::string TxIndexFormatName(TxIndexFormat format)
+{
+    switch (format) {
+    case TxIndexFormat::FULL: return "full";
+    case TxIndexFormat::COMPACT: return "compact";
+    } // no default case, so the compiler can warn about missing cases
+    assert(false);
+}
+
+std::optional<TxIndexFormat> TxIndexFormatFromName(const std::string& name)
+{
+    for (const TxIndexFormat format : {TxIndexFormat::FULL, TxIndexFormat::COMPACT}) {
+        if (TxIndexFormatName(format) == name) return format;
+    }
+    return std::nullopt;
+}
+
+namespace {
+
+/** Key of the compact format: the first 8 bytes of the txid, followed by the
+ * height of the block and the offset of the transaction within it, so that
+ * transactions sharing a truncated txid get distinct keys. */
+struct DBCompactTxKey {
+    uint64_t txid_prefix{0};
+    uint32_t height{0};
+    uint32_t tx_offset{0};
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        ser_writedata8(s, DB_TXINDEX_COMPACT);
+        ser_writedata64(s, txid_prefix);
+        ser_writedata32be(s, height);
+        s << VARINT(tx_offset);
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        const uint8_t prefix{ser_readdata8(s)};
+        if (prefix != DB_TXINDEX_COMPACT) {
+            throw std::ios_base::failure("Invalid format for txindex DB compact key");
+        }
+        txid_prefix = ser_readdata64(s);
+        height = ser_readdata32be(s);
+        s >> VARINT(tx_offset);
+    }
+};
+
+} // namespace
 
 /** Access to the txindex database (indexes/txindex/) */
 class TxIndex::DB : public BaseIndex::DB
@@ -22,23 +75,68 @@ class TxIndex::DB : public BaseIndex::DB
 public:
     explicit DB(size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
 
+    /// Read the format of an existing index. Returns nullopt for an empty index.
+    std::optional<TxIndexFormat> ReadFormat() const;
+
+    /// Write the format of the index.
+    [[nodiscard]] bool WriteFormat(TxIndexFormat format);
+
     /// Read the disk location of the transaction data with the given hash. Returns false if the
     /// transaction hash is not indexed.
     bool ReadTxPos(const uint256& txid, CDiskTxPos& pos) const;
 
+    /// Read all (height, offset in block) candidates of transactions whose
+    /// hash starts with the same 8 bytes as the given hash.
+    std::vector<std::pair<int, uint32_t>> ReadCompactTxPos(const uint256& txid);
+
     /// Write a batch of transaction positions to the DB.
     [[nodiscard]] bool WriteTxs(const std::vector<std::pair<uint256, CDiskTxPos>>& v_pos);
+
+    /// Write a batch of block-relative transaction positions of a block to the DB.
+    [[nodiscard]] bool WriteCompactTxs(int height, const std::vector<std::pair<uint256, uint32_t>>& v_offsets);
 };
 
 TxIndex::DB::DB(size_t n_cache_size, bool f_memory, bool f_wipe) :
     BaseIndex::DB(gArgs.GetDataDirNet() / "indexes" / "txindex", n_cache_size, f_memory, f_wipe)
 {}
 
+std::optional<TxIndexFormat> TxIndex::DB::ReadFormat() const
+{
+    uint8_t format;
+    if (Read(DB_TXINDEX_FORMAT, format)) {
+        return TxIndexFormat{format};
+    }
+    // Indexes created before the format was recorded are in the full format.
+    CBlockLocator locator;
+    if (ReadBestBlock(locator) && !locator.IsNull()) {
+        return TxIndexFormat::FULL;
+    }
+    return std::nullopt;
+}
+
+bool TxIndex::DB::WriteFormat(TxIndexFormat format)
+{
+    return Write(DB_TXINDEX_FORMAT, uint8_t(format), /*fSync=*/true);
+}
+
 bool TxIndex::DB::ReadTxPos(const uint256 &txid, CDiskTxPos& pos) const
 {
     return Read(std::make_pair(DB_TXINDEX, txid), pos);
 }
 
+std::vector<std::pair<int, uint32_t>> TxIndex::DB::ReadCompactTxPos(const uint256& txid)
+{
+    std::vector<std::pair<int, uint32_t>> result;
+    std::unique_ptr<CDBIterator> db_it(NewIterator());
+    DBCompactTxKey key{txid.GetUint64(0), 0, 0};
+    const uint64_t txid_prefix{key.txid_prefix};
+    for (db_it->Seek(key); db_it->Valid(); db_it->Next()) {
+        if (!db_it->GetKey(key) || key.txid_prefix != txid_prefix) break;
+        result.emplace_back(key.height, key.tx_offset);
+    }
+    return result;
+}
+
 bool TxIndex::DB::WriteTxs(const std::vector<std::pair<uint256, CDiskTxPos>>& v_pos)
 {
     CDBBatch batch(*this);
@@ -48,8 +146,36 @@ bool TxIndex::DB::WriteTxs(const std::vector<std::pair<uint256, CDiskTxPos>>& v_
     return WriteBatch(batch);
 }
 
-TxIndex::TxIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory, bool f_wipe)
-    : BaseIndex(std::move(chain), "txindex"), m_db(std::make_unique<TxIndex::DB>(n_cache_size, f_memory, f_wipe))
+bool TxIndex::DB::WriteCompactTxs(int height, const std::vector<std::pair<uint256, uint32_t>>& v_offsets)
+{
+    CDBBatch batch(*this);
+    for (const auto& [txid, tx_offset] : v_offsets) {
+        // The key carries all information, there is no value.
+        batch.Write(DBCompactTxKey{txid.GetUint64(0), uint32_t(height), tx_offset}, uint8_t{0});
+    }
+    return WriteBatch(batch);
+}
+
+std::unique_ptr<TxIndex::DB> TxIndex::OpenDB(size_t n_cache_size, bool f_memory, bool f_wipe, TxIndexFormat format)
+{
+    auto db{std::make_unique<TxIndex::DB>(n_cache_size, f_memory, f_wipe)};
+    const std::optional<TxIndexFormat> existing_format{db->ReadFormat()};
+    if (existing_format && *existing_format != format) {
+        // There is no way to convert entries between formats without reading
+        // all blocks again, so migrate by rebuilding the index.
+        LogPrintf("txindex: existing index has format %s, rebuilding it in format %s\n",
+                  TxIndexFormatName(*existing_format), TxIndexFormatName(format));
+        db.reset();
+        db = std::make_unique<TxIndex::DB>(n_cache_size, f_memory, /*f_wipe=*/true);
+    }
+    if (existing_format != format && !db->WriteFormat(format)) {
+        throw std::runtime_error("txindex: failed to write index format");
+    }
+    return db;
+}
+
+TxIndex::TxIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory, bool f_wipe, TxIndexFormat format)
+    : BaseIndex(std::move(chain), "txindex"), m_format(format), m_db(OpenDB(n_cache_size, f_memory, f_wipe, format))
 {}
 
 TxIndex::~TxIndex() = default;
@@ -61,6 +187,16 @@ bool TxIndex::CustomAppend(const interfaces::BlockInfo& block)
 
     assert(block.data);
     CDiskTxPos pos({block.file_number, block.data_pos}, GetSizeOfCompactSize(block.data->vtx.size()));
+    if (m_format == TxIndexFormat::COMPACT) {
+        std::vector<std::pair<uint256, uint32_t>> v_offsets;
+        v_offsets.reserve(block.data->vtx.size());
+        for (const auto& tx : block.data->vtx) {
+            v_offsets.emplace_back(tx->GetHash(), pos.nTxOffset);
+            pos.nTxOffset += ::GetSerializeSize(TX_WITH_WITNESS(*tx));
+        }
+        return m_db->WriteCompactTxs(block.height, v_offsets);
+    }
+
     std::vector<std::pair<uint256, CDiskTxPos>> vPos;
     vPos.reserve(block.data->vtx.size());
     for (const auto& tx : block.data->vtx) {
@@ -72,13 +208,8 @@ bool TxIndex::CustomAppend(const interfaces::BlockInfo& block)
 
 BaseIndex::DB& TxIndex::GetDB() const { return *m_db; }
 
-bool TxIndex::FindTx(const uint256& tx_hash, uint256& block_hash, CTransactionRef& tx) const
+bool TxIndex::ReadTxFromDisk(const CDiskTxPos& postx, uint256& block_hash, CTransactionRef& tx) const
 {
-    CDiskTxPos postx;
-    if (!m_db->ReadTxPos(tx_hash, postx)) {
-        return false;
-    }
-
     AutoFile file{m_chainstate->m_blockman.OpenBlockFile(postx, true)};
     if (file.IsNull()) {
         LogError("%s: OpenBlockFile failed\n", __func__);
@@ -96,10 +227,40 @@ bool TxIndex::FindTx(const uint256& tx_hash, uint256& block_hash, CTransactionRe
         LogError("%s: Deserialize or I/O error - %s\n", __func__, e.what());
         return false;
     }
+    block_hash = header.GetHash();
+    return true;
+}
+
+bool TxIndex::FindTx(const uint256& tx_hash, uint256& block_hash, CTransactionRef& tx) const
+{
+    if (m_format == TxIndexFormat::COMPACT) {
+        for (const auto& [height, tx_offset] : m_db->ReadCompactTxPos(tx_hash)) {
+            CDiskTxPos postx;
+            {
+                LOCK(cs_main);
+                // Entries of blocks that were disconnected (or not yet
+                // connected to the active chain) can't be resolved.
+                const CBlockIndex* pindex{m_chainstate->m_chain[height]};
+                if (!pindex) continue;
+                postx = CDiskTxPos{pindex->GetBlockPos(), tx_offset};
+            }
+            if (!ReadTxFromDisk(postx, block_hash, tx)) continue;
+            // A mismatching hash means a truncated txid collision or a stale entry.
+            if (tx->GetHash() == tx_hash) return true;
+        }
+        return false;
+    }
+
+    CDiskTxPos postx;
+    if (!m_db->ReadTxPos(tx_hash, postx)) {
+        return false;
+    }
+    if (!ReadTxFromDisk(postx, block_hash, tx)) {
+        return false;
+    }
     if (tx->GetHash() != tx_hash) {
         LogError("%s: txid mismatch\n", __func__);
         return false;
     }
-    block_hash = header.GetHash();
     return true;
 }
@@ -7,12 +7,39 @@
 
 #include <index/base.h>
 
+#include <optional>
+#include <string>
+
+struct CDiskTxPos;
+
 static constexpr bool DEFAULT_TXINDEX{false};
 
+/** On-disk format of the transaction index. */
+enum class TxIndexFormat : uint8_t {
+    //! Full txid -> (block file, block position, tx offset)
+    FULL = 0,
+    //! Truncated txid -> (block height, tx offset in block), resolved through
+    //! the active chain and verified by reading the transaction
+    COMPACT = 1,
+};
+
+static constexpr TxIndexFormat DEFAULT_TXINDEX_FORMAT{TxIndexFormat::FULL};
+
+/** Get the name of a txindex format (as used by -txindexformat). */
+std::string TxIndexFormatName(TxIndexFormat format);
+
+/** Parse a txindex format name. Returns nullopt if the name is unknown. */
+std::optional<TxIndexFormat> TxIndexFormatFromName(const std::string& name);
+
 /**
  * TxIndex is used to look up transactions included in the blockchain by hash.
  * The index is written to a LevelDB database and records the filesystem
  * location of each transaction by transaction hash.
+ *
+ * In the compact format, transactions are keyed by the first 8 bytes of the
+ * txid and located by block height and offset within the block. Entries
+ * sharing a truncated txid are disambiguated by reading the transactions, and
+ * entries of blocks that are no longer in the active chain are ignored.
  */
 class TxIndex final : public BaseIndex
 {
@@ -20,22 +47,33 @@ protected:
     class DB;
 
 private:
+    const TxIndexFormat m_format;
     const std::unique_ptr<DB> m_db;
 
     bool AllowPrune() const override { return false; }
 
+    /// Open the database, wiping it if it holds an index of another format.
+    static std::unique_ptr<DB> OpenDB(size_t n_cache_size, bool f_memory, bool f_wipe, TxIndexFormat format);
+
+    /// Read the transaction at the given position, returning the hash of the block containing it.
+    bool ReadTxFromDisk(const CDiskTxPos& postx, uint256& block_hash, CTransactionRef& tx) const;
+
 protected:
     bool CustomAppend(const interfaces::BlockInfo& block) override;
 
     BaseIndex::DB& GetDB() const override;
 
 public:
-    /// Constructs the index, which becomes available to be queried.
-    explicit TxIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+    /// Constructs the index, which becomes available to be queried. If an
+    /// existing index has a different format, it is wiped and rebuilt.
+    explicit TxIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory = false, bool f_wipe = false,
+                     TxIndexFormat format = DEFAULT_TXINDEX_FORMAT);
 
     // Destructor is declared because this class contains a unique_ptr to an incomplete type.
     virtual ~TxIndex() override;
 
+    TxIndexFormat GetFormat() const { return m_format; }
+
     /// Look up a transaction by hash.
     ///
     /// @param[in]   tx_hash  The hash of the transaction to be returned.
@@ -23,6 +23,7 @@ class ValidationSignals;
 
 static constexpr bool DEFAULT_CHECKPOINTS_ENABLED{true};
 static constexpr auto DEFAULT_MAX_TIP_AGE{24h};
+static constexpr bool DEFAULT_PARALLEL_TX_CHECKS{false};
 
 namespace kernel {
 
@@ -49,6 +50,8 @@ struct ChainstateManagerOpts {
     ValidationSignals* signals{nullptr};
     //! Number of script check worker threads. Zero means no parallel verification.
     int worker_threads_num{0};
+    //! Also run the input, sequence lock and sigop checks of block transactions on worker threads.
+    bool parallel_tx_checks{DEFAULT_PARALLEL_TX_CHECKS};
     size_t script_execution_cache_bytes{DEFAULT_SCRIPT_EXECUTION_CACHE_BYTES};
     size_t signature_cache_bytes{DEFAULT_SIGNATURE_CACHE_BYTES};
 };
@@ -4,7 +4,11 @@
 
 #include <kernel/context.h>
 
+#include <crypto/chacha20.h>
+#include <crypto/poly1305.h>
+#include <crypto/ripemd160.h>
 #include <crypto/sha256.h>
+#include <crypto/siphash.h>
 #include <logging.h>
 #include <random.h>
 
@@ -16,6 +20,14 @@ Context::Context()
 {
     std::string sha256_algo = SHA256AutoDetect();
     LogPrintf("Using the '%s' SHA256 implementation\n", sha256_algo);
+    std::string chacha20_algo = ChaCha20AutoDetect();
+    LogPrintf("Using the '%s' ChaCha20 implementation\n", chacha20_algo);
+    std::string poly1305_algo = Poly1305AutoDetect();
+    LogPrintf("Using the '%s' Poly1305 implementation\n", poly1305_algo);
+    std::string siphash_algo = SipHashAutoDetect();
+    LogPrintf("Using the '%s' SipHash implementation\n", siphash_algo);
+    std::string ripemd160_algo = RIPEMD160AutoDetect();
+    LogPrintf("Using the '%s' RIPEMD160 implementation\n", ripemd160_algo);
     RandomInit();
 }
 
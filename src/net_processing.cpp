@@ -42,15 +42,19 @@
 #include <txrequest.h>
 #include <util/check.h>
 #include <util/strencodings.h>
+#include <util/thread.h>
 #include <util/time.h>
 #include <util/trace.h>
 #include <validation.h>
 
 #include <algorithm>
 #include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <future>
 #include <memory>
 #include <optional>
+#include <thread>
 #include <typeinfo>
 #include <utility>
 
@@ -187,6 +191,8 @@ struct QueuedBlock {
     const CBlockIndex* pindex;
     /** Optional, used for CMPCTBLOCK downloads */
     std::unique_ptr<PartiallyDownloadedBlock> partialBlock;
+    /** When the CMPCTBLOCK message was received, used to log the reconstruction latency */
+    std::chrono::microseconds cmpctblock_time{0};
 };
 
 /**
@@ -487,6 +493,7 @@ public:
     PeerManagerImpl(CConnman& connman, AddrMan& addrman,
                     BanMan* banman, ChainstateManager& chainman,
                     CTxMemPool& pool, node::Warnings& warnings, Options opts);
+    ~PeerManagerImpl() override;
 
     /** Overridden from CValidationInterface. */
     void BlockConnected(ChainstateRole role, const std::shared_ptr<const CBlock>& pblock, const CBlockIndex* pindexConnected) override
@@ -505,12 +512,13 @@ public:
     void FinalizeNode(const CNode& node) override EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex, !m_headers_presync_mutex);
     bool HasAllDesirableServiceFlags(ServiceFlags services) const override;
     bool ProcessMessages(CNode* pfrom, std::atomic<bool>& interrupt) override
-        EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex, !m_recent_confirmed_transactions_mutex, !m_most_recent_block_mutex, !m_headers_presync_mutex, g_msgproc_mutex);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex, !m_recent_confirmed_transactions_mutex, !m_most_recent_block_mutex, !m_headers_presync_mutex, !m_cmpctblock_mutex, g_msgproc_mutex);
     bool SendMessages(CNode* pto) override
         EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex, !m_recent_confirmed_transactions_mutex, !m_most_recent_block_mutex, g_msgproc_mutex);
 
     /** Implement PeerManager */
     void StartScheduledTasks(CScheduler& scheduler) override;
+    void Stop() override EXCLUSIVE_LOCKS_REQUIRED(!m_cmpctblock_mutex);
     void CheckForStaleTipAndEvictPeers() override;
     std::optional<std::string> FetchBlock(NodeId peer_id, const CBlockIndex& block_index) override
         EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex);
@@ -526,7 +534,7 @@ public:
     void UnitTestMisbehaving(NodeId peer_id) override EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex) { Misbehaving(*Assert(GetPeerRef(peer_id)), ""); };
     void ProcessMessage(CNode& pfrom, const std::string& msg_type, DataStream& vRecv,
                         const std::chrono::microseconds time_received, const std::atomic<bool>& interruptMsgProc) override
-        EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex, !m_recent_confirmed_transactions_mutex, !m_most_recent_block_mutex, !m_headers_presync_mutex, g_msgproc_mutex);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex, !m_recent_confirmed_transactions_mutex, !m_most_recent_block_mutex, !m_headers_presync_mutex, !m_cmpctblock_mutex, g_msgproc_mutex);
     void UpdateLastBlockAnnounceTime(NodeId node, int64_t time_in_seconds) override;
     ServiceFlags GetDesirableServiceFlags(ServiceFlags services) const override;
 
@@ -1046,11 +1054,51 @@ private:
         LOCKS_EXCLUDED(::cs_main);
 
     /** Process a new block. Perform any post-processing housekeeping */
-    void ProcessBlock(CNode& node, const std::shared_ptr<const CBlock>& block, bool force_processing, bool min_pow_checked);
+    void ProcessBlock(NodeId peer_id, const std::shared_ptr<const CBlock>& block, bool force_processing, bool min_pow_checked);
 
     /** Process compact block txns  */
     void ProcessCompactBlockTxns(CNode& pfrom, Peer& peer, const BlockTransactions& block_transactions)
-        EXCLUSIVE_LOCKS_REQUIRED(g_msgproc_mutex, !m_most_recent_block_mutex);
+        EXCLUSIVE_LOCKS_REQUIRED(g_msgproc_mutex, !m_most_recent_block_mutex, !m_cmpctblock_mutex);
+
+    /** A compact block handed to m_cmpctblock_thread (see -cmpctblockthread). */
+    struct CompactBlockTask {
+        NodeId peer_id{-1};
+        /** When the CMPCTBLOCK message was received */
+        std::chrono::microseconds time_received{0};
+        /** The block to validate, if it was already reconstructed */
+        std::shared_ptr<const CBlock> block{};
+        /** Otherwise, the compact block to reconstruct optimistically, while
+         *  the block (whose index is pindex) is in flight from another peer */
+        std::optional<CBlockHeaderAndShortTxIDs> cmpctblock{};
+        std::vector<CTransactionRef> extra_txn{};
+        const CBlockIndex* pindex{nullptr};
+    };
+
+    /** Process a block reconstructed from a compact block, on m_cmpctblock_thread if enabled. */
+    void ProcessReconstructedBlock(NodeId peer_id, const std::shared_ptr<const CBlock>& block, std::chrono::microseconds time_received)
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cmpctblock_mutex);
+
+    /** Reconstruct a compact block from the mempool and the extra transactions
+     *  while the block is in flight from another peer, and process it if that
+     *  succeeded without any round trips. */
+    void ReconstructCompactBlockOptimistically(NodeId peer_id, const CBlockHeaderAndShortTxIDs& cmpctblock,
+                                               const std::vector<CTransactionRef>& extra_txn, const CBlockIndex& index,
+                                               std::chrono::microseconds time_received)
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cmpctblock_mutex);
+
+    /** Hand a task to m_cmpctblock_thread. */
+    void QueueCompactBlockTask(CompactBlockTask&& task) EXCLUSIVE_LOCKS_REQUIRED(!m_cmpctblock_mutex);
+
+    /** Main loop of m_cmpctblock_thread. */
+    void ThreadCompactBlocks() EXCLUSIVE_LOCKS_REQUIRED(!m_cmpctblock_mutex);
+
+    Mutex m_cmpctblock_mutex;
+    std::condition_variable m_cmpctblock_cv;
+    std::deque<CompactBlockTask> m_cmpctblock_queue GUARDED_BY(m_cmpctblock_mutex);
+    bool m_cmpctblock_stop GUARDED_BY(m_cmpctblock_mutex){false};
+    /** Reconstructs and validates compact blocks, so that validating a new
+     *  block does not hold up the message handler thread. Only started with -cmpctblockthread. */
+    std::thread m_cmpctblock_thread;
 
     /**
      * When a peer sends us a valid block, instruct it to announce blocks to us
@@ -2038,6 +2086,59 @@ PeerManagerImpl::PeerManagerImpl(CConnman& connman, AddrMan& addrman,
     if (opts.reconcile_txs) {
         m_txreconciliation = std::make_unique<TxReconciliationTracker>(TXRECONCILIATION_VERSION);
     }
+    if (opts.cmpctblock_thread) {
+        m_cmpctblock_thread = std::thread(&util::TraceThread, "cmpctblk", [this] { ThreadCompactBlocks(); });
+    }
+}
+
+PeerManagerImpl::~PeerManagerImpl()
+{
+    Stop();
+}
+
+void PeerManagerImpl::Stop()
+{
+    {
+        LOCK(m_cmpctblock_mutex);
+        m_cmpctblock_stop = true;
+        // Dropped blocks are fetched again from peers after a restart.
+        m_cmpctblock_queue.clear();
+    }
+    m_cmpctblock_cv.notify_all();
+    if (m_cmpctblock_thread.joinable()) m_cmpctblock_thread.join();
+}
+
+void PeerManagerImpl::QueueCompactBlockTask(CompactBlockTask&& task)
+{
+    {
+        LOCK(m_cmpctblock_mutex);
+        if (m_cmpctblock_stop) return;
+        m_cmpctblock_queue.push_back(std::move(task));
+    }
+    m_cmpctblock_cv.notify_one();
+}
+
+void PeerManagerImpl::ThreadCompactBlocks()
+{
+    while (true) {
+        CompactBlockTask task;
+        {
+            WAIT_LOCK(m_cmpctblock_mutex, lock);
+            while (!m_cmpctblock_stop && m_cmpctblock_queue.empty()) {
+                m_cmpctblock_cv.wait(lock);
+            }
+            if (m_cmpctblock_stop) return;
+            task = std::move(m_cmpctblock_queue.front());
+            m_cmpctblock_queue.pop_front();
+        }
+        if (task.cmpctblock) {
+            ReconstructCompactBlockOptimistically(task.peer_id, *task.cmpctblock, task.extra_txn, *Assert(task.pindex), task.time_received);
+        } else {
+            ProcessReconstructedBlock(task.peer_id, task.block, task.time_received);
+            // The block was kept in flight until now, see ProcessCompactBlockTxns.
+            WITH_LOCK(cs_main, RemoveBlockRequest(task.block->GetHash(), task.peer_id));
+        }
+    }
 }
 
 void PeerManagerImpl::StartScheduledTasks(CScheduler& scheduler)
@@ -3552,12 +3653,16 @@ void PeerManagerImpl::ProcessGetCFCheckPt(CNode& node, Peer& peer, DataStream& v
               headers);
 }
 
-void PeerManagerImpl::ProcessBlock(CNode& node, const std::shared_ptr<const CBlock>& block, bool force_processing, bool min_pow_checked)
+void PeerManagerImpl::ProcessBlock(NodeId peer_id, const std::shared_ptr<const CBlock>& block, bool force_processing, bool min_pow_checked)
 {
     bool new_block{false};
     m_chainman.ProcessNewBlock(block, force_processing, min_pow_checked, &new_block);
     if (new_block) {
-        node.m_last_block_time = GetTime<std::chrono::seconds>();
+        // Looked up by id, as this may run on the compact block thread.
+        m_connman.ForNode(peer_id, [](CNode* node) {
+            node->m_last_block_time = GetTime<std::chrono::seconds>();
+            return true;
+        });
         // In case this block came from a different peer than we requested
         // from, we can erase the block request now anyway (as we just stored
         // this block to disk).
@@ -3573,6 +3678,7 @@ void PeerManagerImpl::ProcessCompactBlockTxns(CNode& pfrom, Peer& peer, const Bl
 {
     std::shared_ptr<CBlock> pblock = std::make_shared<CBlock>();
     bool fBlockRead{false};
+    std::chrono::microseconds cmpctblock_time{0};
     {
         LOCK(cs_main);
 
@@ -3632,7 +3738,15 @@ void PeerManagerImpl::ProcessCompactBlockTxns(CNode& pfrom, Peer& peer, const Bl
             // though the block was successfully read, and rely on the
             // handling in ProcessNewBlock to ensure the block index is
             // updated, etc.
-            RemoveBlockRequest(block_transactions.blockhash, pfrom.GetId()); // it is now an empty pointer
+            cmpctblock_time = range_flight.first->second.second->cmpctblock_time;
+            if (m_opts.cmpctblock_thread) {
+                // Keep the block in flight until the compact block thread has
+                // processed it, so that it isn't requested again meanwhile.
+                // Further block transactions for it are ignored.
+                range_flight.first->second.second->partialBlock.reset();
+            } else {
+                RemoveBlockRequest(block_transactions.blockhash, pfrom.GetId()); // it is now an empty pointer
+            }
             fBlockRead = true;
             // mapBlockSource is used for potentially punishing peers and
             // updating which peers send us compact blocks, so the race
@@ -3650,11 +3764,71 @@ void PeerManagerImpl::ProcessCompactBlockTxns(CNode& pfrom, Peer& peer, const Bl
         // disk-space attacks), but this should be safe due to the
         // protections in the compact block handler -- see related comment
         // in compact block optimistic reconstruction handling.
-        ProcessBlock(pfrom, pblock, /*force_processing=*/true, /*min_pow_checked=*/true);
+        LogPrint(BCLog::CMPCTBLOCK, "Reconstructed block %s from peer=%d %.3fms after receiving it\n",
+                 pblock->GetHash().ToString(), pfrom.GetId(),
+                 Ticks<MillisecondsDouble>(GetTime<std::chrono::microseconds>() - cmpctblock_time));
+        ProcessReconstructedBlock(pfrom.GetId(), pblock, cmpctblock_time);
     }
     return;
 }
 
+void PeerManagerImpl::ProcessReconstructedBlock(NodeId peer_id, const std::shared_ptr<const CBlock>& block, std::chrono::microseconds time_received)
+{
+    if (m_opts.cmpctblock_thread && std::this_thread::get_id() != m_cmpctblock_thread.get_id()) {
+        QueueCompactBlockTask({.peer_id = peer_id, .time_received = time_received, .block = block});
+        return;
+    }
+    ProcessBlock(peer_id, block, /*force_processing=*/true, /*min_pow_checked=*/true);
+    LogPrint(BCLog::CMPCTBLOCK, "Processed reconstructed block %s from peer=%d %.3fms after receiving it\n",
+             block->GetHash().ToString(), peer_id,
+             Ticks<MillisecondsDouble>(GetTime<std::chrono::microseconds>() - time_received));
+}
+
+void PeerManagerImpl::ReconstructCompactBlockOptimistically(NodeId peer_id, const CBlockHeaderAndShortTxIDs& cmpctblock,
+                                                            const std::vector<CTransactionRef>& extra_txn, const CBlockIndex& index,
+                                                            std::chrono::microseconds time_received)
+{
+    PartiallyDownloadedBlock tempBlock(&m_mempool);
+    ReadStatus status = tempBlock.InitData(cmpctblock, extra_txn);
+    if (status != READ_STATUS_OK) {
+        // TODO: don't ignore failures
+        return;
+    }
+    std::shared_ptr<CBlock> pblock = std::make_shared<CBlock>();
+    std::vector<CTransactionRef> dummy;
+    status = tempBlock.FillBlock(*pblock, dummy);
+    if (status != READ_STATUS_OK) return;
+
+    // If we got here, we were able to optimistically reconstruct a
+    // block that is in flight from some other peer.
+    LogPrint(BCLog::CMPCTBLOCK, "Reconstructed block %s from peer=%d %.3fms after receiving it\n",
+             pblock->GetHash().ToString(), peer_id,
+             Ticks<MillisecondsDouble>(GetTime<std::chrono::microseconds>() - time_received));
+    {
+        LOCK(cs_main);
+        mapBlockSource.emplace(pblock->GetHash(), std::make_pair(peer_id, false));
+    }
+    // Setting force_processing to true means that we bypass some of
+    // our anti-DoS protections in AcceptBlock, which filters
+    // unrequested blocks that might be trying to waste our resources
+    // (eg disk space). Because we only try to reconstruct blocks when
+    // we're close to caught up (via the CanDirectFetch() requirement
+    // in the compact block handler, combined with the behavior of not
+    // requesting blocks until we have a chain with at least the minimum
+    // chain work), and we ignore compact blocks with less work than our
+    // tip, it is safe to treat reconstructed compact blocks as having
+    // been requested.
+    ProcessReconstructedBlock(peer_id, pblock, time_received);
+    LOCK(cs_main); // hold cs_main for CBlockIndex::IsValid()
+    if (index.IsValid(BLOCK_VALID_TRANSACTIONS)) {
+        // Clear download state for this block, which is in
+        // process from some other peer.  We do this after calling
+        // ProcessNewBlock so that a malleated cmpctblock announcement
+        // can't be used to interfere with block relay.
+        RemoveBlockRequest(pblock->GetHash(), std::nullopt);
+    }
+}
+
 void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type, DataStream& vRecv,
                                      const std::chrono::microseconds time_received,
                                      const std::atomic<bool>& interruptMsgProc)
@@ -4725,10 +4899,9 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
         // without cs_main.
         bool fRevertToHeaderProcessing = false;
 
-        // Keep a CBlock for "optimistic" compactblock reconstructions (see
-        // below)
-        std::shared_ptr<CBlock> pblock = std::make_shared<CBlock>();
-        bool fBlockReconstructed = false;
+        // Whether to try an "optimistic" compactblock reconstruction (see
+        // below), which doesn't need cs_main
+        bool fReconstructOptimistically = false;
 
         {
         LOCK(cs_main);
@@ -4814,6 +4987,8 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
                     return;
                 }
 
+                (*queuedBlockIt)->cmpctblock_time = time_received;
+
                 BlockTransactionsRequest req;
                 for (size_t i = 0; i < cmpctblock.BlockTxCount(); i++) {
                     if (!partialBlock.IsTxAvailable(i))
@@ -4846,17 +5021,7 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
                 // download from.
                 // Optimistically try to reconstruct anyway since we might be
                 // able to without any round trips.
-                PartiallyDownloadedBlock tempBlock(&m_mempool);
-                ReadStatus status = tempBlock.InitData(cmpctblock, vExtraTxnForCompact);
-                if (status != READ_STATUS_OK) {
-                    // TODO: don't ignore failures
-                    return;
-                }
-                std::vector<CTransactionRef> dummy;
-                status = tempBlock.FillBlock(*pblock, dummy);
-                if (status == READ_STATUS_OK) {
-                    fBlockReconstructed = true;
-                }
+                fReconstructOptimistically = true;
             }
         } else {
             if (requested_block_from_this_peer) {
@@ -4888,30 +5053,12 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
             return ProcessHeadersMessage(pfrom, *peer, {cmpctblock.header}, /*via_compact_block=*/true);
         }
 
-        if (fBlockReconstructed) {
-            // If we got here, we were able to optimistically reconstruct a
-            // block that is in flight from some other peer.
-            {
-                LOCK(cs_main);
-                mapBlockSource.emplace(pblock->GetHash(), std::make_pair(pfrom.GetId(), false));
-            }
-            // Setting force_processing to true means that we bypass some of
-            // our anti-DoS protections in AcceptBlock, which filters
-            // unrequested blocks that might be trying to waste our resources
-            // (eg disk space). Because we only try to reconstruct blocks when
-            // we're close to caught up (via the CanDirectFetch() requirement
-            // above, combined with the behavior of not requesting blocks until
-            // we have a chain with at least the minimum chain work), and we ignore
-            // compact blocks with less work than our tip, it is safe to treat
-            // reconstructed compact blocks as having been requested.
-            ProcessBlock(pfrom, pblock, /*force_processing=*/true, /*min_pow_checked=*/true);
-            LOCK(cs_main); // hold cs_main for CBlockIndex::IsValid()
-            if (pindex->IsValid(BLOCK_VALID_TRANSACTIONS)) {
-                // Clear download state for this block, which is in
-                // process from some other peer.  We do this after calling
-                // ProcessNewBlock so that a malleated cmpctblock announcement
-                // can't be used to interfere with block relay.
-                RemoveBlockRequest(pblock->GetHash(), std::nullopt);
+        if (fReconstructOptimistically) {
+            if (m_opts.cmpctblock_thread) {
+                QueueCompactBlockTask({.peer_id = pfrom.GetId(), .time_received = time_received, .cmpctblock = std::move(cmpctblock),
+                                       .extra_txn = vExtraTxnForCompact, .pindex = pindex});
+            } else {
+                ReconstructCompactBlockOptimistically(pfrom.GetId(), cmpctblock, vExtraTxnForCompact, *pindex, time_received);
             }
         }
         return;
@@ -5015,7 +5162,7 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
                 min_pow_checked = true;
             }
         }
-        ProcessBlock(pfrom, pblock, forceProcessing, min_pow_checked);
+        ProcessBlock(pfrom.GetId(), pblock, forceProcessing, min_pow_checked);
         return;
     }
 
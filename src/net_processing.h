@@ -27,6 +27,8 @@ static const uint32_t DEFAULT_MAX_ORPHAN_TRANSACTIONS{100};
 /** Default number of non-mempool transactions to keep around for block reconstruction. Includes
     orphan, replaced, and rejected transactions. */
 static const uint32_t DEFAULT_BLOCK_RECONSTRUCTION_EXTRA_TXN{100};
+/** Default for -cmpctblockthread, whether reconstructed compact blocks are validated on a dedicated thread */
+static constexpr bool DEFAULT_CMPCTBLOCK_THREAD{false};
 static const bool DEFAULT_PEERBLOOMFILTERS = false;
 static const bool DEFAULT_PEERBLOCKFILTERS = false;
 /** Maximum number of outstanding CMPCTBLOCK requests for the same block. */
@@ -66,6 +68,10 @@ public:
         //! Number of non-mempool transactions to keep around for block reconstruction. Includes
         //! orphan, replaced, and rejected transactions.
         uint32_t max_extra_txs{DEFAULT_BLOCK_RECONSTRUCTION_EXTRA_TXN};
+        //! Whether compact blocks are reconstructed (when already in flight
+        //! from another peer) and validated on a dedicated thread instead of
+        //! the message handler thread
+        bool cmpctblock_thread{DEFAULT_CMPCTBLOCK_THREAD};
         //! Whether all P2P messages are captured to disk
         bool capture_messages{false};
         //! Whether or not the internal RNG behaves deterministically (this is
@@ -90,6 +96,12 @@ public:
     /** Begin running background tasks, should only be called once */
     virtual void StartScheduledTasks(CScheduler& scheduler) = 0;
 
+    /**
+     * Stop the compact block thread, if any, dropping the blocks still queued on it.
+     * Must be called after the message handler was stopped and before the scheduler is.
+     */
+    virtual void Stop() = 0;
+
     /** Get statistics from node state */
     virtual bool GetNodeStateStats(NodeId nodeid, CNodeStateStats& stats) const = 0;
 
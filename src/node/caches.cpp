@@ -5,6 +5,8 @@
 #include <node/caches.h>
 
 #include <common/args.h>
+#include <index/prevoutindex.h>
+#include <index/scripthashindex.h>
 #include <index/txindex.h>
 #include <txdb.h>
 
@@ -19,6 +21,10 @@ CacheSizes CalculateCacheSizes(const ArgsManager& args, size_t n_indexes)
     nTotalCache -= sizes.block_tree_db;
     sizes.tx_index = std::min(nTotalCache / 8, args.GetBoolArg("-txindex", DEFAULT_TXINDEX) ? nMaxTxIndexCache << 20 : 0);
     nTotalCache -= sizes.tx_index;
+    sizes.prevout_index = std::min(nTotalCache / 8, args.GetBoolArg("-prevoutindex", DEFAULT_PREVOUTINDEX) ? nMaxTxIndexCache << 20 : 0);
+    nTotalCache -= sizes.prevout_index;
+    sizes.scripthash_index = std::min(nTotalCache / 8, args.GetBoolArg("-scripthashindex", DEFAULT_SCRIPTHASHINDEX) ? nMaxTxIndexCache << 20 : 0);
+    nTotalCache -= sizes.scripthash_index;
     sizes.filter_index = 0;
     if (n_indexes > 0) {
         int64_t max_cache = std::min(nTotalCache / 8, max_filter_index_cache << 20);
@@ -8,6 +8,7 @@
 #include <chain.h>
 #include <chainparams.h>
 #include <common/args.h>
+#include <common/system.h>
 #include <consensus/validation.h>
 #include <deploymentstatus.h>
 #include <external_signer.h>
@@ -51,6 +52,7 @@
 #include <uint256.h>
 #include <univalue.h>
 #include <util/check.h>
+#include <util/parallel.h>
 #include <util/result.h>
 #include <util/signalinterrupt.h>
 #include <util/string.h>
@@ -60,10 +62,12 @@
 
 #include <config/bitcoin-config.h> // IWYU pragma: keep
 
+#include <algorithm>
 #include <any>
 #include <memory>
 #include <optional>
 #include <utility>
+#include <vector>
 
 #include <boost/signals2/signal.hpp>
 
@@ -436,56 +440,106 @@ bool FillBlock(const CBlockIndex* index, const FoundBlock& block, UniqueLock<Rec
     return true;
 }
 
-class NotificationsProxy : public CValidationInterface
+/**
+ * Delivers validation events to all chain clients (wallets), which are
+ * registered as one subscriber. Each block event is built once and passed to
+ * the clients on several threads at once, as processing a block is costly for
+ * every client. The next event is only delivered once all clients are done, so
+ * each client still gets its notifications in order, one at a time.
+ */
+class NotificationsGroup : public CValidationInterface, public std::enable_shared_from_this<NotificationsGroup>
 {
 public:
-    explicit NotificationsProxy(std::shared_ptr<Chain::Notifications> notifications)
-        : m_notifications(std::move(notifications)) {}
-    virtual ~NotificationsProxy() = default;
+    void Add(ValidationSignals& signals, std::shared_ptr<Chain::Notifications> notifications) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        LOCK(m_mutex);
+        m_members.push_back(std::move(notifications));
+        if (m_members.size() == 1) {
+            // Chain clients (wallets) get a queue of their own, so that they
+            // don't delay other subscribers.
+            m_signals = &signals;
+            m_signals->RegisterSharedValidationInterface(shared_from_this(), "wallet");
+        }
+    }
+    void Remove(const Chain::Notifications* notifications) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        LOCK(m_mutex);
+        const auto it{std::find_if(m_members.begin(), m_members.end(), [&](const auto& member) { return member.get() == notifications; })};
+        if (it != m_members.end()) m_members.erase(it);
+        if (m_members.empty() && m_signals) {
+            m_signals->UnregisterValidationInterface(this);
+            m_signals = nullptr;
+        }
+    }
+
     void TransactionAddedToMempool(const NewMempoolTransactionInfo& tx, uint64_t mempool_sequence) override
     {
-        m_notifications->transactionAddedToMempool(tx.info.m_tx);
+        for (const auto& member : Members()) member->transactionAddedToMempool(tx.info.m_tx);
     }
     void TransactionRemovedFromMempool(const CTransactionRef& tx, MemPoolRemovalReason reason, uint64_t mempool_sequence) override
     {
-        m_notifications->transactionRemovedFromMempool(tx, reason);
+        for (const auto& member : Members()) member->transactionRemovedFromMempool(tx, reason);
     }
     void BlockConnected(ChainstateRole role, const std::shared_ptr<const CBlock>& block, const CBlockIndex* index) override
     {
-        m_notifications->blockConnected(role, kernel::MakeBlockInfo(index, block.get()));
+        const interfaces::BlockInfo info{kernel::MakeBlockInfo(index, block.get())};
+        ForEachConcurrently([&](Chain::Notifications& member) { member.blockConnected(role, info); });
     }
     void BlockDisconnected(const std::shared_ptr<const CBlock>& block, const CBlockIndex* index) override
     {
-        m_notifications->blockDisconnected(kernel::MakeBlockInfo(index, block.get()));
+        const interfaces::BlockInfo info{kernel::MakeBlockInfo(index, block.get())};
+        ForEachConcurrently([&](Chain::Notifications& member) { member.blockDisconnected(info); });
     }
     void UpdatedBlockTip(const CBlockIndex* index, const CBlockIndex* fork_index, bool is_ibd) override
     {
-        m_notifications->updatedBlockTip();
+        for (const auto& member : Members()) member->updatedBlockTip();
     }
-    void ChainStateFlushed(ChainstateRole role, const CBlockLocator& locator) override {
-        m_notifications->chainStateFlushed(role, locator);
+    void ChainStateFlushed(ChainstateRole role, const CBlockLocator& locator) override
+    {
+        for (const auto& member : Members()) member->chainStateFlushed(role, locator);
     }
-    std::shared_ptr<Chain::Notifications> m_notifications;
+
+private:
+    //! Copy of the members, so that they can be added and removed while an event is delivered.
+    std::vector<std::shared_ptr<Chain::Notifications>> Members() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        return WITH_LOCK(m_mutex, return m_members);
+    }
+
+    template <typename F>
+    void ForEachConcurrently(F&& func) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        const auto members{Members()};
+        const size_t num_threads{std::min<size_t>(members.size(), std::max(GetNumCores(), 1))};
+        util::ParallelFor(members.size(), num_threads, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) func(*members[i]);
+        });
+    }
+
+    mutable Mutex m_mutex;
+    std::vector<std::shared_ptr<Chain::Notifications>> m_members GUARDED_BY(m_mutex);
+    //! Signals the group is registered with, while it has members
+    ValidationSignals* m_signals GUARDED_BY(m_mutex){nullptr};
 };
 
 class NotificationsHandlerImpl : public Handler
 {
 public:
-    explicit NotificationsHandlerImpl(ValidationSignals& signals, std::shared_ptr<Chain::Notifications> notifications)
-        : m_signals{signals}, m_proxy{std::make_shared<NotificationsProxy>(std::move(notifications))}
+    explicit NotificationsHandlerImpl(ValidationSignals& signals, std::shared_ptr<NotificationsGroup> group, std::shared_ptr<Chain::Notifications> notifications)
+        : m_group{std::move(group)}, m_notifications{std::move(notifications)}
     {
-        m_signals.RegisterSharedValidationInterface(m_proxy);
+        m_group->Add(signals, m_notifications);
     }
     ~NotificationsHandlerImpl() override { disconnect(); }
     void disconnect() override
     {
-        if (m_proxy) {
-            m_signals.UnregisterSharedValidationInterface(m_proxy);
-            m_proxy.reset();
+        if (m_notifications) {
+            m_group->Remove(m_notifications.get());
+            m_notifications.reset();
         }
     }
-    ValidationSignals& m_signals;
-    std::shared_ptr<NotificationsProxy> m_proxy;
+    const std::shared_ptr<NotificationsGroup> m_group;
+    std::shared_ptr<Chain::Notifications> m_notifications;
 };
 
 class RpcHandlerImpl : public Handler
@@ -773,7 +827,7 @@ public:
     }
     std::unique_ptr<Handler> handleNotifications(std::shared_ptr<Notifications> notifications) override
     {
-        return std::make_unique<NotificationsHandlerImpl>(validation_signals(), std::move(notifications));
+        return std::make_unique<NotificationsHandlerImpl>(validation_signals(), m_notifications_group, std::move(notifications));
     }
     void waitForNotificationsIfTipChanged(const uint256& old_tip) override
     {
@@ -836,6 +890,7 @@ public:
     ChainstateManager& chainman() { return *Assert(m_node.chainman); }
     ValidationSignals& validation_signals() { return *Assert(m_node.validation_signals); }
     NodeContext& m_node;
+    const std::shared_ptr<NotificationsGroup> m_notifications_group{std::make_shared<NotificationsGroup>()};
 };
 
 class MinerImpl : public Mining
@@ -0,0 +1 @@
+#define BUILD_GIT_COMMIT "0c25014a9320-dirty"
@@ -11,6 +11,8 @@
 #include <uint256.h>
 #include <util/time.h>
 
+#include <algorithm>
+
 /** Nodes collect new transactions into a block, hash them into a hash tree,
  * and scan through nonce values to make the block's hash satisfy proof-of-work
  * requirements.  When they solve the proof-of-work, they broadcast the block
@@ -67,6 +69,10 @@ public:
 
 class CBlock : public CBlockHeader
 {
+    //! Upper bound for reserving transactions while deserializing, so the
+    //! claimed count of an invalid block can't trigger a huge allocation.
+    static constexpr uint64_t MAX_BLOCK_TXS_RESERVE{1 << 14};
+
 public:
     // network and disk
     std::vector<CTransactionRef> vtx;
@@ -87,9 +93,25 @@ public:
         *(static_cast<CBlockHeader*>(this)) = header;
     }
 
-    SERIALIZE_METHODS(CBlock, obj)
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        s << AsBase<CBlockHeader>(*this) << vtx;
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
     {
-        READWRITE(AsBase<CBlockHeader>(obj), obj.vtx);
+        s >> AsBase<CBlockHeader>(*this);
+        // Read all transactions before constructing them, so that their
+        // hashes are computed together.
+        const uint64_t n_tx{ReadCompactSize(s)};
+        std::vector<CMutableTransaction> txs;
+        txs.reserve(std::min<uint64_t>(n_tx, MAX_BLOCK_TXS_RESERVE));
+        for (uint64_t i = 0; i < n_tx; ++i) {
+            txs.emplace_back(deserialize, s);
+        }
+        vtx = MakeTransactionRefs(std::move(txs), s.template GetParams<TransactionSerParams>().block_arena);
     }
 
     void SetNull()
@@ -7,9 +7,12 @@
 
 #include <consensus/amount.h>
 #include <crypto/hex_base.h>
+#include <crypto/sha256.h>
 #include <hash.h>
 #include <script/script.h>
 #include <serialize.h>
+#include <streams.h>
+#include <support/allocators/arena.h>
 #include <tinyformat.h>
 #include <uint256.h>
 #include <util/transaction_identifier.h>
@@ -94,6 +97,77 @@ Wtxid CTransaction::ComputeWitnessHash() const
 
 CTransaction::CTransaction(const CMutableTransaction& tx) : vin(tx.vin), vout(tx.vout), version{tx.version}, nLockTime{tx.nLockTime}, m_has_witness{ComputeHasWitness()}, hash{ComputeHash()}, m_witness_hash{ComputeWitnessHash()} {}
 CTransaction::CTransaction(CMutableTransaction&& tx) : vin(std::move(tx.vin)), vout(std::move(tx.vout)), version{tx.version}, nLockTime{tx.nLockTime}, m_has_witness{ComputeHasWitness()}, hash{ComputeHash()}, m_witness_hash{ComputeWitnessHash()} {}
+CTransaction::CTransaction(CMutableTransaction&& tx, const PrecomputedHashes& hashes) : vin(std::move(tx.vin)), vout(std::move(tx.vout)), version{tx.version}, nLockTime{tx.nLockTime}, m_has_witness{ComputeHasWitness()}, hash{hashes.m_txid}, m_witness_hash{hashes.m_wtxid} {}
+
+std::vector<CTransactionRef> MakeTransactionRefs(std::vector<CMutableTransaction>&& txs, bool use_arena)
+{
+    // Serialize every transaction once, without witness, for its txid. The
+    // witness serialization hashed for the wtxid is assembled from those bytes
+    // and the witness stacks: the marker and flag bytes follow the version,
+    // and the witnesses precede the lock time.
+    std::vector<unsigned char> buffer;
+    std::vector<unsigned char> witness;
+    std::vector<std::pair<size_t, size_t>> ranges;
+    ranges.reserve(txs.size() * 2);
+    // Index into ranges of the serialization without witness, and of the
+    // witness serialization (0 if there is none).
+    std::vector<size_t> txid_range(txs.size());
+    std::vector<size_t> witness_range(txs.size(), 0);
+    for (size_t i = 0; i < txs.size(); ++i) {
+        const size_t begin{buffer.size()};
+        VectorWriter{buffer, begin, TX_NO_WITNESS(txs[i])};
+        const size_t end{buffer.size()};
+        txid_range[i] = ranges.size();
+        ranges.emplace_back(begin, end);
+        if (!txs[i].HasWitness()) continue;
+
+        witness.clear();
+        VectorWriter witness_writer{witness, 0};
+        for (const CTxIn& txin : txs[i].vin) {
+            witness_writer << txin.scriptWitness.stack;
+        }
+        constexpr size_t VERSION_SIZE{4}, LOCKTIME_SIZE{4};
+        const size_t body_size{end - begin - VERSION_SIZE - LOCKTIME_SIZE};
+        buffer.resize(end + VERSION_SIZE + 2 + body_size + witness.size() + LOCKTIME_SIZE);
+        unsigned char* out{buffer.data() + end};
+        const unsigned char* tx_data{buffer.data() + begin};
+        out = std::copy_n(tx_data, VERSION_SIZE, out);
+        *out++ = 0x00; // marker
+        *out++ = 0x01; // flag
+        out = std::copy_n(tx_data + VERSION_SIZE, body_size, out);
+        out = std::copy(witness.begin(), witness.end(), out);
+        std::copy_n(tx_data + VERSION_SIZE + body_size, LOCKTIME_SIZE, out);
+        witness_range[i] = ranges.size();
+        ranges.emplace_back(end, buffer.size());
+    }
+
+    std::vector<Span<const unsigned char>> msgs;
+    msgs.reserve(ranges.size());
+    for (const auto& [begin, end] : ranges) {
+        msgs.emplace_back(buffer.data() + begin, end - begin);
+    }
+    std::vector<unsigned char> hashes(msgs.size() * CSHA256::OUTPUT_SIZE);
+    SHA256DMulti(hashes.data(), msgs.data(), msgs.size());
+
+    auto get_hash = [&](size_t i) { return uint256{Span{hashes}.subspan(i * CSHA256::OUTPUT_SIZE, CSHA256::OUTPUT_SIZE)}; };
+    std::shared_ptr<ArenaAllocator<CTransaction>::Arena> arena;
+    if (use_arena) {
+        // Room for each transaction and its shared_ptr control block.
+        arena = std::make_shared<ArenaAllocator<CTransaction>::Arena>(txs.size() * (sizeof(CTransaction) + 64));
+    }
+    std::vector<CTransactionRef> ret;
+    ret.reserve(txs.size());
+    for (size_t i = 0; i < txs.size(); ++i) {
+        const Txid txid{Txid::FromUint256(get_hash(txid_range[i]))};
+        const Wtxid wtxid{Wtxid::FromUint256(witness_range[i] ? get_hash(witness_range[i]) : txid.ToUint256())};
+        if (arena) {
+            ret.push_back(std::allocate_shared<const CTransaction>(ArenaAllocator<CTransaction>{arena}, std::move(txs[i]), CTransaction::PrecomputedHashes{txid, wtxid}));
+        } else {
+            ret.push_back(std::make_shared<const CTransaction>(std::move(txs[i]), CTransaction::PrecomputedHashes{txid, wtxid}));
+        }
+    }
+    return ret;
+}
 
 CAmount CTransaction::GetValueOut() const
 {
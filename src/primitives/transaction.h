@@ -190,10 +190,15 @@ struct CMutableTransaction;
 
 struct TransactionSerParams {
     const bool allow_witness;
+    //! When deserializing a block, allocate its transactions from one arena (see MakeTransactionRefs).
+    //! Any of its transactions kept alive keeps the whole arena allocated, so
+    //! this is only suited to blocks whose transactions are all short-lived.
+    const bool block_arena{false};
     SER_PARAMS_OPFUNC
 };
 static constexpr TransactionSerParams TX_WITH_WITNESS{.allow_witness = true};
 static constexpr TransactionSerParams TX_NO_WITNESS{.allow_witness = false};
+static constexpr TransactionSerParams TX_WITH_WITNESS_ARENA{.allow_witness = true, .block_arena = true};
 
 /**
  * Basic transaction serialization format:
@@ -320,9 +325,23 @@ private:
     bool ComputeHasWitness() const;
 
 public:
+    /** Hashes of a transaction computed before constructing it, which only
+     *  MakeTransactionRefs() can create. */
+    class PrecomputedHashes
+    {
+        Txid m_txid;
+        Wtxid m_wtxid;
+
+        PrecomputedHashes(const Txid& txid, const Wtxid& wtxid) : m_txid{txid}, m_wtxid{wtxid} {}
+
+        friend class CTransaction;
+        friend std::vector<std::shared_ptr<const CTransaction>> MakeTransactionRefs(std::vector<CMutableTransaction>&& txs, bool use_arena);
+    };
+
     /** Convert a CMutableTransaction into a CTransaction. */
     explicit CTransaction(const CMutableTransaction& tx);
     explicit CTransaction(CMutableTransaction&& tx);
+    CTransaction(CMutableTransaction&& tx, const PrecomputedHashes& hashes);
 
     template <typename Stream>
     inline void Serialize(Stream& s) const {
@@ -423,6 +442,12 @@ struct CMutableTransaction
 typedef std::shared_ptr<const CTransaction> CTransactionRef;
 template <typename Tx> static inline CTransactionRef MakeTransactionRef(Tx&& txIn) { return std::make_shared<const CTransaction>(std::forward<Tx>(txIn)); }
 
+/** Convert many CMutableTransactions at once, hashing them together (see SHA256DMulti).
+ *  With use_arena, the transactions are allocated from a single arena instead
+ *  of one allocation each, which is freed once none of them is referenced any
+ *  more. Their inputs, outputs and scripts are still allocated individually. */
+std::vector<CTransactionRef> MakeTransactionRefs(std::vector<CMutableTransaction>&& txs, bool use_arena = false);
+
 /** A generic txid reference (txid or wtxid). */
 class GenTxid
 {
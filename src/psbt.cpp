@@ -4,12 +4,18 @@
 
 #include <psbt.h>
 
+#include <common/system.h>
 #include <node/types.h>
 #include <policy/policy.h>
 #include <script/signingprovider.h>
 #include <util/check.h>
+#include <util/parallel.h>
 #include <util/strencodings.h>
 
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
 PartiallySignedTransaction::PartiallySignedTransaction(const CMutableTransaction& tx) : tx(tx)
 {
     inputs.resize(tx.vin.size());
@@ -295,7 +301,7 @@ bool PSBTInputSigned(const PSBTInput& input)
     return !input.final_script_sig.empty() || !input.final_script_witness.IsNull();
 }
 
-bool PSBTInputSignedAndVerified(const PartiallySignedTransaction psbt, unsigned int input_index, const PrecomputedTransactionData* txdata)
+bool PSBTInputSignedAndVerified(const PartiallySignedTransaction& psbt, unsigned int input_index, const PrecomputedTransactionData* txdata)
 {
     CTxOut utxo;
     assert(psbt.inputs.size() >= input_index);
@@ -445,6 +451,37 @@ bool SignPSBTInput(const SigningProvider& provider, PartiallySignedTransaction&
     return sig_complete;
 }
 
+//! Number of threads to process num_inputs inputs of a PSBT with
+static size_t PSBTInputThreads(size_t num_inputs)
+{
+    return std::clamp<size_t>(num_inputs / PSBT_MIN_INPUTS_PER_THREAD, 1, std::max(GetNumCores(), 1));
+}
+
+bool SignPSBTInputs(Span<const SigningProvider* const> providers, PartiallySignedTransaction& psbt, const PrecomputedTransactionData& txdata, int sighash, bool finalize)
+{
+    assert(providers.size() <= psbt.inputs.size());
+    std::atomic<bool> complete{true};
+    util::ParallelFor(providers.size(), PSBTInputThreads(providers.size()), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            if (providers[i] && !SignPSBTInput(*providers[i], psbt, i, &txdata, sighash, nullptr, finalize)) {
+                complete = false;
+            }
+        }
+    });
+    return complete;
+}
+
+bool PSBTInputsSignedAndVerified(const PartiallySignedTransaction& psbt, const PrecomputedTransactionData& txdata)
+{
+    std::atomic<bool> complete{true};
+    util::ParallelFor(psbt.inputs.size(), PSBTInputThreads(psbt.inputs.size()), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end && complete; ++i) {
+            if (!PSBTInputSignedAndVerified(psbt, i, &txdata)) complete = false;
+        }
+    });
+    return complete;
+}
+
 void RemoveUnnecessaryTransactions(PartiallySignedTransaction& psbtx, const int& sighash_type)
 {
     // Only drop non_witness_utxos if sighash_type != SIGHASH_ANYONECANPAY
@@ -483,13 +520,9 @@ bool FinalizePSBT(PartiallySignedTransaction& psbtx)
     //   signature, but have not combined them yet (e.g. because the combiner that created this
     //   PartiallySignedTransaction did not understand them), this will combine them into a final
     //   script.
-    bool complete = true;
     const PrecomputedTransactionData txdata = PrecomputePSBTData(psbtx);
-    for (unsigned int i = 0; i < psbtx.tx->vin.size(); ++i) {
-        complete &= SignPSBTInput(DUMMY_SIGNING_PROVIDER, psbtx, i, &txdata, SIGHASH_ALL, nullptr, true);
-    }
-
-    return complete;
+    const std::vector<const SigningProvider*> providers(psbtx.tx->vin.size(), &DUMMY_SIGNING_PROVIDER);
+    return SignPSBTInputs(providers, psbtx, txdata, SIGHASH_ALL, /*finalize=*/true);
 }
 
 bool FinalizeAndExtractPSBT(PartiallySignedTransaction& psbtx, CMutableTransaction& result)
@@ -1229,7 +1229,7 @@ PrecomputedTransactionData PrecomputePSBTData(const PartiallySignedTransaction&
 bool PSBTInputSigned(const PSBTInput& input);
 
 /** Checks whether a PSBTInput is already signed by doing script verification using final fields. */
-bool PSBTInputSignedAndVerified(const PartiallySignedTransaction psbt, unsigned int input_index, const PrecomputedTransactionData* txdata);
+bool PSBTInputSignedAndVerified(const PartiallySignedTransaction& psbt, unsigned int input_index, const PrecomputedTransactionData* txdata);
 
 /** Signs a PSBTInput, verifying that all provided data matches what is being signed.
  *
@@ -1238,6 +1238,22 @@ bool PSBTInputSignedAndVerified(const PartiallySignedTransaction psbt, unsigned
  **/
 bool SignPSBTInput(const SigningProvider& provider, PartiallySignedTransaction& psbt, int index, const PrecomputedTransactionData* txdata, int sighash = SIGHASH_ALL, SignatureData* out_sigdata = nullptr, bool finalize = true);
 
+//! Minimum number of inputs each thread gets when the inputs of a PSBT are signed in parallel
+static constexpr size_t PSBT_MIN_INPUTS_PER_THREAD{32};
+
+/** Signs the inputs of a PSBT with SignPSBTInput(), using providers[i] for
+ * input i, and skipping the inputs without a provider. Inputs of large
+ * transactions are signed on several threads, each input by one thread, so
+ * the providers must not be shared between inputs unless safe to use
+ * concurrently.
+ *
+ * @return whether all inputs with a provider are now complete
+ **/
+bool SignPSBTInputs(Span<const SigningProvider* const> providers, PartiallySignedTransaction& psbt, const PrecomputedTransactionData& txdata, int sighash = SIGHASH_ALL, bool finalize = true);
+
+/** Checks PSBTInputSignedAndVerified() for all inputs, on several threads for large transactions. */
+bool PSBTInputsSignedAndVerified(const PartiallySignedTransaction& psbt, const PrecomputedTransactionData& txdata);
+
 /**  Reduces the size of the PSBT by dropping unnecessary `non_witness_utxos` (i.e. complete previous transactions) from a psbt when all inputs are segwit v1. */
 void RemoveUnnecessaryTransactions(PartiallySignedTransaction& psbtx, const int& sighash_type);
 
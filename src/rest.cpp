@@ -14,6 +14,8 @@
 #include <flatfile.h>
 #include <httpserver.h>
 #include <index/blockfilterindex.h>
+#include <index/prevoutindex.h>
+#include <index/scripthashindex.h>
 #include <index/txindex.h>
 #include <node/blockstorage.h>
 #include <node/context.h>
@@ -755,6 +757,153 @@ static bool rest_tx(const std::any& context, HTTPRequest* req, const std::string
     }
 }
 
+static bool rest_txprevouts(const std::any& context, HTTPRequest* req, const std::string& strURIPart)
+{
+    if (!CheckWarmup(req))
+        return false;
+    std::string hashStr;
+    const RESTResponseFormat rf = ParseDataFormat(hashStr, strURIPart);
+
+    uint256 hash;
+    if (!ParseHashStr(hashStr, hash))
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid hash: " + hashStr);
+
+    if (!g_prevout_index) {
+        return RESTERR(req, HTTP_BAD_REQUEST, "Prevout index is not enabled (-prevoutindex)");
+    }
+    g_prevout_index->BlockUntilSyncedToCurrentChain();
+
+    TxPrevouts prevouts;
+    if (!g_prevout_index->FindTxPrevouts(hash, prevouts)) {
+        return RESTERR(req, HTTP_NOT_FOUND, hashStr + " not found");
+    }
+
+    switch (rf) {
+    case RESTResponseFormat::JSON: {
+        ChainstateManager* maybe_chainman = GetChainman(context, req);
+        if (!maybe_chainman) return false;
+        ChainstateManager& chainman = *maybe_chainman;
+        LOCK(cs_main);
+        const CBlockIndex* blockindex{chainman.ActiveChain()[prevouts.height]};
+        if (!blockindex) {
+            return RESTERR(req, HTTP_NOT_FOUND, hashStr + " not found");
+        }
+        UniValue objPrevouts = TxPrevoutsToJSON(hash, prevouts, *chainman.ActiveChain().Tip(), *blockindex);
+        std::string strJSON = objPrevouts.write() + "\n";
+        req->WriteHeader("Content-Type", "application/json");
+        req->WriteReply(HTTP_OK, strJSON);
+        return true;
+    }
+
+    default: {
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: json)");
+    }
+    }
+}
+
+/** Parse the hex-encoded output script of a /rest/script* request and look up its hash in the script hash index. */
+static std::optional<uint256> ParseScriptHashRequest(HTTPRequest* req, const std::string& script_hex)
+{
+    if (!IsHex(script_hex)) {
+        RESTERR(req, HTTP_BAD_REQUEST, "Invalid script: " + script_hex);
+        return std::nullopt;
+    }
+    if (!g_scripthash_index) {
+        RESTERR(req, HTTP_BAD_REQUEST, "Script hash index is not enabled (-scripthashindex)");
+        return std::nullopt;
+    }
+    if (!g_scripthash_index->BlockUntilSyncedToCurrentChain()) {
+        RESTERR(req, HTTP_SERVICE_UNAVAILABLE, "Script hash index is still syncing");
+        return std::nullopt;
+    }
+    const std::vector<unsigned char> script_data{ParseHex(script_hex)};
+    return ScriptHashIndex::GetScriptHash(CScript(script_data.begin(), script_data.end()));
+}
+
+static bool rest_scripthistory(const std::any& context, HTTPRequest* req, const std::string& strURIPart)
+{
+    if (!CheckWarmup(req))
+        return false;
+    std::string script_hex;
+    const RESTResponseFormat rf = ParseDataFormat(script_hex, strURIPart);
+
+    std::string raw_start_height;
+    std::string raw_count;
+    std::optional<std::string> raw_cursor;
+    try {
+        raw_start_height = req->GetQueryParameter("start_height").value_or("0");
+        raw_count = req->GetQueryParameter("count").value_or(util::ToString(DEFAULT_SCRIPT_HISTORY_COUNT));
+        raw_cursor = req->GetQueryParameter("cursor");
+    } catch (const std::runtime_error& e) {
+        return RESTERR(req, HTTP_BAD_REQUEST, e.what());
+    }
+    const auto start_height{ToIntegral<int32_t>(raw_start_height)};
+    if (!start_height.has_value() || *start_height < 0) {
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid start_height: " + raw_start_height);
+    }
+    const auto count{ToIntegral<size_t>(raw_count)};
+    if (!count.has_value() || *count < 1) {
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid count: " + raw_count);
+    }
+    ScriptEventPos start{.height = *start_height};
+    if (raw_cursor) {
+        const auto cursor{ScriptEventPosFromString(*raw_cursor)};
+        if (!cursor) {
+            return RESTERR(req, HTTP_BAD_REQUEST, "Invalid cursor: " + *raw_cursor);
+        }
+        start = *cursor;
+    }
+
+    const auto script_hash{ParseScriptHashRequest(req, script_hex)};
+    if (!script_hash) return false;
+
+    switch (rf) {
+    case RESTResponseFormat::JSON: {
+        std::vector<ScriptEvent> events;
+        std::optional<ScriptEventPos> next;
+        if (!g_scripthash_index->LookupEvents(*script_hash, start, *count, events, next)) {
+            return RESTERR(req, HTTP_INTERNAL_SERVER_ERROR, "Unable to read script history from index");
+        }
+        std::string strJSON = ScriptHistoryToJSON(*script_hash, events, next).write() + "\n";
+        req->WriteHeader("Content-Type", "application/json");
+        req->WriteReply(HTTP_OK, strJSON);
+        return true;
+    }
+
+    default: {
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: json)");
+    }
+    }
+}
+
+static bool rest_scriptutxos(const std::any& context, HTTPRequest* req, const std::string& strURIPart)
+{
+    if (!CheckWarmup(req))
+        return false;
+    std::string script_hex;
+    const RESTResponseFormat rf = ParseDataFormat(script_hex, strURIPart);
+
+    const auto script_hash{ParseScriptHashRequest(req, script_hex)};
+    if (!script_hash) return false;
+
+    switch (rf) {
+    case RESTResponseFormat::JSON: {
+        std::vector<ScriptEvent> unspent;
+        if (!g_scripthash_index->LookupUnspent(*script_hash, unspent)) {
+            return RESTERR(req, HTTP_INTERNAL_SERVER_ERROR, "Unable to read script history from index");
+        }
+        std::string strJSON = ScriptUnspentToJSON(*script_hash, unspent).write() + "\n";
+        req->WriteHeader("Content-Type", "application/json");
+        req->WriteReply(HTTP_OK, strJSON);
+        return true;
+    }
+
+    default: {
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: json)");
+    }
+    }
+}
+
 static bool rest_getutxos(const std::any& context, HTTPRequest* req, const std::string& strURIPart)
 {
     if (!CheckWarmup(req))
@@ -1004,6 +1153,7 @@ static const struct {
     bool (*handler)(const std::any& context, HTTPRequest* req, const std::string& strReq);
 } uri_prefixes[] = {
       {"/rest/tx/", rest_tx},
+      {"/rest/txprevouts/", rest_txprevouts},
       {"/rest/block/notxdetails/", rest_block_notxdetails},
       {"/rest/block/", rest_block_extended},
       {"/rest/blockfilter/", rest_block_filter},
@@ -1012,6 +1162,8 @@ static const struct {
       {"/rest/mempool/", rest_mempool},
       {"/rest/headers/", rest_headers},
       {"/rest/getutxos", rest_getutxos},
+      {"/rest/scripthistory/", rest_scripthistory},
+      {"/rest/scriptutxos/", rest_scriptutxos},
       {"/rest/deploymentinfo/", rest_deploymentinfo},
       {"/rest/deploymentinfo", rest_deploymentinfo},
       {"/rest/blockhashbyheight/", rest_blockhash_by_height},
@@ -21,6 +21,9 @@
 #include <hash.h>
 #include <index/blockfilterindex.h>
 #include <index/coinstatsindex.h>
+#include <index/prevoutindex.h>
+#include <index/scripthashindex.h>
+#include <key_io.h>
 #include <kernel/coinstats.h>
 #include <logging/timer.h>
 #include <net.h>
@@ -45,6 +48,7 @@
 #include <util/check.h>
 #include <util/fs.h>
 #include <util/strencodings.h>
+#include <util/string.h>
 #include <util/translation.h>
 #include <validation.h>
 #include <validationinterface.h>
@@ -182,8 +186,9 @@ UniValue blockToJSON(BlockManager& blockman, const CBlock& block, const CBlockIn
         case TxVerbosity::SHOW_DETAILS:
         case TxVerbosity::SHOW_DETAILS_AND_PREVOUT:
             CBlockUndo blockUndo;
-            const bool is_not_pruned{WITH_LOCK(::cs_main, return !blockman.IsBlockPruned(blockindex))};
-            const bool have_undo{is_not_pruned && blockman.UndoReadFromDisk(blockUndo, blockindex)};
+            // Prefer the prevout index (if enabled) over reading the undo data from disk
+            const bool have_undo{(g_prevout_index && g_prevout_index->FindBlockPrevouts(blockindex, block, blockUndo)) ||
+                                 (WITH_LOCK(::cs_main, return !blockman.IsBlockPruned(blockindex)) && blockman.UndoReadFromDisk(blockUndo, blockindex))};
 
             for (size_t i = 0; i < block.vtx.size(); ++i) {
                 const CTransactionRef& tx = block.vtx.at(i);
@@ -2557,6 +2562,310 @@ static RPCHelpMan scanblocks()
     };
 }
 
+UniValue TxPrevoutsToJSON(const uint256& txid, const TxPrevouts& prevouts, const CBlockIndex& tip, const CBlockIndex& blockindex)
+{
+    UniValue result(UniValue::VOBJ);
+    result.pushKV("txid", txid.GetHex());
+    result.pushKV("blockhash", blockindex.GetBlockHash().GetHex());
+    result.pushKV("height", blockindex.nHeight);
+    result.pushKV("confirmations", tip.nHeight - blockindex.nHeight + 1);
+    result.pushKV("fee", ValueFromAmount(prevouts.fee));
+
+    CAmount amt_total_in{0};
+    UniValue vprevout(UniValue::VARR);
+    for (const Coin& coin : prevouts.undo.vprevout) {
+        amt_total_in += coin.out.nValue;
+
+        UniValue o_script_pub_key(UniValue::VOBJ);
+        ScriptToUniv(coin.out.scriptPubKey, /*out=*/o_script_pub_key, /*include_hex=*/true, /*include_address=*/true);
+
+        UniValue p(UniValue::VOBJ);
+        p.pushKV("generated", bool(coin.fCoinBase));
+        p.pushKV("height", uint64_t(coin.nHeight));
+        p.pushKV("value", ValueFromAmount(coin.out.nValue));
+        p.pushKV("scriptPubKey", std::move(o_script_pub_key));
+        vprevout.push_back(std::move(p));
+    }
+    result.pushKV("value_in", ValueFromAmount(amt_total_in));
+    result.pushKV("prevouts", std::move(vprevout));
+    return result;
+}
+
+static RPCHelpMan gettxprevouts()
+{
+    return RPCHelpMan{"gettxprevouts",
+                "\nReturns the fee and the outputs spent by a transaction confirmed in the active chain.\n"
+                "Requires -prevoutindex. Block undo data is not read, so this also works for pruned blocks.\n",
+                {
+                    {"txid", RPCArg::Type::STR_HEX, RPCArg::Optional::NO, "The transaction id"},
+                },
+                RPCResult{
+                    RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::STR_HEX, "txid", "The transaction id (same as provided)"},
+                        {RPCResult::Type::STR_HEX, "blockhash", "The hash of the block the transaction is confirmed in"},
+                        {RPCResult::Type::NUM, "height", "The height of the block the transaction is confirmed in"},
+                        {RPCResult::Type::NUM, "confirmations", "The number of confirmations"},
+                        {RPCResult::Type::STR_AMOUNT, "fee", "The transaction fee in " + CURRENCY_UNIT},
+                        {RPCResult::Type::STR_AMOUNT, "value_in", "The total value of the spent outputs in " + CURRENCY_UNIT},
+                        {RPCResult::Type::ARR, "prevouts", "The spent outputs, in input order",
+                        {
+                            {RPCResult::Type::OBJ, "", "",
+                            {
+                                {RPCResult::Type::BOOL, "generated", "Coinbase or not"},
+                                {RPCResult::Type::NUM, "height", "The height of the prevout"},
+                                {RPCResult::Type::STR_AMOUNT, "value", "The value in " + CURRENCY_UNIT},
+                                {RPCResult::Type::OBJ, "scriptPubKey", "",
+                                {
+                                    {RPCResult::Type::STR, "asm", "Disassembly of the output script"},
+                                    {RPCResult::Type::STR, "desc", "Inferred descriptor for the output"},
+                                    {RPCResult::Type::STR_HEX, "hex", "The raw output script bytes, hex-encoded"},
+                                    {RPCResult::Type::STR, "address", /*optional=*/true, "The Bitcoin address (only if a well-defined address exists)"},
+                                    {RPCResult::Type::STR, "type", "The type (one of: " + GetAllOutputTypes() + ")"},
+                                }},
+                            }},
+                        }},
+                    }},
+                RPCExamples{
+                    HelpExampleCli("gettxprevouts", "\"mytxid\"") +
+                    HelpExampleRpc("gettxprevouts", "\"mytxid\"")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    const uint256 txid{ParseHashV(request.params[0], "txid")};
+
+    if (!g_prevout_index) {
+        throw JSONRPCError(RPC_MISC_ERROR, "Requires -prevoutindex");
+    }
+    const bool index_ready{g_prevout_index->BlockUntilSyncedToCurrentChain()};
+
+    TxPrevouts prevouts;
+    if (!g_prevout_index->FindTxPrevouts(txid, prevouts)) {
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, index_ready ?
+            "No such confirmed non-coinbase transaction" :
+            "No such confirmed non-coinbase transaction. Blockchain transactions are still in the process of being indexed");
+    }
+
+    ChainstateManager& chainman = EnsureAnyChainman(request.context);
+    LOCK(cs_main);
+    const CBlockIndex* blockindex{chainman.ActiveChain()[prevouts.height]};
+    if (!blockindex) {
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No such confirmed non-coinbase transaction");
+    }
+    return TxPrevoutsToJSON(txid, prevouts, *CHECK_NONFATAL(chainman.ActiveChain().Tip()), *blockindex);
+},
+    };
+}
+
+UniValue ScriptEventToJSON(const ScriptEvent& event)
+{
+    UniValue result(UniValue::VOBJ);
+    const bool funding{event.type == ScriptEvent::Type::FUNDING};
+    result.pushKV("type", funding ? "funding" : "spending");
+    result.pushKV("txid", event.txid.GetHex());
+    result.pushKV(funding ? "vout" : "vin", uint64_t{event.index});
+    result.pushKV("height", event.height);
+    result.pushKV("value", ValueFromAmount(event.value));
+    if (!funding) {
+        UniValue prevout(UniValue::VOBJ);
+        prevout.pushKV("txid", event.prevout.hash.GetHex());
+        prevout.pushKV("vout", uint64_t{event.prevout.n});
+        result.pushKV("prevout", std::move(prevout));
+    }
+    return result;
+}
+
+UniValue ScriptHistoryToJSON(const uint256& script_hash, const std::vector<ScriptEvent>& events, const std::optional<ScriptEventPos>& next)
+{
+    UniValue events_json(UniValue::VARR);
+    for (const ScriptEvent& event : events) {
+        events_json.push_back(ScriptEventToJSON(event));
+    }
+    UniValue result(UniValue::VOBJ);
+    result.pushKV("scripthash", script_hash.GetHex());
+    result.pushKV("events", std::move(events_json));
+    if (next) result.pushKV("next", ScriptEventPosToString(*next));
+    return result;
+}
+
+std::string ScriptEventPosToString(const ScriptEventPos& pos)
+{
+    return strprintf("%d:%u:%u:%u", pos.height, pos.tx_pos, uint8_t(pos.type), pos.index);
+}
+
+std::optional<ScriptEventPos> ScriptEventPosFromString(std::string_view str)
+{
+    const std::vector<std::string> parts{util::SplitString(str, ':')};
+    if (parts.size() != 4) return std::nullopt;
+    const auto height{ToIntegral<int32_t>(parts[0])};
+    const auto tx_pos{ToIntegral<uint32_t>(parts[1])};
+    const auto type{ToIntegral<uint8_t>(parts[2])};
+    const auto index{ToIntegral<uint32_t>(parts[3])};
+    if (!height || *height < 0 || !tx_pos || !type || *type > uint8_t(ScriptEvent::Type::SPENDING) || !index) return std::nullopt;
+    return ScriptEventPos{*height, *tx_pos, ScriptEvent::Type{*type}, *index};
+}
+
+UniValue ScriptUnspentToJSON(const uint256& script_hash, const std::vector<ScriptEvent>& unspent)
+{
+    CAmount total_in{0};
+    UniValue unspents(UniValue::VARR);
+    for (const ScriptEvent& event : unspent) {
+        UniValue utxo(UniValue::VOBJ);
+        utxo.pushKV("txid", event.txid.GetHex());
+        utxo.pushKV("vout", uint64_t{event.index});
+        utxo.pushKV("height", event.height);
+        utxo.pushKV("value", ValueFromAmount(event.value));
+        unspents.push_back(std::move(utxo));
+        total_in += event.value;
+    }
+    UniValue result(UniValue::VOBJ);
+    result.pushKV("scripthash", script_hash.GetHex());
+    result.pushKV("total_amount", ValueFromAmount(total_in));
+    result.pushKV("unspents", std::move(unspents));
+    return result;
+}
+
+/** Parse an address or a hex-encoded output script. */
+static CScript ParseAddressOrScript(const UniValue& param)
+{
+    const std::string& str{param.get_str()};
+    const CTxDestination dest{DecodeDestination(str)};
+    if (IsValidDestination(dest)) {
+        return GetScriptForDestination(dest);
+    }
+    if (IsHex(str)) {
+        const std::vector<unsigned char> data{ParseHex(str)};
+        return CScript(data.begin(), data.end());
+    }
+    throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid address or script: " + str);
+}
+
+static ScriptHashIndex& EnsureScriptHashIndex()
+{
+    if (!g_scripthash_index) {
+        throw JSONRPCError(RPC_MISC_ERROR, "Requires -scripthashindex");
+    }
+    if (!g_scripthash_index->BlockUntilSyncedToCurrentChain()) {
+        const IndexSummary summary{g_scripthash_index->GetSummary()};
+        throw JSONRPCError(RPC_INTERNAL_ERROR, strprintf("Unable to get data because scripthashindex is still syncing. Current height: %d", summary.best_block_height));
+    }
+    return *g_scripthash_index;
+}
+
+static RPCHelpMan getscripthistory()
+{
+    return RPCHelpMan{"getscripthistory",
+                "\nReturns the confirmed transactions funding and spending an address or output script, in block order.\n"
+                "Requires -scripthashindex.\n",
+                {
+                    {"script", RPCArg::Type::STR, RPCArg::Optional::NO, "The address or hex-encoded output script"},
+                    {"start_height", RPCArg::Type::NUM, RPCArg::Default{0}, "Only return events in blocks at or above this height"},
+                    {"count", RPCArg::Type::NUM, RPCArg::Default{DEFAULT_SCRIPT_HISTORY_COUNT}, "The maximum number of events to return"},
+                    {"cursor", RPCArg::Type::STR, RPCArg::Optional::OMITTED, "Continue from the \"next\" value of a previous call instead of from start_height"},
+                },
+                RPCResult{
+                    RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::STR_HEX, "scripthash", "The SHA256 of the output script"},
+                        {RPCResult::Type::ARR, "events", "",
+                        {
+                            {RPCResult::Type::OBJ, "", "",
+                            {
+                                {RPCResult::Type::STR, "type", "\"funding\" if the transaction created an output paying to the script, \"spending\" if it spent one"},
+                                {RPCResult::Type::STR_HEX, "txid", "The transaction id"},
+                                {RPCResult::Type::NUM, "vout", /*optional=*/true, "The output index (funding only)"},
+                                {RPCResult::Type::NUM, "vin", /*optional=*/true, "The input index (spending only)"},
+                                {RPCResult::Type::NUM, "height", "The height of the block containing the transaction"},
+                                {RPCResult::Type::STR_AMOUNT, "value", "The value of the created or spent output in " + CURRENCY_UNIT},
+                                {RPCResult::Type::OBJ, "prevout", /*optional=*/true, "The spent output (spending only)",
+                                {
+                                    {RPCResult::Type::STR_HEX, "txid", "The transaction id"},
+                                    {RPCResult::Type::NUM, "vout", "The output index"},
+                                }},
+                            }},
+                        }},
+                        {RPCResult::Type::STR, "next", /*optional=*/true, "The cursor to pass to get the following events, if there are more"},
+                    }},
+                RPCExamples{
+                    HelpExampleCli("getscripthistory", "\"" + EXAMPLE_ADDRESS[0] + "\"") +
+                    HelpExampleCli("getscripthistory", "\"" + EXAMPLE_ADDRESS[0] + "\" 800000 100") +
+                    HelpExampleRpc("getscripthistory", "\"" + EXAMPLE_ADDRESS[0] + "\"")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    const CScript script{ParseAddressOrScript(request.params[0])};
+    const int start_height{request.params[1].isNull() ? 0 : request.params[1].getInt<int>()};
+    const int count{request.params[2].isNull() ? DEFAULT_SCRIPT_HISTORY_COUNT : request.params[2].getInt<int>()};
+    if (start_height < 0) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid start_height");
+    }
+    if (count < 1) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid count");
+    }
+
+    ScriptEventPos start{.height = start_height};
+    if (!request.params[3].isNull()) {
+        const auto cursor{ScriptEventPosFromString(request.params[3].get_str())};
+        if (!cursor) {
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid cursor");
+        }
+        start = *cursor;
+    }
+
+    const ScriptHashIndex& index{EnsureScriptHashIndex()};
+    const uint256 script_hash{ScriptHashIndex::GetScriptHash(script)};
+    std::vector<ScriptEvent> events;
+    std::optional<ScriptEventPos> next;
+    if (!index.LookupEvents(script_hash, start, count, events, next)) {
+        throw JSONRPCError(RPC_INTERNAL_ERROR, "Unable to read script history from index");
+    }
+    return ScriptHistoryToJSON(script_hash, events, next);
+},
+    };
+}
+
+static RPCHelpMan getscriptutxos()
+{
+    return RPCHelpMan{"getscriptutxos",
+                "\nReturns the confirmed unspent outputs paying to an address or output script.\n"
+                "Requires -scripthashindex.\n",
+                {
+                    {"script", RPCArg::Type::STR, RPCArg::Optional::NO, "The address or hex-encoded output script"},
+                },
+                RPCResult{
+                    RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::STR_HEX, "scripthash", "The SHA256 of the output script"},
+                        {RPCResult::Type::STR_AMOUNT, "total_amount", "The total value of the unspent outputs in " + CURRENCY_UNIT},
+                        {RPCResult::Type::ARR, "unspents", "",
+                        {
+                            {RPCResult::Type::OBJ, "", "",
+                            {
+                                {RPCResult::Type::STR_HEX, "txid", "The transaction id"},
+                                {RPCResult::Type::NUM, "vout", "The output index"},
+                                {RPCResult::Type::NUM, "height", "The height of the block containing the transaction"},
+                                {RPCResult::Type::STR_AMOUNT, "value", "The value in " + CURRENCY_UNIT},
+                            }},
+                        }},
+                    }},
+                RPCExamples{
+                    HelpExampleCli("getscriptutxos", "\"" + EXAMPLE_ADDRESS[0] + "\"") +
+                    HelpExampleRpc("getscriptutxos", "\"" + EXAMPLE_ADDRESS[0] + "\"")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    const CScript script{ParseAddressOrScript(request.params[0])};
+    const ScriptHashIndex& index{EnsureScriptHashIndex()};
+    const uint256 script_hash{ScriptHashIndex::GetScriptHash(script)};
+    std::vector<ScriptEvent> unspent;
+    if (!index.LookupUnspent(script_hash, unspent)) {
+        throw JSONRPCError(RPC_INTERNAL_ERROR, "Unable to read script history from index");
+    }
+    return ScriptUnspentToJSON(script_hash, unspent);
+},
+    };
+}
+
 static RPCHelpMan getblockfilter()
 {
     return RPCHelpMan{"getblockfilter",
@@ -2959,6 +3268,9 @@ void RegisterBlockchainRPCCommands(CRPCTable& t)
         {"blockchain", &getdeploymentinfo},
         {"blockchain", &gettxout},
         {"blockchain", &gettxoutsetinfo},
+        {"blockchain", &gettxprevouts},
+        {"blockchain", &getscripthistory},
+        {"blockchain", &getscriptutxos},
         {"blockchain", &pruneblockchain},
         {"blockchain", &verifychain},
         {"blockchain", &preciousblock},
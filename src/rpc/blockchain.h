@@ -13,19 +13,27 @@
 #include <validation.h>
 
 #include <any>
+#include <optional>
 #include <stdint.h>
+#include <string>
+#include <string_view>
 #include <vector>
 
 class CBlock;
 class CBlockIndex;
 class Chainstate;
 class UniValue;
+struct ScriptEvent;
+struct ScriptEventPos;
+struct TxPrevouts;
 namespace node {
 class BlockManager;
 struct NodeContext;
 } // namespace node
 
 static constexpr int NUM_GETBLOCKSTATS_PERCENTILES = 5;
+/** Default number of events returned by getscripthistory */
+static constexpr int DEFAULT_SCRIPT_HISTORY_COUNT{1000};
 
 /**
  * Get the difficulty of the net wrt to the given block index.
@@ -41,6 +49,22 @@ void RPCNotifyBlockChange(const CBlockIndex*);
 /** Block description to JSON */
 UniValue blockToJSON(node::BlockManager& blockman, const CBlock& block, const CBlockIndex& tip, const CBlockIndex& blockindex, TxVerbosity verbosity) LOCKS_EXCLUDED(cs_main);
 
+/** Prevout index entry of a confirmed transaction to JSON */
+UniValue TxPrevoutsToJSON(const uint256& txid, const TxPrevouts& prevouts, const CBlockIndex& tip, const CBlockIndex& blockindex);
+
+/** Script hash index event to JSON */
+UniValue ScriptEventToJSON(const ScriptEvent& event);
+
+/** Script hash index events, and the cursor to continue from if there are more, to JSON */
+UniValue ScriptHistoryToJSON(const uint256& script_hash, const std::vector<ScriptEvent>& events, const std::optional<ScriptEventPos>& next);
+
+/** Encode and parse the cursor of a script history lookup, "<height>:<tx_pos>:<type>:<index>" */
+std::string ScriptEventPosToString(const ScriptEventPos& pos);
+std::optional<ScriptEventPos> ScriptEventPosFromString(std::string_view str);
+
+/** Unspent outputs of a script found in the script hash index to JSON */
+UniValue ScriptUnspentToJSON(const uint256& script_hash, const std::vector<ScriptEvent>& unspent);
+
 /** Block header to JSON */
 UniValue blockheaderToJSON(const CBlockIndex& tip, const CBlockIndex& blockindex) LOCKS_EXCLUDED(cs_main);
 
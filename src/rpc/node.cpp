@@ -9,6 +9,8 @@
 #include <httpserver.h>
 #include <index/blockfilterindex.h>
 #include <index/coinstatsindex.h>
+#include <index/prevoutindex.h>
+#include <index/scripthashindex.h>
 #include <index/txindex.h>
 #include <interfaces/chain.h>
 #include <interfaces/echo.h>
@@ -25,6 +27,7 @@
 #include <util/any.h>
 #include <util/check.h>
 #include <util/time.h>
+#include <validationinterface.h>
 
 #include <stdint.h>
 #ifdef HAVE_MALLOC_INFO
@@ -392,6 +395,14 @@ static RPCHelpMan getindexinfo()
         result.pushKVs(SummaryToJSON(g_coin_stats_index->GetSummary(), index_name));
     }
 
+    if (g_prevout_index) {
+        result.pushKVs(SummaryToJSON(g_prevout_index->GetSummary(), index_name));
+    }
+
+    if (g_scripthash_index) {
+        result.pushKVs(SummaryToJSON(g_scripthash_index->GetSummary(), index_name));
+    }
+
     ForEachBlockFilterIndex([&result, &index_name](const BlockFilterIndex& index) {
         result.pushKVs(SummaryToJSON(index.GetSummary(), index_name));
     });
@@ -401,11 +412,49 @@ static RPCHelpMan getindexinfo()
     };
 }
 
+static RPCHelpMan getvalidationqueueinfo()
+{
+    return RPCHelpMan{"getvalidationqueueinfo",
+                "\nReturns the status of the queues delivering validation events to subscribers such as wallets, indexes and ZMQ.\n"
+                "Each queue delivers events independently, so a queue with many pending events indicates a lagging subscriber.\n",
+                {},
+                RPCResult{
+                    RPCResult::Type::ARR, "", "",
+                    {
+                        {RPCResult::Type::OBJ, "", "",
+                        {
+                            {RPCResult::Type::STR, "name", "The name of the queue"},
+                            {RPCResult::Type::NUM, "subscribers", "The number of subscribers registered in the queue"},
+                            {RPCResult::Type::NUM, "pending", "The number of events waiting to be delivered"},
+                        }},
+                    }
+                },
+                RPCExamples{
+                    HelpExampleCli("getvalidationqueueinfo", "")
+                  + HelpExampleRpc("getvalidationqueueinfo", "")
+                },
+                [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    const NodeContext& node{EnsureAnyNodeContext(request.context)};
+    UniValue result(UniValue::VARR);
+    for (const ValidationQueueInfo& info : CHECK_NONFATAL(node.validation_signals)->GetQueueInfo()) {
+        UniValue obj(UniValue::VOBJ);
+        obj.pushKV("name", info.name);
+        obj.pushKV("subscribers", info.subscribers);
+        obj.pushKV("pending", info.pending);
+        result.push_back(std::move(obj));
+    }
+    return result;
+},
+    };
+}
+
 void RegisterNodeRPCCommands(CRPCTable& t)
 {
     static const CRPCCommand commands[]{
         {"control", &getmemoryinfo},
         {"control", &logging},
+        {"control", &getvalidationqueueinfo},
         {"util", &getindexinfo},
         {"hidden", &setmocktime},
         {"hidden", &mockscheduler},
@@ -9,6 +9,7 @@
 #include <consensus/amount.h>
 #include <consensus/validation.h>
 #include <core_io.h>
+#include <index/prevoutindex.h>
 #include <index/txindex.h>
 #include <key_io.h>
 #include <node/blockstorage.h>
@@ -237,18 +238,20 @@ PartiallySignedTransaction ProcessPSBT(const std::string& psbt_string, const std
 
     const PrecomputedTransactionData& txdata = PrecomputePSBTData(psbtx);
 
+    std::vector<const SigningProvider*> input_providers(psbtx.tx->vin.size());
     for (unsigned int i = 0; i < psbtx.tx->vin.size(); ++i) {
         if (PSBTInputSigned(psbtx.inputs.at(i))) {
             continue;
         }
-
-        // Update script/keypath information using descriptor data.
-        // Note that SignPSBTInput does a lot more than just constructing ECDSA signatures.
-        // We only actually care about those if our signing provider doesn't hide private
-        // information, as is the case with `descriptorprocesspsbt`
-        SignPSBTInput(provider, psbtx, /*index=*/i, &txdata, sighash_type, /*out_sigdata=*/nullptr, finalize);
+        input_providers[i] = &provider;
     }
 
+    // Update script/keypath information using descriptor data.
+    // Note that SignPSBTInput does a lot more than just constructing ECDSA signatures.
+    // We only actually care about those if our signing provider doesn't hide private
+    // information, as is the case with `descriptorprocesspsbt`
+    SignPSBTInputs(input_providers, psbtx, txdata, sighash_type, finalize);
+
     // Update script/keypath information using descriptor data.
     for (unsigned int i = 0; i < psbtx.tx->vout.size(); ++i) {
         UpdatePSBTOutput(provider, psbtx, i);
@@ -402,6 +405,14 @@ static RPCHelpMan getrawtransaction()
         return result;
     }
 
+    // Prefer the prevout index (if enabled) over reading the block and its undo data from disk
+    TxPrevouts prevouts;
+    if (!tx->IsCoinBase() && blockindex && g_prevout_index && g_prevout_index->FindTxPrevouts(tx->GetHash(), prevouts) &&
+        prevouts.height == blockindex->nHeight && WITH_LOCK(::cs_main, return chainman.ActiveChain().Contains(blockindex))) {
+        TxToJSON(*tx, hash_block, result, chainman.ActiveChainstate(), &prevouts.undo, TxVerbosity::SHOW_DETAILS_AND_PREVOUT);
+        return result;
+    }
+
     CBlockUndo blockUndo;
     CBlock block;
 
@@ -16,6 +16,7 @@
 #include <functional>
 #include <list>
 #include <map>
+#include <string>
 #include <thread>
 #include <utility>
 
@@ -157,4 +158,30 @@ public:
     size_t size() override EXCLUSIVE_LOCKS_REQUIRED(!m_callbacks_mutex);
 };
 
+/**
+ * A SerialTaskRunner with a scheduler thread of its own, so that its
+ * callbacks are neither delayed by nor delay other scheduled tasks.
+ */
+class ThreadedSerialTaskRunner : public util::TaskRunnerInterface
+{
+private:
+    CScheduler m_scheduler;
+    SerialTaskRunner m_runner{m_scheduler};
+
+public:
+    explicit ThreadedSerialTaskRunner(const std::string& thread_name);
+    ~ThreadedSerialTaskRunner() override;
+
+    void insert(std::function<void()> func) override { m_runner.insert(std::move(func)); }
+
+    /**
+     * Stops the thread and processes all remaining queue members on the
+     * calling thread. Callbacks inserted afterwards are only run by another
+     * flush().
+     */
+    void flush() override;
+
+    size_t size() override { return m_runner.size(); }
+};
+
 #endif // BITCOIN_SCHEDULER_H
@@ -578,15 +578,16 @@ protected:
 
     /** A helper function to construct the scripts for this descriptor.
      *
-     *  This function is invoked once by ExpandHelper.
+     *  This function is invoked once per position by BuildScripts.
      *
      *  @param pubkeys The evaluations of the m_pubkey_args field.
+     *  @param key_ids The key IDs of pubkeys.
      *  @param scripts The evaluations of m_subdescriptor_args (one for each m_subdescriptor_args element).
      *  @param out A FlatSigningProvider to put scripts or public keys in that are necessary to the solver.
      *             The origin info of the provided pubkeys is automatically added.
      *  @return A vector with scriptPubKeys for this descriptor.
      */
-    virtual std::vector<CScript> MakeScripts(const std::vector<CPubKey>& pubkeys, Span<const CScript> scripts, FlatSigningProvider& out) const = 0;
+    virtual std::vector<CScript> MakeScripts(const std::vector<CPubKey>& pubkeys, Span<const CKeyID> key_ids, Span<const CScript> scripts, FlatSigningProvider& out) const = 0;
 
 public:
     DescriptorImpl(std::vector<std::unique_ptr<PubkeyProvider>> pubkeys, const std::string& name) : m_pubkey_args(std::move(pubkeys)), m_name(name), m_subdescriptor_args() {}
@@ -688,35 +689,92 @@ public:
         return ret;
     }
 
+    /** Derive the public keys of this descriptor and of its subdescriptors at a position, appending
+     *  them to `entries` in the order BuildScripts consumes them. */
     // NOLINTNEXTLINE(misc-no-recursion)
-    bool ExpandHelper(int pos, const SigningProvider& arg, const DescriptorCache* read_cache, std::vector<CScript>& output_scripts, FlatSigningProvider& out, DescriptorCache* write_cache) const
+    bool DeriveKeys(int pos, const SigningProvider& arg, const DescriptorCache* read_cache, std::vector<std::pair<CPubKey, KeyOriginInfo>>& entries, DescriptorCache* write_cache) const
     {
-        std::vector<std::pair<CPubKey, KeyOriginInfo>> entries;
-        entries.reserve(m_pubkey_args.size());
-
-        // Construct temporary data in `entries`, `subscripts`, and `subprovider` to avoid producing output in case of failure.
         for (const auto& p : m_pubkey_args) {
             entries.emplace_back();
             if (!p->GetPubKey(pos, arg, entries.back().first, entries.back().second, read_cache, write_cache)) return false;
         }
+        for (const auto& subarg : m_subdescriptor_args) {
+            if (!subarg->DeriveKeys(pos, arg, read_cache, entries, write_cache)) return false;
+        }
+        return true;
+    }
+
+    /** Construct the scripts from keys derived by DeriveKeys and their key IDs, consuming
+     *  the ones of this descriptor and of its subdescriptors from the front of `entries` and `key_ids`. */
+    // NOLINTNEXTLINE(misc-no-recursion)
+    void BuildScripts(Span<std::pair<CPubKey, KeyOriginInfo>>& entries, Span<const CKeyID>& key_ids, std::vector<CScript>& output_scripts, FlatSigningProvider& out) const
+    {
+        const Span<std::pair<CPubKey, KeyOriginInfo>> own_entries{entries.first(m_pubkey_args.size())};
+        const Span<const CKeyID> own_key_ids{key_ids.first(m_pubkey_args.size())};
+        entries = entries.subspan(m_pubkey_args.size());
+        key_ids = key_ids.subspan(m_pubkey_args.size());
+
         std::vector<CScript> subscripts;
         FlatSigningProvider subprovider;
         for (const auto& subarg : m_subdescriptor_args) {
             std::vector<CScript> outscripts;
-            if (!subarg->ExpandHelper(pos, arg, read_cache, outscripts, subprovider, write_cache)) return false;
+            subarg->BuildScripts(entries, key_ids, outscripts, subprovider);
             assert(outscripts.size() == 1);
             subscripts.emplace_back(std::move(outscripts[0]));
         }
         out.Merge(std::move(subprovider));
 
         std::vector<CPubKey> pubkeys;
+        pubkeys.reserve(own_entries.size());
+        for (size_t i = 0; i < own_entries.size(); ++i) {
+            pubkeys.push_back(own_entries[i].first);
+            out.origins.emplace(own_key_ids[i], std::make_pair<CPubKey, KeyOriginInfo>(CPubKey(own_entries[i].first), std::move(own_entries[i].second)));
+        }
+
+        output_scripts = MakeScripts(pubkeys, own_key_ids, Span{subscripts}, out);
+    }
+
+    /** Compute the key IDs of all derived keys at once, which is faster than one by one. */
+    static std::vector<CKeyID> GetKeyIDs(Span<const std::pair<CPubKey, KeyOriginInfo>> entries)
+    {
+        std::vector<Span<const unsigned char>> pubkeys;
         pubkeys.reserve(entries.size());
-        for (auto& entry : entries) {
-            pubkeys.push_back(entry.first);
-            out.origins.emplace(entry.first.GetID(), std::make_pair<CPubKey, KeyOriginInfo>(CPubKey(entry.first), std::move(entry.second)));
+        for (const auto& entry : entries) pubkeys.emplace_back(entry.first.data(), entry.first.size());
+        std::vector<CKeyID> key_ids;
+        key_ids.reserve(entries.size());
+        for (const uint160& hash : Hash160Multi(pubkeys)) key_ids.emplace_back(hash);
+        return key_ids;
+    }
+
+    bool ExpandHelper(int begin, int end, const SigningProvider& arg, const DescriptorCache* read_cache, std::vector<std::vector<CScript>>& output_scripts, std::vector<FlatSigningProvider>& out, DescriptorCache* write_cache) const
+    {
+        // Derive all keys first to avoid producing output in case of failure, and to hash them together.
+        std::vector<std::pair<CPubKey, KeyOriginInfo>> entries;
+        for (int pos = begin; pos < end; ++pos) {
+            if (!DeriveKeys(pos, arg, read_cache, entries, write_cache)) return false;
         }
+        const std::vector<CKeyID> key_ids{GetKeyIDs(entries)};
 
-        output_scripts = MakeScripts(pubkeys, Span{subscripts}, out);
+        Span<std::pair<CPubKey, KeyOriginInfo>> remaining_entries{entries};
+        Span<const CKeyID> remaining_key_ids{key_ids};
+        output_scripts.resize(end - begin);
+        out.resize(end - begin);
+        for (int pos = begin; pos < end; ++pos) {
+            BuildScripts(remaining_entries, remaining_key_ids, output_scripts[pos - begin], out[pos - begin]);
+        }
+        assert(remaining_entries.empty());
+        return true;
+    }
+
+    bool ExpandHelper(int pos, const SigningProvider& arg, const DescriptorCache* read_cache, std::vector<CScript>& output_scripts, FlatSigningProvider& out, DescriptorCache* write_cache) const
+    {
+        std::vector<std::pair<CPubKey, KeyOriginInfo>> entries;
+        if (!DeriveKeys(pos, arg, read_cache, entries, write_cache)) return false;
+        const std::vector<CKeyID> key_ids{GetKeyIDs(entries)};
+
+        Span<std::pair<CPubKey, KeyOriginInfo>> remaining_entries{entries};
+        Span<const CKeyID> remaining_key_ids{key_ids};
+        BuildScripts(remaining_entries, remaining_key_ids, output_scripts, out);
         return true;
     }
 
@@ -730,6 +788,16 @@ public:
         return ExpandHelper(pos, DUMMY_SIGNING_PROVIDER, &read_cache, output_scripts, out, nullptr);
     }
 
+    bool ExpandRange(int begin, int end, const SigningProvider& provider, std::vector<std::vector<CScript>>& output_scripts, std::vector<FlatSigningProvider>& out, DescriptorCache* write_cache = nullptr) const final
+    {
+        return ExpandHelper(begin, end, provider, nullptr, output_scripts, out, write_cache);
+    }
+
+    bool ExpandRangeFromCache(int begin, int end, const DescriptorCache& read_cache, std::vector<std::vector<CScript>>& output_scripts, std::vector<FlatSigningProvider>& out) const final
+    {
+        return ExpandHelper(begin, end, DUMMY_SIGNING_PROVIDER, &read_cache, output_scripts, out, nullptr);
+    }
+
     // NOLINTNEXTLINE(misc-no-recursion)
     void ExpandPrivate(int pos, const SigningProvider& provider, FlatSigningProvider& out) const final
     {
@@ -779,7 +847,7 @@ class AddressDescriptor final : public DescriptorImpl
     const CTxDestination m_destination;
 protected:
     std::string ToStringExtra() const override { return EncodeDestination(m_destination); }
-    std::vector<CScript> MakeScripts(const std::vector<CPubKey>&, Span<const CScript>, FlatSigningProvider&) const override { return Vector(GetScriptForDestination(m_destination)); }
+    std::vector<CScript> MakeScripts(const std::vector<CPubKey>&, Span<const CKeyID>, Span<const CScript>, FlatSigningProvider&) const override { return Vector(GetScriptForDestination(m_destination)); }
 public:
     AddressDescriptor(CTxDestination destination) : DescriptorImpl({}, "addr"), m_destination(std::move(destination)) {}
     bool IsSolvable() const final { return false; }
@@ -800,7 +868,7 @@ class RawDescriptor final : public DescriptorImpl
     const CScript m_script;
 protected:
     std::string ToStringExtra() const override { return HexStr(m_script); }
-    std::vector<CScript> MakeScripts(const std::vector<CPubKey>&, Span<const CScript>, FlatSigningProvider&) const override { return Vector(m_script); }
+    std::vector<CScript> MakeScripts(const std::vector<CPubKey>&, Span<const CKeyID>, Span<const CScript>, FlatSigningProvider&) const override { return Vector(m_script); }
 public:
     RawDescriptor(CScript script) : DescriptorImpl({}, "raw"), m_script(std::move(script)) {}
     bool IsSolvable() const final { return false; }
@@ -823,7 +891,7 @@ class PKDescriptor final : public DescriptorImpl
 private:
     const bool m_xonly;
 protected:
-    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, Span<const CScript>, FlatSigningProvider&) const override
+    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, Span<const CKeyID>, Span<const CScript>, FlatSigningProvider&) const override
     {
         if (m_xonly) {
             CScript script = CScript() << ToByteVector(XOnlyPubKey(keys[0])) << OP_CHECKSIG;
@@ -856,9 +924,9 @@ public:
 class PKHDescriptor final : public DescriptorImpl
 {
 protected:
-    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, Span<const CScript>, FlatSigningProvider& out) const override
+    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, Span<const CKeyID> key_ids, Span<const CScript>, FlatSigningProvider& out) const override
     {
-        CKeyID id = keys[0].GetID();
+        const CKeyID& id = key_ids[0];
         out.pubkeys.emplace(id, keys[0]);
         return Vector(GetScriptForDestination(PKHash(id)));
     }
@@ -885,9 +953,9 @@ public:
 class WPKHDescriptor final : public DescriptorImpl
 {
 protected:
-    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, Span<const CScript>, FlatSigningProvider& out) const override
+    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, Span<const CKeyID> key_ids, Span<const CScript>, FlatSigningProvider& out) const override
     {
-        CKeyID id = keys[0].GetID();
+        const CKeyID& id = key_ids[0];
         out.pubkeys.emplace(id, keys[0]);
         return Vector(GetScriptForDestination(WitnessV0KeyHash(id)));
     }
@@ -914,10 +982,10 @@ public:
 class ComboDescriptor final : public DescriptorImpl
 {
 protected:
-    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, Span<const CScript>, FlatSigningProvider& out) const override
+    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, Span<const CKeyID> key_ids, Span<const CScript>, FlatSigningProvider& out) const override
     {
         std::vector<CScript> ret;
-        CKeyID id = keys[0].GetID();
+        const CKeyID& id = key_ids[0];
         out.pubkeys.emplace(id, keys[0]);
         ret.emplace_back(GetScriptForRawPubKey(keys[0])); // P2PK
         ret.emplace_back(GetScriptForDestination(PKHash(id))); // P2PKH
@@ -941,7 +1009,7 @@ class MultisigDescriptor final : public DescriptorImpl
     const bool m_sorted;
 protected:
     std::string ToStringExtra() const override { return strprintf("%i", m_threshold); }
-    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, Span<const CScript>, FlatSigningProvider&) const override {
+    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, Span<const CKeyID>, Span<const CScript>, FlatSigningProvider&) const override {
         if (m_sorted) {
             std::vector<CPubKey> sorted_keys(keys);
             std::sort(sorted_keys.begin(), sorted_keys.end());
@@ -979,7 +1047,7 @@ class MultiADescriptor final : public DescriptorImpl
     const bool m_sorted;
 protected:
     std::string ToStringExtra() const override { return strprintf("%i", m_threshold); }
-    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, Span<const CScript>, FlatSigningProvider&) const override {
+    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, Span<const CKeyID>, Span<const CScript>, FlatSigningProvider&) const override {
         CScript ret;
         std::vector<XOnlyPubKey> xkeys;
         xkeys.reserve(keys.size());
@@ -1012,7 +1080,7 @@ public:
 class SHDescriptor final : public DescriptorImpl
 {
 protected:
-    std::vector<CScript> MakeScripts(const std::vector<CPubKey>&, Span<const CScript> scripts, FlatSigningProvider& out) const override
+    std::vector<CScript> MakeScripts(const std::vector<CPubKey>&, Span<const CKeyID>, Span<const CScript> scripts, FlatSigningProvider& out) const override
     {
         auto ret = Vector(GetScriptForDestination(ScriptHash(scripts[0])));
         if (ret.size()) out.scripts.emplace(CScriptID(scripts[0]), scripts[0]);
@@ -1057,7 +1125,7 @@ public:
 class WSHDescriptor final : public DescriptorImpl
 {
 protected:
-    std::vector<CScript> MakeScripts(const std::vector<CPubKey>&, Span<const CScript> scripts, FlatSigningProvider& out) const override
+    std::vector<CScript> MakeScripts(const std::vector<CPubKey>&, Span<const CKeyID>, Span<const CScript> scripts, FlatSigningProvider& out) const override
     {
         auto ret = Vector(GetScriptForDestination(WitnessV0ScriptHash(scripts[0])));
         if (ret.size()) out.scripts.emplace(CScriptID(scripts[0]), scripts[0]);
@@ -1094,7 +1162,7 @@ class TRDescriptor final : public DescriptorImpl
 {
     std::vector<int> m_depths;
 protected:
-    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, Span<const CScript> scripts, FlatSigningProvider& out) const override
+    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, Span<const CKeyID> key_ids, Span<const CScript> scripts, FlatSigningProvider& out) const override
     {
         TaprootBuilder builder;
         assert(m_depths.size() == scripts.size());
@@ -1108,7 +1176,7 @@ protected:
         builder.Finalize(xpk);
         WitnessV1Taproot output = builder.GetOutput();
         out.tr_trees[output] = builder;
-        out.pubkeys.emplace(keys[0].GetID(), keys[0]);
+        out.pubkeys.emplace(key_ids[0], keys[0]);
         return Vector(GetScriptForDestination(output));
     }
     bool ToStringSubScriptHelper(const SigningProvider* arg, std::string& ret, const StringType type, const DescriptorCache* cache = nullptr) const override
@@ -1229,15 +1297,15 @@ private:
     miniscript::NodeRef<uint32_t> m_node;
 
 protected:
-    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, Span<const CScript> scripts,
+    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, Span<const CKeyID> key_ids, Span<const CScript> scripts,
                                      FlatSigningProvider& provider) const override
     {
         const auto script_ctx{m_node->GetMsCtx()};
-        for (const auto& key : keys) {
+        for (size_t i = 0; i < keys.size(); ++i) {
             if (miniscript::IsTapscript(script_ctx)) {
-                provider.pubkeys.emplace(Hash160(XOnlyPubKey{key}), key);
+                provider.pubkeys.emplace(Hash160(XOnlyPubKey{keys[i]}), keys[i]);
             } else {
-                provider.pubkeys.emplace(key.GetID(), key);
+                provider.pubkeys.emplace(key_ids[i], keys[i]);
             }
         }
         return Vector(m_node->ToScript(ScriptMaker(keys, script_ctx)));
@@ -1276,7 +1344,7 @@ public:
 class RawTRDescriptor final : public DescriptorImpl
 {
 protected:
-    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, Span<const CScript> scripts, FlatSigningProvider& out) const override
+    std::vector<CScript> MakeScripts(const std::vector<CPubKey>& keys, Span<const CKeyID>, Span<const CScript> scripts, FlatSigningProvider& out) const override
     {
         assert(keys.size() == 1);
         XOnlyPubKey xpk(keys[0]);
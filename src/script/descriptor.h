@@ -136,6 +136,28 @@ struct Descriptor {
      */
     virtual bool ExpandFromCache(int pos, const DescriptorCache& read_cache, std::vector<CScript>& output_scripts, FlatSigningProvider& out) const = 0;
 
+    /** Expand a descriptor at each position in [begin, end), with the same result as calling Expand for
+     *  each of them. The derived keys of all positions are hashed together, which is faster.
+     *
+     * @param[in] begin The first position at which to expand the descriptor.
+     * @param[in] end The position after the last one at which to expand the descriptor.
+     * @param[in] provider The provider to query for private keys in case of hardened derivation.
+     * @param[out] output_scripts The expanded scriptPubKeys of each position.
+     * @param[out] out Scripts and public keys necessary for solving the expanded scriptPubKeys of each position.
+     * @param[out] write_cache Cache data necessary to evaluate the descriptor at these positions without access to private keys.
+     */
+    virtual bool ExpandRange(int begin, int end, const SigningProvider& provider, std::vector<std::vector<CScript>>& output_scripts, std::vector<FlatSigningProvider>& out, DescriptorCache* write_cache = nullptr) const = 0;
+
+    /** Expand a descriptor at each position in [begin, end) using cached expansion data (see ExpandRange).
+     *
+     * @param[in] begin The first position at which to expand the descriptor.
+     * @param[in] end The position after the last one at which to expand the descriptor.
+     * @param[in] read_cache Cached expansion data.
+     * @param[out] output_scripts The expanded scriptPubKeys of each position.
+     * @param[out] out Scripts and public keys necessary for solving the expanded scriptPubKeys of each position.
+     */
+    virtual bool ExpandRangeFromCache(int begin, int end, const DescriptorCache& read_cache, std::vector<std::vector<CScript>>& output_scripts, std::vector<FlatSigningProvider>& out) const = 0;
+
     /** Expand the private key for a descriptor at a specified position, if possible.
      *
      * @param[in] pos The position at which to expand the descriptor. If IsRange() is false, this is ignored.
@@ -8,6 +8,7 @@
 #include <crypto/ripemd160.h>
 #include <crypto/sha1.h>
 #include <crypto/sha256.h>
+#include <hash.h>
 #include <pubkey.h>
 #include <script/script.h>
 #include <uint256.h>
@@ -1953,7 +1954,94 @@ static bool VerifyWitnessProgram(const CScriptWitness& witness, int witversion,
     // There is intentionally no return statement here, to be able to use "control reaches end of non-void function" warnings to detect gaps in the logic above.
 }
 
+/** Check a P2PKH-style signature and public key pair against a 20-byte key hash, the way
+ *  OP_DUP OP_HASH160 <hash> OP_EQUALVERIFY OP_CHECKSIG would succeed on them. */
+static bool VerifyKeyHashSpend(const valtype& sig, const valtype& pubkey, Span<const unsigned char> hash, const CScript& script_code, unsigned int flags, const BaseSignatureChecker& checker, SigVersion sigversion)
+{
+    if (sig.empty() || sig.size() > MAX_SCRIPT_ELEMENT_SIZE || pubkey.size() > MAX_SCRIPT_ELEMENT_SIZE) return false;
+    uint160 pubkey_hash;
+    CHash160().Write(pubkey).Finalize(pubkey_hash);
+    if (!std::equal(hash.begin(), hash.end(), pubkey_hash.begin())) return false;
+    if (!CheckSignatureEncoding(sig, flags, nullptr) || !CheckPubKeyEncoding(pubkey, flags, sigversion, nullptr)) return false;
+    return checker.CheckECDSASignature(sig, pubkey, script_code, sigversion);
+}
+
+/** Verify a BIP141 P2WPKH witness against its 20-byte program. */
+static bool VerifyWitnessKeyHashSpend(const CScriptWitness& witness, const valtype& program, unsigned int flags, const BaseSignatureChecker& checker)
+{
+    if (witness.stack.size() != 2 || !CastToBool(program)) return false;
+    CScript script_code;
+    script_code << OP_DUP << OP_HASH160 << program << OP_EQUALVERIFY << OP_CHECKSIG;
+    return VerifyKeyHashSpend(witness.stack[0], witness.stack[1], program, script_code, flags, checker, SigVersion::WITNESS_V0);
+}
+
+bool VerifyStandardSpend(const CScript& scriptSig, const CScript& scriptPubKey, const CScriptWitness& witness, unsigned int flags, const BaseSignatureChecker& checker)
+{
+    // The interpreter asserts on these, let it do so.
+    if ((flags & SCRIPT_VERIFY_WITNESS) && !(flags & SCRIPT_VERIFY_P2SH)) return false;
+    if ((flags & SCRIPT_VERIFY_CLEANSTACK) && !((flags & SCRIPT_VERIFY_P2SH) && (flags & SCRIPT_VERIFY_WITNESS))) return false;
+
+    int witnessversion;
+    valtype witnessprogram;
+    if (scriptPubKey.IsWitnessProgram(witnessversion, witnessprogram)) {
+        // Without the witness flag, witness programs are anyone-can-spend.
+        if (!(flags & SCRIPT_VERIFY_WITNESS) || !scriptSig.empty()) return false;
+        if (witnessversion == 0 && witnessprogram.size() == WITNESS_V0_KEYHASH_SIZE) {
+            return VerifyWitnessKeyHashSpend(witness, witnessprogram, flags, checker);
+        }
+        if (witnessversion == 1 && witnessprogram.size() == WITNESS_V1_TAPROOT_SIZE) {
+            // Taproot key path without annex.
+            if (!(flags & SCRIPT_VERIFY_TAPROOT) || witness.stack.size() != 1 || !CastToBool(witnessprogram)) return false;
+            ScriptExecutionData execdata;
+            execdata.m_annex_init = true;
+            execdata.m_annex_present = false;
+            return checker.CheckSchnorrSignature(witness.stack[0], witnessprogram, SigVersion::TAPROOT, execdata, nullptr);
+        }
+        return false;
+    }
+
+    if (scriptPubKey.IsPayToScriptHash()) {
+        // P2SH-P2WPKH: the scriptSig is exactly a push of the witness program.
+        if (!(flags & SCRIPT_VERIFY_WITNESS)) return false;
+        if (scriptSig.size() != 23 || scriptSig[0] != 22 || scriptSig[1] != OP_0 || scriptSig[2] != WITNESS_V0_KEYHASH_SIZE) return false;
+        uint160 redeem_hash;
+        CHash160().Write(Span{scriptSig}.subspan(1)).Finalize(redeem_hash);
+        if (!std::equal(redeem_hash.begin(), redeem_hash.end(), scriptPubKey.begin() + 2)) return false;
+        return VerifyWitnessKeyHashSpend(witness, valtype(scriptSig.begin() + 3, scriptSig.end()), flags, checker);
+    }
+
+    // P2PKH: OP_DUP OP_HASH160 <20> OP_EQUALVERIFY OP_CHECKSIG, spent by two direct pushes.
+    if (scriptPubKey.size() != 25 || scriptPubKey[0] != OP_DUP || scriptPubKey[1] != OP_HASH160 || scriptPubKey[2] != 20 ||
+        scriptPubKey[23] != OP_EQUALVERIFY || scriptPubKey[24] != OP_CHECKSIG) {
+        return false;
+    }
+    if (!witness.IsNull()) return false;
+    CScript::const_iterator pc{scriptSig.begin()};
+    opcodetype opcode;
+    valtype sig, pubkey;
+    // Only direct pushes of at least two bytes, which are always minimal.
+    if (!scriptSig.GetOp(pc, opcode, sig) || opcode >= OP_PUSHDATA1 || sig.size() < 2) return false;
+    if (!scriptSig.GetOp(pc, opcode, pubkey) || opcode >= OP_PUSHDATA1 || pubkey.size() < 2) return false;
+    if (pc != scriptSig.end()) return false;
+    // A 20-byte signature push matches the key hash push in the scriptCode, leave
+    // FindAndDelete to the interpreter.
+    if (sig.size() == 20) return false;
+    return VerifyKeyHashSpend(sig, pubkey, Span{scriptPubKey}.subspan(3, 20), scriptPubKey, flags, checker, SigVersion::BASE);
+}
+
 bool VerifyScript(const CScript& scriptSig, const CScript& scriptPubKey, const CScriptWitness* witness, unsigned int flags, const BaseSignatureChecker& checker, ScriptError* serror)
+{
+    static const CScriptWitness emptyWitness;
+    if (witness == nullptr) {
+        witness = &emptyWitness;
+    }
+    if (VerifyStandardSpend(scriptSig, scriptPubKey, *witness, flags, checker)) {
+        return set_success(serror);
+    }
+    return VerifyScriptInterpreted(scriptSig, scriptPubKey, witness, flags, checker, serror);
+}
+
+bool VerifyScriptInterpreted(const CScript& scriptSig, const CScript& scriptPubKey, const CScriptWitness* witness, unsigned int flags, const BaseSignatureChecker& checker, ScriptError* serror)
 {
     static const CScriptWitness emptyWitness;
     if (witness == nullptr) {
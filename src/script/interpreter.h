@@ -347,6 +347,13 @@ bool EvalScript(std::vector<std::vector<unsigned char> >& stack, const CScript&
 bool EvalScript(std::vector<std::vector<unsigned char> >& stack, const CScript& script, unsigned int flags, const BaseSignatureChecker& checker, SigVersion sigversion, ScriptError* error = nullptr);
 bool VerifyScript(const CScript& scriptSig, const CScript& scriptPubKey, const CScriptWitness* witness, unsigned int flags, const BaseSignatureChecker& checker, ScriptError* serror = nullptr);
 
+/** Verify a spend of a standard template (P2PKH, P2WPKH, P2SH-P2WPKH or taproot key path)
+ *  directly, without running the script interpreter. Only returns true if VerifyScript would
+ *  succeed; any other spend, including an invalid one, is left to the interpreter. */
+bool VerifyStandardSpend(const CScript& scriptSig, const CScript& scriptPubKey, const CScriptWitness& witness, unsigned int flags, const BaseSignatureChecker& checker);
+/** VerifyScript without the VerifyStandardSpend fast path. */
+bool VerifyScriptInterpreted(const CScript& scriptSig, const CScript& scriptPubKey, const CScriptWitness* witness, unsigned int flags, const BaseSignatureChecker& checker, ScriptError* serror = nullptr);
+
 size_t CountWitnessSigOps(const CScript& scriptSig, const CScript& scriptPubKey, const CScriptWitness* witness, unsigned int flags);
 
 int FindAndDelete(CScript& script, const CScript& b);
@@ -0,0 +1,48 @@
+// Copyright (c) 2024 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_SUPPORT_ALLOCATORS_ARENA_H
+#define BITCOIN_SUPPORT_ALLOCATORS_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <utility>
+
+/**
+ * Allocator that carves objects out of a shared monotonic buffer (an arena),
+ * which is freed once the last allocator referring to it is destroyed.
+ *
+ * Deallocation is a no-op, so objects can be released from any thread, while
+ * allocation must not happen concurrently. Used with std::allocate_shared, the
+ * allocator copy stored in each control block keeps the arena alive for as
+ * long as any of the objects is referenced.
+ */
+template <typename T>
+class ArenaAllocator
+{
+public:
+    using value_type = T;
+    using Arena = std::pmr::monotonic_buffer_resource;
+
+    explicit ArenaAllocator(std::shared_ptr<Arena> arena) noexcept : m_arena{std::move(arena)} {}
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : m_arena{other.m_arena} {}
+
+    T* allocate(size_t n) { return static_cast<T*>(m_arena->allocate(n * sizeof(T), alignof(T))); }
+
+    void deallocate(T*, size_t) noexcept {}
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const noexcept { return m_arena == other.m_arena; }
+
+private:
+    template <typename U>
+    friend class ArenaAllocator;
+
+    std::shared_ptr<Arena> m_arena;
+};
+
+#endif // BITCOIN_SUPPORT_ALLOCATORS_ARENA_H
@@ -354,6 +354,30 @@ BOOST_AUTO_TEST_CASE(ReceiveWithExtraTransactions) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(WtxidSipHashesTest)
+{
+    CTxMemPool& pool = *Assert(m_node.mempool);
+    TestMemPoolEntryHelper entry;
+    auto rand_ctx(FastRandomContext(uint256{42}));
+
+    LOCK2(cs_main, pool.cs);
+    for (int i = 0; i < 20; ++i) {
+        CMutableTransaction mtx = BuildTransactionTestCase();
+        mtx.vin[0].prevout.hash = Txid::FromUint256(rand_ctx.rand256());
+        pool.addUnchecked(entry.FromTx(MakeTransactionRef(std::move(mtx))));
+    }
+
+    // Any range of the mempool's transactions hashes as one at a time.
+    const uint64_t k0{rand_ctx.rand64()}, k1{rand_ctx.rand64()};
+    for (const auto& [begin, size] : std::vector<std::pair<size_t, size_t>>{{0, 20}, {3, 9}, {19, 1}, {5, 0}}) {
+        std::vector<uint64_t> hashes(size);
+        pool.GetWtxidSipHashes(k0, k1, begin, hashes);
+        for (size_t i = 0; i < size; ++i) {
+            BOOST_CHECK_EQUAL(hashes[i], SipHashUint256(k0, k1, pool.txns_randomized[begin + i]->GetWitnessHash()));
+        }
+    }
+}
+
 BOOST_AUTO_TEST_CASE(TransactionsRequestSerializationTest) {
     BlockTransactionsRequest req1;
     req1.blockhash = InsecureRand256();
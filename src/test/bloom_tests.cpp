@@ -531,4 +531,40 @@ BOOST_AUTO_TEST_CASE(rolling_bloom)
     }
 }
 
+BOOST_AUTO_TEST_CASE(blocked_bloom)
+{
+    SeedRandomForTest(SeedRand::ZEROS);
+
+    BlockedBloomFilter empty;
+    BOOST_CHECK_EQUAL(empty.capacity(), 0U);
+    BOOST_CHECK(!empty.contains(RandomData()));
+
+    BlockedBloomFilter filter(1000);
+    std::vector<std::vector<unsigned char>> data;
+    std::vector<uint256> hashes;
+    for (int i = 0; i < 500; ++i) {
+        data.push_back(RandomData());
+        hashes.push_back(InsecureRand256());
+        filter.insert(data.back());
+        filter.insert(hashes.back());
+    }
+    BOOST_CHECK_EQUAL(filter.size(), 1000U);
+    BOOST_CHECK_EQUAL(filter.capacity(), 1000U);
+
+    // No false negatives
+    for (int i = 0; i < 500; ++i) {
+        BOOST_CHECK(filter.contains(data[i]));
+        BOOST_CHECK(filter.contains(hashes[i]));
+    }
+
+    // Filled up to capacity, the false positive rate is well below 1%,
+    // so expect far fewer than 100 hits when testing 10,000 random keys
+    unsigned int nHits = 0;
+    for (int i = 0; i < 5000; ++i) {
+        if (filter.contains(RandomData())) ++nHits;
+        if (filter.contains(InsecureRand256())) ++nHits;
+    }
+    BOOST_CHECK_LT(nHits, 50U);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
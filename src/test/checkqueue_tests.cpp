@@ -15,6 +15,7 @@
 #include <atomic>
 #include <condition_variable>
 #include <mutex>
+#include <set>
 #include <thread>
 #include <unordered_set>
 #include <utility>
@@ -135,6 +136,49 @@ struct FrozenCleanupCheck {
     }
 };
 
+/** Check that keeps track of how many of its instances are alive. */
+struct TrackedCheck {
+    static std::atomic<size_t> n_alive;
+    static std::atomic<size_t> n_calls;
+    bool owned{true};
+    bool operator()() const
+    {
+        n_calls.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    TrackedCheck() { n_alive.fetch_add(1, std::memory_order_relaxed); }
+    ~TrackedCheck()
+    {
+        if (owned) n_alive.fetch_sub(1, std::memory_order_relaxed);
+    }
+    TrackedCheck(TrackedCheck&& other) noexcept
+    {
+        owned = other.owned;
+        other.owned = false;
+    }
+    TrackedCheck& operator=(TrackedCheck&& other) noexcept
+    {
+        if (owned) n_alive.fetch_sub(1, std::memory_order_relaxed);
+        owned = other.owned;
+        other.owned = false;
+        return *this;
+    }
+};
+
+/** Check that only succeeds once checks were run by more than one thread. */
+struct StealingCheck {
+    static std::mutex m;
+    static std::condition_variable cv;
+    static std::set<std::thread::id> threads;
+    bool operator()() const
+    {
+        std::unique_lock<std::mutex> l(m);
+        threads.insert(std::this_thread::get_id());
+        cv.notify_all();
+        return cv.wait_for(l, std::chrono::seconds{30}, [] { return threads.size() > 1; });
+    }
+};
+
 // Static Allocations
 std::mutex FrozenCleanupCheck::m{};
 std::atomic<uint64_t> FrozenCleanupCheck::nFrozen{0};
@@ -143,6 +187,11 @@ Mutex UniqueCheck::m;
 std::unordered_multiset<size_t> UniqueCheck::results;
 std::atomic<size_t> FakeCheckCheckCompletion::n_calls{0};
 std::atomic<size_t> MemoryCheck::fake_allocated_memory{0};
+std::atomic<size_t> TrackedCheck::n_alive{0};
+std::atomic<size_t> TrackedCheck::n_calls{0};
+std::mutex StealingCheck::m{};
+std::condition_variable StealingCheck::cv{};
+std::set<std::thread::id> StealingCheck::threads{};
 
 // Queue Typedefs
 typedef CCheckQueue<FakeCheckCheckCompletion> Correct_Queue;
@@ -151,6 +200,8 @@ typedef CCheckQueue<FailingCheck> Failing_Queue;
 typedef CCheckQueue<UniqueCheck> Unique_Queue;
 typedef CCheckQueue<MemoryCheck> Memory_Queue;
 typedef CCheckQueue<FrozenCleanupCheck> FrozenCleanup_Queue;
+typedef CCheckQueue<TrackedCheck> Tracked_Queue;
+typedef CCheckQueue<StealingCheck> Stealing_Queue;
 
 
 /** This test case checks that the CCheckQueue works properly
@@ -315,6 +366,49 @@ BOOST_AUTO_TEST_CASE(test_CheckQueue_Memory)
     }
 }
 
+// Test that checks are destroyed by the time Wait() returns, and that checks
+// which were added but never waited for are destroyed when the queue stops.
+BOOST_AUTO_TEST_CASE(test_CheckQueue_Stop)
+{
+    for (const int threads : {0, SCRIPT_CHECK_THREADS}) {
+        TrackedCheck::n_calls = 0;
+        auto queue = std::make_unique<Tracked_Queue>(QUEUE_BATCH_SIZE, threads);
+        {
+            CCheckQueueControl<TrackedCheck> control(queue.get());
+            control.Add(std::vector<TrackedCheck>(1000));
+            BOOST_REQUIRE(control.Wait());
+            BOOST_CHECK_EQUAL(TrackedCheck::n_alive, 0U);
+            BOOST_CHECK_EQUAL(TrackedCheck::n_calls, 1000U);
+        }
+
+        TrackedCheck::n_calls = 0;
+        queue->Add(std::vector<TrackedCheck>(1000));
+        queue.reset();
+        BOOST_CHECK_EQUAL(TrackedCheck::n_alive, 0U);
+        // Without worker threads, nothing runs the checks before the queue
+        // stops, so they are all discarded.
+        if (threads == 0) BOOST_CHECK_EQUAL(TrackedCheck::n_calls, 0U);
+    }
+}
+
+// Test that a thread stuck on its chunk doesn't hold up the rest of the checks
+// it took: they are stolen from its deque by other threads.
+BOOST_AUTO_TEST_CASE(test_CheckQueue_Work_Stealing)
+{
+    auto queue = std::make_unique<Stealing_Queue>(QUEUE_BATCH_SIZE, SCRIPT_CHECK_THREADS);
+    for (size_t i = 0; i < 10; ++i) {
+        {
+            std::lock_guard<std::mutex> l(StealingCheck::m);
+            StealingCheck::threads.clear();
+        }
+        CCheckQueueControl<StealingCheck> control(queue.get());
+        // All checks are added as one range, the first thread to take it
+        // blocks on its first chunk until another thread ran a check.
+        control.Add(std::vector<StealingCheck>(QUEUE_BATCH_SIZE * 10));
+        BOOST_REQUIRE(control.Wait());
+    }
+}
+
 // Test that a new verification cannot occur until all checks
 // have been destructed
 BOOST_AUTO_TEST_CASE(test_CheckQueue_FrozenCleanup)
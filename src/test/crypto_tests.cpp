@@ -838,6 +838,48 @@ BOOST_AUTO_TEST_CASE(chacha20_midblock)
     BOOST_CHECK(Span{block}.last(52) == Span{b3});
 }
 
+BOOST_AUTO_TEST_CASE(chacha20_implementations)
+{
+    // All multi-block implementations must produce the output of the standard one,
+    // including across the wrap-around of the 32-bit block counter.
+    for (int i = 0; i < 50; ++i) {
+        const auto key{g_insecure_rand_ctx.randbytes<std::byte>(32)};
+        const auto in{g_insecure_rand_ctx.randbytes<std::byte>(InsecureRandRange(64 * 40))};
+        const ChaCha20::Nonce96 nonce{InsecureRand32(), g_insecure_rand_ctx.rand64()};
+        const uint32_t block_counter{i % 2 ? uint32_t(-InsecureRandRange(32)) : InsecureRand32()};
+        std::vector<std::byte> expected;
+        for (const auto impl : {chacha20_implementation::STANDARD, chacha20_implementation::USE_SSE41,
+                                chacha20_implementation::USE_SSE41_AND_AVX2, chacha20_implementation::USE_ALL}) {
+            ChaCha20AutoDetect(impl);
+            ChaCha20 c20{key};
+            c20.Seek(nonce, block_counter);
+            std::vector<std::byte> out(in.size());
+            c20.Crypt(in, out);
+            if (impl == chacha20_implementation::STANDARD) {
+                expected = out;
+            } else {
+                BOOST_CHECK(out == expected);
+            }
+        }
+    }
+    ChaCha20AutoDetect();
+}
+
+BOOST_AUTO_TEST_CASE(poly1305_implementations)
+{
+    for (int i = 0; i < 50; ++i) {
+        const auto key{g_insecure_rand_ctx.randbytes<std::byte>(32)};
+        const auto in{g_insecure_rand_ctx.randbytes<std::byte>(InsecureRandRange(2000))};
+        const size_t split{size_t(InsecureRandRange(in.size() + 1))};
+        std::byte expected[Poly1305::TAGLEN], tag[Poly1305::TAGLEN];
+        Poly1305AutoDetect(poly1305_implementation::STANDARD);
+        Poly1305{key}.Update(Span{in}.first(split)).Update(Span{in}.subspan(split)).Finalize(expected);
+        Poly1305AutoDetect();
+        Poly1305{key}.Update(Span{in}.first(split)).Update(Span{in}.subspan(split)).Finalize(tag);
+        BOOST_CHECK(Span{tag} == Span{expected});
+    }
+}
+
 BOOST_AUTO_TEST_CASE(poly1305_testvector)
 {
     // RFC 7539, section 2.5.2.
@@ -1076,6 +1118,54 @@ BOOST_AUTO_TEST_CASE(sha256d64)
     }
 }
 
+BOOST_AUTO_TEST_CASE(sha256dmulti)
+{
+    // Cover messages of up to a few blocks, including all padding boundaries.
+    for (int count = 0; count <= 33; ++count) {
+        std::vector<std::vector<unsigned char>> msgs(count);
+        std::vector<Span<const unsigned char>> in;
+        for (auto& msg : msgs) {
+            msg = g_insecure_rand_ctx.randbytes(InsecureRandRange(200));
+            in.emplace_back(msg);
+        }
+        std::vector<unsigned char> out1(32 * count), out2(32 * count);
+        for (int j = 0; j < count; ++j) {
+            CHash256().Write(msgs[j]).Finalize({out1.data() + 32 * j, 32});
+        }
+        SHA256DMulti(out2.data(), in.data(), count);
+        BOOST_CHECK(out1 == out2);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(hash160multi)
+{
+    for (const auto use_implementation : {ripemd160_implementation::STANDARD, ripemd160_implementation::USE_SSE41, ripemd160_implementation::USE_ALL}) {
+        RIPEMD160AutoDetect(use_implementation);
+        // Cover messages of up to a few blocks, including all padding boundaries.
+        for (int count = 0; count <= 33; ++count) {
+            std::vector<std::vector<unsigned char>> msgs(count);
+            std::vector<Span<const unsigned char>> in;
+            for (auto& msg : msgs) {
+                msg = g_insecure_rand_ctx.randbytes(InsecureRandRange(200));
+                in.emplace_back(msg);
+            }
+            std::vector<unsigned char> out1(20 * count), out2(20 * count);
+            for (int j = 0; j < count; ++j) {
+                CRIPEMD160().Write(msgs[j].data(), msgs[j].size()).Finalize(out1.data() + 20 * j);
+            }
+            RIPEMD160Multi(out2.data(), in.data(), count);
+            BOOST_CHECK(out1 == out2);
+
+            const std::vector<uint160> hashes{Hash160Multi(in)};
+            BOOST_REQUIRE_EQUAL(hashes.size(), size_t(count));
+            for (int j = 0; j < count; ++j) {
+                BOOST_CHECK(hashes[j] == Hash160(msgs[j]));
+            }
+        }
+    }
+    RIPEMD160AutoDetect();
+}
+
 static void TestSHA3_256(const std::string& input, const std::string& output)
 {
     const auto in_bytes = ParseHex(input);
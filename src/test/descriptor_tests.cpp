@@ -241,6 +241,21 @@ void DoCheck(std::string prv, std::string pub, const std::string& norm_pub, int
             BOOST_CHECK(script_provider.scripts == script_provider_cached.scripts);
             BOOST_CHECK(GetKeyOriginData(script_provider, flags) == GetKeyOriginData(script_provider_cached, flags));
 
+            // Expanding a range of positions ending at i gives the same result at i, also from the cache.
+            std::vector<std::vector<CScript>> spks_range, spks_range_cached;
+            std::vector<FlatSigningProvider> script_providers_range, script_providers_range_cached;
+            BOOST_CHECK((t ? parse_priv : parse_pub)->ExpandRange(0, i + 1, key_provider, spks_range, script_providers_range));
+            BOOST_REQUIRE_EQUAL(spks_range.size(), i + 1);
+            BOOST_REQUIRE_EQUAL(script_providers_range.size(), i + 1);
+            BOOST_CHECK(spks_range[i] == spks);
+            BOOST_CHECK(GetKeyData(script_providers_range[i], flags) == GetKeyData(script_provider, flags));
+            BOOST_CHECK(script_providers_range[i].scripts == script_provider.scripts);
+            BOOST_CHECK(GetKeyOriginData(script_providers_range[i], flags) == GetKeyOriginData(script_provider, flags));
+            BOOST_CHECK(parse_pub->ExpandRangeFromCache(i, i + 1, desc_cache, spks_range_cached, script_providers_range_cached));
+            BOOST_REQUIRE_EQUAL(spks_range_cached.size(), 1U);
+            BOOST_CHECK(spks_range_cached[0] == spks);
+            BOOST_CHECK(GetKeyOriginData(script_providers_range_cached[0], flags) == GetKeyOriginData(script_provider, flags));
+
             // Check whether keys are in the cache
             const auto& der_xpub_cache = desc_cache.GetCachedDerivedExtPubKeys();
             const auto& parent_xpub_cache = desc_cache.GetCachedParentExtPubKeys();
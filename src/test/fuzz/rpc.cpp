@@ -149,9 +149,13 @@ const std::vector<std::string> RPC_COMMANDS_SAFE_FOR_FUZZING{
     "getrawmempool",
     "getrawtransaction",
     "getrpcinfo",
+    "getscripthistory",
+    "getscriptutxos",
     "gettxout",
     "gettxoutsetinfo",
+    "gettxprevouts",
     "gettxspendingprevout",
+    "getvalidationqueueinfo",
     "help",
     "invalidateblock",
     "joinpsbts",
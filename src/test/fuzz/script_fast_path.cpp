@@ -0,0 +1,106 @@
+// Copyright (c) 2024 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <hash.h>
+#include <script/interpreter.h>
+#include <script/script.h>
+#include <test/fuzz/FuzzedDataProvider.h>
+#include <test/fuzz/fuzz.h>
+#include <test/fuzz/util.h>
+#include <test/util/script.h>
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+namespace {
+/** Signature checker with a fixed outcome, so that both verification paths see the same results. */
+class FixedSignatureChecker : public BaseSignatureChecker
+{
+    const bool m_ecdsa_result;
+    const bool m_schnorr_result;
+
+public:
+    FixedSignatureChecker(bool ecdsa_result, bool schnorr_result) : m_ecdsa_result{ecdsa_result}, m_schnorr_result{schnorr_result} {}
+
+    bool CheckECDSASignature(const std::vector<unsigned char>& sig, const std::vector<unsigned char>& pubkey, const CScript& script_code, SigVersion sigversion) const override
+    {
+        return m_ecdsa_result && !sig.empty();
+    }
+
+    bool CheckSchnorrSignature(Span<const unsigned char> sig, Span<const unsigned char> pubkey, SigVersion sigversion, ScriptExecutionData& execdata, ScriptError* serror = nullptr) const override
+    {
+        if (!m_schnorr_result) {
+            if (serror) *serror = SCRIPT_ERR_SCHNORR_SIG;
+            return false;
+        }
+        return true;
+    }
+};
+
+std::vector<unsigned char> ConsumeElement(FuzzedDataProvider& provider)
+{
+    // Mostly sizes around real signatures and keys, sometimes anything.
+    const size_t size{provider.ConsumeBool() ? provider.PickValueInArray<size_t>({0, 1, 20, 32, 33, 64, 65, 71, 72, 73}) :
+                                               provider.ConsumeIntegralInRange<size_t>(0, 600)};
+    std::vector<unsigned char> element{provider.ConsumeBytes<unsigned char>(size)};
+    element.resize(size);
+    return element;
+}
+
+std::vector<unsigned char> KeyHash(FuzzedDataProvider& provider, const std::vector<unsigned char>& data)
+{
+    if (provider.ConsumeBool()) return ConsumeElement(provider);
+    return ToByteVector(Hash160(data));
+}
+} // namespace
+
+FUZZ_TARGET(script_fast_path)
+{
+    FuzzedDataProvider provider(buffer.data(), buffer.size());
+    const unsigned int flags{provider.ConsumeIntegral<unsigned int>()};
+    if (!IsValidFlagCombination(flags)) return;
+
+    CScript script_sig;
+    CScript script_pubkey;
+    CScriptWitness witness;
+    const auto sig{ConsumeElement(provider)};
+    const auto pubkey{ConsumeElement(provider)};
+    switch (provider.ConsumeIntegralInRange<int>(0, 4)) {
+    case 0: // P2PKH
+        script_sig << sig << pubkey;
+        script_pubkey << OP_DUP << OP_HASH160 << KeyHash(provider, pubkey) << OP_EQUALVERIFY << OP_CHECKSIG;
+        break;
+    case 1: // P2WPKH
+        script_pubkey << OP_0 << KeyHash(provider, pubkey);
+        witness.stack = {sig, pubkey};
+        break;
+    case 2: { // P2SH-P2WPKH
+        const CScript redeem_script{CScript() << OP_0 << KeyHash(provider, pubkey)};
+        script_sig << ToByteVector(redeem_script);
+        script_pubkey << OP_HASH160 << KeyHash(provider, ToByteVector(redeem_script)) << OP_EQUAL;
+        witness.stack = {sig, pubkey};
+        break;
+    }
+    case 3: // P2TR
+        script_pubkey << OP_1 << pubkey;
+        witness.stack = {sig};
+        break;
+    case 4: // Anything
+        script_sig = ConsumeScript(provider);
+        script_pubkey = ConsumeScript(provider);
+        break;
+    }
+    // Perturb the spend with extra witness elements or scriptSig data.
+    if (provider.ConsumeBool()) witness.stack.push_back(ConsumeElement(provider));
+    if (provider.ConsumeBool()) script_sig << ConsumeElement(provider);
+
+    const FixedSignatureChecker checker{provider.ConsumeBool(), provider.ConsumeBool()};
+    ScriptError fast_error;
+    ScriptError interpreted_error;
+    const bool fast{VerifyScript(script_sig, script_pubkey, &witness, flags, checker, &fast_error)};
+    const bool interpreted{VerifyScriptInterpreted(script_sig, script_pubkey, &witness, flags, checker, &interpreted_error)};
+    assert(fast == interpreted);
+    assert(fast_error == interpreted_error);
+}
@@ -146,6 +146,28 @@ BOOST_AUTO_TEST_CASE(siphash)
         BOOST_CHECK_EQUAL(SipHashUint256(k1, k2, x), sip256.Finalize());
         BOOST_CHECK_EQUAL(SipHashUint256Extra(k1, k2, x, n), sip288.Finalize());
     }
+
+    // Check consistency between SipHashUint256Multi and SipHashUint256 for all implementations,
+    // for every size up to two full batches of the 4-way implementation and a remainder.
+    for (const auto impl : {siphash_implementation::STANDARD, siphash_implementation::USE_ALL}) {
+        SipHashAutoDetect(impl);
+        const uint64_t k1 = ctx.rand64();
+        const uint64_t k2 = ctx.rand64();
+        for (size_t size = 0; size <= 2 * 4 + 1; ++size) {
+            std::vector<uint256> vals(size);
+            std::vector<const uint256*> val_ptrs;
+            for (uint256& val : vals) {
+                val = InsecureRand256();
+                val_ptrs.push_back(&val);
+            }
+            std::vector<uint64_t> out(vals.size());
+            SipHashUint256Multi(k1, k2, val_ptrs, out);
+            for (size_t i = 0; i < vals.size(); ++i) {
+                BOOST_CHECK_EQUAL(out[i], SipHashUint256(k1, k2, vals[i]));
+            }
+        }
+    }
+    SipHashAutoDetect();
 }
 
 BOOST_AUTO_TEST_SUITE_END()
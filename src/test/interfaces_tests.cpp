@@ -5,9 +5,14 @@
 #include <chainparams.h>
 #include <consensus/validation.h>
 #include <interfaces/chain.h>
+#include <interfaces/handler.h>
 #include <test/util/setup_common.h>
 #include <script/solver.h>
 #include <validation.h>
+#include <validationinterface.h>
+
+#include <memory>
+#include <vector>
 
 #include <boost/test/unit_test.hpp>
 
@@ -162,4 +167,35 @@ BOOST_AUTO_TEST_CASE(hasBlocks)
     BOOST_CHECK(!chain->hasBlocks(active.Tip()->GetBlockHash(), 6, 50));
 }
 
+BOOST_AUTO_TEST_CASE(handleNotifications)
+{
+    struct BlockRecorder : interfaces::Chain::Notifications {
+        std::vector<int> heights;
+        void blockConnected(ChainstateRole role, const interfaces::BlockInfo& block) override { heights.push_back(block.height); }
+    };
+
+    // Several clients each get all blocks, in order
+    std::vector<std::shared_ptr<BlockRecorder>> clients;
+    std::vector<std::unique_ptr<interfaces::Handler>> handlers;
+    for (int i = 0; i < 10; ++i) {
+        clients.push_back(std::make_shared<BlockRecorder>());
+        handlers.push_back(m_node.chain->handleNotifications(clients.back()));
+    }
+    const CScript script{CScript() << OP_TRUE};
+    for (int i = 0; i < 3; ++i) CreateAndProcessBlock({}, script);
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    for (const auto& client : clients) {
+        BOOST_CHECK(client->heights == std::vector<int>({101, 102, 103}));
+    }
+
+    // A disconnected client doesn't get further blocks
+    handlers[0]->disconnect();
+    CreateAndProcessBlock({}, script);
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    BOOST_CHECK_EQUAL(clients[0]->heights.size(), 3U);
+    for (size_t i = 1; i < clients.size(); ++i) {
+        BOOST_CHECK(clients[i]->heights == std::vector<int>({101, 102, 103, 104}));
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,99 @@
+// Copyright (c) 2024 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <addresstype.h>
+#include <chain.h>
+#include <index/prevoutindex.h>
+#include <interfaces/chain.h>
+#include <node/blockstorage.h>
+#include <test/util/index.h>
+#include <test/util/setup_common.h>
+#include <undo.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(prevoutindex_tests)
+
+BOOST_FIXTURE_TEST_CASE(prevoutindex_initial_sync, TestChain100Setup)
+{
+    const CScript coinbase_script_pub_key{GetScriptForDestination(PKHash(coinbaseKey.GetPubKey()))};
+
+    // Confirm a transaction spending the first coinbase output before the index is started.
+    const CAmount output_amount{1 * COIN};
+    const CMutableTransaction spend{CreateValidMempoolTransaction(m_coinbase_txns[0], /*input_vout=*/0, /*input_height=*/1,
+                                                                  coinbaseKey, coinbase_script_pub_key, output_amount, /*submit=*/false)};
+    const CBlock block{CreateAndProcessBlock({spend}, coinbase_script_pub_key)};
+    BOOST_REQUIRE_EQUAL(block.vtx.size(), 2U);
+
+    PrevoutIndex prevout_index(interfaces::MakeChain(m_node), 1 << 20, true);
+    BOOST_REQUIRE(prevout_index.Init());
+
+    TxPrevouts prevouts;
+
+    // Transaction should not be found in the index before it is started.
+    BOOST_CHECK(!prevout_index.FindTxPrevouts(spend.GetHash(), prevouts));
+
+    // BlockUntilSyncedToCurrentChain should return false before the index is started.
+    BOOST_CHECK(!prevout_index.BlockUntilSyncedToCurrentChain());
+
+    BOOST_REQUIRE(prevout_index.StartBackgroundSync());
+
+    // Allow the index to catch up with the block index.
+    IndexWaitSynced(prevout_index, *Assert(m_node.shutdown));
+
+    // Coinbase transactions don't spend any outputs and are not indexed.
+    for (const auto& txn : m_coinbase_txns) {
+        BOOST_CHECK(!prevout_index.FindTxPrevouts(txn->GetHash(), prevouts));
+    }
+
+    const CBlockIndex* tip{WITH_LOCK(cs_main, return m_node.chainman->ActiveChain().Tip())};
+    BOOST_REQUIRE(prevout_index.FindTxPrevouts(spend.GetHash(), prevouts));
+    BOOST_CHECK_EQUAL(prevouts.height, tip->nHeight);
+    BOOST_REQUIRE_EQUAL(prevouts.undo.vprevout.size(), 1U);
+    const Coin& coin{prevouts.undo.vprevout[0]};
+    BOOST_CHECK(coin.out == m_coinbase_txns[0]->vout[0]);
+    BOOST_CHECK_EQUAL(coin.nHeight, 1U);
+    BOOST_CHECK(coin.fCoinBase);
+    BOOST_CHECK_EQUAL(prevouts.fee, m_coinbase_txns[0]->vout[0].nValue - output_amount);
+
+    // The prevouts of a whole block match its undo data.
+    CBlockUndo index_undo, disk_undo;
+    BOOST_REQUIRE(prevout_index.FindBlockPrevouts(*tip, block, index_undo));
+    BOOST_REQUIRE(m_node.chainman->m_blockman.UndoReadFromDisk(disk_undo, *tip));
+    BOOST_REQUIRE_EQUAL(index_undo.vtxundo.size(), disk_undo.vtxundo.size());
+    for (size_t i = 0; i < disk_undo.vtxundo.size(); ++i) {
+        BOOST_REQUIRE_EQUAL(index_undo.vtxundo[i].vprevout.size(), disk_undo.vtxundo[i].vprevout.size());
+        for (size_t j = 0; j < disk_undo.vtxundo[i].vprevout.size(); ++j) {
+            BOOST_CHECK(index_undo.vtxundo[i].vprevout[j].out == disk_undo.vtxundo[i].vprevout[j].out);
+            BOOST_CHECK_EQUAL(index_undo.vtxundo[i].vprevout[j].nHeight, disk_undo.vtxundo[i].vprevout[j].nHeight);
+        }
+    }
+
+    // Blocks that are not in the chain the index is synced to are not resolved.
+    const CBlockIndex* prev{tip->pprev};
+    BOOST_CHECK(!prevout_index.FindBlockPrevouts(*prev, block, index_undo));
+
+    // Check that new transactions in new blocks make it into the index.
+    const CMutableTransaction spend_new{CreateValidMempoolTransaction(m_coinbase_txns[1], /*input_vout=*/0, /*input_height=*/2,
+                                                                      coinbaseKey, coinbase_script_pub_key, output_amount, /*submit=*/false)};
+    CreateAndProcessBlock({spend_new}, coinbase_script_pub_key);
+    BOOST_CHECK(prevout_index.BlockUntilSyncedToCurrentChain());
+    BOOST_REQUIRE(prevout_index.FindTxPrevouts(spend_new.GetHash(), prevouts));
+    BOOST_CHECK_EQUAL(prevouts.height, tip->nHeight + 1);
+    BOOST_CHECK_EQUAL(prevouts.fee, m_coinbase_txns[1]->vout[0].nValue - output_amount);
+
+    // It is not safe to stop and destroy the index until it finishes handling
+    // the last BlockConnected notification. The BlockUntilSyncedToCurrentChain()
+    // call above is sufficient to ensure this, but the
+    // SyncWithValidationInterfaceQueue() call below is also needed to ensure
+    // TSAN always sees the test thread waiting for the notification thread, and
+    // avoid potential false positive reports.
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+
+    // shutdown sequence (c.f. Shutdown() in init.cpp)
+    prevout_index.Stop();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,138 @@
+// Copyright (c) 2024 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <addresstype.h>
+#include <chain.h>
+#include <consensus/validation.h>
+#include <index/scripthashindex.h>
+#include <interfaces/chain.h>
+#include <test/util/index.h>
+#include <test/util/setup_common.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <limits>
+#include <optional>
+
+BOOST_AUTO_TEST_SUITE(scripthashindex_tests)
+
+static constexpr size_t ALL_EVENTS{std::numeric_limits<size_t>::max()};
+
+BOOST_FIXTURE_TEST_CASE(scripthashindex_initial_sync, TestChain100Setup)
+{
+    // TestChain100Setup pays all coinbase outputs to a P2PK script of coinbaseKey.
+    const CScript coinbase_script{CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG};
+    const uint256 coinbase_hash{ScriptHashIndex::GetScriptHash(coinbase_script)};
+    const CScript dest_script{GetScriptForDestination(PKHash(coinbaseKey.GetPubKey()))};
+    const uint256 dest_hash{ScriptHashIndex::GetScriptHash(dest_script)};
+
+    const CMutableTransaction spend{CreateValidMempoolTransaction(m_coinbase_txns[0], /*input_vout=*/0, /*input_height=*/1,
+                                                                  coinbaseKey, dest_script, 1 * COIN, /*submit=*/false)};
+    CreateAndProcessBlock({spend}, coinbase_script);
+    const int spend_height{WITH_LOCK(cs_main, return m_node.chainman->ActiveChain().Height())};
+
+    ScriptHashIndex index(interfaces::MakeChain(m_node), 1 << 20, true);
+    BOOST_REQUIRE(index.Init());
+
+    std::vector<ScriptEvent> events;
+    std::optional<ScriptEventPos> next;
+    BOOST_CHECK(index.LookupEvents(coinbase_hash, {}, ALL_EVENTS, events, next));
+    BOOST_CHECK(events.empty());
+
+    BOOST_REQUIRE(index.StartBackgroundSync());
+    IndexWaitSynced(index, *Assert(m_node.shutdown));
+
+    // One funding event per coinbase and one spending event.
+    BOOST_REQUIRE(index.LookupEvents(coinbase_hash, {}, ALL_EVENTS, events, next));
+    BOOST_REQUIRE_EQUAL(events.size(), size_t(spend_height) + 1);
+    for (size_t i = 0; i < events.size() - 1; ++i) {
+        BOOST_CHECK(events[i].type == ScriptEvent::Type::FUNDING);
+        BOOST_CHECK_EQUAL(events[i].height, int(i) + 1);
+        BOOST_CHECK_EQUAL(events[i].tx_pos, 0U);
+    }
+    for (size_t i = 0; i < m_coinbase_txns.size(); ++i) {
+        BOOST_CHECK(events[i].txid == m_coinbase_txns[i]->GetHash());
+        BOOST_CHECK_EQUAL(events[i].value, m_coinbase_txns[i]->vout[0].nValue);
+    }
+    const ScriptEvent& spending{events.back()};
+    BOOST_CHECK(spending.type == ScriptEvent::Type::SPENDING);
+    BOOST_CHECK_EQUAL(spending.height, spend_height);
+    BOOST_CHECK_EQUAL(spending.tx_pos, 1U);
+    BOOST_CHECK(spending.txid == spend.GetHash());
+    BOOST_CHECK_EQUAL(spending.index, 0U);
+    BOOST_CHECK_EQUAL(spending.value, m_coinbase_txns[0]->vout[0].nValue);
+    BOOST_CHECK(spending.prevout == COutPoint(m_coinbase_txns[0]->GetHash(), 0));
+
+    // Range lookups start at the requested height and stop at the requested count.
+    const std::vector<ScriptEvent> all_events{events};
+    BOOST_CHECK(!next);
+    events.clear();
+    BOOST_REQUIRE(index.LookupEvents(coinbase_hash, ScriptEventPos{.height = 50}, 10, events, next));
+    BOOST_REQUIRE_EQUAL(events.size(), 10U);
+    BOOST_CHECK_EQUAL(events.front().height, 50);
+    BOOST_CHECK_EQUAL(events.back().height, 59);
+    BOOST_REQUIRE(next);
+    BOOST_CHECK_EQUAL(next->height, 60);
+
+    // Paging one event at a time resumes within a height too: the last block
+    // has both a funding and a spending event of the coinbase script.
+    std::vector<ScriptEvent> paged;
+    next = ScriptEventPos{};
+    while (next) {
+        events.clear();
+        BOOST_REQUIRE(index.LookupEvents(coinbase_hash, *next, 1, events, next));
+        BOOST_REQUIRE_EQUAL(events.size(), 1U);
+        paged.push_back(events[0]);
+    }
+    BOOST_REQUIRE_EQUAL(paged.size(), all_events.size());
+    for (size_t i = 0; i < paged.size(); ++i) {
+        BOOST_CHECK(paged[i].type == all_events[i].type);
+        BOOST_CHECK_EQUAL(paged[i].height, all_events[i].height);
+        BOOST_CHECK_EQUAL(paged[i].tx_pos, all_events[i].tx_pos);
+        BOOST_CHECK_EQUAL(paged[i].index, all_events[i].index);
+    }
+
+    events.clear();
+    BOOST_REQUIRE(index.LookupEvents(dest_hash, {}, ALL_EVENTS, events, next));
+    BOOST_REQUIRE_EQUAL(events.size(), 1U);
+    BOOST_CHECK(events[0].type == ScriptEvent::Type::FUNDING);
+    BOOST_CHECK(events[0].txid == spend.GetHash());
+    BOOST_CHECK_EQUAL(events[0].value, 1 * COIN);
+
+    // All coinbase outputs but the spent one are unspent.
+    std::vector<ScriptEvent> unspent;
+    BOOST_REQUIRE(index.LookupUnspent(coinbase_hash, unspent));
+    BOOST_CHECK_EQUAL(unspent.size(), size_t(spend_height) - 1);
+    for (const ScriptEvent& event : unspent) {
+        BOOST_CHECK(event.txid != m_coinbase_txns[0]->GetHash());
+    }
+
+    // Entries of disconnected blocks are removed on reorg.
+    CBlockIndex* tip{WITH_LOCK(cs_main, return m_node.chainman->ActiveChain().Tip())};
+    BlockValidationState state;
+    BOOST_REQUIRE(m_node.chainman->ActiveChainstate().InvalidateBlock(state, tip));
+    CreateAndProcessBlock({}, CScript() << OP_TRUE);
+    BOOST_CHECK(index.BlockUntilSyncedToCurrentChain());
+
+    events.clear();
+    BOOST_REQUIRE(index.LookupEvents(dest_hash, {}, ALL_EVENTS, events, next));
+    BOOST_CHECK(events.empty());
+    events.clear();
+    BOOST_REQUIRE(index.LookupEvents(coinbase_hash, {}, ALL_EVENTS, events, next));
+    BOOST_CHECK_EQUAL(events.size(), m_coinbase_txns.size());
+
+    // It is not safe to stop and destroy the index until it finishes handling
+    // the last BlockConnected notification. The BlockUntilSyncedToCurrentChain()
+    // call above is sufficient to ensure this, but the
+    // SyncWithValidationInterfaceQueue() call below is also needed to ensure
+    // TSAN always sees the test thread waiting for the notification thread, and
+    // avoid potential false positive reports.
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+
+    // shutdown sequence (c.f. Shutdown() in init.cpp)
+    index.Stop();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -1036,4 +1036,34 @@ BOOST_AUTO_TEST_CASE(test_TxidFromString)
         "000000000000000000000000000000000000000000000000000000000000abcd");
 }
 
+BOOST_AUTO_TEST_CASE(block_arena_deserialization)
+{
+    CBlock block;
+    for (int i = 0; i < 10; ++i) {
+        CMutableTransaction mtx;
+        mtx.vin.emplace_back(COutPoint{Txid::FromUint256(InsecureRand256()), uint32_t(i)}, CScript() << i);
+        if (i % 2) mtx.vin[0].scriptWitness.stack.push_back(std::vector<unsigned char>(i, 0x42));
+        // Only some inputs of a transaction may have a witness.
+        if (i % 3 == 0) mtx.vin.emplace_back(COutPoint{Txid::FromUint256(InsecureRand256()), 0});
+        mtx.vout.emplace_back(i * COIN, CScript() << OP_TRUE);
+        block.vtx.push_back(MakeTransactionRef(std::move(mtx)));
+    }
+    DataStream stream;
+    stream << TX_WITH_WITNESS(block);
+
+    CBlock block_arena;
+    stream >> TX_WITH_WITNESS_ARENA(block_arena);
+    BOOST_REQUIRE_EQUAL(block_arena.vtx.size(), block.vtx.size());
+    for (size_t i = 0; i < block.vtx.size(); ++i) {
+        BOOST_CHECK(block_arena.vtx[i]->GetHash() == block.vtx[i]->GetHash());
+        BOOST_CHECK(block_arena.vtx[i]->GetWitnessHash() == block.vtx[i]->GetWitnessHash());
+    }
+
+    // Transactions allocated from the arena outlive the block.
+    CTransactionRef tx{block_arena.vtx.back()};
+    block_arena.SetNull();
+    BOOST_CHECK(tx->GetWitnessHash() == block.vtx.back()->GetWitnessHash());
+    BOOST_CHECK_EQUAL(tx->vout[0].nValue, 9 * COIN);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
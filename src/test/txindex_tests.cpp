@@ -3,7 +3,9 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <addresstype.h>
+#include <chain.h>
 #include <chainparams.h>
+#include <consensus/validation.h>
 #include <index/txindex.h>
 #include <interfaces/chain.h>
 #include <test/util/index.h>
@@ -77,4 +79,61 @@ BOOST_FIXTURE_TEST_CASE(txindex_initial_sync, TestChain100Setup)
     txindex.Stop();
 }
 
+BOOST_FIXTURE_TEST_CASE(txindex_compact_format, TestChain100Setup)
+{
+    // Build an index in the full format first, so the compact index below has
+    // to migrate it.
+    {
+        TxIndex txindex(interfaces::MakeChain(m_node), 1 << 20, false, false, TxIndexFormat::FULL);
+        BOOST_REQUIRE(txindex.Init());
+        BOOST_REQUIRE(txindex.StartBackgroundSync());
+        IndexWaitSynced(txindex, *Assert(m_node.shutdown));
+        txindex.Stop();
+    }
+
+    TxIndex txindex(interfaces::MakeChain(m_node), 1 << 20, false, false, TxIndexFormat::COMPACT);
+    BOOST_CHECK(txindex.GetFormat() == TxIndexFormat::COMPACT);
+    BOOST_REQUIRE(txindex.Init());
+
+    // The existing index was wiped, so nothing is found before syncing again.
+    CTransactionRef tx_disk;
+    uint256 block_hash;
+    BOOST_CHECK(!txindex.FindTx(m_coinbase_txns[0]->GetHash(), block_hash, tx_disk));
+
+    BOOST_REQUIRE(txindex.StartBackgroundSync());
+    IndexWaitSynced(txindex, *Assert(m_node.shutdown));
+
+    for (const auto& txn : Params().GenesisBlock().vtx) {
+        BOOST_CHECK(!txindex.FindTx(txn->GetHash(), block_hash, tx_disk));
+    }
+    for (size_t i = 0; i < m_coinbase_txns.size(); ++i) {
+        BOOST_REQUIRE(txindex.FindTx(m_coinbase_txns[i]->GetHash(), block_hash, tx_disk));
+        BOOST_CHECK(tx_disk->GetHash() == m_coinbase_txns[i]->GetHash());
+        BOOST_CHECK_EQUAL(block_hash, WITH_LOCK(cs_main, return m_node.chainman->ActiveChain()[i + 1]->GetBlockHash()));
+    }
+
+    // Transactions at a non-zero offset within the block are found too.
+    const CScript script_pub_key{GetScriptForDestination(PKHash(coinbaseKey.GetPubKey()))};
+    const CMutableTransaction spend{CreateValidMempoolTransaction(m_coinbase_txns[0], /*input_vout=*/0, /*input_height=*/1,
+                                                                  coinbaseKey, script_pub_key, 1 * COIN, /*submit=*/false)};
+    const CBlock block{CreateAndProcessBlock({spend}, script_pub_key)};
+    BOOST_CHECK(txindex.BlockUntilSyncedToCurrentChain());
+    BOOST_REQUIRE(txindex.FindTx(spend.GetHash(), block_hash, tx_disk));
+    BOOST_CHECK(tx_disk->GetHash() == spend.GetHash());
+    BOOST_CHECK_EQUAL(block_hash, block.GetHash());
+
+    // Entries of blocks that are no longer in the active chain are ignored.
+    CBlockIndex* tip{WITH_LOCK(cs_main, return m_node.chainman->ActiveChain().Tip())};
+    BlockValidationState state;
+    BOOST_REQUIRE(m_node.chainman->ActiveChainstate().InvalidateBlock(state, tip));
+    CreateAndProcessBlock({}, CScript() << OP_TRUE);
+    BOOST_CHECK(txindex.BlockUntilSyncedToCurrentChain());
+    BOOST_CHECK(!txindex.FindTx(spend.GetHash(), block_hash, tx_disk));
+    BOOST_CHECK(!txindex.FindTx(block.vtx[0]->GetHash(), block_hash, tx_disk));
+
+    // See txindex_initial_sync for why this is needed before stopping the index.
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    txindex.Stop();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -251,6 +251,7 @@ ChainTestingSetup::ChainTestingSetup(const ChainType chainType, TestOpts opts)
         .notifications = *m_node.notifications,
         .signals = m_node.validation_signals.get(),
         .worker_threads_num = 2,
+        .parallel_tx_checks = m_args.GetBoolArg("-partxchecks", DEFAULT_PARALLEL_TX_CHECKS),
     };
     const BlockManager::Options blockman_opts{
         .chainparams = chainman_opts.chainparams,
@@ -16,6 +16,7 @@
 #include <util/fs_helpers.h>
 #include <util/moneystr.h>
 #include <util/overflow.h>
+#include <util/parallel.h>
 #include <util/readwritefile.h>
 #include <util/strencodings.h>
 #include <util/string.h>
@@ -1831,4 +1832,26 @@ BOOST_AUTO_TEST_CASE(clearshrink_test)
     }
 }
 
+BOOST_AUTO_TEST_CASE(parallel_for)
+{
+    for (const size_t count : {0, 1, 7, 1000}) {
+        for (const size_t num_threads : {1, 3, 16}) {
+            std::vector<int> visited(count);
+            util::ParallelFor(count, num_threads, [&](size_t begin, size_t end) {
+                BOOST_REQUIRE(begin <= end && end <= count);
+                for (size_t i = begin; i < end; ++i) ++visited[i];
+            });
+            BOOST_CHECK(std::all_of(visited.begin(), visited.end(), [](int n) { return n == 1; }));
+        }
+    }
+
+    // Exceptions are propagated to the caller once all threads are done
+    std::atomic<size_t> processed{0};
+    BOOST_CHECK_THROW(util::ParallelFor(100, 4, [&](size_t begin, size_t end) {
+        if (begin == 50) throw std::runtime_error("fail");
+        processed += end - begin;
+    }), std::runtime_error);
+    BOOST_CHECK_EQUAL(processed, 75U);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -8,6 +8,7 @@
 #include <core_io.h>
 #include <hash.h>
 #include <net.h>
+#include <script/script.h>
 #include <signet.h>
 #include <uint256.h>
 #include <util/chaintype.h>
@@ -360,4 +361,32 @@ BOOST_AUTO_TEST_CASE(block_malleation)
     }
 }
 
+struct ParallelTxChecksSetup : public TestChain100Setup {
+    ParallelTxChecksSetup() : TestChain100Setup{ChainType::REGTEST, {.extra_args = {"-partxchecks=1"}}} {}
+};
+
+BOOST_FIXTURE_TEST_CASE(parallel_tx_checks, ParallelTxChecksSetup)
+{
+    BOOST_REQUIRE(m_node.chainman->GetCheckQueue().HasThreads());
+    const CScript script_pub_key{CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG};
+    const auto spend{[&](size_t coinbase_index, CAmount amount) {
+        return CreateValidMempoolTransaction(m_coinbase_txns[coinbase_index], /*input_vout=*/0, /*input_height=*/coinbase_index + 1,
+                                             coinbaseKey, script_pub_key, amount, /*submit=*/false);
+    }};
+    const auto tip_hash{[&] { return WITH_LOCK(cs_main, return m_node.chainman->ActiveChain().Tip()->GetBlockHash()); }};
+    // Mature the first coinbase outputs
+    for (int i = 0; i < 10; ++i) CreateAndProcessBlock({}, script_pub_key);
+
+    // A block of valid spends is connected
+    const CBlock block{CreateAndProcessBlock({spend(0, COIN), spend(1, COIN), spend(2, COIN)}, script_pub_key)};
+    BOOST_CHECK_EQUAL(tip_hash(), block.GetHash());
+
+    // A block with an overspending or a premature coinbase spend among valid ones is not
+    for (const CMutableTransaction& invalid : {spend(3, 60 * COIN), spend(99, COIN)}) {
+        const uint256 tip{tip_hash()};
+        CreateAndProcessBlock({spend(4, COIN), invalid, spend(5, COIN)}, script_pub_key);
+        BOOST_CHECK_EQUAL(tip_hash(), tip);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -12,6 +12,9 @@
 #include <validationinterface.h>
 
 #include <atomic>
+#include <future>
+#include <string>
+#include <vector>
 
 BOOST_FIXTURE_TEST_SUITE(validationinterface_tests, ChainTestingSetup)
 
@@ -101,4 +104,65 @@ BOOST_AUTO_TEST_CASE(unregister_all_during_call)
     BOOST_CHECK(destroyed);
 }
 
+class TestFlushedInterface : public CValidationInterface
+{
+public:
+    explicit TestFlushedInterface(std::function<void(int)> on_flushed) : m_on_flushed{std::move(on_flushed)} {}
+    void ChainStateFlushed(ChainstateRole role, const CBlockLocator& locator) override
+    {
+        m_on_flushed(locator.vHave.size());
+    }
+    std::function<void(int)> m_on_flushed;
+};
+
+BOOST_AUTO_TEST_CASE(separate_queues)
+{
+    ValidationSignals signals{std::make_unique<util::ImmediateTaskRunner>(), [](const std::string& name) {
+        return std::make_unique<ThreadedSerialTaskRunner>(name);
+    }};
+
+    // A subscriber in its own queue that blocks until released.
+    std::promise<void> release;
+    std::shared_future<void> released{release.get_future()};
+    std::vector<int> slow_events;
+    TestFlushedInterface slow{[&](int event) {
+        released.wait();
+        slow_events.push_back(event);
+    }};
+    signals.RegisterValidationInterface(&slow, "slow");
+
+    std::vector<int> fast_events;
+    TestFlushedInterface fast{[&](int event) { fast_events.push_back(event); }};
+    signals.RegisterValidationInterface(&fast);
+
+    const int num_events{5};
+    for (int i = 1; i <= num_events; ++i) {
+        signals.ChainStateFlushed(ChainstateRole::NORMAL, CBlockLocator{std::vector<uint256>(i)});
+    }
+
+    // The blocked subscriber doesn't delay the subscribers of other queues.
+    BOOST_CHECK_EQUAL(fast_events.size(), size_t(num_events));
+    BOOST_CHECK(slow_events.empty());
+    BOOST_CHECK_GE(signals.CallbacksPending(), size_t(num_events - 1));
+    for (const ValidationQueueInfo& info : signals.GetQueueInfo()) {
+        BOOST_CHECK_EQUAL(info.subscribers, 1U);
+        if (info.name == DEFAULT_VALIDATION_QUEUE) {
+            BOOST_CHECK_EQUAL(info.pending, 0U);
+        } else {
+            BOOST_CHECK_EQUAL(info.name, "slow");
+            BOOST_CHECK_GE(info.pending, size_t(num_events - 1));
+        }
+    }
+
+    // Once released, it receives all events in order, before the
+    // synchronization with all queues returns.
+    release.set_value();
+    signals.SyncWithValidationInterfaceQueue();
+    BOOST_CHECK(slow_events == fast_events);
+    BOOST_CHECK_EQUAL(signals.CallbacksPending(), 0U);
+
+    signals.UnregisterAllValidationInterfaces();
+    signals.FlushBackgroundCallbacks();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
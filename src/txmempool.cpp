@@ -11,6 +11,7 @@
 #include <consensus/consensus.h>
 #include <consensus/tx_verify.h>
 #include <consensus/validation.h>
+#include <crypto/siphash.h>
 #include <logging.h>
 #include <policy/policy.h>
 #include <policy/settings.h>
@@ -529,6 +530,19 @@ void CTxMemPool::removeUnchecked(txiter it, MemPoolRemovalReason reason)
     nTransactionsUpdated++;
 }
 
+void CTxMemPool::GetWtxidSipHashes(uint64_t k0, uint64_t k1, size_t begin, Span<uint64_t> out) const
+{
+    AssertLockHeld(cs);
+    assert(begin + out.size() <= txns_randomized.size());
+
+    std::vector<const uint256*> wtxids;
+    wtxids.reserve(out.size());
+    for (size_t i = 0; i < out.size(); ++i) {
+        wtxids.push_back(&txns_randomized[begin + i]->GetWitnessHash().ToUint256());
+    }
+    SipHashUint256Multi(k0, k1, wtxids, out);
+}
+
 // Calculates descendants of entry that are not already in setDescendants, and adds to
 // setDescendants. Assumes entryit is already a tx in the mempool and CTxMemPoolEntry::m_children
 // is correct for tx and all descendants.
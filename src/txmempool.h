@@ -391,6 +391,13 @@ public:
     using txiter = indexed_transaction_set::nth_index<0>::type::const_iterator;
     std::vector<CTransactionRef> txns_randomized GUARDED_BY(cs); //!< All transactions in mapTx, in random order
 
+    /**
+     * Compute the SipHash-2-4 of the wtxids of txns_randomized[begin, begin + out.size())
+     * under the key (k0, k1), as used for compact block short IDs (BIP152). Several
+     * wtxids are hashed at once if the SipHash implementation supports it.
+     */
+    void GetWtxidSipHashes(uint64_t k0, uint64_t k1, size_t begin, Span<uint64_t> out) const EXCLUSIVE_LOCKS_REQUIRED(cs);
+
     typedef std::set<txiter, CompareIteratorByHash> setEntries;
 
     using Limits = kernel::MemPoolLimits;
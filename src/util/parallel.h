@@ -0,0 +1,61 @@
+// Copyright (c) 2024 The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_UTIL_PARALLEL_H
+#define BITCOIN_UTIL_PARALLEL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace util {
+/**
+ * Call func(begin, end) on consecutive, disjoint sub-ranges covering [0, count),
+ * using up to num_threads threads including the calling one. Returns once all
+ * sub-ranges have been processed. If func throws, the first exception (in range
+ * order) is rethrown on the calling thread after all threads have finished.
+ * If a thread can't be started, the error is rethrown once the started ones
+ * have finished.
+ */
+template <typename F>
+void ParallelFor(size_t count, size_t num_threads, F&& func)
+{
+    num_threads = std::clamp<size_t>(num_threads, 1, std::max<size_t>(count, 1));
+    const size_t chunk{(count + num_threads - 1) / num_threads};
+    if (num_threads == 1) {
+        func(size_t{0}, count);
+        return;
+    }
+
+    std::vector<std::exception_ptr> errors(num_threads);
+    const auto run{[&](size_t i) {
+        try {
+            func(std::min(i * chunk, count), std::min((i + 1) * chunk, count));
+        } catch (...) {
+            errors[i] = std::current_exception();
+        }
+    }};
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads - 1);
+    try {
+        for (size_t i = 1; i < num_threads; ++i) {
+            threads.emplace_back(run, i);
+        }
+    } catch (...) {
+        // Destroying a joinable thread would terminate the process.
+        for (auto& thread : threads) thread.join();
+        throw;
+    }
+    run(0);
+    for (auto& thread : threads) thread.join();
+
+    for (const auto& error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+}
+} // namespace util
+
+#endif // BITCOIN_UTIL_PARALLEL_H
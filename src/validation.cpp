@@ -2094,6 +2094,27 @@ bool CScriptCheck::operator()() {
     return VerifyScript(scriptSig, m_tx_out.scriptPubKey, witness, nFlags, CachingTransactionSignatureChecker(ptxTo, nIn, m_tx_out.nValue, cacheStore, *m_signature_cache, *txdata), &error);
 }
 
+bool CTxInputsCheck::operator()()
+{
+    const CTransaction& tx{*m_tx};
+    Result& result{*m_result};
+    if (!tx.IsCoinBase()) {
+        result.inputs_ok = Consensus::CheckTxInputs(tx, result.state, m_coins, m_block_index->nHeight, result.fee);
+        if (!result.inputs_ok) return true;
+
+        std::vector<int> prevheights(tx.vin.size());
+        for (size_t j = 0; j < tx.vin.size(); j++) {
+            prevheights[j] = m_coins[j].nHeight;
+        }
+        result.sequence_locks_ok = SequenceLocks(tx, m_lock_time_flags, prevheights, *m_block_index);
+    } else {
+        result.inputs_ok = true;
+        result.sequence_locks_ok = true;
+    }
+    result.sigop_cost = GetTransactionSigOpCost(tx, m_coins, m_flags);
+    return true;
+}
+
 ValidationCache::ValidationCache(const size_t script_execution_cache_bytes, const size_t signature_cache_bytes)
     : m_signature_cache{signature_cache_bytes}
 {
@@ -2595,37 +2616,91 @@ bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state,
 
     CBlockUndo blockundo;
 
+    CAmount nFees = 0;
+    int nInputs = 0;
+    int64_t nSigOpsCost = 0;
+    blockundo.vtxundo.reserve(block.vtx.size() - 1);
+
+    // Resolve the coins spent by the block and apply its UTXO changes, which has
+    // to happen serially and in order. The spent coins end up in the undo data,
+    // which the contextual checks read from, possibly on multiple threads, and
+    // in a separate view for the script checks.
+    // This stops at the first transaction with missing inputs, the transactions
+    // before it are checked first, so that failures are reported in order.
+    CCoinsView coins_dummy;
+    CCoinsViewCache spent_coins{&coins_dummy};
+    size_t num_resolved{0};
+    for (; num_resolved < block.vtx.size(); ++num_resolved) {
+        const CTransaction& tx{*block.vtx[num_resolved]};
+        if (!tx.IsCoinBase() && !view.HaveInputs(tx)) break;
+
+        nInputs += tx.vin.size();
+        CTxUndo undoDummy;
+        if (num_resolved > 0) {
+            blockundo.vtxundo.emplace_back();
+        }
+        UpdateCoins(tx, view, num_resolved == 0 ? undoDummy : blockundo.vtxundo.back(), pindex->nHeight);
+        if (num_resolved > 0) {
+            const CTxUndo& txundo{blockundo.vtxundo.back()};
+            for (size_t j = 0; j < tx.vin.size(); j++) {
+                spent_coins.AddCoin(tx.vin[j].prevout, Coin{txundo.vprevout[j]}, /*possible_overwrite=*/false);
+            }
+        }
+    }
+
+    // Run the contextual checks of the resolved transactions, on the script
+    // check threads if enabled. The undo data is not modified until they are done.
+    std::vector<CTxInputsCheck::Result> tx_results(num_resolved);
+    {
+        std::vector<CTxInputsCheck> tx_checks;
+        tx_checks.reserve(num_resolved);
+        for (size_t i = 0; i < num_resolved; i++) {
+            const Span<const Coin> coins{i == 0 ? Span<const Coin>{} : Span<const Coin>{blockundo.vtxundo[i - 1].vprevout}};
+            tx_checks.emplace_back(*block.vtx[i], coins, *pindex, nLockTimeFlags, flags, tx_results[i]);
+        }
+        if (parallel_script_checks && m_chainman.m_options.parallel_tx_checks) {
+            CCheckQueueControl<CBlockCheck> tx_control(&m_chainman.GetCheckQueue());
+            tx_control.Add(std::move(tx_checks));
+            tx_control.Wait();
+        } else {
+            for (auto& check : tx_checks) check();
+        }
+    }
+
     // Precomputed transaction data pointers must not be invalidated
     // until after `control` has run the script checks (potentially
     // in multiple threads). Preallocate the vector size so a new allocation
     // doesn't invalidate pointers into the vector, and keep txsdata in scope
     // for as long as `control`.
-    CCheckQueueControl<CScriptCheck> control(fScriptChecks && parallel_script_checks ? &m_chainman.GetCheckQueue() : nullptr);
+    CCheckQueueControl<CBlockCheck> control(fScriptChecks && parallel_script_checks ? &m_chainman.GetCheckQueue() : nullptr);
     std::vector<PrecomputedTransactionData> txsdata(block.vtx.size());
 
-    std::vector<int> prevheights;
-    CAmount nFees = 0;
-    int nInputs = 0;
-    int64_t nSigOpsCost = 0;
-    blockundo.vtxundo.reserve(block.vtx.size() - 1);
     for (unsigned int i = 0; i < block.vtx.size(); i++)
     {
         const CTransaction &tx = *(block.vtx[i]);
 
-        nInputs += tx.vin.size();
+        if (i == num_resolved) {
+            // The inputs of this transaction are missing or spent.
+            TxValidationState tx_state;
+            CAmount txfee = 0;
+            Assume(!Consensus::CheckTxInputs(tx, tx_state, view, pindex->nHeight, txfee));
+            state.Invalid(BlockValidationResult::BLOCK_CONSENSUS,
+                          tx_state.GetRejectReason(), tx_state.GetDebugMessage());
+            LogError("%s: Consensus::CheckTxInputs: %s, %s\n", __func__, tx.GetHash().ToString(), state.ToString());
+            return false;
+        }
+        const CTxInputsCheck::Result& tx_result{tx_results[i]};
 
         if (!tx.IsCoinBase())
         {
-            CAmount txfee = 0;
-            TxValidationState tx_state;
-            if (!Consensus::CheckTxInputs(tx, tx_state, view, pindex->nHeight, txfee)) {
+            if (!tx_result.inputs_ok) {
                 // Any transaction validation failure in ConnectBlock is a block consensus failure
                 state.Invalid(BlockValidationResult::BLOCK_CONSENSUS,
-                            tx_state.GetRejectReason(), tx_state.GetDebugMessage());
+                            tx_result.state.GetRejectReason(), tx_result.state.GetDebugMessage());
                 LogError("%s: Consensus::CheckTxInputs: %s, %s\n", __func__, tx.GetHash().ToString(), state.ToString());
                 return false;
             }
-            nFees += txfee;
+            nFees += tx_result.fee;
             if (!MoneyRange(nFees)) {
                 LogPrintf("ERROR: %s: accumulated fee in the block out of range.\n", __func__);
                 return state.Invalid(BlockValidationResult::BLOCK_CONSENSUS, "bad-txns-accumulated-fee-outofrange");
@@ -2634,12 +2709,7 @@ bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state,
             // Check that transaction is BIP68 final
             // BIP68 lock checks (as opposed to nLockTime checks) must
             // be in ConnectBlock because they require the UTXO set
-            prevheights.resize(tx.vin.size());
-            for (size_t j = 0; j < tx.vin.size(); j++) {
-                prevheights[j] = view.AccessCoin(tx.vin[j].prevout).nHeight;
-            }
-
-            if (!SequenceLocks(tx, nLockTimeFlags, prevheights, *pindex)) {
+            if (!tx_result.sequence_locks_ok) {
                 LogPrintf("ERROR: %s: contains a non-BIP68-final transaction\n", __func__);
                 return state.Invalid(BlockValidationResult::BLOCK_CONSENSUS, "bad-txns-nonfinal");
             }
@@ -2649,7 +2719,7 @@ bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state,
         // * legacy (always)
         // * p2sh (when P2SH enabled in flags and excludes coinbase)
         // * witness (when witness enabled in flags and excludes coinbase)
-        nSigOpsCost += GetTransactionSigOpCost(tx, view, flags);
+        nSigOpsCost += tx_result.sigop_cost;
         if (nSigOpsCost > MAX_BLOCK_SIGOPS_COST) {
             LogPrintf("ERROR: ConnectBlock(): too many sigops\n");
             return state.Invalid(BlockValidationResult::BLOCK_CONSENSUS, "bad-blk-sigops");
@@ -2660,7 +2730,7 @@ bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state,
             std::vector<CScriptCheck> vChecks;
             bool fCacheResults = fJustCheck; /* Don't cache results if we're actually connecting blocks (still consult the cache, though) */
             TxValidationState tx_state;
-            if (fScriptChecks && !CheckInputScripts(tx, tx_state, view, flags, fCacheResults, fCacheResults, txsdata[i], m_chainman.m_validation_cache, parallel_script_checks ? &vChecks : nullptr)) {
+            if (fScriptChecks && !CheckInputScripts(tx, tx_state, spent_coins, flags, fCacheResults, fCacheResults, txsdata[i], m_chainman.m_validation_cache, parallel_script_checks ? &vChecks : nullptr)) {
                 // Any transaction validation failure in ConnectBlock is a block consensus failure
                 state.Invalid(BlockValidationResult::BLOCK_CONSENSUS,
                               tx_state.GetRejectReason(), tx_state.GetDebugMessage());
@@ -2670,12 +2740,6 @@ bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state,
             }
             control.Add(std::move(vChecks));
         }
-
-        CTxUndo undoDummy;
-        if (i > 0) {
-            blockundo.vtxundo.emplace_back();
-        }
-        UpdateCoins(tx, view, i == 0 ? undoDummy : blockundo.vtxundo.back(), pindex->nHeight);
     }
     const auto time_3{SteadyClock::now()};
     m_chainman.time_connect += time_3 - time_2;
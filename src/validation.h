@@ -11,6 +11,7 @@
 #include <chain.h>
 #include <checkqueue.h>
 #include <consensus/amount.h>
+#include <consensus/validation.h>
 #include <cuckoocache.h>
 #include <deploymentstatus.h>
 #include <kernel/chain.h>
@@ -44,6 +45,7 @@
 #include <thread>
 #include <type_traits>
 #include <utility>
+#include <variant>
 #include <vector>
 
 class Chainstate;
@@ -363,6 +365,67 @@ static_assert(std::is_nothrow_move_assignable_v<CScriptCheck>);
 static_assert(std::is_nothrow_move_constructible_v<CScriptCheck>);
 static_assert(std::is_nothrow_destructible_v<CScriptCheck>);
 
+/**
+ * Closure representing the contextual checks of one block transaction against
+ * the coins it spends: input checks, sequence locks and sigop cost. These only
+ * read the coins, so the checks of the transactions of a block can run in
+ * parallel once the coins are resolved.
+ * Note that this stores references to the transaction, coins and result. The
+ * coins are the ones spent by the transaction, one per input, and must not
+ * change while the check may run.
+ */
+class CTxInputsCheck
+{
+public:
+    struct Result {
+        //! Whether Consensus::CheckTxInputs succeeded, with its state and fee
+        bool inputs_ok{false};
+        TxValidationState state;
+        CAmount fee{0};
+        //! Whether the transaction is BIP68 final
+        bool sequence_locks_ok{false};
+        int64_t sigop_cost{0};
+    };
+
+private:
+    const CTransaction* m_tx;
+    Span<const Coin> m_coins;
+    const CBlockIndex* m_block_index;
+    int m_lock_time_flags;
+    unsigned int m_flags;
+    Result* m_result;
+
+public:
+    CTxInputsCheck(const CTransaction& tx, Span<const Coin> coins, const CBlockIndex& block_index, int lock_time_flags, unsigned int flags, Result& result)
+        : m_tx{&tx}, m_coins{coins}, m_block_index{&block_index}, m_lock_time_flags{lock_time_flags}, m_flags{flags}, m_result{&result} {}
+
+    CTxInputsCheck(const CTxInputsCheck&) = delete;
+    CTxInputsCheck& operator=(const CTxInputsCheck&) = delete;
+    CTxInputsCheck(CTxInputsCheck&&) = default;
+    CTxInputsCheck& operator=(CTxInputsCheck&&) = default;
+
+    //! Run the checks and store their outcome in the result. Always succeeds,
+    //! failures are reported in order by the caller.
+    bool operator()();
+};
+
+/**
+ * A check run by the script check queue while connecting a block: the
+ * verification of an input script, or the contextual checks of a transaction,
+ * so that both share the queue's worker threads.
+ */
+class CBlockCheck
+{
+private:
+    std::variant<CScriptCheck, CTxInputsCheck> m_check;
+
+public:
+    CBlockCheck(CScriptCheck&& check) noexcept : m_check{std::move(check)} {}
+    CBlockCheck(CTxInputsCheck&& check) noexcept : m_check{std::move(check)} {}
+
+    bool operator()() { return std::visit([](auto& check) { return check(); }, m_check); }
+};
+
 /**
  * Convenience class for initializing and passing the script execution cache
  * and signature cache.
@@ -952,7 +1015,9 @@ private:
     }
 
     //! A queue for script verifications that have to be performed by worker threads.
-    CCheckQueue<CScriptCheck> m_script_check_queue;
+    //! With parallel_tx_checks, it runs the contextual transaction checks of
+    //! ConnectBlock too.
+    CCheckQueue<CBlockCheck> m_script_check_queue;
 
     //! Timers and counters used for benchmarking validation in both background
     //! and active chainstates.
@@ -1321,7 +1386,7 @@ public:
     //! nullopt.
     std::optional<int> GetSnapshotBaseHeight() const EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
 
-    CCheckQueue<CScriptCheck>& GetCheckQueue() { return m_script_check_queue; }
+    CCheckQueue<CBlockCheck>& GetCheckQueue() { return m_script_check_queue; }
 
     ~ChainstateManager();
 };
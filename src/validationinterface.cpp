@@ -15,21 +15,25 @@
 #include <util/check.h>
 #include <util/task_runner.h>
 
+#include <algorithm>
+#include <atomic>
 #include <future>
+#include <map>
 #include <unordered_map>
 #include <utility>
 
 std::string RemovalReasonToString(const MemPoolRemovalReason& r) noexcept;
 
 /**
- * ValidationSignalsImpl manages a list of shared_ptr<CValidationInterface> callbacks.
+ * SubscriberQueue manages a list of shared_ptr<CValidationInterface> callbacks,
+ * whose events are delivered through the queue's own task runner.
  *
  * A std::unordered_map is used to track what callbacks are currently
  * registered, and a std::list is used to store the callbacks that are
  * currently registered as well as any callbacks that are just unregistered
  * and about to be deleted when they are done executing.
  */
-class ValidationSignalsImpl
+class SubscriberQueue
 {
 private:
     Mutex m_mutex;
@@ -42,10 +46,11 @@ private:
     std::unordered_map<CValidationInterface*, std::list<ListEntry>::iterator> m_map GUARDED_BY(m_mutex);
 
 public:
+    const std::string m_name;
     std::unique_ptr<util::TaskRunnerInterface> m_task_runner;
 
-    explicit ValidationSignalsImpl(std::unique_ptr<util::TaskRunnerInterface> task_runner)
-        : m_task_runner{std::move(Assert(task_runner))} {}
+    SubscriberQueue(std::string name, std::unique_ptr<util::TaskRunnerInterface> task_runner)
+        : m_name{std::move(name)}, m_task_runner{std::move(Assert(task_runner))} {}
 
     void Register(std::shared_ptr<CValidationInterface> callbacks) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
     {
@@ -55,14 +60,15 @@ public:
         inserted.first->second->callbacks = std::move(callbacks);
     }
 
-    void Unregister(CValidationInterface* callbacks) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    //! Returns whether the callbacks were registered in this queue.
+    bool Unregister(CValidationInterface* callbacks) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
     {
         LOCK(m_mutex);
         auto it = m_map.find(callbacks);
-        if (it != m_map.end()) {
-            if (!--it->second->count) m_list.erase(it->second);
-            m_map.erase(it);
-        }
+        if (it == m_map.end()) return false;
+        if (!--it->second->count) m_list.erase(it->second);
+        m_map.erase(it);
+        return true;
     }
 
     //! Clear unregisters every previously registered callback, erasing every
@@ -78,6 +84,11 @@ public:
         m_map.clear();
     }
 
+    size_t Subscribers() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        return WITH_LOCK(m_mutex, return m_map.size());
+    }
+
     template<typename F> void Iterate(F&& f) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
     {
         WAIT_LOCK(m_mutex, lock);
@@ -92,33 +103,96 @@ public:
     }
 };
 
-ValidationSignals::ValidationSignals(std::unique_ptr<util::TaskRunnerInterface> task_runner)
-    : m_internals{std::make_unique<ValidationSignalsImpl>(std::move(task_runner))} {}
+/**
+ * ValidationSignalsImpl manages the subscriber queues. Events are delivered
+ * to every queue, and each queue delivers them to its subscribers in order.
+ * Queues are created on first use and live as long as ValidationSignals, so
+ * pointers to them remain valid.
+ */
+class ValidationSignalsImpl
+{
+private:
+    Mutex m_queues_mutex;
+    std::map<std::string, std::unique_ptr<SubscriberQueue>> m_queues GUARDED_BY(m_queues_mutex);
+    const ValidationSignals::QueueFactory m_make_queue;
+
+public:
+    SubscriberQueue& m_default_queue;
+
+    ValidationSignalsImpl(std::unique_ptr<util::TaskRunnerInterface> task_runner, ValidationSignals::QueueFactory make_queue)
+        : m_make_queue{std::move(make_queue)},
+          m_default_queue{*WITH_LOCK(m_queues_mutex, return m_queues.emplace(DEFAULT_VALIDATION_QUEUE, std::make_unique<SubscriberQueue>(DEFAULT_VALIDATION_QUEUE, std::move(task_runner))).first->second.get())} {}
+
+    //! Get the queue with the given name, creating it if needed. Without a
+    //! queue factory, all subscribers share the default queue.
+    SubscriberQueue& GetQueue(const std::string& name) EXCLUSIVE_LOCKS_REQUIRED(!m_queues_mutex)
+    {
+        if (!m_make_queue) return m_default_queue;
+        LOCK(m_queues_mutex);
+        auto it = m_queues.find(name);
+        if (it == m_queues.end()) {
+            it = m_queues.emplace(name, std::make_unique<SubscriberQueue>(name, m_make_queue(name))).first;
+        }
+        return *it->second;
+    }
+
+    std::vector<SubscriberQueue*> Queues() EXCLUSIVE_LOCKS_REQUIRED(!m_queues_mutex)
+    {
+        LOCK(m_queues_mutex);
+        std::vector<SubscriberQueue*> queues;
+        queues.reserve(m_queues.size());
+        for (const auto& [name, queue] : m_queues) queues.push_back(queue.get());
+        return queues;
+    }
+
+    template<typename F> void Iterate(F&& f) EXCLUSIVE_LOCKS_REQUIRED(!m_queues_mutex)
+    {
+        for (SubscriberQueue* queue : Queues()) queue->Iterate(f);
+    }
+};
+
+ValidationSignals::ValidationSignals(std::unique_ptr<util::TaskRunnerInterface> task_runner, QueueFactory make_queue)
+    : m_internals{std::make_unique<ValidationSignalsImpl>(std::move(task_runner), std::move(make_queue))} {}
 
 ValidationSignals::~ValidationSignals() = default;
 
 void ValidationSignals::FlushBackgroundCallbacks()
 {
-    m_internals->m_task_runner->flush();
+    for (SubscriberQueue* queue : m_internals->Queues()) {
+        queue->m_task_runner->flush();
+    }
 }
 
 size_t ValidationSignals::CallbacksPending()
 {
-    return m_internals->m_task_runner->size();
+    size_t pending{0};
+    for (SubscriberQueue* queue : m_internals->Queues()) {
+        pending = std::max(pending, queue->m_task_runner->size());
+    }
+    return pending;
 }
 
-void ValidationSignals::RegisterSharedValidationInterface(std::shared_ptr<CValidationInterface> callbacks)
+std::vector<ValidationQueueInfo> ValidationSignals::GetQueueInfo()
+{
+    std::vector<ValidationQueueInfo> info;
+    for (SubscriberQueue* queue : m_internals->Queues()) {
+        info.push_back({queue->m_name, queue->Subscribers(), queue->m_task_runner->size()});
+    }
+    return info;
+}
+
+void ValidationSignals::RegisterSharedValidationInterface(std::shared_ptr<CValidationInterface> callbacks, const std::string& queue)
 {
     // Each connection captures the shared_ptr to ensure that each callback is
     // executed before the subscriber is destroyed. For more details see #18338.
-    m_internals->Register(std::move(callbacks));
+    m_internals->GetQueue(queue).Register(std::move(callbacks));
 }
 
-void ValidationSignals::RegisterValidationInterface(CValidationInterface* callbacks)
+void ValidationSignals::RegisterValidationInterface(CValidationInterface* callbacks, const std::string& queue)
 {
     // Create a shared_ptr with a no-op deleter - CValidationInterface lifecycle
     // is managed by the caller.
-    RegisterSharedValidationInterface({callbacks, [](CValidationInterface*){}});
+    RegisterSharedValidationInterface({callbacks, [](CValidationInterface*){}}, queue);
 }
 
 void ValidationSignals::UnregisterSharedValidationInterface(std::shared_ptr<CValidationInterface> callbacks)
@@ -128,17 +202,34 @@ void ValidationSignals::UnregisterSharedValidationInterface(std::shared_ptr<CVal
 
 void ValidationSignals::UnregisterValidationInterface(CValidationInterface* callbacks)
 {
-    m_internals->Unregister(callbacks);
+    for (SubscriberQueue* queue : m_internals->Queues()) {
+        if (queue->Unregister(callbacks)) break;
+    }
 }
 
 void ValidationSignals::UnregisterAllValidationInterfaces()
 {
-    m_internals->Clear();
+    for (SubscriberQueue* queue : m_internals->Queues()) {
+        queue->Clear();
+    }
 }
 
 void ValidationSignals::CallFunctionInValidationInterfaceQueue(std::function<void()> func)
 {
-    m_internals->m_task_runner->insert(std::move(func));
+    const std::vector<SubscriberQueue*> queues{m_internals->Queues()};
+    if (queues.size() == 1) {
+        queues.front()->m_task_runner->insert(std::move(func));
+        return;
+    }
+    // Call func once every queue has reached this point, i.e. from the queue
+    // that gets there last.
+    auto remaining{std::make_shared<std::atomic<size_t>>(queues.size())};
+    auto shared_func{std::make_shared<std::function<void()>>(std::move(func))};
+    for (SubscriberQueue* queue : queues) {
+        queue->m_task_runner->insert([remaining, shared_func] {
+            if (--*remaining == 0) (*shared_func)();
+        });
+    }
 }
 
 void ValidationSignals::SyncWithValidationInterfaceQueue()
@@ -156,14 +247,17 @@ void ValidationSignals::SyncWithValidationInterfaceQueue()
 // evaluating arguments when logging is not enabled.
 //
 // NOTE: The lambda captures all local variables by value.
-#define ENQUEUE_AND_LOG_EVENT(event, fmt, name, ...)           \
-    do {                                                       \
-        auto local_name = (name);                              \
-        LOG_EVENT("Enqueuing " fmt, local_name, __VA_ARGS__);  \
-        m_internals->m_task_runner->insert([=] { \
-            LOG_EVENT(fmt, local_name, __VA_ARGS__);           \
-            event();                                           \
-        });                                                    \
+#define ENQUEUE_AND_LOG_EVENT(event, fmt, name, ...)                   \
+    do {                                                               \
+        auto local_name = (name);                                      \
+        LOG_EVENT("Enqueuing " fmt, local_name, __VA_ARGS__);          \
+        auto shared_event = std::make_shared<decltype(event)>(event);  \
+        for (SubscriberQueue* queue : m_internals->Queues()) {         \
+            queue->m_task_runner->insert([=] {                         \
+                LOG_EVENT(fmt " queue=%s", local_name, __VA_ARGS__, queue->m_name); \
+                (*shared_event)(*queue);                               \
+            });                                                        \
+        }                                                              \
     } while (0)
 
 #define LOG_EVENT(fmt, ...) \
@@ -174,8 +268,8 @@ void ValidationSignals::UpdatedBlockTip(const CBlockIndex *pindexNew, const CBlo
     // the chain actually updates. One way to ensure this is for the caller to invoke this signal
     // in the same critical section where the chain is updated
 
-    auto event = [pindexNew, pindexFork, fInitialDownload, this] {
-        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.UpdatedBlockTip(pindexNew, pindexFork, fInitialDownload); });
+    auto event = [pindexNew, pindexFork, fInitialDownload](SubscriberQueue& queue) {
+        queue.Iterate([&](CValidationInterface& callbacks) { callbacks.UpdatedBlockTip(pindexNew, pindexFork, fInitialDownload); });
     };
     ENQUEUE_AND_LOG_EVENT(event, "%s: new block hash=%s fork block hash=%s (in IBD=%s)", __func__,
                           pindexNew->GetBlockHash().ToString(),
@@ -185,8 +279,8 @@ void ValidationSignals::UpdatedBlockTip(const CBlockIndex *pindexNew, const CBlo
 
 void ValidationSignals::TransactionAddedToMempool(const NewMempoolTransactionInfo& tx, uint64_t mempool_sequence)
 {
-    auto event = [tx, mempool_sequence, this] {
-        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.TransactionAddedToMempool(tx, mempool_sequence); });
+    auto event = [tx, mempool_sequence](SubscriberQueue& queue) {
+        queue.Iterate([&](CValidationInterface& callbacks) { callbacks.TransactionAddedToMempool(tx, mempool_sequence); });
     };
     ENQUEUE_AND_LOG_EVENT(event, "%s: txid=%s wtxid=%s", __func__,
                           tx.info.m_tx->GetHash().ToString(),
@@ -194,8 +288,8 @@ void ValidationSignals::TransactionAddedToMempool(const NewMempoolTransactionInf
 }
 
 void ValidationSignals::TransactionRemovedFromMempool(const CTransactionRef& tx, MemPoolRemovalReason reason, uint64_t mempool_sequence) {
-    auto event = [tx, reason, mempool_sequence, this] {
-        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.TransactionRemovedFromMempool(tx, reason, mempool_sequence); });
+    auto event = [tx, reason, mempool_sequence](SubscriberQueue& queue) {
+        queue.Iterate([&](CValidationInterface& callbacks) { callbacks.TransactionRemovedFromMempool(tx, reason, mempool_sequence); });
     };
     ENQUEUE_AND_LOG_EVENT(event, "%s: txid=%s wtxid=%s reason=%s", __func__,
                           tx->GetHash().ToString(),
@@ -204,8 +298,8 @@ void ValidationSignals::TransactionRemovedFromMempool(const CTransactionRef& tx,
 }
 
 void ValidationSignals::BlockConnected(ChainstateRole role, const std::shared_ptr<const CBlock> &pblock, const CBlockIndex *pindex) {
-    auto event = [role, pblock, pindex, this] {
-        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.BlockConnected(role, pblock, pindex); });
+    auto event = [role, pblock, pindex](SubscriberQueue& queue) {
+        queue.Iterate([&](CValidationInterface& callbacks) { callbacks.BlockConnected(role, pblock, pindex); });
     };
     ENQUEUE_AND_LOG_EVENT(event, "%s: block hash=%s block height=%d", __func__,
                           pblock->GetHash().ToString(),
@@ -214,8 +308,8 @@ void ValidationSignals::BlockConnected(ChainstateRole role, const std::shared_pt
 
 void ValidationSignals::MempoolTransactionsRemovedForBlock(const std::vector<RemovedMempoolTransactionInfo>& txs_removed_for_block, unsigned int nBlockHeight)
 {
-    auto event = [txs_removed_for_block, nBlockHeight, this] {
-        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.MempoolTransactionsRemovedForBlock(txs_removed_for_block, nBlockHeight); });
+    auto event = [txs_removed_for_block, nBlockHeight](SubscriberQueue& queue) {
+        queue.Iterate([&](CValidationInterface& callbacks) { callbacks.MempoolTransactionsRemovedForBlock(txs_removed_for_block, nBlockHeight); });
     };
     ENQUEUE_AND_LOG_EVENT(event, "%s: block height=%s txs removed=%s", __func__,
                           nBlockHeight,
@@ -224,8 +318,8 @@ void ValidationSignals::MempoolTransactionsRemovedForBlock(const std::vector<Rem
 
 void ValidationSignals::BlockDisconnected(const std::shared_ptr<const CBlock>& pblock, const CBlockIndex* pindex)
 {
-    auto event = [pblock, pindex, this] {
-        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.BlockDisconnected(pblock, pindex); });
+    auto event = [pblock, pindex](SubscriberQueue& queue) {
+        queue.Iterate([&](CValidationInterface& callbacks) { callbacks.BlockDisconnected(pblock, pindex); });
     };
     ENQUEUE_AND_LOG_EVENT(event, "%s: block hash=%s block height=%d", __func__,
                           pblock->GetHash().ToString(),
@@ -233,8 +327,8 @@ void ValidationSignals::BlockDisconnected(const std::shared_ptr<const CBlock>& p
 }
 
 void ValidationSignals::ChainStateFlushed(ChainstateRole role, const CBlockLocator &locator) {
-    auto event = [role, locator, this] {
-        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.ChainStateFlushed(role, locator); });
+    auto event = [role, locator](SubscriberQueue& queue) {
+        queue.Iterate([&](CValidationInterface& callbacks) { callbacks.ChainStateFlushed(role, locator); });
     };
     ENQUEUE_AND_LOG_EVENT(event, "%s: block hash=%s", __func__,
                           locator.IsNull() ? "null" : locator.vHave.front().ToString());
@@ -15,6 +15,7 @@
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace util {
@@ -157,26 +158,52 @@ protected:
     friend class ValidationInterfaceTest;
 };
 
+//! Name of the queue subscribers are registered in by default
+static const std::string DEFAULT_VALIDATION_QUEUE{"default"};
+
+/** Status of a validation interface queue, see ValidationSignals::GetQueueInfo(). */
+struct ValidationQueueInfo {
+    std::string name;
+    //! Number of registered subscribers
+    size_t subscribers;
+    //! Number of events waiting to be delivered
+    size_t pending;
+};
+
 class ValidationSignalsImpl;
 class ValidationSignals {
 private:
     std::unique_ptr<ValidationSignalsImpl> m_internals;
 
 public:
+    //! Creates the task runner of a named subscriber queue.
+    using QueueFactory = std::function<std::unique_ptr<util::TaskRunnerInterface>(const std::string& name)>;
+
     // The task runner will block validation if it calls its insert method's
     // func argument synchronously. In this class func contains a loop that
-    // dispatches a single validation event to all subscribers sequentially.
-    explicit ValidationSignals(std::unique_ptr<util::TaskRunnerInterface> task_runner);
+    // dispatches a single validation event to all subscribers of a queue
+    // sequentially.
+    //
+    // Subscribers are registered in the default queue, which uses task_runner,
+    // or in a named queue, which gets its own task runner from make_queue. Each
+    // queue delivers events independently, so a slow subscriber only delays
+    // the subscribers sharing its queue. Without make_queue, all subscribers
+    // share the default queue.
+    explicit ValidationSignals(std::unique_ptr<util::TaskRunnerInterface> task_runner, QueueFactory make_queue = {});
 
     ~ValidationSignals();
 
     /** Call any remaining callbacks on the calling thread */
     void FlushBackgroundCallbacks();
 
+    /** Number of events pending in the most lagging queue */
     size_t CallbacksPending();
 
-    /** Register subscriber */
-    void RegisterValidationInterface(CValidationInterface* callbacks);
+    /** Status of all queues, to see which subscribers are lagging */
+    std::vector<ValidationQueueInfo> GetQueueInfo();
+
+    /** Register subscriber, in the given queue */
+    void RegisterValidationInterface(CValidationInterface* callbacks, const std::string& queue = DEFAULT_VALIDATION_QUEUE);
     /** Unregister subscriber. DEPRECATED. This is not safe to use when the RPC server or main message handler thread is running. */
     void UnregisterValidationInterface(CValidationInterface* callbacks);
     /** Unregister all subscribers */
@@ -186,14 +213,15 @@ public:
     // notification is sent. These are useful for race-free cleanup, since
     // unregistration is nonblocking and can return before the last notification is
     // processed.
-    /** Register subscriber */
-    void RegisterSharedValidationInterface(std::shared_ptr<CValidationInterface> callbacks);
+    /** Register subscriber, in the given queue */
+    void RegisterSharedValidationInterface(std::shared_ptr<CValidationInterface> callbacks, const std::string& queue = DEFAULT_VALIDATION_QUEUE);
     /** Unregister subscriber */
     void UnregisterSharedValidationInterface(std::shared_ptr<CValidationInterface> callbacks);
 
     /**
-     * Pushes a function to callback onto the notification queue, guaranteeing any
+     * Pushes a function to callback onto the notification queues, guaranteeing any
      * callbacks generated prior to now are finished when the function is called.
+     * With several queues, the function is called by the last queue to reach it.
      *
      * Be very careful blocking on func to be called if any locks are held -
      * validation interface clients may not be able to make progress as they often
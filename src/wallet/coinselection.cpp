@@ -12,7 +12,10 @@
 #include <policy/feerate.h>
 #include <util/check.h>
 #include <util/moneystr.h>
+#include <util/parallel.h>
 
+#include <algorithm>
+#include <limits>
 #include <numeric>
 #include <optional>
 #include <queue>
@@ -49,6 +52,134 @@ struct {
     }
 } descending_effval_weight;
 
+static const size_t TOTAL_TRIES = 100000;
+
+/** The effective values, fees, waste and weights of a sorted UTXO pool, stored in contiguous arrays
+ *  together with their suffix sums and minima, so that the searches below don't touch the OutputGroups. */
+struct SearchPool {
+    std::vector<CAmount> amounts;
+    std::vector<CAmount> fees;
+    std::vector<CAmount> waste;
+    std::vector<int> weights;
+    //! Aggregates of the UTXOs from an index on, e.g. lookahead[5] = Σ(UTXO[5+].amount). One longer than the pool.
+    std::vector<CAmount> lookahead;
+    std::vector<int> min_tail_weight;
+    std::vector<CAmount> min_tail_waste;
+
+    explicit SearchPool(const std::vector<OutputGroup>& utxo_pool)
+    {
+        const size_t pool_size{utxo_pool.size()};
+        amounts.reserve(pool_size);
+        fees.reserve(pool_size);
+        waste.reserve(pool_size);
+        weights.reserve(pool_size);
+        for (const OutputGroup& utxo : utxo_pool) {
+            amounts.push_back(utxo.GetSelectionAmount());
+            fees.push_back(utxo.fee);
+            waste.push_back(utxo.fee - utxo.long_term_fee);
+            weights.push_back(utxo.m_weight);
+        }
+        lookahead.assign(pool_size + 1, 0);
+        min_tail_weight.assign(pool_size + 1, std::numeric_limits<int>::max());
+        min_tail_waste.assign(pool_size + 1, MAX_MONEY);
+        for (size_t i = pool_size; i-- > 0;) {
+            lookahead[i] = lookahead[i + 1] + amounts[i];
+            min_tail_weight[i] = std::min(min_tail_weight[i + 1], weights[i]);
+            min_tail_waste[i] = std::min(min_tail_waste[i + 1], waste[i]);
+        }
+    }
+
+    size_t size() const { return amounts.size(); }
+};
+
+struct BnBSearch {
+    std::vector<size_t> best_selection;
+    CAmount best_waste{MAX_MONEY};
+    bool max_tx_weight_exceeded{false};
+};
+
+/** Run the depth first search of SelectCoinsBnB (described below) over the subtrees whose first selected UTXO is
+ *  first_root, first_root + root_step, first_root + 2 * root_step, ... */
+static BnBSearch SearchBnB(const SearchPool& pool, const CAmount selection_target, const CAmount cost_of_change, const int max_selection_weight,
+                           const bool is_feerate_high, const size_t first_root, const size_t root_step)
+{
+    BnBSearch search;
+    CAmount curr_value = 0;
+    std::vector<size_t> curr_selection; // selected utxo indexes
+    int curr_selection_weight = 0; // sum of selected utxo weight
+    CAmount curr_waste = 0;
+
+    // Depth First search loop for choosing the UTXOs
+    for (size_t curr_try = 0, utxo_pool_index = first_root; curr_try < TOTAL_TRIES; ++curr_try, ++utxo_pool_index) {
+        // The lookahead is the total value of the unexplored UTXOs
+        const CAmount curr_available_value{pool.lookahead[utxo_pool_index]};
+
+        // Conditions for starting a backtrack
+        bool backtrack = false;
+        if (curr_value + curr_available_value < selection_target || // Cannot possibly reach target with the amount remaining in the curr_available_value.
+            curr_value > selection_target + cost_of_change || // Selected value is out of range, go back and try other branch
+            (curr_waste > search.best_waste && is_feerate_high)) { // Don't select things which we know will be more wasteful if the waste is increasing
+            backtrack = true;
+        } else if (curr_selection_weight > max_selection_weight) { // Selected UTXOs weight exceeds the maximum weight allowed, cannot find more solutions by adding more inputs
+            search.max_tx_weight_exceeded = true; // at least one selection attempt exceeded the max weight
+            backtrack = true;
+        } else if (curr_value >= selection_target) {       // Selected value is within range
+            curr_waste += (curr_value - selection_target); // This is the excess value which is added to the waste for the below comparison
+            // Adding another UTXO after this check could bring the waste down if the long term fee is higher than the current fee.
+            // However we are not going to explore that because this optimization for the waste is only done when we have hit our target
+            // value. Adding any more UTXOs will be just burning the UTXO; it will go entirely to fees. Thus we aren't going to
+            // explore any more UTXOs to avoid burning money like that.
+            if (curr_waste <= search.best_waste) {
+                search.best_selection = curr_selection;
+                search.best_waste = curr_waste;
+            }
+            curr_waste -= (curr_value - selection_target); // Remove the excess value as we will be selecting different coins now
+            backtrack = true;
+        } else if (is_feerate_high && curr_waste + pool.min_tail_waste[utxo_pool_index] > search.best_waste) {
+            // Reaching the target takes at least one more UTXO, which adds at least the least waste among the unexplored ones
+            backtrack = true;
+        } else if (curr_selection_weight + int64_t{pool.min_tail_weight[utxo_pool_index]} > max_selection_weight) {
+            // Reaching the target takes at least one more UTXO, and even the lightest unexplored one exceeds the maximum weight
+            search.max_tx_weight_exceeded = true;
+            backtrack = true;
+        }
+
+        if (backtrack) { // Backtracking, moving backwards
+            if (curr_selection.empty()) { // We have walked back to the first utxo and no branch is untraversed. All solutions searched
+                break;
+            }
+
+            // Output was included on previous iterations, try excluding now.
+            utxo_pool_index = curr_selection.back();
+            curr_value -= pool.amounts[utxo_pool_index];
+            curr_waste -= pool.waste[utxo_pool_index];
+            curr_selection_weight -= pool.weights[utxo_pool_index];
+            curr_selection.pop_back();
+
+            if (curr_selection.empty() && root_step > 1) {
+                // Continue with the next subtree assigned to this search instead of the following one
+                utxo_pool_index = std::min(utxo_pool_index + root_step, pool.size()) - 1;
+            }
+        } else { // Moving forwards, continuing down this branch
+            if (curr_selection.empty() ||
+                // The previous index is included and therefore not relevant for exclusion shortcut
+                (utxo_pool_index - 1) == curr_selection.back() ||
+                // Avoid searching a branch if the previous UTXO has the same value and same waste and was excluded.
+                // Since the ratio of fee to long term fee is the same, we only need to check if one of those values match in order to know that the waste is the same.
+                pool.amounts[utxo_pool_index] != pool.amounts[utxo_pool_index - 1] ||
+                pool.fees[utxo_pool_index] != pool.fees[utxo_pool_index - 1])
+            {
+                // Inclusion branch first (Largest First Exploration)
+                curr_selection.push_back(utxo_pool_index);
+                curr_value += pool.amounts[utxo_pool_index];
+                curr_waste += pool.waste[utxo_pool_index];
+                curr_selection_weight += pool.weights[utxo_pool_index];
+            }
+        }
+    }
+    return search;
+}
+
 /*
  * This is the Branch and Bound Coin Selection algorithm designed by Murch. It searches for an input
  * set that can pay for the spending target and does not exceed the spending target by more than the
@@ -85,18 +216,14 @@ struct {
  * @param const CAmount& cost_of_change This is the cost of creating and spending a change output.
  *        This plus selection_target is the upper bound of the range.
  * @param int max_selection_weight The maximum allowed weight for a selection result to be valid.
+ * @param size_t num_threads The number of threads to split the search tree across. Each thread searches
+ *        the subtrees starting at every num_threads-th UTXO with the full number of tries.
  * @returns The result of this coin selection algorithm, or std::nullopt
  */
-
-static const size_t TOTAL_TRIES = 100000;
-
 util::Result<SelectionResult> SelectCoinsBnB(std::vector<OutputGroup>& utxo_pool, const CAmount& selection_target, const CAmount& cost_of_change,
-                                             int max_selection_weight)
+                                             int max_selection_weight, size_t num_threads)
 {
     SelectionResult result(selection_target, SelectionAlgorithm::BNB);
-    CAmount curr_value = 0;
-    std::vector<size_t> curr_selection; // selected utxo indexes
-    int curr_selection_weight = 0; // sum of selected utxo weight
 
     // Calculate curr_available_value
     CAmount curr_available_value = 0;
@@ -112,260 +239,84 @@ util::Result<SelectionResult> SelectCoinsBnB(std::vector<OutputGroup>& utxo_pool
 
     // Sort the utxo_pool
     std::sort(utxo_pool.begin(), utxo_pool.end(), descending);
-
-    CAmount curr_waste = 0;
-    std::vector<size_t> best_selection;
-    CAmount best_waste = MAX_MONEY;
+    const SearchPool pool{utxo_pool};
 
     bool is_feerate_high = utxo_pool.at(0).fee > utxo_pool.at(0).long_term_fee;
-    bool max_tx_weight_exceeded = false;
 
-    // Depth First search loop for choosing the UTXOs
-    for (size_t curr_try = 0, utxo_pool_index = 0; curr_try < TOTAL_TRIES; ++curr_try, ++utxo_pool_index) {
-        // Conditions for starting a backtrack
-        bool backtrack = false;
-        if (curr_value + curr_available_value < selection_target || // Cannot possibly reach target with the amount remaining in the curr_available_value.
-            curr_value > selection_target + cost_of_change || // Selected value is out of range, go back and try other branch
-            (curr_waste > best_waste && is_feerate_high)) { // Don't select things which we know will be more wasteful if the waste is increasing
-            backtrack = true;
-        } else if (curr_selection_weight > max_selection_weight) { // Selected UTXOs weight exceeds the maximum weight allowed, cannot find more solutions by adding more inputs
-            max_tx_weight_exceeded = true; // at least one selection attempt exceeded the max weight
-            backtrack = true;
-        } else if (curr_value >= selection_target) {       // Selected value is within range
-            curr_waste += (curr_value - selection_target); // This is the excess value which is added to the waste for the below comparison
-            // Adding another UTXO after this check could bring the waste down if the long term fee is higher than the current fee.
-            // However we are not going to explore that because this optimization for the waste is only done when we have hit our target
-            // value. Adding any more UTXOs will be just burning the UTXO; it will go entirely to fees. Thus we aren't going to
-            // explore any more UTXOs to avoid burning money like that.
-            if (curr_waste <= best_waste) {
-                best_selection = curr_selection;
-                best_waste = curr_waste;
-            }
-            curr_waste -= (curr_value - selection_target); // Remove the excess value as we will be selecting different coins now
-            backtrack = true;
+    num_threads = std::clamp<size_t>(num_threads, 1, std::max<size_t>(utxo_pool.size(), 1));
+    std::vector<BnBSearch> searches(num_threads);
+    util::ParallelFor(num_threads, num_threads, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            searches[i] = SearchBnB(pool, selection_target, cost_of_change, max_selection_weight, is_feerate_high, /*first_root=*/i, /*root_step=*/num_threads);
         }
+    });
 
-        if (backtrack) { // Backtracking, moving backwards
-            if (curr_selection.empty()) { // We have walked back to the first utxo and no branch is untraversed. All solutions searched
-                break;
-            }
-
-            // Add omitted UTXOs back to lookahead before traversing the omission branch of last included UTXO.
-            for (--utxo_pool_index; utxo_pool_index > curr_selection.back(); --utxo_pool_index) {
-                curr_available_value += utxo_pool.at(utxo_pool_index).GetSelectionAmount();
-            }
-
-            // Output was included on previous iterations, try excluding now.
-            assert(utxo_pool_index == curr_selection.back());
-            OutputGroup& utxo = utxo_pool.at(utxo_pool_index);
-            curr_value -= utxo.GetSelectionAmount();
-            curr_waste -= utxo.fee - utxo.long_term_fee;
-            curr_selection_weight -= utxo.m_weight;
-            curr_selection.pop_back();
-        } else { // Moving forwards, continuing down this branch
-            OutputGroup& utxo = utxo_pool.at(utxo_pool_index);
-
-            // Remove this utxo from the curr_available_value utxo amount
-            curr_available_value -= utxo.GetSelectionAmount();
-
-            if (curr_selection.empty() ||
-                // The previous index is included and therefore not relevant for exclusion shortcut
-                (utxo_pool_index - 1) == curr_selection.back() ||
-                // Avoid searching a branch if the previous UTXO has the same value and same waste and was excluded.
-                // Since the ratio of fee to long term fee is the same, we only need to check if one of those values match in order to know that the waste is the same.
-                utxo.GetSelectionAmount() != utxo_pool.at(utxo_pool_index - 1).GetSelectionAmount() ||
-                utxo.fee != utxo_pool.at(utxo_pool_index - 1).fee)
-            {
-                // Inclusion branch first (Largest First Exploration)
-                curr_selection.push_back(utxo_pool_index);
-                curr_value += utxo.GetSelectionAmount();
-                curr_waste += utxo.fee - utxo.long_term_fee;
-                curr_selection_weight += utxo.m_weight;
-            }
+    // Pick the least wasteful selection. On a tie, pick the one a single search would have found last.
+    const BnBSearch* best{nullptr};
+    bool max_tx_weight_exceeded = false;
+    for (const BnBSearch& search : searches) {
+        max_tx_weight_exceeded |= search.max_tx_weight_exceeded;
+        if (search.best_selection.empty()) continue;
+        if (!best || search.best_waste < best->best_waste ||
+            (search.best_waste == best->best_waste && search.best_selection.front() > best->best_selection.front())) {
+            best = &search;
         }
     }
 
     // Check for solution
-    if (best_selection.empty()) {
+    if (!best) {
         return max_tx_weight_exceeded ? ErrorMaxWeightExceeded() : util::Error();
     }
 
     // Set output set
-    for (const size_t& i : best_selection) {
+    for (const size_t& i : best->best_selection) {
         result.AddInput(utxo_pool.at(i));
     }
     result.RecalculateWaste(cost_of_change, cost_of_change, CAmount{0});
-    assert(best_waste == result.GetWaste());
+    assert(best->best_waste == result.GetWaste());
 
     return result;
 }
 
-/*
- * TL;DR: Coin Grinder is a DFS-based algorithm that deterministically searches for the minimum-weight input set to fund
- * the transaction. The algorithm is similar to the Branch and Bound algorithm, but will produce a transaction _with_ a
- * change output instead of a changeless transaction.
- *
- * Full description: CoinGrinder can be thought of as a graph walking algorithm. It explores a binary tree
- * representation of the powerset of the UTXO pool. Each node in the tree represents a candidate input set. The tree’s
- * root is the empty set. Each node in the tree has two children which are formed by either adding or skipping the next
- * UTXO ("inclusion/omission branch"). Each level in the tree after the root corresponds to a decision about one UTXO in
- * the UTXO pool.
- *
- * Example:
- * We represent UTXOs as _alias=[effective_value/weight]_ and indicate omitted UTXOs with an underscore. Given a UTXO
- * pool {A=[10/2], B=[7/1], C=[5/1], D=[4/2]} sorted by descending effective value, our search tree looks as follows:
- *
- *                                       _______________________ {} ________________________
- *                                      /                                                   \
- * A=[10/2]               __________ {A} _________                                __________ {_} _________
- *                       /                        \                              /                        \
- * B=[7/1]            {AB} _                      {A_} _                      {_B} _                      {__} _
- *                  /       \                   /       \                   /       \                   /       \
- * C=[5/1]     {ABC}         {AB_}         {A_C}         {A__}         {_BC}         {_B_}         {__C}         {___}
- *              / \           / \           / \           / \           / \           / \           / \           / \
- * D=[4/2] {ABCD} {ABC_} {AB_D} {AB__} {A_CD} {A_C_} {A__D} {A___} {_BCD} {_BC_} {_B_D} {_B__} {__CD} {__C_} {___D} {____}
- *
- *
- * CoinGrinder uses a depth-first search to walk this tree. It first tries inclusion branches, then omission branches. A
- * naive exploration of a tree with four UTXOs requires visiting all 31 nodes:
- *
- *     {} {A} {AB} {ABC} {ABCD} {ABC_} {AB_} {AB_D} {AB__} {A_} {A_C} {A_CD} {A_C_} {A__} {A__D} {A___} {_} {_B} {_BC}
- *     {_BCD} {_BC_} {_B_} {_B_D} {_B__} {__} {__C} {__CD} {__C} {___} {___D} {____}
- *
- * As powersets grow exponentially with the set size, walking the entire tree would quickly get computationally
- * infeasible with growing UTXO pools. Thanks to traversing the tree in a deterministic order, we can keep track of the
- * progress of the search solely on basis of the current selection (and the best selection so far). We visit as few
- * nodes as possible by recognizing and skipping any branches that can only contain solutions worse than the best
- * solution so far. This makes CoinGrinder a branch-and-bound algorithm
- * (https://en.wikipedia.org/wiki/Branch_and_bound).
- * CoinGrinder is searching for the input set with lowest weight that can fund a transaction, so for example we can only
- * ever find a _better_ candidate input set in a node that adds a UTXO, but never in a node that skips a UTXO. After
- * visiting {A} and exploring the inclusion branch {AB} and its descendants, the candidate input set in the omission
- * branch {A_} is equivalent to the parent {A} in effective value and weight. While CoinGrinder does need to visit the
- * descendants of the omission branch {A_}, it is unnecessary to evaluate the candidate input set in the omission branch
- * itself. By skipping evaluation of all nodes on an omission branch we reduce the visited nodes to 15:
- *
- *     {A} {AB} {ABC} {ABCD} {AB_D} {A_C} {A_CD} {A__D} {_B} {_BC} {_BCD} {_B_D} {__C} {__CD} {___D}
- *
- *                                       _______________________ {} ________________________
- *                                      /                                                   \
- * A=[10/2]               __________ {A} _________                                ___________\____________
- *                       /                        \                              /                        \
- * B=[7/1]            {AB} __                    __\_____                     {_B} __                    __\_____
- *                  /        \                  /        \                  /        \                  /        \
- * C=[5/1]     {ABC}          \            {A_C}          \            {_BC}          \            {__C}          \
- *              /             /             /             /             /             /             /             /
- * D=[4/2] {ABCD}        {AB_D}        {A_CD}        {A__D}        {_BCD}        {_B_D}        {__CD}        {___D}
- *
- *
- * We refer to the move from the inclusion branch {AB} via the omission branch {A_} to its inclusion-branch child {A_C}
- * as _shifting to the omission branch_ or just _SHIFT_. (The index of the ultimate element in the candidate input set
- * shifts right by one: {AB} ⇒ {A_C}.)
- * When we reach a leaf node in the last level of the tree, shifting to the omission branch is not possible. Instead we
- * go to the omission branch of the node’s last ancestor on an inclusion branch: from {ABCD}, we go to {AB_D}. From
- * {AB_D}, we go to {A_C}. We refer to this operation as a _CUT_. (The ultimate element in
- * the input set is deselected, and the penultimate element is shifted right by one: {AB_D} ⇒ {A_C}.)
- * If a candidate input set in a node has not selected sufficient funds to build the transaction, we continue directly
- * along the next inclusion branch. We call this operation _EXPLORE_. (We go from one inclusion branch to the next
- * inclusion branch: {_B} ⇒ {_BC}.)
- * Further, any prefix that already has selected sufficient effective value to fund the transaction cannot be improved
- * by adding more UTXOs. If for example the candidate input set in {AB} is a valid solution, all potential descendant
- * solutions {ABC}, {ABCD}, and {AB_D} must have a higher weight, thus instead of exploring the descendants of {AB}, we
- * can SHIFT from {AB} to {A_C}.
- *
- * Given the above UTXO set, using a target of 11, and following these initial observations, the basic implementation of
- * CoinGrinder visits the following 10 nodes:
- *
- *     Node   [eff_val/weight]  Evaluation
- *     ---------------------------------------------------------------
- *     {A}    [10/2]            Insufficient funds: EXPLORE
- *     {AB}   [17/3]            Solution: SHIFT to omission branch
- *     {A_C}  [15/3]            Better solution: SHIFT to omission branch
- *     {A__D} [14/4]            Worse solution, shift impossible due to leaf node: CUT to omission branch of {A__D},
- *                              i.e. SHIFT to omission branch of {A}
- *     {_B}   [7/1]             Insufficient funds: EXPLORE
- *     {_BC}  [12/2]            Better solution: SHIFT to omission branch
- *     {_B_D} [11/3]            Worse solution, shift impossible due to leaf node: CUT to omission branch of {_B_D},
- *                              i.e. SHIFT to omission branch of {_B}
- *     {__C}  [5/1]             Insufficient funds: EXPLORE
- *     {__CD} [9/3]             Insufficient funds, leaf node: CUT
- *     {___D} [4/2]             Insufficient funds, leaf node, cannot CUT since only one UTXO selected: done.
- *
- *                                       _______________________ {} ________________________
- *                                      /                                                   \
- * A=[10/2]               __________ {A} _________                                ___________\____________
- *                       /                        \                              /                        \
- * B=[7/1]            {AB}                       __\_____                     {_B} __                    __\_____
- *                                              /        \                  /        \                  /        \
- * C=[5/1]                                 {A_C}          \            {_BC}          \            {__C}          \
- *                                                        /                           /             /             /
- * D=[4/2]                                           {A__D}                      {_B_D}        {__CD}        {___D}
- *
- *
- * We implement this tree walk in the following algorithm:
- * 1. Add `next_utxo`
- * 2. Evaluate candidate input set
- * 3. Determine `next_utxo` by deciding whether to
- *    a) EXPLORE: Add next inclusion branch, e.g. {_B} ⇒ {_B} + `next_uxto`: C
- *    b) SHIFT: Replace last selected UTXO by next higher index, e.g. {A_C} ⇒ {A__} + `next_utxo`: D
- *    c) CUT: deselect last selected UTXO and shift to omission branch of penultimate UTXO, e.g. {AB_D} ⇒ {A_} + `next_utxo: C
- *
- * The implementation then adds further optimizations by discovering further situations in which either the inclusion
- * branch can be skipped, or both the inclusion and omission branch can be skipped after evaluating the candidate input
- * set in the node.
- *
- * @param std::vector<OutputGroup>& utxo_pool The UTXOs that we are choosing from. These UTXOs will be sorted in
- *        descending order by effective value, with lower weight preferred as a tie-breaker. (We can think of an output
- *        group with multiple as a heavier UTXO with the combined amount here.)
- * @param const CAmount& selection_target This is the minimum amount that we need for the transaction without considering change.
- * @param const CAmount& change_target The minimum budget for creating a change output, by which we increase the selection_target.
- * @param int max_selection_weight The maximum allowed weight for a selection result to be valid.
- * @returns The result of this coin selection algorithm, or std::nullopt
- */
-util::Result<SelectionResult> CoinGrinder(std::vector<OutputGroup>& utxo_pool, const CAmount& selection_target, CAmount change_target, int max_selection_weight)
-{
-    std::sort(utxo_pool.begin(), utxo_pool.end(), descending_effval_weight);
-    // The sum of UTXO amounts after this UTXO index, e.g. lookahead[5] = Σ(UTXO[6+].amount)
-    std::vector<CAmount> lookahead(utxo_pool.size());
-    // The minimum UTXO weight among the remaining UTXOs after this UTXO index, e.g. min_tail_weight[5] = min(UTXO[6+].weight)
-    std::vector<int> min_tail_weight(utxo_pool.size());
-
-    // Calculate lookahead values, min_tail_weights, and check that there are sufficient funds
-    CAmount total_available = 0;
-    int min_group_weight = std::numeric_limits<int>::max();
-    for (size_t i = 0; i < utxo_pool.size(); ++i) {
-        size_t index = utxo_pool.size() - 1 - i; // Loop over every element in reverse order
-        lookahead[index] = total_available;
-        min_tail_weight[index] = min_group_weight;
-        // UTXOs with non-positive effective value must have been filtered
-        Assume(utxo_pool[index].GetSelectionAmount() > 0);
-        total_available += utxo_pool[index].GetSelectionAmount();
-        min_group_weight = std::min(min_group_weight, utxo_pool[index].m_weight);
-    }
+struct CoinGrinderSearch {
+    std::vector<size_t> best_selection;
+    CAmount best_selection_amount{MAX_MONEY};
+    int best_selection_weight{0};
+    size_t tries{0};
+    bool completed{false};
+    bool max_tx_weight_exceeded{false};
+};
 
-    const CAmount total_target = selection_target + change_target;
-    if (total_available < total_target) {
-        // Insufficient funds
-        return util::Error();
-    }
+/** Run the search of CoinGrinder (described below) over the subtrees whose first selected UTXO is first_root,
+ *  first_root + root_step, first_root + 2 * root_step, ... */
+static CoinGrinderSearch SearchCoinGrinder(const SearchPool& pool, const CAmount total_target, const int max_selection_weight,
+                                           const size_t first_root, const size_t root_step)
+{
+    CoinGrinderSearch search;
 
     // The current selection and the best input set found so far, stored as the utxo_pool indices of the UTXOs forming them
     std::vector<size_t> curr_selection;
-    std::vector<size_t> best_selection;
+    std::vector<size_t>& best_selection{search.best_selection};
 
     // The currently selected effective amount, and the effective amount of the best selection so far
     CAmount curr_amount = 0;
-    CAmount best_selection_amount = MAX_MONEY;
+    CAmount& best_selection_amount{search.best_selection_amount};
 
     // The weight of the currently selected input set, and the weight of the best selection
     int curr_weight = 0;
-    int best_selection_weight = max_selection_weight; // Tie is fine, because we prefer lower selection amount
-
-    // Whether the input sets generated during this search have exceeded the maximum transaction weight at any point
-    bool max_tx_weight_exceeded = false;
-
-    // Index of the next UTXO to consider in utxo_pool
-    size_t next_utxo = 0;
+    int& best_selection_weight{search.best_selection_weight};
+    best_selection_weight = max_selection_weight; // Tie is fine, because we prefer lower selection amount
+
+    // Index of the next UTXO to consider in utxo_pool. Subtrees starting with a clone of the UTXO before
+    // them are skipped below, so skip them here as well.
+    size_t next_utxo = first_root;
+    while (next_utxo > 0 && next_utxo < pool.size() && pool.amounts[next_utxo - 1] == pool.amounts[next_utxo]) {
+        next_utxo += root_step;
+    }
+    if (next_utxo >= pool.size()) {
+        search.completed = true;
+        return search;
+    }
 
     /*
      * You can think of the current selection as a vector of booleans that has decided inclusion or exclusion of all
@@ -411,36 +362,37 @@ util::Result<SelectionResult> CoinGrinder(std::vector<OutputGroup>& utxo_pool, c
      *                                 Next Selection: {0, 6}
      */
     auto deselect_last = [&]() {
-        OutputGroup& utxo = utxo_pool[curr_selection.back()];
-        curr_amount -= utxo.GetSelectionAmount();
-        curr_weight -= utxo.m_weight;
+        const size_t last{curr_selection.back()};
+        curr_amount -= pool.amounts[last];
+        curr_weight -= pool.weights[last];
         curr_selection.pop_back();
     };
 
-    SelectionResult result(selection_target, SelectionAlgorithm::CG);
     bool is_done = false;
-    size_t curr_try = 0;
+    size_t& curr_try{search.tries};
     while (!is_done) {
         bool should_shift{false}, should_cut{false};
         // Select `next_utxo`
-        OutputGroup& utxo = utxo_pool[next_utxo];
-        curr_amount += utxo.GetSelectionAmount();
-        curr_weight += utxo.m_weight;
+        curr_amount += pool.amounts[next_utxo];
+        curr_weight += pool.weights[next_utxo];
         curr_selection.push_back(next_utxo);
         ++next_utxo;
         ++curr_try;
 
         // EVALUATE current selection: check for solutions and see whether we can CUT or SHIFT before EXPLORING further
         auto curr_tail = curr_selection.back();
-        if (curr_amount + lookahead[curr_tail] < total_target) {
+        // The lookahead and minimal weight of the UTXOs after the tail
+        const CAmount lookahead{pool.lookahead[curr_tail + 1]};
+        const int min_tail_weight{pool.min_tail_weight[curr_tail + 1]};
+        if (curr_amount + lookahead < total_target) {
             // Insufficient funds with lookahead: CUT
             should_cut = true;
         } else if (curr_weight > best_selection_weight) {
             // best_selection_weight is initialized to max_selection_weight
-            if (curr_weight > max_selection_weight) max_tx_weight_exceeded = true;
+            if (curr_weight > max_selection_weight) search.max_tx_weight_exceeded = true;
             // Worse weight than best solution. More UTXOs only increase weight:
             // CUT if last selected group had minimal weight, else SHIFT
-            if (utxo_pool[curr_tail].m_weight <= min_tail_weight[curr_tail]) {
+            if (pool.weights[curr_tail] <= min_tail_weight) {
                 should_cut = true;
             } else {
                 should_shift  = true;
@@ -454,9 +406,9 @@ util::Result<SelectionResult> CoinGrinder(std::vector<OutputGroup>& utxo_pool, c
                 best_selection_weight = curr_weight;
                 best_selection_amount = curr_amount;
             }
-        } else if (!best_selection.empty() && curr_weight + int64_t{min_tail_weight[curr_tail]} * ((total_target - curr_amount + utxo_pool[curr_tail].GetSelectionAmount() - 1) / utxo_pool[curr_tail].GetSelectionAmount()) > best_selection_weight) {
+        } else if (!best_selection.empty() && curr_weight + int64_t{min_tail_weight} * ((total_target - curr_amount + pool.amounts[curr_tail] - 1) / pool.amounts[curr_tail]) > best_selection_weight) {
             // Compare minimal tail weight and last selected amount with the amount missing to gauge whether a better weight is still possible.
-            if (utxo_pool[curr_tail].m_weight <= min_tail_weight[curr_tail]) {
+            if (pool.weights[curr_tail] <= min_tail_weight) {
                 should_cut = true;
             } else {
                 should_shift = true;
@@ -465,11 +417,11 @@ util::Result<SelectionResult> CoinGrinder(std::vector<OutputGroup>& utxo_pool, c
 
         if (curr_try >= TOTAL_TRIES) {
             // Solution is not guaranteed to be optimal if `curr_try` hit TOTAL_TRIES
-            result.SetAlgoCompleted(false);
+            search.completed = false;
             break;
         }
 
-        if (next_utxo == utxo_pool.size()) {
+        if (next_utxo == pool.size()) {
             // Last added UTXO was end of UTXO pool, nothing left to add on inclusion or omission branch: CUT
             should_cut = true;
         }
@@ -488,20 +440,31 @@ util::Result<SelectionResult> CoinGrinder(std::vector<OutputGroup>& utxo_pool, c
             if (curr_selection.empty()) {
                 // Exhausted search space before running into attempt limit
                 is_done = true;
-                result.SetAlgoCompleted(true);
+                search.completed = true;
                 break;
             }
             next_utxo = curr_selection.back() + 1;
             deselect_last();
             should_shift  = false;
 
+            if (curr_selection.empty() && root_step > 1) {
+                // Continue with the next subtree assigned to this search instead of the following one, skipping clones
+                // of the UTXO before it like below
+                next_utxo += root_step - 1;
+                while (next_utxo < pool.size() && pool.amounts[next_utxo - 1] == pool.amounts[next_utxo]) {
+                    next_utxo += root_step;
+                }
+                if (next_utxo >= pool.size()) should_shift = true;
+                continue;
+            }
+
             // After SHIFTing to an omission branch, the `next_utxo` might have the same effective value as the UTXO we
             // just omitted. Since lower weight is our tiebreaker on UTXOs with equal effective value for sorting, if it
             // ties on the effective value, it _must_ have the same weight (i.e. be a "clone" of the prior UTXO) or a
             // higher weight. If so, selecting `next_utxo` would produce an equivalent or worse selection as one we
             // previously evaluated. In that case, increment `next_utxo` until we find a UTXO with a differing amount.
-            while (utxo_pool[next_utxo - 1].GetSelectionAmount() == utxo_pool[next_utxo].GetSelectionAmount()) {
-                if (next_utxo >= utxo_pool.size() - 1) {
+            while (pool.amounts[next_utxo - 1] == pool.amounts[next_utxo]) {
+                if (next_utxo >= pool.size() - 1) {
                     // Reached end of UTXO pool skipping clones: SHIFT instead
                     should_shift = true;
                     break;
@@ -511,14 +474,183 @@ util::Result<SelectionResult> CoinGrinder(std::vector<OutputGroup>& utxo_pool, c
             }
         }
     }
+    return search;
+}
 
-    result.SetSelectionsEvaluated(curr_try);
+/*
+ * TL;DR: Coin Grinder is a DFS-based algorithm that deterministically searches for the minimum-weight input set to fund
+ * the transaction. The algorithm is similar to the Branch and Bound algorithm, but will produce a transaction _with_ a
+ * change output instead of a changeless transaction.
+ *
+ * Full description: CoinGrinder can be thought of as a graph walking algorithm. It explores a binary tree
+ * representation of the powerset of the UTXO pool. Each node in the tree represents a candidate input set. The tree’s
+ * root is the empty set. Each node in the tree has two children which are formed by either adding or skipping the next
+ * UTXO ("inclusion/omission branch"). Each level in the tree after the root corresponds to a decision about one UTXO in
+ * the UTXO pool.
+ *
+ * Example:
+ * We represent UTXOs as _alias=[effective_value/weight]_ and indicate omitted UTXOs with an underscore. Given a UTXO
+ * pool {A=[10/2], B=[7/1], C=[5/1], D=[4/2]} sorted by descending effective value, our search tree looks as follows:
+ *
+ *                                       _______________________ {} ________________________
+ *                                      /                                                   \
+ * A=[10/2]               __________ {A} _________                                __________ {_} _________
+ *                       /                        \                              /                        \
+ * B=[7/1]            {AB} _                      {A_} _                      {_B} _                      {__} _
+ *                  /       \                   /       \                   /       \                   /       \
+ * C=[5/1]     {ABC}         {AB_}         {A_C}         {A__}         {_BC}         {_B_}         {__C}         {___}
+ *              / \           / \           / \           / \           / \           / \           / \           / \
+ * D=[4/2] {ABCD} {ABC_} {AB_D} {AB__} {A_CD} {A_C_} {A__D} {A___} {_BCD} {_BC_} {_B_D} {_B__} {__CD} {__C_} {___D} {____}
+ *
+ *
+ * CoinGrinder uses a depth-first search to walk this tree. It first tries inclusion branches, then omission branches. A
+ * naive exploration of a tree with four UTXOs requires visiting all 31 nodes:
+ *
+ *     {} {A} {AB} {ABC} {ABCD} {ABC_} {AB_} {AB_D} {AB__} {A_} {A_C} {A_CD} {A_C_} {A__} {A__D} {A___} {_} {_B} {_BC}
+ *     {_BCD} {_BC_} {_B_} {_B_D} {_B__} {__} {__C} {__CD} {__C} {___} {___D} {____}
+ *
+ * As powersets grow exponentially with the set size, walking the entire tree would quickly get computationally
+ * infeasible with growing UTXO pools. Thanks to traversing the tree in a deterministic order, we can keep track of the
+ * progress of the search solely on basis of the current selection (and the best selection so far). We visit as few
+ * nodes as possible by recognizing and skipping any branches that can only contain solutions worse than the best
+ * solution so far. This makes CoinGrinder a branch-and-bound algorithm
+ * (https://en.wikipedia.org/wiki/Branch_and_bound).
+ * CoinGrinder is searching for the input set with lowest weight that can fund a transaction, so for example we can only
+ * ever find a _better_ candidate input set in a node that adds a UTXO, but never in a node that skips a UTXO. After
+ * visiting {A} and exploring the inclusion branch {AB} and its descendants, the candidate input set in the omission
+ * branch {A_} is equivalent to the parent {A} in effective value and weight. While CoinGrinder does need to visit the
+ * descendants of the omission branch {A_}, it is unnecessary to evaluate the candidate input set in the omission branch
+ * itself. By skipping evaluation of all nodes on an omission branch we reduce the visited nodes to 15:
+ *
+ *     {A} {AB} {ABC} {ABCD} {AB_D} {A_C} {A_CD} {A__D} {_B} {_BC} {_BCD} {_B_D} {__C} {__CD} {___D}
+ *
+ *                                       _______________________ {} ________________________
+ *                                      /                                                   \
+ * A=[10/2]               __________ {A} _________                                ___________\____________
+ *                       /                        \                              /                        \
+ * B=[7/1]            {AB} __                    __\_____                     {_B} __                    __\_____
+ *                  /        \                  /        \                  /        \                  /        \
+ * C=[5/1]     {ABC}          \            {A_C}          \            {_BC}          \            {__C}          \
+ *              /             /             /             /             /             /             /             /
+ * D=[4/2] {ABCD}        {AB_D}        {A_CD}        {A__D}        {_BCD}        {_B_D}        {__CD}        {___D}
+ *
+ *
+ * We refer to the move from the inclusion branch {AB} via the omission branch {A_} to its inclusion-branch child {A_C}
+ * as _shifting to the omission branch_ or just _SHIFT_. (The index of the ultimate element in the candidate input set
+ * shifts right by one: {AB} ⇒ {A_C}.)
+ * When we reach a leaf node in the last level of the tree, shifting to the omission branch is not possible. Instead we
+ * go to the omission branch of the node’s last ancestor on an inclusion branch: from {ABCD}, we go to {AB_D}. From
+ * {AB_D}, we go to {A_C}. We refer to this operation as a _CUT_. (The ultimate element in
+ * the input set is deselected, and the penultimate element is shifted right by one: {AB_D} ⇒ {A_C}.)
+ * If a candidate input set in a node has not selected sufficient funds to build the transaction, we continue directly
+ * along the next inclusion branch. We call this operation _EXPLORE_. (We go from one inclusion branch to the next
+ * inclusion branch: {_B} ⇒ {_BC}.)
+ * Further, any prefix that already has selected sufficient effective value to fund the transaction cannot be improved
+ * by adding more UTXOs. If for example the candidate input set in {AB} is a valid solution, all potential descendant
+ * solutions {ABC}, {ABCD}, and {AB_D} must have a higher weight, thus instead of exploring the descendants of {AB}, we
+ * can SHIFT from {AB} to {A_C}.
+ *
+ * Given the above UTXO set, using a target of 11, and following these initial observations, the basic implementation of
+ * CoinGrinder visits the following 10 nodes:
+ *
+ *     Node   [eff_val/weight]  Evaluation
+ *     ---------------------------------------------------------------
+ *     {A}    [10/2]            Insufficient funds: EXPLORE
+ *     {AB}   [17/3]            Solution: SHIFT to omission branch
+ *     {A_C}  [15/3]            Better solution: SHIFT to omission branch
+ *     {A__D} [14/4]            Worse solution, shift impossible due to leaf node: CUT to omission branch of {A__D},
+ *                              i.e. SHIFT to omission branch of {A}
+ *     {_B}   [7/1]             Insufficient funds: EXPLORE
+ *     {_BC}  [12/2]            Better solution: SHIFT to omission branch
+ *     {_B_D} [11/3]            Worse solution, shift impossible due to leaf node: CUT to omission branch of {_B_D},
+ *                              i.e. SHIFT to omission branch of {_B}
+ *     {__C}  [5/1]             Insufficient funds: EXPLORE
+ *     {__CD} [9/3]             Insufficient funds, leaf node: CUT
+ *     {___D} [4/2]             Insufficient funds, leaf node, cannot CUT since only one UTXO selected: done.
+ *
+ *                                       _______________________ {} ________________________
+ *                                      /                                                   \
+ * A=[10/2]               __________ {A} _________                                ___________\____________
+ *                       /                        \                              /                        \
+ * B=[7/1]            {AB}                       __\_____                     {_B} __                    __\_____
+ *                                              /        \                  /        \                  /        \
+ * C=[5/1]                                 {A_C}          \            {_BC}          \            {__C}          \
+ *                                                        /                           /             /             /
+ * D=[4/2]                                           {A__D}                      {_B_D}        {__CD}        {___D}
+ *
+ *
+ * We implement this tree walk in the following algorithm:
+ * 1. Add `next_utxo`
+ * 2. Evaluate candidate input set
+ * 3. Determine `next_utxo` by deciding whether to
+ *    a) EXPLORE: Add next inclusion branch, e.g. {_B} ⇒ {_B} + `next_uxto`: C
+ *    b) SHIFT: Replace last selected UTXO by next higher index, e.g. {A_C} ⇒ {A__} + `next_utxo`: D
+ *    c) CUT: deselect last selected UTXO and shift to omission branch of penultimate UTXO, e.g. {AB_D} ⇒ {A_} + `next_utxo: C
+ *
+ * The implementation then adds further optimizations by discovering further situations in which either the inclusion
+ * branch can be skipped, or both the inclusion and omission branch can be skipped after evaluating the candidate input
+ * set in the node.
+ *
+ * @param std::vector<OutputGroup>& utxo_pool The UTXOs that we are choosing from. These UTXOs will be sorted in
+ *        descending order by effective value, with lower weight preferred as a tie-breaker. (We can think of an output
+ *        group with multiple as a heavier UTXO with the combined amount here.)
+ * @param const CAmount& selection_target This is the minimum amount that we need for the transaction without considering change.
+ * @param const CAmount& change_target The minimum budget for creating a change output, by which we increase the selection_target.
+ * @param int max_selection_weight The maximum allowed weight for a selection result to be valid.
+ * @param size_t num_threads The number of threads to split the search tree across, as in SelectCoinsBnB.
+ * @returns The result of this coin selection algorithm, or std::nullopt
+ */
+util::Result<SelectionResult> CoinGrinder(std::vector<OutputGroup>& utxo_pool, const CAmount& selection_target, CAmount change_target, int max_selection_weight,
+                                          size_t num_threads)
+{
+    std::sort(utxo_pool.begin(), utxo_pool.end(), descending_effval_weight);
+    const SearchPool pool{utxo_pool};
+
+    // Check that there are sufficient funds
+    for (const OutputGroup& utxo : utxo_pool) {
+        // UTXOs with non-positive effective value must have been filtered
+        Assume(utxo.GetSelectionAmount() > 0);
+    }
+    const CAmount total_target = selection_target + change_target;
+    if (pool.lookahead[0] < total_target) {
+        // Insufficient funds
+        return util::Error();
+    }
+
+    num_threads = std::clamp<size_t>(num_threads, 1, std::max<size_t>(utxo_pool.size(), 1));
+    std::vector<CoinGrinderSearch> searches(num_threads);
+    util::ParallelFor(num_threads, num_threads, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            searches[i] = SearchCoinGrinder(pool, total_target, max_selection_weight, /*first_root=*/i, /*root_step=*/num_threads);
+        }
+    });
+
+    // Pick the lowest weight, then the lowest amount. On a tie, pick the one a single search would have found first.
+    SelectionResult result(selection_target, SelectionAlgorithm::CG);
+    const CoinGrinderSearch* best{nullptr};
+    bool max_tx_weight_exceeded = false;
+    bool completed = true;
+    size_t tries = 0;
+    for (const CoinGrinderSearch& search : searches) {
+        max_tx_weight_exceeded |= search.max_tx_weight_exceeded;
+        completed &= search.completed;
+        tries += search.tries;
+        if (search.best_selection.empty()) continue;
+        if (!best || search.best_selection_weight < best->best_selection_weight ||
+            (search.best_selection_weight == best->best_selection_weight &&
+             (search.best_selection_amount < best->best_selection_amount ||
+              (search.best_selection_amount == best->best_selection_amount && search.best_selection.front() < best->best_selection.front())))) {
+            best = &search;
+        }
+    }
+    result.SetAlgoCompleted(completed);
+    result.SetSelectionsEvaluated(tries);
 
-    if (best_selection.empty()) {
+    if (!best) {
         return max_tx_weight_exceeded ? ErrorMaxWeightExceeded() : util::Error();
     }
 
-    for (const size_t& i : best_selection) {
+    for (const size_t& i : best->best_selection) {
         result.AddInput(utxo_pool[i]);
     }
 
@@ -23,6 +23,8 @@ namespace wallet {
 static constexpr CAmount CHANGE_LOWER{50000};
 //! upper bound for randomly-chosen target change amount
 static constexpr CAmount CHANGE_UPPER{1000000};
+//! minimum number of UTXO groups for which the exact coin selection searches are split across threads
+static constexpr size_t PARALLEL_SEARCH_MIN_UTXOS{1000};
 
 /** A UTXO under consideration for use in funding a new transaction. */
 struct COutput {
@@ -444,9 +446,10 @@ public:
 };
 
 util::Result<SelectionResult> SelectCoinsBnB(std::vector<OutputGroup>& utxo_pool, const CAmount& selection_target, const CAmount& cost_of_change,
-                                             int max_selection_weight);
+                                             int max_selection_weight, size_t num_threads = 1);
 
-util::Result<SelectionResult> CoinGrinder(std::vector<OutputGroup>& utxo_pool, const CAmount& selection_target, CAmount change_target, int max_selection_weight);
+util::Result<SelectionResult> CoinGrinder(std::vector<OutputGroup>& utxo_pool, const CAmount& selection_target, CAmount change_target, int max_selection_weight,
+                                          size_t num_threads = 1);
 
 /** Select coins by Single Random Draw. OutputGroups are selected randomly from the eligible
  * outputs until the target is satisfied
@@ -146,6 +146,8 @@ void ReadDatabaseArgs(const ArgsManager& args, DatabaseOptions& options)
 {
     // Override current options with args values, if any were specified
     options.use_unsafe_sync = args.GetBoolArg("-unsafesqlitesync", options.use_unsafe_sync);
+    options.use_wal_journal = args.GetBoolArg("-sqlitewal", options.use_wal_journal);
+    options.sync_level = args.GetArg("-sqlitesynchronous", options.sync_level);
     options.use_shared_memory = !args.GetBoolArg("-privdb", !options.use_shared_memory);
     options.max_log_mb = args.GetIntArg("-dblogsize", options.max_log_mb);
 }
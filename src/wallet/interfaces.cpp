@@ -333,7 +333,7 @@ public:
         LOCK(m_wallet->cs_wallet);
         auto mi = m_wallet->mapWallet.find(txid);
         if (mi != m_wallet->mapWallet.end()) {
-            return mi->second.tx;
+            return m_wallet->GetFullTx(mi->second);
         }
         return {};
     }
@@ -387,7 +387,9 @@ public:
             in_mempool = mi->second.InMempool();
             order_form = mi->second.vOrderForm;
             tx_status = MakeWalletTxStatus(*m_wallet, mi->second);
-            return MakeWalletTx(*m_wallet, mi->second);
+            WalletTx wtx{MakeWalletTx(*m_wallet, mi->second)};
+            wtx.tx = m_wallet->GetFullTx(mi->second);
+            return wtx;
         }
         return {};
     }
@@ -520,14 +520,42 @@ RPCHelpMan listtransactions()
     {
         LOCK(pwallet->cs_wallet);
 
-        const CWallet::TxItems & txOrdered = pwallet->wtxOrdered;
+        // Continue where the previous page ended if possible, instead of
+        // listing all newer transactions again only to skip their entries.
+        // Legacy wallets have no notification of scripts becoming theirs, so
+        // their entries may change without invalidating the cursor.
+        std::optional<CWallet::TxListCursor> cursor;
+        if (pwallet->IsWalletFlagSet(WALLET_FLAG_DESCRIPTORS)) {
+            cursor = pwallet->GetTxListCursor(filter, filter_label, nFrom);
+        }
+        const int64_t start_pos{cursor ? cursor->order_pos : std::numeric_limits<int64_t>::max()};
+        const size_t entries_before{cursor ? cursor->entries_before : 0};
+        nFrom -= static_cast<int>(entries_before);
+
+        const auto list_tx{[&](const CWalletTx& wtx) EXCLUSIVE_LOCKS_REQUIRED(pwallet->cs_wallet) {
+            const size_t entries{entries_before + ret.size()};
+            ListTransactions(*pwallet, wtx, 0, true, ret, filter, filter_label);
+            if ((int)ret.size() < (nCount+nFrom)) return false;
+            if (pwallet->wtxOrdered.count(wtx.nOrderPos) == 1) {
+                pwallet->SaveTxListCursor({filter, filter_label, wtx.nOrderPos, entries, /*version=*/0});
+            }
+            return true;
+        }};
+
+        if (filter_label) {
+            // Only transactions paying to an address with the label have entries
+            for (const CWalletTx* pwtx : pwallet->GetTxsWithLabel(*filter_label)) {
+                if (pwtx->nOrderPos > start_pos) continue;
+                if (list_tx(*pwtx)) break;
+            }
+        } else {
+            const CWallet::TxItems & txOrdered = pwallet->wtxOrdered;
 
-        // iterate backwards until we have nCount items to return:
-        for (CWallet::TxItems::const_reverse_iterator it = txOrdered.rbegin(); it != txOrdered.rend(); ++it)
-        {
-            CWalletTx *const pwtx = (*it).second;
-            ListTransactions(*pwallet, *pwtx, 0, true, ret, filter, filter_label);
-            if ((int)ret.size() >= (nCount+nFrom)) break;
+            // iterate backwards until we have nCount items to return:
+            for (auto it = std::make_reverse_iterator(txOrdered.upper_bound(start_pos)); it != txOrdered.rend(); ++it)
+            {
+                if (list_tx(*it->second)) break;
+            }
         }
     }
 
@@ -649,11 +677,16 @@ RPCHelpMan listsinceblock()
 
     UniValue transactions(UniValue::VARR);
 
-    for (const std::pair<const uint256, CWalletTx>& pairWtx : wallet.mapWallet) {
-        const CWalletTx& tx = pairWtx.second;
-
-        if (depth == -1 || abs(wallet.GetTxDepthInMainChain(tx)) < depth) {
-            ListTransactions(wallet, tx, 0, true, transactions, filter, filter_label, include_change);
+    if (height) {
+        // Only look at the transactions confirmed or conflicted after height, or in neither state
+        for (const CWalletTx* tx : wallet.GetTxsSinceHeight(*height)) {
+            if (abs(wallet.GetTxDepthInMainChain(*tx)) < depth) {
+                ListTransactions(wallet, *tx, 0, true, transactions, filter, filter_label, include_change);
+            }
+        }
+    } else {
+        for (const std::pair<const uint256, CWalletTx>& pairWtx : wallet.mapWallet) {
+            ListTransactions(wallet, pairWtx.second, 0, true, transactions, filter, filter_label, include_change);
         }
     }
 
@@ -791,11 +824,12 @@ RPCHelpMan gettransaction()
     ListTransactions(*pwallet, wtx, 0, false, details, filter, /*filter_label=*/std::nullopt);
     entry.pushKV("details", std::move(details));
 
-    entry.pushKV("hex", EncodeHexTx(*wtx.tx));
+    const CTransactionRef tx{pwallet->GetFullTx(wtx)};
+    entry.pushKV("hex", EncodeHexTx(*tx));
 
     if (verbose) {
         UniValue decoded(UniValue::VOBJ);
-        TxToUniv(*wtx.tx, /*block_hash=*/uint256(), /*entry=*/decoded, /*include_hex=*/false);
+        TxToUniv(*tx, /*block_hash=*/uint256(), /*entry=*/decoded, /*include_hex=*/false);
         entry.pushKV("decoded", std::move(decoded));
     }
 
@@ -2,6 +2,7 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <common/system.h>
 #include <hash.h>
 #include <key_io.h>
 #include <logging.h>
@@ -13,12 +14,15 @@
 #include <script/solver.h>
 #include <util/bip32.h>
 #include <util/check.h>
+#include <util/parallel.h>
 #include <util/strencodings.h>
 #include <util/string.h>
 #include <util/time.h>
 #include <util/translation.h>
 #include <wallet/scriptpubkeyman.h>
 
+#include <algorithm>
+#include <atomic>
 #include <optional>
 
 using common::PSBTError;
@@ -27,6 +31,10 @@ using util::ToString;
 namespace wallet {
 //! Value for the first BIP 32 hardened derivation. Can be used as a bit mask and as a value. See BIP 32 for more details.
 const uint32_t BIP32_HARDENED_KEY_LIMIT = 0x80000000;
+//! Maximum number of positions DescriptorScriptPubKeyMan::TopUp expands at once.
+static constexpr int32_t TOPUP_EXPAND_BATCH_SIZE{1000};
+//! Minimum number of positions each thread expands in DescriptorScriptPubKeyMan::TopUp.
+static constexpr int32_t TOPUP_MIN_POSITIONS_PER_THREAD{100};
 
 util::Result<CTxDestination> LegacyScriptPubKeyMan::GetNewDestination(const OutputType type)
 {
@@ -2231,34 +2239,58 @@ bool DescriptorScriptPubKeyMan::TopUpWithDB(WalletBatch& batch, unsigned int siz
     provider.keys = GetKeys();
 
     uint256 id = GetID();
-    for (int32_t i = m_max_cached_index + 1; i < new_range_end; ++i) {
-        FlatSigningProvider out_keys;
-        std::vector<CScript> scripts_temp;
+    const Descriptor& descriptor{*m_wallet_descriptor.descriptor};
+    const DescriptorCache& read_cache{m_wallet_descriptor.cache};
+    while (m_max_cached_index + 1 < new_range_end) {
+        // Expand several positions at once, so their keys are hashed together.
+        // Positions are independent, so split them across threads.
+        const int32_t begin{m_max_cached_index + 1};
+        const int32_t end{std::min(new_range_end, begin + TOPUP_EXPAND_BATCH_SIZE)};
+        std::vector<FlatSigningProvider> out_keys(end - begin);
+        std::vector<std::vector<CScript>> scripts_temp(end - begin);
         DescriptorCache temp_cache;
-        // Maybe we have a cached xpub and we can expand from the cache first
-        if (!m_wallet_descriptor.descriptor->ExpandFromCache(i, m_wallet_descriptor.cache, scripts_temp, out_keys)) {
-            if (!m_wallet_descriptor.descriptor->Expand(i, provider, scripts_temp, out_keys, &temp_cache)) return false;
-        }
-        // Add all of the scriptPubKeys to the scriptPubKey set
-        new_spks.insert(scripts_temp.begin(), scripts_temp.end());
-        for (const CScript& script : scripts_temp) {
-            m_map_script_pub_keys[script] = i;
-        }
-        for (const auto& pk_pair : out_keys.pubkeys) {
-            const CPubKey& pubkey = pk_pair.second;
-            if (m_map_pubkeys.count(pubkey) != 0) {
-                // We don't need to give an error here.
-                // It doesn't matter which of many valid indexes the pubkey has, we just need an index where we can derive it and it's private key
-                continue;
+        Mutex temp_cache_mutex;
+        std::atomic<bool> expanded{true};
+        const size_t num_threads{std::clamp<size_t>((end - begin) / TOPUP_MIN_POSITIONS_PER_THREAD, 1, std::max(GetNumCores(), 1))};
+        util::ParallelFor(end - begin, num_threads, [&](size_t sub_begin, size_t sub_end) {
+            std::vector<FlatSigningProvider> sub_keys;
+            std::vector<std::vector<CScript>> sub_scripts;
+            DescriptorCache sub_cache;
+            // Maybe we have a cached xpub and we can expand from the cache first
+            if (!descriptor.ExpandRangeFromCache(begin + sub_begin, begin + sub_end, read_cache, sub_scripts, sub_keys)) {
+                if (!descriptor.ExpandRange(begin + sub_begin, begin + sub_end, provider, sub_scripts, sub_keys, &sub_cache)) {
+                    expanded = false;
+                    return;
+                }
+            }
+            std::move(sub_keys.begin(), sub_keys.end(), out_keys.begin() + sub_begin);
+            std::move(sub_scripts.begin(), sub_scripts.end(), scripts_temp.begin() + sub_begin);
+            LOCK(temp_cache_mutex);
+            temp_cache.MergeAndDiff(sub_cache);
+        });
+        if (!expanded) return false;
+        for (int32_t i = begin; i < end; ++i) {
+            // Add all of the scriptPubKeys to the scriptPubKey set
+            new_spks.insert(scripts_temp[i - begin].begin(), scripts_temp[i - begin].end());
+            for (const CScript& script : scripts_temp[i - begin]) {
+                m_map_script_pub_keys[script] = i;
+            }
+            for (const auto& pk_pair : out_keys[i - begin].pubkeys) {
+                const CPubKey& pubkey = pk_pair.second;
+                if (m_map_pubkeys.count(pubkey) != 0) {
+                    // We don't need to give an error here.
+                    // It doesn't matter which of many valid indexes the pubkey has, we just need an index where we can derive it and it's private key
+                    continue;
+                }
+                m_map_pubkeys[pubkey] = i;
             }
-            m_map_pubkeys[pubkey] = i;
         }
         // Merge and write the cache
         DescriptorCache new_items = m_wallet_descriptor.cache.MergeAndDiff(temp_cache);
         if (!batch.WriteDescriptorCacheItems(id, new_items)) {
             throw std::runtime_error(std::string(__func__) + ": writing cache items failed");
         }
-        m_max_cached_index++;
+        m_max_cached_index = end - 1;
     }
     m_wallet_descriptor.range_end = new_range_end;
     batch.WriteDescriptor(GetID(), m_wallet_descriptor);
@@ -2512,6 +2544,9 @@ std::optional<PSBTError> DescriptorScriptPubKeyMan::FillPSBT(PartiallySignedTran
     if (n_signed) {
         *n_signed = 0;
     }
+    // Collect the keys for each input first, so that the inputs can then be
+    // signed in parallel without calling back into this ScriptPubKeyMan
+    std::vector<std::unique_ptr<FlatSigningProvider>> input_keys(psbtx.tx->vin.size());
     for (unsigned int i = 0; i < psbtx.tx->vin.size(); ++i) {
         const CTxIn& txin = psbtx.tx->vin[i];
         PSBTInput& input = psbtx.inputs.at(i);
@@ -2582,9 +2617,20 @@ std::optional<PSBTError> DescriptorScriptPubKeyMan::FillPSBT(PartiallySignedTran
             }
         }
 
-        SignPSBTInput(HidingSigningProvider(keys.get(), /*hide_secret=*/!sign, /*hide_origin=*/!bip32derivs), psbtx, i, &txdata, sighash_type, nullptr, finalize);
+        input_keys[i] = std::move(keys);
+    }
+
+    std::vector<std::optional<HidingSigningProvider>> hiding_providers(input_keys.size());
+    std::vector<const SigningProvider*> input_providers(input_keys.size());
+    for (size_t i = 0; i < input_keys.size(); ++i) {
+        if (!input_keys[i]) continue;
+        input_providers[i] = &hiding_providers[i].emplace(input_keys[i].get(), /*hide_secret=*/!sign, /*hide_origin=*/!bip32derivs);
+    }
+    SignPSBTInputs(input_providers, psbtx, txdata, sighash_type, finalize);
 
-        bool signed_one = PSBTInputSigned(input);
+    for (size_t i = 0; i < input_keys.size(); ++i) {
+        if (!input_keys[i]) continue;
+        bool signed_one = PSBTInputSigned(psbtx.inputs[i]);
         if (n_signed && (signed_one || !sign)) {
             // If sign is false, we assume that we _could_ sign if we get here. This
             // will never have false negatives; it is hard to tell under what i
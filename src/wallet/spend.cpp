@@ -324,10 +324,10 @@ CoinsResult AvailableCoins(const CWallet& wallet,
     std::vector<COutPoint> outpoints;
 
     std::set<uint256> trusted_parents;
-    for (const auto& entry : wallet.mapWallet)
+    for (const CWalletTx* ptx : wallet.GetUnspentTxs())
     {
-        const uint256& txid = entry.first;
-        const CWalletTx& wtx = entry.second;
+        const CWalletTx& wtx = *ptx;
+        const uint256& txid = wtx.GetHash();
 
         if (wallet.IsTxImmatureCoinBase(wtx) && !params.include_immature_coinbase)
             continue;
@@ -703,9 +703,12 @@ util::Result<SelectionResult> ChooseSelectionResult(interfaces::Chain& chain, co
         return util::Error{_("Maximum transaction weight is less than transaction weight without inputs")};
     }
 
+    // Split the exact searches over large UTXO pools across threads, which cover more of the search tree in the same time
+    const size_t search_threads{groups.positive_group.size() >= PARALLEL_SEARCH_MIN_UTXOS ? static_cast<size_t>(std::max(GetNumCores(), 1)) : 1};
+
     // SFFO frequently causes issues in the context of changeless input sets: skip BnB when SFFO is active
     if (!coin_selection_params.m_subtract_fee_outputs) {
-        if (auto bnb_result{SelectCoinsBnB(groups.positive_group, nTargetValue, coin_selection_params.m_cost_of_change, max_selection_weight)}) {
+        if (auto bnb_result{SelectCoinsBnB(groups.positive_group, nTargetValue, coin_selection_params.m_cost_of_change, max_selection_weight, search_threads)}) {
             results.push_back(*bnb_result);
         } else append_error(std::move(bnb_result));
     }
@@ -723,7 +726,7 @@ util::Result<SelectionResult> ChooseSelectionResult(interfaces::Chain& chain, co
     } else append_error(std::move(knapsack_result));
 
     if (coin_selection_params.m_effective_feerate > CFeeRate{3 * coin_selection_params.m_long_term_feerate}) { // Minimize input set for feerates of at least 3×LTFRE (default: 30 ṩ/vB+)
-        if (auto cg_result{CoinGrinder(groups.positive_group, nTargetValue, coin_selection_params.m_min_change_target, max_selection_weight)}) {
+        if (auto cg_result{CoinGrinder(groups.positive_group, nTargetValue, coin_selection_params.m_min_change_target, max_selection_weight, search_threads)}) {
             cg_result->RecalculateWaste(coin_selection_params.min_viable_change, coin_selection_params.m_cost_of_change, coin_selection_params.m_change_fee);
             results.push_back(*cg_result);
         } else {
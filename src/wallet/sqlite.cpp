@@ -25,6 +25,8 @@
 
 namespace wallet {
 static constexpr int32_t WALLET_SCHEMA_VERSION = 0;
+//! Maximum number of sets of prepared statements a database keeps around for new batches.
+static constexpr size_t MAX_FREE_STATEMENTS{8};
 
 static Span<const std::byte> SpanFromBlob(sqlite3_stmt* stmt, int col)
 {
@@ -112,7 +114,7 @@ Mutex SQLiteDatabase::g_sqlite_mutex;
 int SQLiteDatabase::g_sqlite_count = 0;
 
 SQLiteDatabase::SQLiteDatabase(const fs::path& dir_path, const fs::path& file_path, const DatabaseOptions& options, bool mock)
-    : WalletDatabase(), m_mock(mock), m_dir_path(fs::PathToString(dir_path)), m_file_path(fs::PathToString(file_path)), m_write_semaphore(1), m_use_unsafe_sync(options.use_unsafe_sync)
+    : WalletDatabase(), m_mock(mock), m_dir_path(fs::PathToString(dir_path)), m_file_path(fs::PathToString(file_path)), m_write_semaphore(1), m_use_unsafe_sync(options.use_unsafe_sync), m_use_wal_journal(options.use_wal_journal), m_sync_level(ToLower(options.sync_level))
 {
     {
         LOCK(g_sqlite_mutex);
@@ -156,6 +158,15 @@ void SQLiteBatch::SetupSQLStatements()
         {&m_delete_prefix_stmt, "DELETE FROM main WHERE instr(key, ?) = 1"},
     };
 
+    // Reuse the statements of a closed batch, if there is one
+    std::vector<sqlite3_stmt*> free_statements{m_database.TakeStatements()};
+    if (free_statements.size() == statements.size()) {
+        for (size_t i = 0; i < statements.size(); ++i) {
+            *statements[i].first = free_statements[i];
+        }
+        return;
+    }
+
     for (const auto& [stmt_prepared, stmt_text] : statements) {
         if (*stmt_prepared == nullptr) {
             int res = sqlite3_prepare_v2(m_database.m_db, stmt_text, -1, stmt_prepared, nullptr);
@@ -292,10 +303,16 @@ void SQLiteDatabase::Open()
     // Enable fullfsync for the platforms that use it
     SetPragma(m_db, "fullfsync", "true", "Failed to enable fullfsync");
 
+    // The journal mode is persistent, so set it either way: a database last opened with a write-ahead
+    // log would keep using it otherwise. With the exclusive locking mode, the log does not need shared memory.
+    SetPragma(m_db, "journal_mode", m_use_wal_journal ? "WAL" : "DELETE", "Failed to set journal mode");
+
     if (m_use_unsafe_sync) {
         // Use normal synchronous mode for the journal
         LogPrintf("WARNING SQLite is configured to not wait for data to be flushed to disk. Data loss and corruption may occur.\n");
         SetPragma(m_db, "synchronous", "OFF", "Failed to set synchronous mode to OFF");
+    } else if (m_sync_level != "full") {
+        SetPragma(m_db, "synchronous", m_sync_level, "Failed to set synchronous level");
     }
 
     // Make the table for our key-value pairs
@@ -372,6 +389,7 @@ bool SQLiteDatabase::Backup(const std::string& dest) const
 
 void SQLiteDatabase::Close()
 {
+    FinalizeFreeStatements();
     int res = sqlite3_close(m_db);
     if (res != SQLITE_OK) {
         throw std::runtime_error(strprintf("SQLiteDatabase: Failed to close database: %s\n", sqlite3_errstr(res)));
@@ -385,6 +403,36 @@ bool SQLiteDatabase::HasActiveTxn()
     return m_db && sqlite3_get_autocommit(m_db) == 0;
 }
 
+std::vector<sqlite3_stmt*> SQLiteDatabase::TakeStatements()
+{
+    LOCK(m_statements_mutex);
+    if (m_free_statements.empty()) return {};
+    std::vector<sqlite3_stmt*> statements{std::move(m_free_statements.back())};
+    m_free_statements.pop_back();
+    return statements;
+}
+
+void SQLiteDatabase::ReturnStatements(std::vector<sqlite3_stmt*> statements)
+{
+    {
+        LOCK(m_statements_mutex);
+        if (m_free_statements.size() < MAX_FREE_STATEMENTS) {
+            m_free_statements.push_back(std::move(statements));
+            return;
+        }
+    }
+    for (sqlite3_stmt* stmt : statements) sqlite3_finalize(stmt);
+}
+
+void SQLiteDatabase::FinalizeFreeStatements()
+{
+    LOCK(m_statements_mutex);
+    for (const auto& statements : m_free_statements) {
+        for (sqlite3_stmt* stmt : statements) sqlite3_finalize(stmt);
+    }
+    m_free_statements.clear();
+}
+
 int SQliteExecHandler::Exec(SQLiteDatabase& database, const std::string& statement)
 {
     return sqlite3_exec(database.m_db, statement.data(), nullptr, nullptr, nullptr);
@@ -422,6 +470,12 @@ void SQLiteBatch::Close()
         }
     }
 
+    // Hand the prepared statements to the database for reuse, unless the connection is reset below
+    if (!force_conn_refresh && m_read_stmt) {
+        m_database.ReturnStatements({m_read_stmt, m_insert_stmt, m_overwrite_stmt, m_delete_stmt, m_delete_prefix_stmt});
+        m_read_stmt = m_insert_stmt = m_overwrite_stmt = m_delete_stmt = m_delete_prefix_stmt = nullptr;
+    }
+
     // Free all of the prepared statements
     const std::vector<std::pair<sqlite3_stmt**, const char*>> statements{
         {&m_read_stmt, "read"},
@@ -691,8 +745,19 @@ bool SQLiteBatch::TxnAbort()
     return res == SQLITE_OK;
 }
 
+bool IsSQLiteSyncLevel(const std::string& level)
+{
+    const std::string lower{ToLower(level)};
+    return lower == "off" || lower == "normal" || lower == "full" || lower == "extra";
+}
+
 std::unique_ptr<SQLiteDatabase> MakeSQLiteDatabase(const fs::path& path, const DatabaseOptions& options, DatabaseStatus& status, bilingual_str& error)
 {
+    if (!IsSQLiteSyncLevel(options.sync_level)) {
+        status = DatabaseStatus::FAILED_LOAD;
+        error = Untranslated(strprintf("Invalid SQLite synchronous level '%s'", options.sync_level));
+        return nullptr;
+    }
     try {
         fs::path data_file = SQLiteDataFile(path);
         auto db = std::make_unique<SQLiteDatabase>(data_file.parent_path(), data_file, options);
@@ -8,6 +8,9 @@
 #include <sync.h>
 #include <wallet/db.h>
 
+#include <string>
+#include <vector>
+
 struct bilingual_str;
 
 struct sqlite3_stmt;
@@ -117,7 +120,12 @@ private:
     static Mutex g_sqlite_mutex;
     static int g_sqlite_count GUARDED_BY(g_sqlite_mutex);
 
+    /** Prepared statements of closed batches, kept so that new batches do not have to prepare them again. */
+    Mutex m_statements_mutex;
+    std::vector<std::vector<sqlite3_stmt*>> m_free_statements GUARDED_BY(m_statements_mutex);
+
     void Cleanup() noexcept EXCLUSIVE_LOCKS_REQUIRED(!g_sqlite_mutex);
+    void FinalizeFreeStatements() EXCLUSIVE_LOCKS_REQUIRED(!m_statements_mutex);
 
 public:
     SQLiteDatabase() = delete;
@@ -173,10 +181,19 @@ public:
     /** Return true if there is an on-going txn in this connection */
     bool HasActiveTxn();
 
+    /** Take the prepared statements of a closed batch, if any, or hand them back for later batches. */
+    std::vector<sqlite3_stmt*> TakeStatements() EXCLUSIVE_LOCKS_REQUIRED(!m_statements_mutex);
+    void ReturnStatements(std::vector<sqlite3_stmt*> statements) EXCLUSIVE_LOCKS_REQUIRED(!m_statements_mutex);
+
     sqlite3* m_db{nullptr};
     bool m_use_unsafe_sync;
+    bool m_use_wal_journal;
+    std::string m_sync_level;
 };
 
+//! Whether level is a valid SQLite synchronous level (off, normal, full or extra), in any case.
+bool IsSQLiteSyncLevel(const std::string& level);
+
 std::unique_ptr<SQLiteDatabase> MakeSQLiteDatabase(const fs::path& path, const DatabaseOptions& options, DatabaseStatus& status, bilingual_str& error);
 
 std::string SQLiteDatabaseVersion();
@@ -1317,6 +1317,52 @@ static util::Result<SelectionResult> SelectCoinsSRD(const CAmount& target,
     return SelectCoinsSRD(group.positive_group, target, cs_params.m_change_fee, cs_params.rng_fast, max_selection_weight);
 }
 
+static void add_search_coin(const CAmount& nValue, int input_bytes, std::vector<OutputGroup>& pool)
+{
+    CMutableTransaction tx;
+    tx.vout.resize(1);
+    tx.vout[0].nValue = nValue;
+    tx.nLockTime = nextLockTime++;        // so all transactions get different hashes
+    const CAmount fee{input_bytes * 20};
+    OutputGroup group;
+    group.Insert(std::make_shared<COutput>(COutPoint(tx.GetHash(), 0), tx.vout.at(0), /*depth=*/ 1, input_bytes, /*spendable=*/ true, /*solvable=*/ true, /*safe=*/ true, /*time=*/ 0, /*from_me=*/ false, fee), /*ancestors=*/ 0, /*descendants=*/ 0);
+    group.long_term_fee = input_bytes * 10;
+    pool.push_back(group);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_search_test)
+{
+    // Splitting the search tree across threads must find selections as good as those of a single
+    // search, as long as the searches complete. Small enough pools are searched exhaustively.
+    std::vector<OutputGroup> utxo_pool;
+    for (int i = 0; i < 12; ++i) {
+        add_search_coin(((i * 7919) % 97 + 3) * CENT / 10, i % 2 ? 68 : 148, utxo_pool);
+    }
+    // Clones, whose subtrees are skipped
+    add_search_coin(utxo_pool.back().m_value, 68, utxo_pool);
+    add_search_coin(utxo_pool.back().m_value, 68, utxo_pool);
+
+    for (const CAmount target : {CENT, 17 * CENT / 10, 5 * CENT, 13 * CENT}) {
+        const auto bnb_single{SelectCoinsBnB(utxo_pool, target, /*cost_of_change=*/5000, MAX_STANDARD_TX_WEIGHT)};
+        const auto cg_single{CoinGrinder(utxo_pool, target, /*change_target=*/5000, MAX_STANDARD_TX_WEIGHT)};
+        BOOST_CHECK(cg_single && cg_single->GetAlgoCompleted());
+        for (const size_t num_threads : {2, 3, 16, 100}) {
+            const auto bnb_parallel{SelectCoinsBnB(utxo_pool, target, /*cost_of_change=*/5000, MAX_STANDARD_TX_WEIGHT, num_threads)};
+            BOOST_CHECK_EQUAL(bool{bnb_single}, bool{bnb_parallel});
+            if (bnb_single && bnb_parallel) {
+                BOOST_CHECK_EQUAL(bnb_single->GetWaste(), bnb_parallel->GetWaste());
+                BOOST_CHECK(EqualResult(*bnb_single, *bnb_parallel));
+            }
+
+            const auto cg_parallel{CoinGrinder(utxo_pool, target, /*change_target=*/5000, MAX_STANDARD_TX_WEIGHT, num_threads)};
+            BOOST_REQUIRE(cg_single && cg_parallel);
+            BOOST_CHECK(cg_parallel->GetAlgoCompleted());
+            BOOST_CHECK_EQUAL(cg_single->GetWeight(), cg_parallel->GetWeight());
+            BOOST_CHECK(EqualResult(*cg_single, *cg_parallel));
+        }
+    }
+}
+
 BOOST_AUTO_TEST_CASE(srd_tests)
 {
     // Test SRD:
@@ -383,6 +383,40 @@ BOOST_AUTO_TEST_CASE(concurrent_txn_dont_interfere)
     BOOST_CHECK(handler2->Read(key, read_value));
     BOOST_CHECK_EQUAL(read_value, value2);
 }
+
+BOOST_AUTO_TEST_CASE(wal_journal_and_sync_level)
+{
+    std::string key = "key";
+    std::string value = "value";
+
+    DatabaseOptions options;
+    options.use_wal_journal = true;
+    options.sync_level = "normal";
+    DatabaseStatus status;
+    bilingual_str error;
+    std::unique_ptr<SQLiteDatabase> database = MakeSQLiteDatabase(m_path_root / "sqlite", options, status, error);
+    BOOST_CHECK(database->MakeBatch()->Write(key, value));
+    BOOST_CHECK(fs::exists(m_path_root / "sqlite" / "wallet.dat-wal"));
+
+    // The log is checkpointed into the database when it is closed
+    database.reset();
+    BOOST_CHECK(!fs::exists(m_path_root / "sqlite" / "wallet.dat-wal"));
+    database = MakeSQLiteDatabase(m_path_root / "sqlite", DatabaseOptions{}, status, error);
+    std::string read_value;
+    BOOST_CHECK(database->MakeBatch()->Read(key, read_value));
+    BOOST_CHECK_EQUAL(read_value, value);
+
+    // Without the option, the database goes back to the rollback journal, although the mode is persistent
+    BOOST_CHECK(database->MakeBatch()->Write(key, value, /*fOverwrite=*/true));
+    BOOST_CHECK(!fs::exists(m_path_root / "sqlite" / "wallet.dat-wal"));
+    database.reset();
+
+    BOOST_CHECK(IsSQLiteSyncLevel("NORMAL"));
+    BOOST_CHECK(!IsSQLiteSyncLevel("sometimes"));
+    options.sync_level = "sometimes";
+    BOOST_CHECK(!MakeSQLiteDatabase(m_path_root / "sqlite", options, status, error));
+    BOOST_CHECK(status == DatabaseStatus::FAILED_LOAD);
+}
 #endif // USE_SQLITE
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -4,6 +4,7 @@
 
 #include <key_io.h>
 #include <node/types.h>
+#include <psbt.h>
 #include <util/bip32.h>
 #include <util/strencodings.h>
 #include <wallet/wallet.h>
@@ -77,6 +78,46 @@ BOOST_AUTO_TEST_CASE(psbt_updater_test)
     BOOST_CHECK(m_wallet.FillPSBT(psbtx, complete, SIGHASH_ALL, true, true));
 }
 
+BOOST_AUTO_TEST_CASE(psbt_sign_many_inputs)
+{
+    LOCK(m_wallet.cs_wallet);
+    m_wallet.SetWalletFlag(WALLET_FLAG_DESCRIPTORS);
+
+    // Enough inputs to be signed on several threads
+    constexpr int NUM_INPUTS{PSBT_MIN_INPUTS_PER_THREAD * 4};
+    FlatSigningProvider provider;
+    std::string error;
+    std::unique_ptr<Descriptor> desc = Parse("wpkh(xprv9s21ZrQH143K2LE7W4Xf3jATf9jECxSb7wj91ZnmY4qEJrS66Qru9RFqq8xbkgT32ya6HqYJweFdJUEDf5Q6JFV7jMiUws7kQfe6Tv4RbfN/0h/0h/*)", provider, error, /*require_checksum=*/false);
+    BOOST_REQUIRE(desc);
+    CMutableTransaction prev_tx;
+    for (int i = 0; i < NUM_INPUTS; ++i) {
+        std::vector<CScript> scripts;
+        FlatSigningProvider out;
+        BOOST_REQUIRE(desc->Expand(i, provider, scripts, out));
+        prev_tx.vout.emplace_back(COIN, scripts.at(0));
+    }
+    WalletDescriptor w_desc(std::move(desc), 0, 0, NUM_INPUTS, 0);
+    BOOST_REQUIRE(m_wallet.AddWalletDescriptor(w_desc, provider, "", false));
+    const CTransactionRef prev{MakeTransactionRef(std::move(prev_tx))};
+    m_wallet.mapWallet.emplace(std::piecewise_construct, std::forward_as_tuple(prev->GetHash()), std::forward_as_tuple(prev, TxStateInactive{}));
+
+    CMutableTransaction tx;
+    for (int i = 0; i < NUM_INPUTS; ++i) tx.vin.emplace_back(COutPoint{prev->GetHash(), static_cast<uint32_t>(i)});
+    tx.vout.emplace_back(NUM_INPUTS * COIN / 2, prev->vout[0].scriptPubKey);
+    PartiallySignedTransaction psbtx{tx};
+
+    bool complete{false};
+    size_t n_signed{0};
+    BOOST_REQUIRE(!m_wallet.FillPSBT(psbtx, complete, SIGHASH_ALL, /*sign=*/true, /*bip32derivs=*/true, &n_signed));
+    BOOST_CHECK(complete);
+    BOOST_CHECK_EQUAL(n_signed, size_t{NUM_INPUTS});
+    for (const PSBTInput& input : psbtx.inputs) {
+        BOOST_CHECK(PSBTInputSigned(input));
+    }
+    CMutableTransaction final_tx;
+    BOOST_CHECK(FinalizeAndExtractPSBT(psbtx, final_tx));
+}
+
 BOOST_AUTO_TEST_CASE(parse_hd_keypath)
 {
     std::vector<uint32_t> keypath;
@@ -682,6 +682,34 @@ BOOST_FIXTURE_TEST_CASE(BasicOutputTypesTest, ListCoinsTest)
     }
 }
 
+BOOST_FIXTURE_TEST_CASE(unspent_txs_abandon, ListCoinsTestingSetup)
+{
+    // One mature coinbase, plus the immature ones
+    BOOST_CHECK_EQUAL(GetBalance(*wallet).m_mine_trusted, 50 * COIN);
+    BOOST_CHECK_EQUAL(WITH_LOCK(wallet->cs_wallet, return AvailableCoins(*wallet).Size()), 1U);
+
+    // Spend the mature coinbase without broadcasting the spending transaction.
+    // It is neither trusted nor in the mempool, so its change does not count.
+    CCoinControl coin_control;
+    auto res = CreateTransaction(*wallet, {CRecipient{PubKeyDestination{{}}, 1 * COIN, /*subtract_fee=*/false}}, /*change_pos=*/std::nullopt, coin_control);
+    BOOST_REQUIRE(res);
+    wallet->CommitTransaction(res->tx, {}, {});
+    BOOST_CHECK_EQUAL(GetBalance(*wallet).m_mine_trusted, 0);
+    {
+        LOCK(wallet->cs_wallet);
+        BOOST_CHECK_EQUAL(AvailableCoins(*wallet).Size(), 0U);
+        // The spent coinbase has been dropped from the unspent transactions
+        const auto unspent_txs{wallet->GetUnspentTxs()};
+        const Txid& coinbase_txid{res->tx->vin[0].prevout.hash};
+        BOOST_CHECK(std::none_of(unspent_txs.begin(), unspent_txs.end(), [&](const CWalletTx* wtx) { return wtx->GetHash() == coinbase_txid; }));
+    }
+
+    // Abandoning the spend makes the coinbase unspent again
+    BOOST_CHECK(wallet->AbandonTransaction(res->tx->GetHash()));
+    BOOST_CHECK_EQUAL(GetBalance(*wallet).m_mine_trusted, 50 * COIN);
+    BOOST_CHECK_EQUAL(WITH_LOCK(wallet->cs_wallet, return AvailableCoins(*wallet).Size()), 1U);
+}
+
 BOOST_FIXTURE_TEST_CASE(wallet_disableprivkeys, TestChain100Setup)
 {
     {
@@ -987,5 +1015,100 @@ BOOST_FIXTURE_TEST_CASE(wallet_sync_tx_invalid_state_test, TestingSetup)
                           HasReason("DB error adding transaction to wallet, write failed"));
 }
 
+BOOST_FIXTURE_TEST_CASE(wallet_tx_list_indexes, TestingSetup)
+{
+    CWallet wallet(m_node.chain.get(), "", CreateMockableWalletDatabase());
+    LOCK(wallet.cs_wallet);
+    wallet.SetWalletFlag(WALLET_FLAG_DESCRIPTORS);
+    wallet.SetupDescriptorScriptPubKeyMans();
+    const CTxDestination dest{*Assert(wallet.GetNewDestination(OutputType::BECH32, ""))};
+    const CTxDestination dest_label{*Assert(wallet.GetNewDestination(OutputType::BECH32, "label"))};
+
+    const auto add_tx{[&](const CTxDestination& to, const TxState& state) EXCLUSIVE_LOCKS_REQUIRED(wallet.cs_wallet) {
+        CMutableTransaction mtx;
+        mtx.vin.emplace_back(Txid::FromUint256(g_insecure_rand_ctx.rand256()), 0);
+        mtx.vout.emplace_back(COIN, GetScriptForDestination(to));
+        return Assert(wallet.AddToWallet(MakeTransactionRef(std::move(mtx)), state));
+    }};
+    const CWalletTx* confirmed_1{add_tx(dest_label, TxStateConfirmed{uint256::ONE, /*height=*/1, /*index=*/0})};
+    const CWalletTx* confirmed_2{add_tx(dest, TxStateConfirmed{uint256::ONE, /*height=*/2, /*index=*/0})};
+    const CWalletTx* mempool{add_tx(dest_label, TxStateInMempool{})};
+
+    using TxList = std::vector<const CWalletTx*>;
+    BOOST_CHECK(wallet.GetTxsSinceHeight(0) == (TxList{confirmed_1, confirmed_2, mempool}));
+    BOOST_CHECK(wallet.GetTxsSinceHeight(1) == (TxList{confirmed_2, mempool}));
+    BOOST_CHECK(wallet.GetTxsSinceHeight(2) == TxList{mempool});
+    BOOST_CHECK(wallet.GetTxsWithLabel("label") == (TxList{mempool, confirmed_1}));
+    BOOST_CHECK(wallet.GetTxsWithLabel("other").empty());
+
+    // Confirming a transaction moves it in the height index
+    Assert(wallet.AddToWallet(mempool->tx, TxStateConfirmed{uint256::ONE, /*height=*/3, /*index=*/0}));
+    BOOST_CHECK(wallet.GetTxsSinceHeight(2) == TxList{mempool});
+    BOOST_CHECK(wallet.GetTxsSinceHeight(3).empty());
+
+    // Relabeling an address changes the transactions listed for the label
+    BOOST_CHECK(wallet.SetAddressBook(dest, "label", AddressPurpose::RECEIVE));
+    BOOST_CHECK(wallet.GetTxsWithLabel("label") == (TxList{mempool, confirmed_2, confirmed_1}));
+
+    // A saved cursor is only returned until a transaction or label changes
+    const CWallet::TxListCursor cursor{ISMINE_SPENDABLE, std::nullopt, confirmed_2->nOrderPos, /*entries_before=*/1, /*version=*/0};
+    wallet.SaveTxListCursor(cursor);
+    BOOST_CHECK(wallet.GetTxListCursor(ISMINE_SPENDABLE, std::nullopt, /*from=*/1));
+    BOOST_CHECK(!wallet.GetTxListCursor(ISMINE_SPENDABLE, std::nullopt, /*from=*/0));
+    BOOST_CHECK(!wallet.GetTxListCursor(ISMINE_SPENDABLE, "label", /*from=*/1));
+    BOOST_CHECK(wallet.SetAddressBook(dest, "", AddressPurpose::RECEIVE));
+    BOOST_CHECK(!wallet.GetTxListCursor(ISMINE_SPENDABLE, std::nullopt, /*from=*/1));
+    wallet.SaveTxListCursor(cursor);
+    add_tx(dest, TxStateInMempool{});
+    BOOST_CHECK(!wallet.GetTxListCursor(ISMINE_SPENDABLE, std::nullopt, /*from=*/1));
+}
+
+BOOST_FIXTURE_TEST_CASE(wallet_compact_txs, TestingSetup)
+{
+    CWallet wallet(m_node.chain.get(), "", CreateMockableWalletDatabase());
+    LOCK(wallet.cs_wallet);
+    wallet.SetWalletFlag(WALLET_FLAG_DESCRIPTORS);
+    wallet.SetupDescriptorScriptPubKeyMans();
+    const uint256 genesis{m_node.chain->getBlockHash(0)};
+    wallet.SetLastBlockProcessed(0, genesis);
+
+    CMutableTransaction mtx;
+    mtx.vin.emplace_back(Txid::FromUint256(g_insecure_rand_ctx.rand256()), 0);
+    mtx.vin.back().scriptWitness.stack = {std::vector<unsigned char>(72, 1), std::vector<unsigned char>(33, 2)};
+    mtx.vout.emplace_back(COIN, GetScriptForDestination(*Assert(wallet.GetNewDestination(OutputType::BECH32, ""))));
+    const CTransactionRef tx{MakeTransactionRef(std::move(mtx))};
+    CWalletTx& wtx{*Assert(wallet.AddToWallet(tx, TxStateConfirmed{genesis, /*height=*/0, /*index=*/0}))};
+
+    // Nothing is compacted unless enabled, or before the transaction is deep enough
+    wallet.CompactTxs();
+    BOOST_CHECK(!wtx.IsCompacted());
+    wallet.m_compact_history_depth = 2;
+    wallet.CompactTxs();
+    BOOST_CHECK(!wtx.IsCompacted());
+
+    wallet.m_compact_history_depth = 1;
+    wallet.CompactTxs();
+    BOOST_CHECK(wtx.IsCompacted());
+    BOOST_CHECK(!wtx.tx->HasWitness());
+    BOOST_CHECK_EQUAL(wtx.GetHash(), tx->GetHash());
+    BOOST_CHECK_EQUAL(wtx.GetWitnessHash(), tx->GetWitnessHash());
+    BOOST_CHECK_EQUAL(wtx.tx->vout.size(), tx->vout.size());
+    BOOST_CHECK_EQUAL(CachedTxGetCredit(wallet, wtx, ISMINE_SPENDABLE), COIN);
+
+    // The full transaction is read back from the database, and kept when the record is rewritten
+    BOOST_CHECK_EQUAL(wallet.GetFullTx(wtx)->GetWitnessHash(), tx->GetWitnessHash());
+    wtx.mapValue["comment"] = "compacted";
+    BOOST_CHECK(WalletBatch(wallet.GetDatabase()).WriteTx(wtx));
+    CWalletTx stored{nullptr, TxStateInactive{}};
+    BOOST_CHECK(WalletBatch(wallet.GetDatabase()).ReadTx(wtx.GetHash(), stored));
+    BOOST_CHECK_EQUAL(stored.tx->GetWitnessHash(), tx->GetWitnessHash());
+    BOOST_CHECK_EQUAL(stored.mapValue["comment"], "compacted");
+
+    // Seeing the transaction in full again restores it
+    Assert(wallet.AddToWallet(tx, TxStateConfirmed{genesis, /*height=*/0, /*index=*/0}));
+    BOOST_CHECK(!wtx.IsCompacted());
+    BOOST_CHECK(wtx.tx->HasWitness());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 } // namespace wallet
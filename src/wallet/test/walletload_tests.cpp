@@ -30,6 +30,8 @@ public:
     bool ToNormalizedString(const SigningProvider& provider, std::string& out, const DescriptorCache* cache = nullptr) const override { return false; }
     bool Expand(int pos, const SigningProvider& provider, std::vector<CScript>& output_scripts, FlatSigningProvider& out, DescriptorCache* write_cache = nullptr) const override { return false; };
     bool ExpandFromCache(int pos, const DescriptorCache& read_cache, std::vector<CScript>& output_scripts, FlatSigningProvider& out) const override { return false; }
+    bool ExpandRange(int begin, int end, const SigningProvider& provider, std::vector<std::vector<CScript>>& output_scripts, std::vector<FlatSigningProvider>& out, DescriptorCache* write_cache = nullptr) const override { return false; }
+    bool ExpandRangeFromCache(int begin, int end, const DescriptorCache& read_cache, std::vector<std::vector<CScript>>& output_scripts, std::vector<FlatSigningProvider>& out) const override { return false; }
     void ExpandPrivate(int pos, const SigningProvider& provider, FlatSigningProvider& out) const override {}
     std::optional<int64_t> ScriptSize() const override { return {}; }
     std::optional<int64_t> MaxSatisfactionWeight(bool) const override { return {}; }
@@ -54,4 +54,9 @@ void CWalletTx::CopyFrom(const CWalletTx& _tx)
 {
     *this = _tx;
 }
+
+void CWalletTx::MoveFrom(CWalletTx&& _tx)
+{
+    *this = std::move(_tx);
+}
 } // namespace wallet
@@ -18,6 +18,7 @@
 #include <bitset>
 #include <cstdint>
 #include <map>
+#include <optional>
 #include <utility>
 #include <variant>
 #include <vector>
@@ -253,11 +254,19 @@ public:
         fChangeCached = false;
         nChangeCached = 0;
         nOrderPos = -1;
+        m_compacted_wtxid.reset();
     }
 
     CTransactionRef tx;
     TxState m_state;
 
+    /**
+     * Witness hash of tx while its witnesses are dropped from memory, see
+     * CWallet::CompactTxs(). The wallet database keeps the full transaction,
+     * and tx keeps its txid, inputs and outputs.
+     */
+    std::optional<Wtxid> m_compacted_wtxid;
+
     // Set of mempool transactions that conflict
     // directly with the transaction, or that conflict
     // with an ancestor transaction. This set will be
@@ -315,6 +324,7 @@ public:
     void SetTx(CTransactionRef arg)
     {
         tx = std::move(arg);
+        m_compacted_wtxid.reset();
     }
 
     //! make sure balances are recalculated
@@ -349,7 +359,8 @@ public:
     bool isUnconfirmed() const { return !isAbandoned() && !isBlockConflicted() && !isMempoolConflicted() && !isConfirmed(); }
     bool isConfirmed() const { return state<TxStateConfirmed>(); }
     const Txid& GetHash() const LIFETIMEBOUND { return tx->GetHash(); }
-    const Wtxid& GetWitnessHash() const LIFETIMEBOUND { return tx->GetWitnessHash(); }
+    const Wtxid& GetWitnessHash() const LIFETIMEBOUND { return m_compacted_wtxid ? *m_compacted_wtxid : tx->GetWitnessHash(); }
+    bool IsCompacted() const { return m_compacted_wtxid.has_value(); }
     bool IsCoinBase() const { return tx->IsCoinBase(); }
 
 private:
@@ -358,9 +369,12 @@ private:
     // wrong copy.
     CWalletTx(const CWalletTx&) = default;
     CWalletTx& operator=(const CWalletTx&) = default;
+    CWalletTx(CWalletTx&&) = default;
+    CWalletTx& operator=(CWalletTx&&) = default;
 public:
-    // Instead have an explicit copy function
+    // Instead have explicit copy and move functions
     void CopyFrom(const CWalletTx&);
+    void MoveFrom(CWalletTx&&);
 };
 
 struct WalletTxOrderComparator {
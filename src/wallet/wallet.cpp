@@ -536,6 +536,57 @@ const CWalletTx* CWallet::GetWalletTx(const uint256& hash) const
     return &(it->second);
 }
 
+void CWallet::CompactTxs()
+{
+    AssertLockHeld(cs_wallet);
+    if (m_compact_history_depth == 0) return;
+    // A transaction confirmed at height h is GetLastBlockHeight() + 1 - h blocks deep
+    const int max_height{GetLastBlockHeight() + 1 - static_cast<int>(m_compact_history_depth)};
+    if (max_height <= m_compacted_height) return;
+
+    UpdateTxListIndexes();
+    const auto end{m_txs_by_height.lower_bound({max_height + 1, uint256::ZERO})};
+    for (auto it{m_txs_by_height.lower_bound({m_compacted_height + 1, uint256::ZERO})}; it != end; ++it) {
+        CWalletTx& wtx{mapWallet.at(it->second)};
+        if (!wtx.isConfirmed() || wtx.IsCompacted() || !wtx.tx->HasWitness()) continue;
+        const Wtxid wtxid{wtx.GetWitnessHash()};
+        CMutableTransaction mtx{*wtx.tx};
+        for (CTxIn& txin : mtx.vin) {
+            txin.scriptWitness.SetNull();
+        }
+        wtx.SetTx(MakeTransactionRef(std::move(mtx)));
+        wtx.m_compacted_wtxid = wtxid;
+        // A full copy cached for an earlier compaction may have had other witnesses
+        if (const auto full_it{m_full_txs_index.find(it->second)}; full_it != m_full_txs_index.end()) {
+            m_full_txs.erase(full_it->second);
+            m_full_txs_index.erase(full_it);
+        }
+    }
+    m_compacted_height = max_height;
+}
+
+CTransactionRef CWallet::GetFullTx(const CWalletTx& wtx) const
+{
+    AssertLockHeld(cs_wallet);
+    if (!wtx.IsCompacted()) return wtx.tx;
+    if (const auto it{m_full_txs_index.find(wtx.GetHash())}; it != m_full_txs_index.end()) {
+        m_full_txs.splice(m_full_txs.begin(), m_full_txs, it->second);
+        return *it->second;
+    }
+
+    CWalletTx full{nullptr, TxStateInactive{}};
+    if (!WalletBatch(GetDatabase()).ReadTx(wtx.GetHash(), full)) {
+        throw std::runtime_error(strprintf("%s: unable to read transaction %s from the wallet database", __func__, wtx.GetHash().ToString()));
+    }
+    m_full_txs.push_front(full.tx);
+    m_full_txs_index.emplace(wtx.GetHash(), m_full_txs.begin());
+    if (m_full_txs.size() > WALLET_FULL_TX_CACHE_SIZE) {
+        m_full_txs_index.erase(m_full_txs.back()->GetHash());
+        m_full_txs.pop_back();
+    }
+    return full.tx;
+}
+
 void CWallet::UpgradeKeyMetadata()
 {
     if (IsLocked() || IsWalletFlagSet(WALLET_FLAG_KEY_ORIGIN_METADATA)) {
@@ -769,15 +820,175 @@ bool CWallet::IsSpent(const COutPoint& outpoint) const
     return false;
 }
 
+bool CWallet::HasUnspentOutputs(const CWalletTx& wtx) const
+{
+    AssertLockHeld(cs_wallet);
+    // Immature coinbase credit is counted regardless of spentness
+    if (IsTxImmatureCoinBase(wtx)) return true;
+    for (unsigned int i = 0; i < wtx.tx->vout.size(); ++i) {
+        if (!IsSpent(COutPoint(wtx.GetHash(), i)) && IsMine(wtx.tx->vout[i]) != ISMINE_NO) return true;
+    }
+    return false;
+}
+
+std::vector<const CWalletTx*> CWallet::GetUnspentTxs() const
+{
+    AssertLockHeld(cs_wallet);
+    std::vector<const CWalletTx*> txs;
+    txs.reserve(m_unspent_txs.size());
+    for (auto it = m_unspent_txs.begin(); it != m_unspent_txs.end();) {
+        const auto mit = mapWallet.find(*it);
+        if (mit == mapWallet.end() || !HasUnspentOutputs(mit->second)) {
+            // Added back by MarkTxChanged if this ever changes
+            it = m_unspent_txs.erase(it);
+            continue;
+        }
+        txs.push_back(&mit->second);
+        ++it;
+    }
+    return txs;
+}
+
+std::optional<Balance> CWallet::GetCachedBalance(int min_depth, bool avoid_reuse) const
+{
+    AssertLockHeld(cs_wallet);
+    // Depths, and so the balances, change with every block
+    if (m_balance_cache_block != m_last_block_processed) {
+        m_balance_cache.clear();
+        m_balance_cache_block = m_last_block_processed;
+        return std::nullopt;
+    }
+    const auto it = m_balance_cache.find({min_depth, avoid_reuse});
+    if (it == m_balance_cache.end()) return std::nullopt;
+    return it->second;
+}
+
+void CWallet::CacheBalance(int min_depth, bool avoid_reuse, const Balance& balance) const
+{
+    AssertLockHeld(cs_wallet);
+    m_balance_cache.insert_or_assign({min_depth, avoid_reuse}, balance);
+}
+
+void CWallet::MarkTxChanged(const uint256& hash)
+{
+    AssertLockHeld(cs_wallet);
+    m_unspent_txs.insert(hash);
+    m_balance_cache.clear();
+    m_tx_list_changed.insert(hash);
+    ++m_tx_list_version;
+}
+
+void CWallet::UpdateTxListIndexes() const
+{
+    AssertLockHeld(cs_wallet);
+    for (const uint256& hash : m_tx_list_changed) {
+        if (const auto it{m_tx_list_keys.find(hash)}; it != m_tx_list_keys.end()) {
+            const TxListKeys& keys{it->second};
+            m_txs_by_height.erase({keys.height, hash});
+            for (const CTxDestination& dest : keys.destinations) {
+                const auto dest_it{m_txs_by_destination.find(dest)};
+                if (dest_it == m_txs_by_destination.end()) continue;
+                dest_it->second.erase({keys.order_pos, hash});
+                if (dest_it->second.empty()) m_txs_by_destination.erase(dest_it);
+            }
+            m_tx_list_keys.erase(it);
+        }
+
+        const auto wtx_it{mapWallet.find(hash)};
+        if (wtx_it == mapWallet.end()) continue;
+        const CWalletTx& wtx{wtx_it->second};
+        TxListKeys keys{std::numeric_limits<int>::max(), wtx.nOrderPos, {}};
+        if (const auto* conf = wtx.state<TxStateConfirmed>()) {
+            keys.height = conf->confirmed_block_height;
+        } else if (const auto* conflicted = wtx.state<TxStateBlockConflicted>()) {
+            keys.height = conflicted->conflicting_block_height;
+        }
+        for (const CTxOut& txout : wtx.tx->vout) {
+            CTxDestination dest;
+            if (ExtractDestination(txout.scriptPubKey, dest)) keys.destinations.push_back(std::move(dest));
+        }
+        m_txs_by_height.emplace(keys.height, hash);
+        for (const CTxDestination& dest : keys.destinations) {
+            m_txs_by_destination[dest].emplace(keys.order_pos, hash);
+        }
+        m_tx_list_keys.emplace(hash, std::move(keys));
+    }
+    m_tx_list_changed.clear();
+}
+
+std::vector<const CWalletTx*> CWallet::GetTxsSinceHeight(int height) const
+{
+    AssertLockHeld(cs_wallet);
+    UpdateTxListIndexes();
+    std::vector<const CWalletTx*> txs;
+    for (auto it{m_txs_by_height.upper_bound({height, uint256::ZERO})}; it != m_txs_by_height.end(); ++it) {
+        if (it->first == height) continue;
+        txs.push_back(&mapWallet.at(it->second));
+    }
+    return txs;
+}
+
+std::vector<const CWalletTx*> CWallet::GetTxsWithLabel(const std::string& label) const
+{
+    AssertLockHeld(cs_wallet);
+    UpdateTxListIndexes();
+    std::set<std::pair<int64_t, uint256>> found;
+    for (const auto& [dest, entry] : m_address_book) {
+        if (entry.IsChange() || entry.GetLabel() != label) continue;
+        const auto it{m_txs_by_destination.find(dest)};
+        if (it != m_txs_by_destination.end()) found.insert(it->second.begin(), it->second.end());
+    }
+    std::vector<const CWalletTx*> txs;
+    txs.reserve(found.size());
+    for (auto it{found.rbegin()}; it != found.rend(); ++it) {
+        txs.push_back(&mapWallet.at(it->second));
+    }
+    return txs;
+}
+
+std::optional<CWallet::TxListCursor> CWallet::GetTxListCursor(isminefilter filter, const std::optional<std::string>& label, size_t from) const
+{
+    AssertLockHeld(cs_wallet);
+    if (!m_tx_list_cursor) return std::nullopt;
+    const TxListCursor& cursor{*m_tx_list_cursor};
+    if (cursor.version != m_tx_list_version || cursor.filter != filter || cursor.label != label || cursor.entries_before > from) {
+        return std::nullopt;
+    }
+    return cursor;
+}
+
+void CWallet::SaveTxListCursor(TxListCursor cursor) const
+{
+    AssertLockHeld(cs_wallet);
+    cursor.version = m_tx_list_version;
+    m_tx_list_cursor = std::move(cursor);
+}
+
+void CWallet::AddToTxidFilter(const uint256& txid)
+{
+    AssertLockHeld(cs_wallet);
+    if (m_txid_filter.size() >= m_txid_filter.capacity()) {
+        // Full, rebuild with room for as many transactions again
+        m_txid_filter = BlockedBloomFilter{std::max<size_t>(1000, 2 * (mapWallet.size() + mapTxSpends.size()))};
+        for (const auto& [hash, _] : mapWallet) m_txid_filter.insert(hash);
+        for (const auto& [outpoint, _] : mapTxSpends) m_txid_filter.insert(outpoint.hash.ToUint256());
+    }
+    m_txid_filter.insert(txid);
+}
+
 void CWallet::AddToSpends(const COutPoint& outpoint, const uint256& wtxid, WalletBatch* batch)
 {
     mapTxSpends.insert(std::make_pair(outpoint, wtxid));
+    AddToTxidFilter(outpoint.hash.ToUint256());
 
-    if (batch) {
-        UnlockCoin(outpoint, batch);
-    } else {
-        WalletBatch temp_batch(GetDatabase());
-        UnlockCoin(outpoint, &temp_batch);
+    // Avoid opening a database batch per input, e.g. when loading the wallet
+    if (IsLockedCoin(outpoint)) {
+        if (batch) {
+            UnlockCoin(outpoint, batch);
+        } else {
+            WalletBatch temp_batch(GetDatabase());
+            UnlockCoin(outpoint, &temp_batch);
+        }
     }
 
     std::pair<TxSpends::iterator, TxSpends::iterator> range;
@@ -971,8 +1182,10 @@ void CWallet::MarkDirty()
 {
     {
         LOCK(cs_wallet);
-        for (std::pair<const uint256, CWalletTx>& item : mapWallet)
+        for (std::pair<const uint256, CWalletTx>& item : mapWallet) {
             item.second.MarkDirty();
+            MarkTxChanged(item.first);
+        }
     }
 }
 
@@ -1082,10 +1295,13 @@ CWalletTx* CWallet::AddToWallet(CTransactionRef tx, const TxState& state, const
     auto ret = mapWallet.emplace(std::piecewise_construct, std::forward_as_tuple(hash), std::forward_as_tuple(tx, state));
     CWalletTx& wtx = (*ret.first).second;
     bool fInsertedNew = ret.second;
+    if (fInsertedNew) AddToTxidFilter(hash);
     bool fUpdated = update_wtx && update_wtx(wtx, fInsertedNew);
+    // Transactions found by a rescan are written later, together with the next order position
+    const bool write_later{rescanning_old_block && m_rescan_txs_to_write};
     if (fInsertedNew) {
         wtx.nTimeReceived = GetTime();
-        wtx.nOrderPos = IncOrderPosNext(&batch);
+        wtx.nOrderPos = write_later ? nOrderPosNext++ : IncOrderPosNext(&batch);
         wtx.m_it_wtxOrdered = wtxOrdered.insert(std::make_pair(wtx.nOrderPos, &wtx));
         wtx.nTimeSmart = ComputeTimeSmart(wtx, rescanning_old_block);
         AddToSpends(wtx, &batch);
@@ -1126,6 +1342,7 @@ CWalletTx* CWallet::AddToWallet(CTransactionRef tx, const TxState& state, const
             desc_tx->m_state = inactive_state;
             // Break caches since we have changed the state
             desc_tx->MarkDirty();
+            MarkTxChanged(desc_tx->GetHash());
             batch.WriteTx(*desc_tx);
             MarkInputsDirty(desc_tx->tx);
             for (unsigned int i = 0; i < desc_tx->tx->vout.size(); ++i) {
@@ -1145,12 +1362,17 @@ CWalletTx* CWallet::AddToWallet(CTransactionRef tx, const TxState& state, const
     WalletLogPrintf("AddToWallet %s  %s%s %s\n", hash.ToString(), (fInsertedNew ? "new" : ""), (fUpdated ? "update" : ""), TxStateString(state));
 
     // Write to disk
-    if (fInsertedNew || fUpdated)
-        if (!batch.WriteTx(wtx))
+    if (fInsertedNew || fUpdated) {
+        if (write_later) {
+            m_rescan_txs_to_write->insert(hash);
+        } else if (!batch.WriteTx(wtx)) {
             return nullptr;
+        }
+    }
 
     // Break debit/credit balance caches:
     wtx.MarkDirty();
+    MarkTxChanged(hash);
 
     // Notify UI of new or updated transaction
     NotifyTransactionChanged(hash, fInsertedNew ? CT_NEW : CT_UPDATED);
@@ -1190,6 +1412,7 @@ bool CWallet::LoadToWallet(const uint256& hash, const UpdateWalletTxFn& fill_wtx
 {
     const auto& ins = mapWallet.emplace(std::piecewise_construct, std::forward_as_tuple(hash), std::forward_as_tuple(nullptr, TxStateInactive{}));
     CWalletTx& wtx = ins.first->second;
+    if (ins.second) AddToTxidFilter(hash);
     if (!fill_wtx(wtx, ins.second)) {
         return false;
     }
@@ -1202,6 +1425,7 @@ bool CWallet::LoadToWallet(const uint256& hash, const UpdateWalletTxFn& fill_wtx
         wtx.m_it_wtxOrdered = wtxOrdered.insert(std::make_pair(wtx.nOrderPos, &wtx));
     }
     AddToSpends(wtx);
+    MarkTxChanged(hash);
     for (const CTxIn& txin : wtx.tx->vin) {
         auto it = mapWallet.find(txin.prevout.hash);
         if (it != mapWallet.end()) {
@@ -1226,6 +1450,7 @@ bool CWallet::AddToWalletIfInvolvingMe(const CTransactionRef& ptx, const SyncTxS
 
         if (auto* conf = std::get_if<TxStateConfirmed>(&state)) {
             for (const CTxIn& txin : tx.vin) {
+                if (!m_txid_filter.contains(txin.prevout.hash.ToUint256())) continue;
                 std::pair<TxSpends::const_iterator, TxSpends::const_iterator> range = mapTxSpends.equal_range(txin.prevout);
                 while (range.first != range.second) {
                     if (range.first->second != tx.GetHash()) {
@@ -1297,6 +1522,7 @@ void CWallet::MarkInputsDirty(const CTransactionRef& tx)
         auto it = mapWallet.find(txin.prevout.hash);
         if (it != mapWallet.end()) {
             it->second.MarkDirty();
+            MarkTxChanged(it->first);
         }
     }
 }
@@ -1389,6 +1615,7 @@ void CWallet::RecursiveUpdateTxState(WalletBatch* batch, const uint256& tx_hash,
         TxUpdate update_state = try_updating_state(wtx);
         if (update_state != TxUpdate::UNCHANGED) {
             wtx.MarkDirty();
+            MarkTxChanged(now);
             if (batch) batch->WriteTx(wtx);
             // Iterate over all its outputs, and update those tx states as well (if applicable)
             for (unsigned int i = 0; i < wtx.tx->vout.size(); ++i) {
@@ -1508,6 +1735,7 @@ void CWallet::blockConnected(ChainstateRole role, const interfaces::BlockInfo& b
 
     m_last_block_processed_height = block.height;
     m_last_block_processed = block.hash;
+    CompactTxs();
 
     // No need to scan block if it was created before the wallet birthday.
     // Uses chain max time and twice the grace period to adjust time for block time variability.
@@ -1531,6 +1759,8 @@ void CWallet::blockDisconnected(const interfaces::BlockInfo& block)
     // future with a stickier abandoned state or even removing abandontransaction call.
     m_last_block_processed_height = block.height - 1;
     m_last_block_processed = *Assert(block.prev_hash);
+    // Transactions confirmed again below the disconnected block are compacted after enough blocks
+    m_compacted_height = std::min(m_compacted_height, block.height - 1);
 
     int disconnect_height = block.height;
 
@@ -1585,6 +1815,7 @@ CAmount CWallet::GetDebit(const CTxIn &txin, const isminefilter& filter) const
 {
     {
         LOCK(cs_wallet);
+        if (!m_txid_filter.contains(txin.prevout.hash.ToUint256())) return 0;
         const auto mi = mapWallet.find(txin.prevout.hash);
         if (mi != mapWallet.end())
         {
@@ -1613,15 +1844,18 @@ isminetype CWallet::IsMine(const CScript& script) const
 {
     AssertLockHeld(cs_wallet);
 
-    // Search the cache so that IsMine is called only on the relevant SPKMs instead of on everything in m_spk_managers
-    const auto& it = m_cached_spks.find(script);
-    if (it != m_cached_spks.end()) {
-        isminetype res = ISMINE_NO;
-        for (const auto& spkm : it->second) {
-            res = std::max(res, spkm->IsMine(script));
+    // Search the cache so that IsMine is called only on the relevant SPKMs instead of on everything in m_spk_managers.
+    // Most scripts seen while scanning blocks aren't ours, rule those out with the prefilter first.
+    if (m_cached_spks_filter.contains(script)) {
+        const auto& it = m_cached_spks.find(script);
+        if (it != m_cached_spks.end()) {
+            isminetype res = ISMINE_NO;
+            for (const auto& spkm : it->second) {
+                res = std::max(res, spkm->IsMine(script));
+            }
+            Assume(res == ISMINE_SPENDABLE);
+            return res;
         }
-        Assume(res == ISMINE_SPENDABLE);
-        return res;
     }
 
     // Legacy wallet
@@ -1697,6 +1931,7 @@ void CWallet::SetWalletFlag(uint64_t flags)
 {
     LOCK(cs_wallet);
     m_wallet_flags |= flags;
+    m_balance_cache.clear();
     if (!WalletBatch(GetDatabase()).WriteWalletFlags(m_wallet_flags))
         throw std::runtime_error(std::string(__func__) + ": writing wallet flags failed");
 }
@@ -1711,6 +1946,7 @@ void CWallet::UnsetWalletFlagWithDB(WalletBatch& batch, uint64_t flag)
 {
     LOCK(cs_wallet);
     m_wallet_flags &= ~flag;
+    m_balance_cache.clear();
     if (!batch.WriteWalletFlags(m_wallet_flags))
         throw std::runtime_error(std::string(__func__) + ": writing wallet flags failed");
 }
@@ -1869,10 +2105,13 @@ int64_t CWallet::RescanFromTime(int64_t startTime, const WalletRescanReserver& r
 CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_block, int start_height, std::optional<int> max_height, const WalletRescanReserver& reserver, bool fUpdate, const bool save_progress)
 {
     constexpr auto INTERVAL_TIME{60s};
+    constexpr size_t TXS_PER_WRITE{1000};
     auto current_time{reserver.now()};
     auto start_time{reserver.now()};
 
     assert(reserver.isReserved());
+    // Write the transactions found in large database transactions, see AddToWallet()
+    WITH_LOCK(cs_wallet, m_rescan_txs_to_write.emplace());
 
     uint256 block_hash = start_block;
     ScanResult result;
@@ -1949,6 +2188,13 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
                 for (size_t posInBlock = 0; posInBlock < block.vtx.size(); ++posInBlock) {
                     SyncTransaction(block.vtx[posInBlock], TxStateConfirmed{block_hash, block_height, static_cast<int>(posInBlock)}, fUpdate, /*rescanning_old_block=*/true);
                 }
+                // Write the transactions found before the progress is saved, so that it never gets ahead of them
+                if ((m_rescan_txs_to_write->size() >= TXS_PER_WRITE || (save_progress && next_interval)) && !WriteRescanTxs()) {
+                    WalletLogPrintf("Failed to write the transactions found by the rescan at block %d\n", block_height);
+                    result.last_failed_block = block_hash;
+                    result.status = ScanResult::FAILURE;
+                    break;
+                }
                 // scan succeeded, record block as most recent successfully scanned
                 result.last_scanned_block = block_hash;
                 result.last_scanned_height = block_height;
@@ -1992,6 +2238,14 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
             }
         }
     }
+    {
+        LOCK(cs_wallet);
+        if (!WriteRescanTxs()) {
+            WalletLogPrintf("Failed to write the transactions found by the rescan\n");
+            result.status = ScanResult::FAILURE;
+        }
+        m_rescan_txs_to_write.reset();
+    }
     if (!max_height) {
         WalletLogPrintf("Scanning current mempool transactions.\n");
         WITH_LOCK(cs_wallet, chain().requestMempoolTransactions(*this));
@@ -2009,6 +2263,27 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
     return result;
 }
 
+bool CWallet::WriteRescanTxs()
+{
+    AssertLockHeld(cs_wallet);
+    if (!m_rescan_txs_to_write || m_rescan_txs_to_write->empty()) return true;
+    WalletBatch batch(GetDatabase());
+    if (!batch.TxnBegin()) return false;
+    for (const uint256& hash : *m_rescan_txs_to_write) {
+        const auto it{mapWallet.find(hash)};
+        if (it != mapWallet.end() && !batch.WriteTx(it->second)) {
+            batch.TxnAbort();
+            return false;
+        }
+    }
+    if (!batch.WriteOrderPosNext(nOrderPosNext) || !batch.TxnCommit()) {
+        batch.TxnAbort();
+        return false;
+    }
+    m_rescan_txs_to_write->clear();
+    return true;
+}
+
 bool CWallet::SubmitTxMemoryPoolAndRelay(CWalletTx& wtx, std::string& err_string, bool relay) const
 {
     AssertLockHeld(cs_wallet);
@@ -2034,7 +2309,7 @@ bool CWallet::SubmitTxMemoryPoolAndRelay(CWalletTx& wtx, std::string& err_string
     // If broadcast fails for any reason, trying to set wtx.m_state here would be incorrect.
     // If transaction was previously in the mempool, it should be updated when
     // TransactionRemovedFromMempool fires.
-    bool ret = chain().broadcastTransaction(wtx.tx, m_default_max_tx_fee, relay, err_string);
+    bool ret = chain().broadcastTransaction(GetFullTx(wtx), m_default_max_tx_fee, relay, err_string);
     if (ret) wtx.m_state = TxStateInMempool{};
     return ret;
 }
@@ -2224,10 +2499,7 @@ std::optional<PSBTError> CWallet::FillPSBT(PartiallySignedTransaction& psbtx, bo
     RemoveUnnecessaryTransactions(psbtx, sighash_type);
 
     // Complete if every input is now signed
-    complete = true;
-    for (size_t i = 0; i < psbtx.inputs.size(); ++i) {
-        complete &= PSBTInputSignedAndVerified(psbtx, i, &txdata);
-    }
+    complete = PSBTInputsSignedAndVerified(psbtx, txdata);
 
     return {};
 }
@@ -2410,6 +2682,8 @@ util::Result<void> CWallet::RemoveTxs(std::vector<uint256>& txs_to_remove)
         wtxOrdered.erase(it->second.m_it_wtxOrdered);
         for (const auto& txin : it->second.tx->vin)
             mapTxSpends.erase(txin.prevout);
+        m_unspent_txs.erase(hash);
+        m_tx_list_changed.insert(hash);
         mapWallet.erase(it);
         NotifyTransactionChanged(hash, CT_DELETED);
     }
@@ -2431,6 +2705,7 @@ bool CWallet::SetAddressBookWithDB(WalletBatch& batch, const CTxDestination& add
 
         CAddressBookData& record = mi != m_address_book.end() ? mi->second : m_address_book[address];
         record.SetLabel(strName);
+        ++m_tx_list_version;
         is_mine = IsMine(address) != ISMINE_NO;
         if (new_purpose) { /* update purpose only if requested */
             record.purpose = new_purpose;
@@ -2500,6 +2775,7 @@ bool CWallet::DelAddressBookWithDB(WalletBatch& batch, const CTxDestination& add
 
         // finally, remove it from the map
         m_address_book.erase(address);
+        ++m_tx_list_version;
     }
 
     // All good, signal changes
@@ -2587,6 +2863,7 @@ std::optional<int64_t> CWallet::GetOldestKeyPoolTime() const
 }
 
 void CWallet::MarkDestinationsDirty(const std::set<CTxDestination>& destinations) {
+    m_balance_cache.clear();
     for (auto& entry : mapWallet) {
         CWalletTx& wtx = entry.second;
         if (wtx.m_is_cache_empty) continue;
@@ -3196,6 +3473,7 @@ std::shared_ptr<CWallet> CWallet::Create(WalletContext& context, const std::stri
     walletInstance->m_confirm_target = args.GetIntArg("-txconfirmtarget", DEFAULT_TX_CONFIRM_TARGET);
     walletInstance->m_spend_zero_conf_change = args.GetBoolArg("-spendzeroconfchange", DEFAULT_SPEND_ZEROCONF_CHANGE);
     walletInstance->m_signal_rbf = args.GetBoolArg("-walletrbf", DEFAULT_WALLET_RBF);
+    walletInstance->m_compact_history_depth = args.GetIntArg("-walletcompacthistory", DEFAULT_WALLET_COMPACT_HISTORY);
 
     walletInstance->WalletLogPrintf("Wallet completed loading in %15dms\n", Ticks<std::chrono::milliseconds>(SteadyClock::now() - start));
 
@@ -3344,6 +3622,7 @@ bool CWallet::AttachChain(const std::shared_ptr<CWallet>& walletInstance, interf
         walletInstance->GetDatabase().IncrementUpdateCounter();
     }
     walletInstance->m_attaching_chain = false;
+    walletInstance->CompactTxs();
 
     return true;
 }
@@ -4134,8 +4413,8 @@ bool CWallet::ApplyMigrationData(MigrationData& data, bilingual_str& error)
                 const CWalletTx& to_copy_wtx = *wtx;
                 if (!data.watchonly_wallet->LoadToWallet(hash, [&](CWalletTx& ins_wtx, bool new_tx) EXCLUSIVE_LOCKS_REQUIRED(data.watchonly_wallet->cs_wallet) {
                     if (!new_tx) return false;
-                    ins_wtx.SetTx(to_copy_wtx.tx);
                     ins_wtx.CopyFrom(to_copy_wtx);
+                    ins_wtx.SetTx(GetFullTx(to_copy_wtx));
                     return true;
                 })) {
                     error = strprintf(_("Error: Could not add watchonly tx %s to watchonly wallet"), wtx->GetHash().GetHex());
@@ -4566,6 +4845,15 @@ void CWallet::CacheNewScriptPubKeys(const std::set<CScript>& spks, ScriptPubKeyM
     for (const auto& script : spks) {
         m_cached_spks[script].push_back(spkm);
     }
+    ++m_tx_list_version;
+
+    if (m_cached_spks_filter.size() + spks.size() > m_cached_spks_filter.capacity()) {
+        // Rebuild with room for as many scripts again, so top-ups rarely rebuild it
+        m_cached_spks_filter = BlockedBloomFilter{2 * m_cached_spks.size()};
+        for (const auto& [script, _] : m_cached_spks) m_cached_spks_filter.insert(script);
+    } else {
+        for (const auto& script : spks) m_cached_spks_filter.insert(script);
+    }
 }
 
 void CWallet::TopUpCallback(const std::set<CScript>& spks, ScriptPubKeyMan* spkm)
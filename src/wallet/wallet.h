@@ -7,6 +7,7 @@
 #define BITCOIN_WALLET_WALLET_H
 
 #include <addresstype.h>
+#include <common/bloom.h>
 #include <consensus/amount.h>
 #include <interfaces/chain.h>
 #include <interfaces/handler.h>
@@ -40,12 +41,14 @@
 #include <cstdint>
 #include <functional>
 #include <limits>
+#include <list>
 #include <map>
 #include <memory>
 #include <optional>
 #include <set>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -133,6 +136,10 @@ static const bool DEFAULT_WALLET_REJECT_LONG_CHAINS{true};
 static const unsigned int DEFAULT_TX_CONFIRM_TARGET = 6;
 //! -walletrbf default
 static const bool DEFAULT_WALLET_RBF = true;
+//! -walletcompacthistory default
+static const unsigned int DEFAULT_WALLET_COMPACT_HISTORY{0};
+//! Number of compacted transactions whose full data is kept by CWallet::GetFullTx()
+static constexpr size_t WALLET_FULL_TX_CACHE_SIZE{100};
 static const bool DEFAULT_WALLETBROADCAST = true;
 static const bool DEFAULT_DISABLE_WALLET = false;
 static const bool DEFAULT_WALLETCROSSCHAIN = false;
@@ -295,6 +302,15 @@ struct CRecipient
     bool fSubtractFeeFromAmount;
 };
 
+struct Balance {
+    CAmount m_mine_trusted{0};           //!< Trusted, at depth=GetBalance.min_depth or more
+    CAmount m_mine_untrusted_pending{0}; //!< Untrusted, but in mempool (pending)
+    CAmount m_mine_immature{0};          //!< Immature coinbases in the main chain
+    CAmount m_watchonly_trusted{0};
+    CAmount m_watchonly_untrusted_pending{0};
+    CAmount m_watchonly_immature{0};
+};
+
 class WalletRescanReserver; //forward declarations for ScanForWalletTransactions/RescanFromTime
 /**
  * A CWallet maintains a set of transactions and balances, and provides the ability to create new transactions.
@@ -339,6 +355,64 @@ private:
     void AddToSpends(const COutPoint& outpoint, const uint256& wtxid, WalletBatch* batch = nullptr) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
     void AddToSpends(const CWalletTx& wtx, WalletBatch* batch = nullptr) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
 
+    /**
+     * Prefilter over the txids of mapWallet and of the outpoints in mapTxSpends,
+     * so the inputs of transactions unrelated to the wallet can be ruled out
+     * without searching either map. Never has false negatives; removed
+     * transactions stay in it until it is rebuilt.
+     */
+    BlockedBloomFilter m_txid_filter GUARDED_BY(cs_wallet);
+    void AddToTxidFilter(const uint256& txid) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+
+    /**
+     * Wallet transactions that may still have unspent outputs of ours, a
+     * superset of the transactions funding the wallet's UTXO set. A transaction
+     * is added whenever it or one of its spenders changes, and dropped by
+     * GetUnspentTxs() once none of its outputs can count towards the balance.
+     */
+    mutable std::unordered_set<uint256, SaltedTxidHasher> m_unspent_txs GUARDED_BY(cs_wallet);
+
+    /** Balances computed by GetBalance() at m_balance_cache_block, keyed by its
+     * min_depth and avoid_reuse arguments. Cleared when a wallet transaction
+     * changes. */
+    mutable std::map<std::pair<int, bool>, Balance> m_balance_cache GUARDED_BY(cs_wallet);
+    mutable uint256 m_balance_cache_block GUARDED_BY(cs_wallet);
+
+    /** Whether any output of wtx is ours and unspent, or wtx is an immature coinbase. */
+    bool HasUnspentOutputs(const CWalletTx& wtx) const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+
+    /** Mark a transaction, its outputs or their spentness as changed, for the
+     * caches and indexes derived from them. */
+    void MarkTxChanged(const uint256& hash) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+
+    /** Keys a transaction is indexed under, to remove it from the indexes again. */
+    struct TxListKeys {
+        int height;
+        int64_t order_pos;
+        std::vector<CTxDestination> destinations;
+    };
+    /**
+     * Secondary indexes over mapWallet for listing transactions: by the height
+     * of the block that confirmed or conflicted them (INT_MAX if neither), and
+     * by the destinations of their outputs. Like wtxOrdered they are kept in
+     * memory only. They are updated lazily by UpdateTxListIndexes(), from the
+     * transactions MarkTxChanged() queued in m_tx_list_changed.
+     */
+    mutable std::set<std::pair<int, uint256>> m_txs_by_height GUARDED_BY(cs_wallet);
+    mutable std::map<CTxDestination, std::set<std::pair<int64_t, uint256>>> m_txs_by_destination GUARDED_BY(cs_wallet);
+    mutable std::unordered_map<uint256, TxListKeys, SaltedTxidHasher> m_tx_list_keys GUARDED_BY(cs_wallet);
+    mutable std::unordered_set<uint256, SaltedTxidHasher> m_tx_list_changed GUARDED_BY(cs_wallet);
+    void UpdateTxListIndexes() const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+
+    //! Incremented whenever the entries listed for a transaction may have changed
+    std::atomic<uint64_t> m_tx_list_version{0};
+
+    //! Height up to which confirmed transactions were compacted by CompactTxs()
+    int m_compacted_height GUARDED_BY(cs_wallet){-1};
+    //! Full data of recently used compacted transactions, most recently used first
+    mutable std::list<CTransactionRef> m_full_txs GUARDED_BY(cs_wallet);
+    mutable std::unordered_map<uint256, std::list<CTransactionRef>::iterator, SaltedTxidHasher> m_full_txs_index GUARDED_BY(cs_wallet);
+
     /**
      * Add a transaction to the wallet, or update it.  confirm.block_* should
      * be set when the transaction was known to be included in a block.  When
@@ -357,6 +431,11 @@ private:
      */
     bool AddToWalletIfInvolvingMe(const CTransactionRef& tx, const SyncTxState& state, bool fUpdate, bool rescanning_old_block) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
 
+    /** Transactions added or updated by the running rescan, if any, that still have to be written to the
+     * database. They are written in one database transaction by WriteRescanTxs() rather than one by one. */
+    std::optional<std::set<uint256>> m_rescan_txs_to_write GUARDED_BY(cs_wallet);
+    bool WriteRescanTxs() EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+
     /** Mark a transaction (and its in-wallet descendants) as conflicting with a particular block. */
     void MarkConflicted(const uint256& hashBlock, int conflicting_height, const uint256& hashTx);
 
@@ -427,6 +506,8 @@ private:
 
     //! Cache of descriptor ScriptPubKeys used for IsMine. Maps ScriptPubKey to set of spkms
     std::unordered_map<CScript, std::vector<ScriptPubKeyMan*>, SaltedSipHasher> m_cached_spks;
+    //! Prefilter over the keys of m_cached_spks, rebuilt larger when a top-up fills it
+    BlockedBloomFilter m_cached_spks_filter;
 
     /**
      * Catch wallet up to current chain, scanning new blocks, updating the best
@@ -483,9 +564,48 @@ public:
      * interested in, including received and sent transactions. */
     std::unordered_map<uint256, CWalletTx, SaltedTxidHasher> mapWallet GUARDED_BY(cs_wallet);
 
+    /**
+     * Return the wallet transactions that may have unspent outputs of ours, or
+     * are immature coinbases. Unlike iterating mapWallet, this is proportional
+     * to the wallet's UTXO set rather than to its transaction history.
+     */
+    std::vector<const CWalletTx*> GetUnspentTxs() const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+
+    /** Return the balance cached by GetBalance() for these arguments, if it is still valid. */
+    std::optional<Balance> GetCachedBalance(int min_depth, bool avoid_reuse) const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+    void CacheBalance(int min_depth, bool avoid_reuse, const Balance& balance) const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+
     typedef std::multimap<int64_t, CWalletTx*> TxItems;
     TxItems wtxOrdered;
 
+    /**
+     * Return the transactions confirmed or conflicted in a block above height,
+     * and those in neither, ordered by that height and the latter last. This is
+     * proportional to the number of transactions returned.
+     */
+    std::vector<const CWalletTx*> GetTxsSinceHeight(int height) const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+
+    /** Return the transactions with an output to an address with the given
+     * label in the address book, newest (by nOrderPos) first. */
+    std::vector<const CWalletTx*> GetTxsWithLabel(const std::string& label) const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+
+    /** Where a listing of transactions, newest first, stopped, so that the next
+     * page can be listed from there instead of from the newest transaction. */
+    struct TxListCursor {
+        isminefilter filter;
+        std::optional<std::string> label;
+        //! nOrderPos of the transaction to continue at
+        int64_t order_pos;
+        //! Number of entries listed for the transactions newer than it
+        size_t entries_before;
+        uint64_t version;
+    };
+    /** Return the cursor last saved for this filter and label, if it is at or
+     * before entry `from` and no transaction, label or script changed since. */
+    std::optional<TxListCursor> GetTxListCursor(isminefilter filter, const std::optional<std::string>& label, size_t from) const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+    void SaveTxListCursor(TxListCursor cursor) const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+    mutable std::optional<TxListCursor> m_tx_list_cursor GUARDED_BY(cs_wallet);
+
     int64_t nOrderPosNext GUARDED_BY(cs_wallet) = 0;
 
     std::map<CTxDestination, CAddressBookData> m_address_book GUARDED_BY(cs_wallet);
@@ -505,6 +625,17 @@ public:
 
     const CWalletTx* GetWalletTx(const uint256& hash) const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
 
+    /**
+     * Drop the witnesses of transactions confirmed at least
+     * m_compact_history_depth blocks deep from memory. They take most of the
+     * memory of a large history and are only needed to show or relay the full
+     * transaction, for which GetFullTx() reads them back from the database.
+     */
+    void CompactTxs() EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+    /** Return the full transaction of wtx, reading it from the database if it
+     * was compacted. */
+    CTransactionRef GetFullTx(const CWalletTx& wtx) const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+
     std::set<uint256> GetTxConflicts(const CWalletTx& wtx) const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
 
     /**
@@ -698,6 +829,8 @@ public:
      * cannot fund the transaction otherwise. */
     bool m_spend_zero_conf_change{DEFAULT_SPEND_ZEROCONF_CHANGE};
     bool m_signal_rbf{DEFAULT_WALLET_RBF};
+    //! Depth from which CompactTxs() compacts confirmed transactions, 0 to keep all in full
+    unsigned int m_compact_history_depth{DEFAULT_WALLET_COMPACT_HISTORY};
     bool m_allow_fallback_fee{true}; //!< will be false if -fallbackfee=0
     CFeeRate m_min_fee{DEFAULT_TRANSACTION_MINFEE}; //!< Override with -mintxfee
     /**
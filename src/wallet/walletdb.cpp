@@ -16,6 +16,7 @@
 #include <util/bip32.h>
 #include <util/check.h>
 #include <util/fs.h>
+#include <util/parallel.h>
 #include <util/time.h>
 #include <util/translation.h>
 #ifdef USE_BDB
@@ -27,7 +28,9 @@
 #endif
 #include <wallet/wallet.h>
 
+#include <algorithm>
 #include <atomic>
+#include <deque>
 #include <optional>
 #include <string>
 
@@ -67,6 +70,9 @@ const std::string WATCHS{"watchs"};
 const std::unordered_set<std::string> LEGACY_TYPES{CRYPTED_KEY, CSCRIPT, DEFAULTKEY, HDCHAIN, KEYMETA, KEY, OLD_KEY, POOL, WATCHMETA, WATCHS};
 } // namespace DBKeys
 
+//! Minimum number of transaction records each thread deserializes when loading a wallet.
+static constexpr size_t MIN_TX_RECORDS_PER_LOAD_THREAD{1000};
+
 //
 // WalletBatch
 //
@@ -95,9 +101,23 @@ bool WalletBatch::ErasePurpose(const std::string& strAddress)
 
 bool WalletBatch::WriteTx(const CWalletTx& wtx)
 {
+    if (wtx.IsCompacted()) {
+        // Only the copy in memory lacks the witnesses, keep them in the record
+        CWalletTx full{nullptr, TxStateInactive{}};
+        if (!ReadTx(wtx.GetHash(), full)) return false;
+        const CTransactionRef tx{full.tx};
+        full.CopyFrom(wtx);
+        full.SetTx(tx);
+        return WriteIC(std::make_pair(DBKeys::TX, wtx.GetHash()), full);
+    }
     return WriteIC(std::make_pair(DBKeys::TX, wtx.GetHash()), wtx);
 }
 
+bool WalletBatch::ReadTx(const uint256& hash, CWalletTx& wtx)
+{
+    return m_batch->Read(std::make_pair(DBKeys::TX, hash), wtx);
+}
+
 bool WalletBatch::EraseTx(uint256 hash)
 {
     return EraseIC(std::make_pair(DBKeys::TX, hash));
@@ -1019,58 +1039,84 @@ static DBErrors LoadTxRecords(CWallet* pwallet, DatabaseBatch& batch, std::vecto
     AssertLockHeld(pwallet->cs_wallet);
     DBErrors result = DBErrors::LOAD_OK;
 
-    // Load tx record
+    // Read the tx records in batches. The transactions of a batch, whose
+    // deserialization dominates the loading time of large wallets, are
+    // deserialized in parallel. They are then moved into the wallet in database
+    // order, releasing each record once it is loaded.
+    const size_t max_threads{static_cast<size_t>(std::max(GetNumCores(), 1))};
+    std::deque<std::pair<uint256, DataStream>> tx_records;
+    std::deque<CWalletTx> wtxs;
     any_unordered = false;
-    LoadResult tx_res = LoadRecords(pwallet, batch, DBKeys::TX,
-        [&any_unordered, &upgraded_txs] (CWallet* pwallet, DataStream& key, DataStream& value, std::string& err) EXCLUSIVE_LOCKS_REQUIRED(pwallet->cs_wallet) {
-        DBErrors result = DBErrors::LOAD_OK;
-        uint256 hash;
-        key >> hash;
-        // LoadToWallet call below creates a new CWalletTx that fill_wtx
-        // callback fills with transaction metadata.
-        auto fill_wtx = [&](CWalletTx& wtx, bool new_tx) {
-            if(!new_tx) {
-                // There's some corruption here since the tx we just tried to load was already in the wallet.
-                err = "Error: Corrupt transaction found. This can be fixed by removing transactions from wallet and rescanning.";
-                result = DBErrors::CORRUPT;
-                return false;
-            }
-            value >> wtx;
-            if (wtx.GetHash() != hash)
-                return false;
+    const auto load_tx_records{[&]() EXCLUSIVE_LOCKS_REQUIRED(pwallet->cs_wallet) {
+        for (size_t i = 0; i < tx_records.size(); ++i) wtxs.emplace_back(nullptr, TxStateInactive{});
+        const size_t num_threads{std::clamp<size_t>(tx_records.size() / MIN_TX_RECORDS_PER_LOAD_THREAD, 1, max_threads)};
+        util::ParallelFor(tx_records.size(), num_threads, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) tx_records[i].second >> wtxs[i];
+        });
 
-            // Undo serialize changes in 31600
-            if (31404 <= wtx.fTimeReceivedIsTxTime && wtx.fTimeReceivedIsTxTime <= 31703)
-            {
-                if (!value.empty())
-                {
-                    uint8_t fTmp;
-                    uint8_t fUnused;
-                    std::string unused_string;
-                    value >> fTmp >> fUnused >> unused_string;
-                    pwallet->WalletLogPrintf("LoadWallet() upgrading tx ver=%d %d %s\n",
-                                       wtx.fTimeReceivedIsTxTime, fTmp, hash.ToString());
-                    wtx.fTimeReceivedIsTxTime = fTmp;
+        for (; !tx_records.empty(); tx_records.pop_front(), wtxs.pop_front()) {
+            auto& [hash, value] = tx_records.front();
+            DBErrors record_res = DBErrors::LOAD_OK;
+            std::string err;
+            // LoadToWallet call below creates a new CWalletTx that fill_wtx
+            // callback fills with the deserialized transaction.
+            auto fill_wtx = [&](CWalletTx& wtx, bool new_tx) {
+                if(!new_tx) {
+                    // There's some corruption here since the tx we just tried to load was already in the wallet.
+                    err = "Error: Corrupt transaction found. This can be fixed by removing transactions from wallet and rescanning.";
+                    record_res = DBErrors::CORRUPT;
+                    return false;
                 }
-                else
+                wtx.MoveFrom(std::move(wtxs.front()));
+                if (wtx.GetHash() != hash)
+                    return false;
+
+                // Undo serialize changes in 31600
+                if (31404 <= wtx.fTimeReceivedIsTxTime && wtx.fTimeReceivedIsTxTime <= 31703)
                 {
-                    pwallet->WalletLogPrintf("LoadWallet() repairing tx ver=%d %s\n", wtx.fTimeReceivedIsTxTime, hash.ToString());
-                    wtx.fTimeReceivedIsTxTime = 0;
+                    if (!value.empty())
+                    {
+                        uint8_t fTmp;
+                        uint8_t fUnused;
+                        std::string unused_string;
+                        value >> fTmp >> fUnused >> unused_string;
+                        pwallet->WalletLogPrintf("LoadWallet() upgrading tx ver=%d %d %s\n",
+                                           wtx.fTimeReceivedIsTxTime, fTmp, hash.ToString());
+                        wtx.fTimeReceivedIsTxTime = fTmp;
+                    }
+                    else
+                    {
+                        pwallet->WalletLogPrintf("LoadWallet() repairing tx ver=%d %s\n", wtx.fTimeReceivedIsTxTime, hash.ToString());
+                        wtx.fTimeReceivedIsTxTime = 0;
+                    }
+                    upgraded_txs.push_back(hash);
                 }
-                upgraded_txs.push_back(hash);
-            }
 
-            if (wtx.nOrderPos == -1)
-                any_unordered = true;
+                if (wtx.nOrderPos == -1)
+                    any_unordered = true;
 
-            return true;
-        };
-        if (!pwallet->LoadToWallet(hash, fill_wtx)) {
-            // Use std::max as fill_wtx may have already set result to CORRUPT
-            result = std::max(result, DBErrors::NEED_RESCAN);
+                return true;
+            };
+            if (!pwallet->LoadToWallet(hash, fill_wtx)) {
+                // Use std::max as fill_wtx may have already set record_res to CORRUPT
+                record_res = std::max(record_res, DBErrors::NEED_RESCAN);
+            }
+            if (record_res != DBErrors::LOAD_OK) {
+                pwallet->WalletLogPrintf("%s\n", err);
+            }
+            result = std::max(result, record_res);
         }
-        return result;
+    }};
+    LoadResult tx_res = LoadRecords(pwallet, batch, DBKeys::TX,
+        [&] (CWallet* pwallet, DataStream& key, DataStream& value, std::string& err) EXCLUSIVE_LOCKS_REQUIRED(pwallet->cs_wallet) {
+        uint256 hash;
+        key >> hash;
+        // Take the value, leaving an empty stream for the cursor to read the next record into
+        tx_records.emplace_back(hash, std::exchange(value, DataStream{}));
+        if (tx_records.size() >= MIN_TX_RECORDS_PER_LOAD_THREAD * max_threads) load_tx_records();
+        return DBErrors::LOAD_OK;
     });
+    load_tx_records();
     result = std::max(result, tx_res.m_result);
 
     // Load locked utxo record
@@ -5,6 +5,7 @@
 #ifndef BITCOIN_ZMQ_ZMQABSTRACTNOTIFIER_H
 #define BITCOIN_ZMQ_ZMQABSTRACTNOTIFIER_H
 
+#include <atomic>
 #include <cstdint>
 #include <functional>
 #include <memory>
@@ -13,6 +14,7 @@
 class CBlockIndex;
 class CTransaction;
 class CZMQAbstractNotifier;
+class CZMQPublisher;
 
 using CZMQNotifierFactory = std::function<std::unique_ptr<CZMQAbstractNotifier>()>;
 
@@ -41,7 +43,12 @@ public:
         }
     }
 
-    virtual bool Initialize(void *pcontext) = 0;
+    //! Number of messages handed to the socket
+    uint64_t GetMessagesPublished() const { return m_messages_published; }
+    //! Number of messages dropped because the publisher queue was full or sending failed
+    uint64_t GetMessagesDropped() const { return m_messages_dropped; }
+
+    virtual bool Initialize(void *pcontext, CZMQPublisher& publisher) = 0;
     virtual void Shutdown() = 0;
 
     // Notifies of ConnectTip result, i.e., new active tip only
@@ -62,6 +69,8 @@ protected:
     std::string type;
     std::string address;
     int outbound_message_high_water_mark; // aka SNDHWM
+    std::atomic<uint64_t> m_messages_published{0};
+    std::atomic<uint64_t> m_messages_dropped{0};
 };
 
 #endif // BITCOIN_ZMQ_ZMQABSTRACTNOTIFIER_H
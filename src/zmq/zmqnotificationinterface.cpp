@@ -18,6 +18,7 @@
 
 #include <zmq.h>
 
+#include <algorithm>
 #include <cassert>
 #include <map>
 #include <string>
@@ -49,6 +50,7 @@ std::unique_ptr<CZMQNotificationInterface> CZMQNotificationInterface::Create(std
         return std::make_unique<CZMQPublishRawBlockNotifier>(get_block_by_index);
     };
     factories["pubrawtx"] = CZMQAbstractNotifier::Create<CZMQPublishRawTransactionNotifier>;
+    factories["pubbatchrawtx"] = CZMQAbstractNotifier::Create<CZMQPublishBatchRawTransactionNotifier>;
     factories["pubsequence"] = CZMQAbstractNotifier::Create<CZMQPublishSequenceNotifier>;
 
     std::list<std::unique_ptr<CZMQAbstractNotifier>> notifiers;
@@ -74,6 +76,7 @@ std::unique_ptr<CZMQNotificationInterface> CZMQNotificationInterface::Create(std
     {
         std::unique_ptr<CZMQNotificationInterface> notificationInterface(new CZMQNotificationInterface());
         notificationInterface->notifiers = std::move(notifiers);
+        notificationInterface->m_max_queue_bytes = std::max<int64_t>(gArgs.GetIntArg("-zmqqueuesize", DEFAULT_ZMQ_QUEUE_SIZE), 0) * 1024 * 1024;
 
         if (notificationInterface->Initialize()) {
             return notificationInterface;
@@ -101,8 +104,10 @@ bool CZMQNotificationInterface::Initialize()
         return false;
     }
 
+    m_publisher = std::make_unique<CZMQPublisher>(m_max_queue_bytes);
+
     for (auto& notifier : notifiers) {
-        if (notifier->Initialize(pcontext)) {
+        if (notifier->Initialize(pcontext, *m_publisher)) {
             LogPrint(BCLog::ZMQ, "Notifier %s ready (address = %s)\n", notifier->GetType(), notifier->GetAddress());
         } else {
             LogPrint(BCLog::ZMQ, "Notifier %s failed (address = %s)\n", notifier->GetType(), notifier->GetAddress());
@@ -110,6 +115,8 @@ bool CZMQNotificationInterface::Initialize()
         }
     }
 
+    m_publisher->Start();
+
     return true;
 }
 
@@ -119,6 +126,8 @@ void CZMQNotificationInterface::Shutdown()
     LogPrint(BCLog::ZMQ, "Shutdown notification interface\n");
     if (pcontext)
     {
+        // Publish the remaining queued messages before closing the sockets.
+        m_publisher->Stop();
         for (auto& notifier : notifiers) {
             LogPrint(BCLog::ZMQ, "Shutdown notifier %s at %s\n", notifier->GetType(), notifier->GetAddress());
             notifier->Shutdown();
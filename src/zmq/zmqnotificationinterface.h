@@ -8,6 +8,7 @@
 #include <primitives/transaction.h>
 #include <validationinterface.h>
 
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <list>
@@ -17,8 +18,12 @@
 class CBlock;
 class CBlockIndex;
 class CZMQAbstractNotifier;
+class CZMQPublisher;
 struct NewMempoolTransactionInfo;
 
+//! Default for -zmqqueuesize, in megabytes
+static constexpr int64_t DEFAULT_ZMQ_QUEUE_SIZE{100};
+
 class CZMQNotificationInterface final : public CValidationInterface
 {
 public:
@@ -44,6 +49,8 @@ private:
 
     void* pcontext{nullptr};
     std::list<std::unique_ptr<CZMQAbstractNotifier>> notifiers;
+    size_t m_max_queue_bytes{0};
+    std::unique_ptr<CZMQPublisher> m_publisher;
 };
 
 extern std::unique_ptr<CZMQNotificationInterface> g_zmq_notification_interface;
@@ -19,6 +19,7 @@
 #include <streams.h>
 #include <sync.h>
 #include <uint256.h>
+#include <util/thread.h>
 #include <zmq/zmqutil.h>
 
 #include <zmq.h>
@@ -45,6 +46,7 @@ static const char *MSG_HASHTX    = "hashtx";
 static const char *MSG_RAWBLOCK  = "rawblock";
 static const char *MSG_RAWTX     = "rawtx";
 static const char *MSG_SEQUENCE  = "sequence";
+static const char *MSG_BATCHRAWTX = "batchrawtx";
 
 // Internal function to send multipart message
 static int zmq_send_multipart(void *sock, const void* data, size_t size, ...)
@@ -102,9 +104,108 @@ static bool IsZMQAddressIPV6(const std::string &zmq_address)
     return false;
 }
 
-bool CZMQAbstractPublishNotifier::Initialize(void *pcontext)
+CZMQPublisher::CZMQPublisher(size_t max_queue_bytes) : m_max_queue_bytes{max_queue_bytes} {}
+
+CZMQPublisher::~CZMQPublisher()
+{
+    Stop();
+}
+
+void CZMQPublisher::Start()
+{
+    assert(!m_thread.joinable());
+    m_thread = std::thread(&util::TraceThread, "zmqpub", [this] { ThreadPublish(); });
+}
+
+void CZMQPublisher::Stop()
+{
+    WITH_LOCK(m_mutex, m_stop = true);
+    m_worker_cv.notify_one();
+    if (m_thread.joinable()) m_thread.join();
+}
+
+bool CZMQPublisher::Enqueue(CZMQQueuedMessage&& message)
+{
+    {
+        LOCK(m_mutex);
+        if (m_stop || m_queue_bytes + message.data.size() > m_max_queue_bytes) return false;
+        m_queue_bytes += message.data.size();
+        m_queue.push_back(std::move(message));
+    }
+    m_worker_cv.notify_one();
+    return true;
+}
+
+void CZMQPublisher::Discard(const CZMQAbstractPublishNotifier& notifier)
+{
+    WAIT_LOCK(m_mutex, lock);
+    m_idle_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return !m_sending; });
+    for (auto it = m_queue.begin(); it != m_queue.end();) {
+        if (it->notifier == &notifier) {
+            m_queue_bytes -= it->data.size();
+            it = m_queue.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void CZMQPublisher::ThreadPublish()
+{
+    std::deque<CZMQQueuedMessage> messages;
+    while (true) {
+        {
+            WAIT_LOCK(m_mutex, lock);
+            m_sending = false;
+            m_idle_cv.notify_all();
+            m_worker_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return m_stop || !m_queue.empty(); });
+            // Only exit once all queued messages are published.
+            if (m_queue.empty()) return;
+            messages.swap(m_queue);
+            m_queue_bytes = 0;
+            m_sending = true;
+        }
+        PublishMessages(messages);
+        messages.clear();
+    }
+}
+
+void CZMQPublisher::PublishMessages(std::deque<CZMQQueuedMessage>& messages)
+{
+    // Coalesce the messages of batch topics, keeping their relative order.
+    struct Batch {
+        const char* command;
+        std::vector<std::vector<uint8_t>> parts;
+    };
+    std::map<CZMQAbstractPublishNotifier*, Batch> batches;
+    const auto send_batch{[](CZMQAbstractPublishNotifier* notifier, Batch& batch) {
+        DataStream frame;
+        WriteCompactSize(frame, batch.parts.size());
+        for (const auto& part : batch.parts) {
+            frame.write(MakeByteSpan(part));
+        }
+        notifier->SendZmqMessage(batch.command, frame.data(), frame.size(), /*sequence=*/std::nullopt, batch.parts.size());
+        batch.parts.clear();
+    }};
+
+    for (CZMQQueuedMessage& message : messages) {
+        if (message.sequence) {
+            message.notifier->SendZmqMessage(message.command, message.data.data(), message.data.size(), message.sequence);
+            continue;
+        }
+        Batch& batch{batches.try_emplace(message.notifier, Batch{message.command, {}}).first->second};
+        batch.parts.push_back(std::move(message.data));
+        if (batch.parts.size() >= MAX_ZMQ_BATCH_MESSAGES) send_batch(message.notifier, batch);
+    }
+    for (auto& [notifier, batch] : batches) {
+        if (!batch.parts.empty()) send_batch(notifier, batch);
+    }
+}
+
+bool CZMQAbstractPublishNotifier::Initialize(void *pcontext, CZMQPublisher& publisher)
 {
     assert(!psocket);
+    m_publisher = &publisher;
 
     // check if address is being used by other publish notifier
     std::multimap<std::string, CZMQAbstractPublishNotifier*>::iterator i = mapPublishNotifiers.find(address);
@@ -174,6 +275,9 @@ void CZMQAbstractPublishNotifier::Shutdown()
     // Early return if Initialize was not called
     if (!psocket) return;
 
+    // Make sure the publisher thread no longer uses the socket.
+    m_publisher->Discard(*this);
+
     int count = mapPublishNotifiers.count(address);
 
     // remove this notifier from the list of publishers using this address
@@ -200,19 +304,41 @@ void CZMQAbstractPublishNotifier::Shutdown()
     psocket = nullptr;
 }
 
-bool CZMQAbstractPublishNotifier::SendZmqMessage(const char *command, const void* data, size_t size)
+bool CZMQAbstractPublishNotifier::QueueZmqMessage(const char *command, const void* data, size_t size, bool batch)
+{
+    assert(psocket);
+
+    const uint8_t* begin{static_cast<const uint8_t*>(data)};
+    std::optional<uint32_t> sequence;
+    if (!batch) sequence = nSequence;
+    if (!m_publisher->Enqueue({this, command, std::vector<uint8_t>(begin, begin + size), sequence})) {
+        LogPrint(BCLog::ZMQ, "Publisher queue full, dropping %s message to %s\n", command, address);
+        MessagesDropped(1);
+    }
+
+    /* a dropped message still consumes a sequence number, so subscribers
+       can detect it */
+    if (!batch) nSequence++;
+
+    return true;
+}
+
+bool CZMQAbstractPublishNotifier::SendZmqMessage(const char *command, const void* data, size_t size, std::optional<uint32_t> sequence, size_t n_messages)
 {
     assert(psocket);
 
     /* send three parts, command & data & a LE 4byte sequence number */
     unsigned char msgseq[sizeof(uint32_t)];
-    WriteLE32(msgseq, nSequence);
+    WriteLE32(msgseq, sequence ? *sequence : nSequence);
     int rc = zmq_send_multipart(psocket, command, strlen(command), data, size, msgseq, (size_t)sizeof(uint32_t), nullptr);
-    if (rc == -1)
+    if (rc == -1) {
+        MessagesDropped(n_messages);
         return false;
+    }
 
     /* increment memory only sequence number after sending */
-    nSequence++;
+    if (!sequence) nSequence++;
+    m_messages_published += n_messages;
 
     return true;
 }
@@ -225,7 +351,7 @@ bool CZMQPublishHashBlockNotifier::NotifyBlock(const CBlockIndex *pindex)
     for (unsigned int i = 0; i < 32; i++) {
         data[31 - i] = hash.begin()[i];
     }
-    return SendZmqMessage(MSG_HASHBLOCK, data, 32);
+    return QueueZmqMessage(MSG_HASHBLOCK, data, 32);
 }
 
 bool CZMQPublishHashTransactionNotifier::NotifyTransaction(const CTransaction &transaction)
@@ -236,7 +362,7 @@ bool CZMQPublishHashTransactionNotifier::NotifyTransaction(const CTransaction &t
     for (unsigned int i = 0; i < 32; i++) {
         data[31 - i] = hash.begin()[i];
     }
-    return SendZmqMessage(MSG_HASHTX, data, 32);
+    return QueueZmqMessage(MSG_HASHTX, data, 32);
 }
 
 bool CZMQPublishRawBlockNotifier::NotifyBlock(const CBlockIndex *pindex)
@@ -249,7 +375,7 @@ bool CZMQPublishRawBlockNotifier::NotifyBlock(const CBlockIndex *pindex)
         return false;
     }
 
-    return SendZmqMessage(MSG_RAWBLOCK, block.data(), block.size());
+    return QueueZmqMessage(MSG_RAWBLOCK, block.data(), block.size());
 }
 
 bool CZMQPublishRawTransactionNotifier::NotifyTransaction(const CTransaction &transaction)
@@ -258,7 +384,16 @@ bool CZMQPublishRawTransactionNotifier::NotifyTransaction(const CTransaction &tr
     LogPrint(BCLog::ZMQ, "Publish rawtx %s to %s\n", hash.GetHex(), this->address);
     DataStream ss;
     ss << TX_WITH_WITNESS(transaction);
-    return SendZmqMessage(MSG_RAWTX, &(*ss.begin()), ss.size());
+    return QueueZmqMessage(MSG_RAWTX, &(*ss.begin()), ss.size());
+}
+
+bool CZMQPublishBatchRawTransactionNotifier::NotifyTransaction(const CTransaction &transaction)
+{
+    uint256 hash = transaction.GetHash();
+    LogPrint(BCLog::ZMQ, "Queue batchrawtx %s to %s\n", hash.GetHex(), this->address);
+    DataStream ss;
+    ss << TX_WITH_WITNESS(transaction);
+    return QueueZmqMessage(MSG_BATCHRAWTX, &(*ss.begin()), ss.size(), /*batch=*/true);
 }
 
 // Helper function to send a 'sequence' topic message with the following structure:
@@ -271,7 +406,7 @@ static bool SendSequenceMsg(CZMQAbstractPublishNotifier& notifier, uint256 hash,
     }
     data[sizeof(hash)] = label;
     if (sequence) WriteLE64(data + sizeof(hash) + sizeof(label), *sequence);
-    return notifier.SendZmqMessage(MSG_SEQUENCE, data, sequence ? sizeof(data) : sizeof(hash) + sizeof(label));
+    return notifier.QueueZmqMessage(MSG_SEQUENCE, data, sequence ? sizeof(data) : sizeof(hash) + sizeof(label));
 }
 
 bool CZMQPublishSequenceNotifier::NotifyBlockConnect(const CBlockIndex *pindex)
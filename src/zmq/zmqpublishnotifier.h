@@ -5,32 +5,108 @@
 #ifndef BITCOIN_ZMQ_ZMQPUBLISHNOTIFIER_H
 #define BITCOIN_ZMQ_ZMQPUBLISHNOTIFIER_H
 
+#include <sync.h>
+#include <threadsafety.h>
 #include <zmq/zmqabstractnotifier.h>
 
+#include <condition_variable>
 #include <cstddef>
 #include <cstdint>
+#include <deque>
 #include <functional>
+#include <optional>
+#include <thread>
 #include <vector>
 
 class CBlockIndex;
 class CTransaction;
+class CZMQAbstractPublishNotifier;
+
+//! Maximum number of messages coalesced into one frame of a batch topic
+static constexpr size_t MAX_ZMQ_BATCH_MESSAGES{1000};
+
+/** A message waiting to be published by the CZMQPublisher thread. */
+struct CZMQQueuedMessage {
+    CZMQAbstractPublishNotifier* notifier;
+    const char* command;
+    std::vector<uint8_t> data;
+    //! Sequence number, assigned when queued. Unset for batch topics, whose
+    //! sequence numbers count frames and are assigned when a frame is sent.
+    std::optional<uint32_t> sequence;
+};
+
+/**
+ * Publishes the messages of all notifiers of a CZMQNotificationInterface from
+ * a dedicated thread, so that slow subscribers or a burst of notifications
+ * never block the validation interface callbacks.
+ *
+ * The queue is bounded in memory; messages that don't fit are dropped and
+ * accounted to their notifier. Messages of batch topics that are queued
+ * together are coalesced into a single frame.
+ */
+class CZMQPublisher
+{
+public:
+    explicit CZMQPublisher(size_t max_queue_bytes);
+    ~CZMQPublisher();
+
+    void Start();
+    //! Publish all queued messages and stop the thread.
+    void Stop() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    //! Queue a message. Returns false if the queue is full and the message was dropped.
+    bool Enqueue(CZMQQueuedMessage&& message) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    //! Drop all queued messages of a notifier and wait until none of its
+    //! messages are being sent, so it can be shut down.
+    void Discard(const CZMQAbstractPublishNotifier& notifier) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+private:
+    void ThreadPublish() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    static void PublishMessages(std::deque<CZMQQueuedMessage>& messages);
+
+    Mutex m_mutex;
+    std::condition_variable m_worker_cv;
+    std::condition_variable m_idle_cv;
+    std::deque<CZMQQueuedMessage> m_queue GUARDED_BY(m_mutex);
+    size_t m_queue_bytes GUARDED_BY(m_mutex){0};
+    //! Whether the thread is sending messages taken from the queue
+    bool m_sending GUARDED_BY(m_mutex){false};
+    bool m_stop GUARDED_BY(m_mutex){false};
+    const size_t m_max_queue_bytes;
+    std::thread m_thread;
+};
 
 class CZMQAbstractPublishNotifier : public CZMQAbstractNotifier
 {
 private:
-    uint32_t nSequence {0U}; //!< upcounting per message sequence number
+    //! upcounting per message sequence number. Only accessed by the thread
+    //! queueing messages, or by the publisher thread for batch topics.
+    uint32_t nSequence {0U};
+    CZMQPublisher* m_publisher{nullptr};
 
 public:
 
-    /* send zmq multipart message
+    /* queue zmq multipart message for publishing
        parts:
           * command
           * data
           * message sequence number
+       Messages of batch topics queued together are coalesced by the
+       publisher into a single message, whose data is the number of
+       messages (as compact size) followed by their concatenated data.
     */
-    bool SendZmqMessage(const char *command, const void* data, size_t size);
+    bool QueueZmqMessage(const char *command, const void* data, size_t size, bool batch = false);
+
+    /* send zmq multipart message, called by the publisher thread.
+       A sequence number is assigned if none is given. n_messages is the
+       number of queued messages the data consists of. */
+    bool SendZmqMessage(const char *command, const void* data, size_t size, std::optional<uint32_t> sequence, size_t n_messages = 1);
+
+    //! Account for queued messages that could not be published.
+    void MessagesDropped(size_t n_messages) { m_messages_dropped += n_messages; }
 
-    bool Initialize(void *pcontext) override;
+    bool Initialize(void *pcontext, CZMQPublisher& publisher) override;
     void Shutdown() override;
 };
 
@@ -63,6 +139,12 @@ public:
     bool NotifyTransaction(const CTransaction &transaction) override;
 };
 
+class CZMQPublishBatchRawTransactionNotifier : public CZMQAbstractPublishNotifier
+{
+public:
+    bool NotifyTransaction(const CTransaction &transaction) override;
+};
+
 class CZMQPublishSequenceNotifier : public CZMQAbstractPublishNotifier
 {
 public:
@@ -31,6 +31,8 @@ static RPCHelpMan getzmqnotifications()
                             {RPCResult::Type::STR, "type", "Type of notification"},
                             {RPCResult::Type::STR, "address", "Address of the publisher"},
                             {RPCResult::Type::NUM, "hwm", "Outbound message high water mark"},
+                            {RPCResult::Type::NUM, "published", "Number of messages handed to the socket"},
+                            {RPCResult::Type::NUM, "dropped", "Number of messages dropped because the publisher queue was full (see -zmqqueuesize) or sending failed"},
                         }},
                     }
                 },
@@ -47,6 +49,8 @@ static RPCHelpMan getzmqnotifications()
             obj.pushKV("type", n->GetType());
             obj.pushKV("address", n->GetAddress());
             obj.pushKV("hwm", n->GetOutboundMessageHighWaterMark());
+            obj.pushKV("published", n->GetMessagesPublished());
+            obj.pushKV("dropped", n->GetMessagesDropped());
             result.push_back(std::move(obj));
         }
     }
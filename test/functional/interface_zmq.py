@@ -21,6 +21,8 @@ from test_framework.blocktools import (
 from test_framework.test_framework import BitcoinTestFramework
 from test_framework.messages import (
     CBlock,
+    CTransaction,
+    deser_compact_size,
     hash256,
     tx_from_hex,
 )
@@ -129,6 +131,7 @@ class ZMQTest (BitcoinTestFramework):
             self.test_mempool_sync()
             self.test_reorg()
             self.test_multiple_interfaces()
+            self.test_batch_rawtx()
             self.test_ipv6()
         finally:
             # Destroy the ZMQ context.
@@ -252,12 +255,16 @@ class ZMQTest (BitcoinTestFramework):
 
 
         self.log.info("Test the getzmqnotifications RPC")
-        assert_equal(self.nodes[0].getzmqnotifications(), [
+        notifications = self.nodes[0].getzmqnotifications()
+        assert_equal([{k: n[k] for k in ["type", "address", "hwm"]} for n in notifications], [
             {"type": "pubhashblock", "address": address, "hwm": 1000},
             {"type": "pubhashtx", "address": address, "hwm": 1000},
             {"type": "pubrawblock", "address": address, "hwm": 1000},
             {"type": "pubrawtx", "address": address, "hwm": 1000},
         ])
+        for n in notifications:
+            assert n["published"] > 0
+            assert_equal(n["dropped"], 0)
 
         assert_equal(self.nodes[1].getzmqnotifications(), [])
         if unix:
@@ -579,6 +586,33 @@ class ZMQTest (BitcoinTestFramework):
         assert_equal(self.nodes[0].getbestblockhash(), subscribers[0].receive().hex())
         assert_equal(self.nodes[0].getbestblockhash(), subscribers[1].receive().hex())
 
+    def test_batch_rawtx(self):
+        self.log.info("Testing batchrawtx")
+        address = f"tcp://127.0.0.1:{self.zmq_port_base}"
+        [batchrawtx] = self.setup_zmq_test([("batchrawtx", address)], sync_blocks=False)
+
+        # Transactions arriving while others are waiting to be published are
+        # coalesced, so collect messages until all transactions are seen.
+        self.wallet.rescan_utxos()
+        txs = [self.wallet.send_self_transfer(from_node=self.nodes[0]) for _ in range(10)]
+        hashes = self.generatetoaddress(self.nodes[0], 1, ADDRESS_BCRT1_UNSPENDABLE, sync_fun=self.no_op)
+        block_txids = self.nodes[0].getblock(hashes[0])["tx"]
+        expected = [tx["txid"] for tx in txs] + block_txids
+        received = []
+        while len(received) < len(expected):
+            body = BytesIO(batchrawtx.receive())
+            for _ in range(deser_compact_size(body)):
+                tx = CTransaction()
+                tx.deserialize(body)
+                tx.calc_sha256()
+                received.append(tx.hash)
+            assert_equal(body.read(), b"")
+        assert_equal(received, expected)
+
+        [notification] = self.nodes[0].getzmqnotifications()
+        assert_equal(notification["type"], "pubbatchrawtx")
+        assert_equal(notification["dropped"], 0)
+
     def test_ipv6(self):
         if not test_ipv6_local():
             self.log.info("Skipping IPv6 test, because IPv6 is not supported.")
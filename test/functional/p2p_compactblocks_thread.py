@@ -0,0 +1,52 @@
+#!/usr/bin/env python3
+# Copyright (c) 2024 The Bitcoin Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test compact block relay with -cmpctblockthread.
+
+Blocks reconstructed from compact blocks are validated on a dedicated thread,
+which must leave the relay behavior unchanged.
+"""
+
+from test_framework.test_framework import BitcoinTestFramework
+from test_framework.util import assert_equal
+from test_framework.wallet import MiniWallet
+
+
+class CompactBlocksThreadTest(BitcoinTestFramework):
+    def set_test_params(self):
+        self.num_nodes = 3
+        self.extra_args = [
+            [],
+            ["-cmpctblockthread", "-debug=cmpctblock"],
+            ["-cmpctblockthread", "-debug=cmpctblock"],
+        ]
+
+    def run_test(self):
+        wallet = MiniWallet(self.nodes[0])
+
+        self.log.info("Relay blocks whose transactions are all in the mempools")
+        for _ in range(3):
+            for _ in range(5):
+                wallet.send_self_transfer(from_node=self.nodes[0])
+            self.sync_mempools()
+            with self.nodes[1].assert_debug_log(expected_msgs=["Reconstructed block", "Processed reconstructed block"]):
+                self.generate(self.nodes[0], 1)
+            for node in self.nodes:
+                assert_equal(node.getrawmempool(), [])
+
+        self.log.info("Relay a block with a transaction missing from a mempool")
+        self.disconnect_nodes(0, 1)
+        wallet.send_self_transfer(from_node=self.nodes[0])
+        self.connect_nodes(0, 1)
+        self.generate(self.nodes[0], 1)
+        assert_equal(len({node.getbestblockhash() for node in self.nodes}), 1)
+        # The block stays in flight until the thread processed it, not longer
+        self.wait_until(lambda: all(peer["inflight"] == [] for peer in self.nodes[1].getpeerinfo()))
+
+        self.log.info("Shut down with the compact block thread running")
+        self.restart_node(1, extra_args=["-cmpctblockthread"])
+
+
+if __name__ == '__main__':
+    CompactBlocksThreadTest(__file__).main()